@@ -9,6 +9,8 @@
 #include <utility>
 #include <iostream>
 #include <concepts>
+#include <span>
+#include <initializer_list>
 #include <pp_allocator.h>
 #include <not_implemented.h>
 
@@ -46,12 +48,16 @@ namespace __detail
     }
 }
 
+class big_int_vector;
+
 class big_int
 {
     // Call optimise after every operation!!!
     bool _sign; // 1 +  0 -
     std::vector<unsigned int, pp_allocator<unsigned int>> _digits;
 
+    friend class big_int_vector;
+
 public:
 
     enum class multiplication_rule
@@ -180,4 +186,153 @@ big_int::big_int(Num d, pp_allocator<unsigned int>)
 
 big_int operator""_bi(unsigned long long n);
 
+/** Structure-of-arrays batch of big integers sharing one limb pool.
+ *  Every lane is kept in two's complement of the same width and limbs are stored limb-major
+ *  (_limbs[limb * size() + lane]), so one pass over a row carries all lanes at once without
+ *  per-number branching or allocation.
+ */
+class big_int_vector
+{
+    size_t _size; // lanes
+    size_t _width; // limbs per lane
+    std::vector<unsigned int, pp_allocator<unsigned int>> _limbs;
+
+    /** Drops top limb rows that are pure sign extension in every lane
+     */
+    void optimise() noexcept;
+
+    unsigned int* row(size_t limb) noexcept;
+    const unsigned int* row(size_t limb) const noexcept;
+
+    void check_size(const big_int_vector& other) const;
+
+public:
+
+    explicit big_int_vector(size_t size = 0, size_t width = 1, pp_allocator<unsigned int> allocator = pp_allocator<unsigned int>());
+
+    explicit big_int_vector(std::span<const big_int> nums, pp_allocator<unsigned int> allocator = pp_allocator<unsigned int>());
+
+    template<std::integral Num> requires (!std::same_as<Num, bool>)
+    big_int_vector(std::initializer_list<Num> nums, pp_allocator<unsigned int> allocator = pp_allocator<unsigned int>());
+
+    size_t size() const noexcept;
+    size_t width() const noexcept;
+
+    /** Sign-extends or truncates every lane to width limbs
+     */
+    void resize_width(size_t width);
+
+    bool is_negative(size_t lane) const noexcept;
+
+    void assign(size_t lane, const big_int& value);
+
+    template<std::integral Num> requires (!std::same_as<Num, bool>)
+    void assign(size_t lane, Num value);
+
+    /** Returns the lowest bits of lane converted to Num (modular, like static_cast)
+     */
+    template<std::integral Num> requires (!std::same_as<Num, bool>)
+    Num get(size_t lane) const noexcept;
+
+    /** Writes lane into value reusing its digits storage
+     */
+    void store(size_t lane, big_int& value) const;
+
+    void store(std::span<big_int> values) const;
+
+    big_int_vector& plus_assign(const big_int_vector& other) &;
+
+    big_int_vector& minus_assign(const big_int_vector& other) &;
+
+    /** Lane-wise schoolbook multiplication, result width is the sum of operand widths
+     */
+    big_int_vector& multiply_assign(const big_int_vector& other) &;
+
+    big_int_vector& operator+=(const big_int_vector& other) &;
+    big_int_vector& operator-=(const big_int_vector& other) &;
+    big_int_vector& operator*=(const big_int_vector& other) &;
+
+    big_int_vector operator+(const big_int_vector& other) const;
+    big_int_vector operator-(const big_int_vector& other) const;
+    big_int_vector operator*(const big_int_vector& other) const;
+
+    /** Lane-wise equality independent of widths
+     */
+    bool operator==(const big_int_vector& other) const noexcept;
+
+    /** Pairwise lhs[i] += rhs[i] through one packed batch
+     */
+    static void plus_assign(std::span<big_int> lhs, std::span<const big_int> rhs);
+
+    static void minus_assign(std::span<big_int> lhs, std::span<const big_int> rhs);
+
+    /** Pairwise lhs[i] *= rhs[i] through one packed batch
+     */
+    static void multiply_assign(std::span<big_int> lhs, std::span<const big_int> rhs);
+};
+
+template<std::integral Num> requires (!std::same_as<Num, bool>)
+big_int_vector::big_int_vector(std::initializer_list<Num> nums, pp_allocator<unsigned int> allocator)
+    : big_int_vector(nums.size(), (sizeof(Num) + sizeof(unsigned int) - 1) / sizeof(unsigned int) + 1, allocator)
+{
+    size_t lane = 0;
+    for (auto num : nums)
+    {
+        assign(lane++, num);
+    }
+    optimise();
+}
+
+template<std::integral Num> requires (!std::same_as<Num, bool>)
+void big_int_vector::assign(size_t lane, Num value)
+{
+    constexpr size_t limb_bits = sizeof(unsigned int) * 8;
+    constexpr size_t needed = (sizeof(Num) + sizeof(unsigned int) - 1) / sizeof(unsigned int) + 1;
+
+    if (lane >= _size)
+    {
+        throw std::out_of_range("big_int_vector::assign: lane out of range");
+    }
+
+    if (_width < needed)
+    {
+        resize_width(needed);
+    }
+
+    bool negative = false;
+    if constexpr (std::is_signed_v<Num>)
+    {
+        negative = value < 0;
+    }
+
+    auto bits = static_cast<std::make_unsigned_t<Num>>(value);
+    const unsigned int extension = negative ? ~0u : 0u;
+
+    for (size_t i = 0; i < _width; ++i)
+    {
+        if (i * limb_bits < sizeof(Num) * 8)
+        {
+            row(i)[lane] = static_cast<unsigned int>(bits >> (i * limb_bits));
+        } else
+        {
+            row(i)[lane] = extension;
+        }
+    }
+}
+
+template<std::integral Num> requires (!std::same_as<Num, bool>)
+Num big_int_vector::get(size_t lane) const noexcept
+{
+    constexpr size_t limb_bits = sizeof(unsigned int) * 8;
+    std::make_unsigned_t<Num> bits = 0;
+
+    for (size_t i = 0; i * limb_bits < sizeof(Num) * 8; ++i)
+    {
+        unsigned int limb = i < _width ? row(i)[lane] : (is_negative(lane) ? ~0u : 0u);
+        bits |= static_cast<std::make_unsigned_t<Num>>(static_cast<std::make_unsigned_t<Num>>(limb) << (i * limb_bits));
+    }
+
+    return static_cast<Num>(bits);
+}
+
 #endif //MP_OS_BIG_INT_H
@@ -192,9 +192,9 @@ big_int::big_int(const std::string &num, unsigned int radix, pp_allocator<unsign
     throw not_implemented("big_int::big_int(const std::string &num, unsigned int radix, pp_allocator<unsigned int>)", "your code should be here...");
 }
 
-big_int::big_int(pp_allocator<unsigned int>)
+big_int::big_int(pp_allocator<unsigned int> allocator)
+    : _sign(true), _digits(1, 0u, allocator)
 {
-    throw not_implemented("big_int::big_int(pp_allocator<unsigned int>)", "your code should be here...");
 }
 
 big_int &big_int::multiply_assign(const big_int &other, big_int::multiplication_rule rule) &
@@ -215,4 +215,434 @@ big_int &big_int::modulo_assign(const big_int &other, big_int::division_rule rul
 big_int operator""_bi(unsigned long long n)
 {
     throw not_implemented("big_int operator\"\"_bi(unsigned long long n)", "your code should be here...");
-}
\ No newline at end of file
+}
+
+big_int_vector::big_int_vector(size_t size, size_t width, pp_allocator<unsigned int> allocator)
+    : _size(size), _width(std::max<size_t>(width, 1)), _limbs(size * std::max<size_t>(width, 1), 0u, allocator)
+{
+}
+
+big_int_vector::big_int_vector(std::span<const big_int> nums, pp_allocator<unsigned int> allocator)
+    : _size(nums.size()), _width(1), _limbs(allocator)
+{
+    for (auto& num : nums)
+    {
+        _width = std::max(_width, num._digits.size() + 1);
+    }
+
+    _limbs.assign(_size * _width, 0u);
+
+    for (size_t lane = 0; lane < _size; ++lane)
+    {
+        assign(lane, nums[lane]);
+    }
+
+    optimise();
+}
+
+unsigned int *big_int_vector::row(size_t limb) noexcept
+{
+    return _limbs.data() + limb * _size;
+}
+
+const unsigned int *big_int_vector::row(size_t limb) const noexcept
+{
+    return _limbs.data() + limb * _size;
+}
+
+size_t big_int_vector::size() const noexcept
+{
+    return _size;
+}
+
+size_t big_int_vector::width() const noexcept
+{
+    return _width;
+}
+
+bool big_int_vector::is_negative(size_t lane) const noexcept
+{
+    return (row(_width - 1)[lane] >> (sizeof(unsigned int) * 8 - 1)) != 0;
+}
+
+void big_int_vector::check_size(const big_int_vector &other) const
+{
+    if (_size != other._size)
+    {
+        throw std::invalid_argument("big_int_vector: lane counts of operands differ");
+    }
+}
+
+void big_int_vector::resize_width(size_t width)
+{
+    width = std::max<size_t>(width, 1);
+
+    if (width <= _width)
+    {
+        _limbs.resize(width * _size);
+        _width = width;
+        return;
+    }
+
+    _limbs.resize(width * _size);
+
+    const unsigned int* top = row(_width - 1);
+    for (size_t i = _width; i < width; ++i)
+    {
+        unsigned int* dst = row(i);
+        for (size_t lane = 0; lane < _size; ++lane)
+        {
+            dst[lane] = 0u - (top[lane] >> (sizeof(unsigned int) * 8 - 1));
+        }
+    }
+
+    _width = width;
+}
+
+void big_int_vector::optimise() noexcept
+{
+    while (_width > 1)
+    {
+        const unsigned int* top = row(_width - 1);
+        const unsigned int* below = row(_width - 2);
+        bool redundant = true;
+
+        for (size_t lane = 0; lane < _size; ++lane)
+        {
+            redundant &= top[lane] == 0u - (below[lane] >> (sizeof(unsigned int) * 8 - 1));
+        }
+
+        if (!redundant)
+        {
+            break;
+        }
+
+        --_width;
+        _limbs.resize(_width * _size);
+    }
+}
+
+void big_int_vector::assign(size_t lane, const big_int &value)
+{
+    if (lane >= _size)
+    {
+        throw std::out_of_range("big_int_vector::assign: lane out of range");
+    }
+
+    if (_width < value._digits.size() + 1)
+    {
+        resize_width(value._digits.size() + 1);
+    }
+
+    for (size_t i = 0; i < _width; ++i)
+    {
+        row(i)[lane] = i < value._digits.size() ? value._digits[i] : 0u;
+    }
+
+    if (!value._sign)
+    {
+        unsigned long long carry = 1;
+        for (size_t i = 0; i < _width; ++i)
+        {
+            carry += static_cast<unsigned int>(~row(i)[lane]);
+            row(i)[lane] = static_cast<unsigned int>(carry);
+            carry >>= sizeof(unsigned int) * 8;
+        }
+    }
+}
+
+void big_int_vector::store(size_t lane, big_int &value) const
+{
+    const bool negative = is_negative(lane);
+    const unsigned int mask = negative ? ~0u : 0u;
+
+    value._digits.resize(_width);
+
+    unsigned long long carry = negative ? 1 : 0;
+    for (size_t i = 0; i < _width; ++i)
+    {
+        carry += row(i)[lane] ^ mask;
+        value._digits[i] = static_cast<unsigned int>(carry);
+        carry >>= sizeof(unsigned int) * 8;
+    }
+
+    while (value._digits.size() > 1 && value._digits.back() == 0)
+    {
+        value._digits.pop_back();
+    }
+
+    value._sign = !negative || (value._digits.size() == 1 && value._digits[0] == 0);
+}
+
+void big_int_vector::store(std::span<big_int> values) const
+{
+    if (values.size() != _size)
+    {
+        throw std::invalid_argument("big_int_vector::store: span size differs from lane count");
+    }
+
+    for (size_t lane = 0; lane < _size; ++lane)
+    {
+        store(lane, values[lane]);
+    }
+}
+
+big_int_vector &big_int_vector::plus_assign(const big_int_vector &other) &
+{
+    check_size(other);
+
+    if (this == &other)
+    {
+        big_int_vector copy(other);
+        return plus_assign(copy);
+    }
+
+    constexpr size_t sign_shift = sizeof(unsigned int) * 8 - 1;
+    resize_width(std::max(_width, other._width) + 1);
+
+    std::vector<unsigned int, pp_allocator<unsigned int>> carry(_size, 0u, _limbs.get_allocator());
+    const unsigned int* other_top = other.row(other._width - 1);
+
+    for (size_t i = 0; i < _width; ++i)
+    {
+        unsigned int* dst = row(i);
+        const unsigned int* src = i < other._width ? other.row(i) : nullptr;
+
+        for (size_t lane = 0; lane < _size; ++lane)
+        {
+            unsigned int rhs = src != nullptr ? src[lane] : 0u - (other_top[lane] >> sign_shift);
+            unsigned long long sum = static_cast<unsigned long long>(dst[lane]) + rhs + carry[lane];
+            dst[lane] = static_cast<unsigned int>(sum);
+            carry[lane] = static_cast<unsigned int>(sum >> (sign_shift + 1));
+        }
+    }
+
+    optimise();
+    return *this;
+}
+
+big_int_vector &big_int_vector::minus_assign(const big_int_vector &other) &
+{
+    check_size(other);
+
+    if (this == &other)
+    {
+        std::fill(_limbs.begin(), _limbs.end(), 0u);
+        optimise();
+        return *this;
+    }
+
+    constexpr size_t sign_shift = sizeof(unsigned int) * 8 - 1;
+    resize_width(std::max(_width, other._width) + 1);
+
+    // a - b == a + ~b + 1
+    std::vector<unsigned int, pp_allocator<unsigned int>> carry(_size, 1u, _limbs.get_allocator());
+    const unsigned int* other_top = other.row(other._width - 1);
+
+    for (size_t i = 0; i < _width; ++i)
+    {
+        unsigned int* dst = row(i);
+        const unsigned int* src = i < other._width ? other.row(i) : nullptr;
+
+        for (size_t lane = 0; lane < _size; ++lane)
+        {
+            unsigned int rhs = src != nullptr ? src[lane] : 0u - (other_top[lane] >> sign_shift);
+            unsigned long long sum = static_cast<unsigned long long>(dst[lane]) + static_cast<unsigned int>(~rhs) + carry[lane];
+            dst[lane] = static_cast<unsigned int>(sum);
+            carry[lane] = static_cast<unsigned int>(sum >> (sign_shift + 1));
+        }
+    }
+
+    optimise();
+    return *this;
+}
+
+big_int_vector &big_int_vector::multiply_assign(const big_int_vector &other) &
+{
+    check_size(other);
+
+    constexpr size_t sign_shift = sizeof(unsigned int) * 8 - 1;
+    constexpr size_t limb_bits = sign_shift + 1;
+
+    auto allocator = _limbs.get_allocator();
+    const size_t lhs_width = _width, rhs_width = other._width, res_width = lhs_width + rhs_width;
+
+    // Magnitudes are taken lane-wise with a branchless conditional negation: (x ^ mask) + (mask & 1)
+    auto magnitude = [&](const big_int_vector& src, std::vector<unsigned int, pp_allocator<unsigned int>>& mask)
+    {
+        std::vector<unsigned int, pp_allocator<unsigned int>> res(src._limbs.size(), 0u, allocator);
+        std::vector<unsigned int, pp_allocator<unsigned int>> carry(_size, 0u, allocator);
+        const unsigned int* top = src.row(src._width - 1);
+
+        for (size_t lane = 0; lane < _size; ++lane)
+        {
+            mask[lane] = 0u - (top[lane] >> sign_shift);
+            carry[lane] = mask[lane] & 1u;
+        }
+
+        for (size_t i = 0; i < src._width; ++i)
+        {
+            const unsigned int* s = src.row(i);
+            unsigned int* d = res.data() + i * _size;
+            for (size_t lane = 0; lane < _size; ++lane)
+            {
+                unsigned long long sum = static_cast<unsigned long long>(s[lane] ^ mask[lane]) + carry[lane];
+                d[lane] = static_cast<unsigned int>(sum);
+                carry[lane] = static_cast<unsigned int>(sum >> limb_bits);
+            }
+        }
+
+        return res;
+    };
+
+    std::vector<unsigned int, pp_allocator<unsigned int>> lhs_mask(_size, 0u, allocator), rhs_mask(_size, 0u, allocator);
+    auto lhs = magnitude(*this, lhs_mask);
+    auto rhs = magnitude(other, rhs_mask);
+
+    std::vector<unsigned int, pp_allocator<unsigned int>> res(res_width * _size, 0u, allocator);
+    std::vector<unsigned int, pp_allocator<unsigned int>> carry(_size, 0u, allocator);
+
+    for (size_t i = 0; i < lhs_width; ++i)
+    {
+        const unsigned int* a = lhs.data() + i * _size;
+        std::fill(carry.begin(), carry.end(), 0u);
+
+        for (size_t j = 0; j < rhs_width; ++j)
+        {
+            const unsigned int* b = rhs.data() + j * _size;
+            unsigned int* d = res.data() + (i + j) * _size;
+
+            for (size_t lane = 0; lane < _size; ++lane)
+            {
+                unsigned long long cur = static_cast<unsigned long long>(a[lane]) * b[lane] + d[lane] + carry[lane];
+                d[lane] = static_cast<unsigned int>(cur);
+                carry[lane] = static_cast<unsigned int>(cur >> limb_bits);
+            }
+        }
+
+        std::copy(carry.begin(), carry.end(), res.begin() + (i + rhs_width) * _size);
+    }
+
+    // Restore signs: negate lanes whose operand signs differ
+    for (size_t lane = 0; lane < _size; ++lane)
+    {
+        lhs_mask[lane] ^= rhs_mask[lane];
+        carry[lane] = lhs_mask[lane] & 1u;
+    }
+
+    for (size_t i = 0; i < res_width; ++i)
+    {
+        unsigned int* d = res.data() + i * _size;
+        for (size_t lane = 0; lane < _size; ++lane)
+        {
+            unsigned long long sum = static_cast<unsigned long long>(d[lane] ^ lhs_mask[lane]) + carry[lane];
+            d[lane] = static_cast<unsigned int>(sum);
+            carry[lane] = static_cast<unsigned int>(sum >> limb_bits);
+        }
+    }
+
+    _limbs = std::move(res);
+    _width = res_width;
+    optimise();
+    return *this;
+}
+
+big_int_vector &big_int_vector::operator+=(const big_int_vector &other) &
+{
+    return plus_assign(other);
+}
+
+big_int_vector &big_int_vector::operator-=(const big_int_vector &other) &
+{
+    return minus_assign(other);
+}
+
+big_int_vector &big_int_vector::operator*=(const big_int_vector &other) &
+{
+    return multiply_assign(other);
+}
+
+big_int_vector big_int_vector::operator+(const big_int_vector &other) const
+{
+    big_int_vector res(*this);
+    res += other;
+    return res;
+}
+
+big_int_vector big_int_vector::operator-(const big_int_vector &other) const
+{
+    big_int_vector res(*this);
+    res -= other;
+    return res;
+}
+
+big_int_vector big_int_vector::operator*(const big_int_vector &other) const
+{
+    big_int_vector res(*this);
+    res *= other;
+    return res;
+}
+
+bool big_int_vector::operator==(const big_int_vector &other) const noexcept
+{
+    if (_size != other._size)
+    {
+        return false;
+    }
+
+    constexpr size_t sign_shift = sizeof(unsigned int) * 8 - 1;
+    const size_t width = std::max(_width, other._width);
+    const unsigned int* top = row(_width - 1);
+    const unsigned int* other_top = other.row(other._width - 1);
+
+    for (size_t i = 0; i < width; ++i)
+    {
+        for (size_t lane = 0; lane < _size; ++lane)
+        {
+            unsigned int lhs = i < _width ? row(i)[lane] : 0u - (top[lane] >> sign_shift);
+            unsigned int rhs = i < other._width ? other.row(i)[lane] : 0u - (other_top[lane] >> sign_shift);
+            if (lhs != rhs)
+            {
+                return false;
+            }
+        }
+    }
+
+    return true;
+}
+
+void big_int_vector::plus_assign(std::span<big_int> lhs, std::span<const big_int> rhs)
+{
+    if (lhs.size() != rhs.size())
+    {
+        throw std::invalid_argument("big_int_vector::plus_assign: spans have different sizes");
+    }
+
+    big_int_vector res(std::span<const big_int>(lhs.data(), lhs.size()), lhs.empty() ? pp_allocator<unsigned int>() : lhs.front()._digits.get_allocator());
+    res += big_int_vector(rhs, res._limbs.get_allocator());
+    res.store(lhs);
+}
+
+void big_int_vector::minus_assign(std::span<big_int> lhs, std::span<const big_int> rhs)
+{
+    if (lhs.size() != rhs.size())
+    {
+        throw std::invalid_argument("big_int_vector::minus_assign: spans have different sizes");
+    }
+
+    big_int_vector res(std::span<const big_int>(lhs.data(), lhs.size()), lhs.empty() ? pp_allocator<unsigned int>() : lhs.front()._digits.get_allocator());
+    res -= big_int_vector(rhs, res._limbs.get_allocator());
+    res.store(lhs);
+}
+
+void big_int_vector::multiply_assign(std::span<big_int> lhs, std::span<const big_int> rhs)
+{
+    if (lhs.size() != rhs.size())
+    {
+        throw std::invalid_argument("big_int_vector::multiply_assign: spans have different sizes");
+    }
+
+    big_int_vector res(std::span<const big_int>(lhs.data(), lhs.size()), lhs.empty() ? pp_allocator<unsigned int>() : lhs.front()._digits.get_allocator());
+    res *= big_int_vector(rhs, res._limbs.get_allocator());
+    res.store(lhs);
+}
@@ -4,6 +4,7 @@
 #include <client_logger.h>
 #include <client_logger_builder.h>
 #include <operation_not_supported.h>
+#include <random>
 
 logger *create_logger(
     std::vector<std::pair<std::string, logger::severity>> const &output_file_streams_setup,
@@ -231,6 +232,82 @@ TEST(positive_tests, test9)
     delete logger;
 }
 
+TEST(batch_tests, test1)
+{
+    big_int_vector lhs{ 1ll, -7ll, 4000000000ll, -4294967296ll, 0ll };
+    big_int_vector rhs{ 2ll, 3ll, 4000000000ll, 1ll, -5ll };
+
+    auto sum = lhs + rhs;
+    auto difference = lhs - rhs;
+    auto product = lhs * rhs;
+
+    std::vector<long long> expected_sum{ 3, -4, 8000000000ll, -4294967295ll, -5 };
+    std::vector<long long> expected_difference{ -1, -10, 0, -4294967297ll, 5 };
+
+    for (size_t i = 0; i < lhs.size(); ++i)
+    {
+        EXPECT_EQ(sum.get<long long>(i), expected_sum[i]);
+        EXPECT_EQ(difference.get<long long>(i), expected_difference[i]);
+    }
+
+    EXPECT_EQ(product.get<unsigned long long>(2), 16000000000000000000ull);
+    EXPECT_EQ(product.get<long long>(0), 2);
+    EXPECT_EQ(product.get<long long>(1), -21);
+    EXPECT_EQ(product.get<long long>(3), -4294967296ll);
+    EXPECT_EQ(product.get<long long>(4), 0);
+    EXPECT_TRUE(product.is_negative(1));
+    EXPECT_FALSE(product.is_negative(2));
+}
+
+TEST(batch_tests, test2)
+{
+    std::mt19937_64 gen(42);
+    big_int_vector a(1000), b(1000), c(1000);
+
+    for (size_t i = 0; i < a.size(); ++i)
+    {
+        a.assign(i, static_cast<long long>(gen()));
+        b.assign(i, static_cast<long long>(gen()));
+        c.assign(i, static_cast<long long>(gen()));
+    }
+
+    auto lhs = (a + b) * c;
+    auto rhs = a * c + b * c;
+
+    EXPECT_TRUE(lhs == rhs);
+    EXPECT_TRUE(a * b == b * a);
+    EXPECT_TRUE(a * b * c - a * (b * c) == big_int_vector(1000));
+    EXPECT_LE(lhs.width(), 5);
+}
+
+TEST(batch_tests, test3)
+{
+    big_int_vector lhs_lanes{ 123456789012345678ll, -99999999999ll, 0ll };
+    big_int_vector rhs_lanes{ 987654321098765432ll, 1ll, -12345ll };
+
+    std::vector<big_int> lhs(3), rhs(3);
+    lhs_lanes.store(lhs);
+    rhs_lanes.store(rhs);
+
+    big_int_vector::multiply_assign(lhs, rhs);
+
+    big_int_vector product(lhs);
+
+    EXPECT_TRUE(product == lhs_lanes * rhs_lanes);
+    EXPECT_EQ(product.get<unsigned long long>(0), 11144622436905182352ull);
+    EXPECT_FALSE(product.is_negative(0));
+    EXPECT_EQ(product.get<long long>(1), -99999999999ll);
+    EXPECT_EQ(product.get<long long>(2), 0);
+
+    big_int_vector::plus_assign(lhs, rhs);
+
+    big_int_vector sum(lhs);
+
+    EXPECT_TRUE(sum == lhs_lanes * rhs_lanes + rhs_lanes);
+    EXPECT_EQ(sum.get<long long>(1), -99999999998ll);
+    EXPECT_EQ(sum.get<long long>(2), -12345);
+}
+
 int main(
     int argc,
     char **argv)
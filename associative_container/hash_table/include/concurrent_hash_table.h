@@ -0,0 +1,697 @@
+#ifndef MP_OS_WORKBENCH_CONCURRENT_HASH_TABLE_H
+#define MP_OS_WORKBENCH_CONCURRENT_HASH_TABLE_H
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cstdint>
+#include <functional>
+#include <optional>
+#include <stdexcept>
+#include <thread>
+#include <utility>
+#include <vector>
+#include <logger.h>
+#include <logger_guardant.h>
+#include <pp_allocator.h>
+
+namespace __detail
+{
+    /**
+     * Reader-writer spin lock of one word, small enough to sit in every bucket
+    **/
+    class bucket_lock
+    {
+        static constexpr const uint32_t writer = 1u << 31;
+
+        std::atomic<uint32_t> _state{0};
+
+    public:
+
+        void lock_shared() noexcept
+        {
+            while (true)
+            {
+                uint32_t state = _state.load(std::memory_order_relaxed);
+
+                if ((state & writer) == 0 && _state.compare_exchange_weak(state, state + 1, std::memory_order_acquire))
+                {
+                    return;
+                }
+
+                std::this_thread::yield();
+            }
+        }
+
+        void unlock_shared() noexcept
+        {
+            _state.fetch_sub(1, std::memory_order_release);
+        }
+
+        void lock() noexcept
+        {
+            while (true)
+            {
+                uint32_t state = 0;
+
+                if (_state.compare_exchange_weak(state, writer, std::memory_order_acquire))
+                {
+                    return;
+                }
+
+                std::this_thread::yield();
+            }
+        }
+
+        void unlock() noexcept
+        {
+            _state.store(0, std::memory_order_release);
+        }
+    };
+}
+
+/**
+ * Hash map for concurrent use. Every bucket has its own reader-writer lock over its chain, so operations on
+ * different buckets never meet. Growth is incremental and cooperative: thread which finds table too loaded links
+ * bucket array of twice the size, then every operation migrates a few buckets before doing its own work, and
+ * operation finding its bucket already moved follows to the new array. Replaced bucket arrays are kept until
+ * destruction, their total size never exceeds size of the live one.
+**/
+template<typename tkey, typename tvalue, typename hash = std::hash<tkey>, typename equal = std::equal_to<tkey>>
+class concurrent_hash_table final : private logger_guardant, private hash, private equal
+{
+public:
+
+    using value_type = std::pair<const tkey, tvalue>;
+
+private:
+
+    static constexpr const size_t default_bucket_count = 16;
+    static constexpr const size_t migration_chunk = 16;
+    static constexpr const size_t counter_stripes = 16;
+    static constexpr const size_t cache_line = 64;
+
+    struct node
+    {
+        value_type data;
+        size_t hash_value;
+        node* next;
+
+        template<typename ...Args>
+        node(size_t hash_value, node* next, Args&&... args);
+    };
+
+    struct bucket
+    {
+        __detail::bucket_lock lock;
+        bool moved = false;
+        node* head = nullptr;
+    };
+
+    struct table
+    {
+        std::vector<bucket, pp_allocator<bucket>> buckets;
+        size_t mask;
+
+        std::atomic<table*> next{nullptr};
+
+        // Buckets handed out to migrating threads and buckets already moved
+        std::atomic<size_t> claimed{0};
+        std::atomic<size_t> migrated{0};
+
+        table(size_t count, pp_allocator<bucket> alloc);
+    };
+
+    struct alignas(cache_line) counter
+    {
+        std::atomic<ptrdiff_t> value{0};
+    };
+
+    pp_allocator<value_type> _alloc;
+    logger* _logger;
+    double _max_load_factor;
+
+    mutable std::atomic<table*> _table;
+    table* _oldest;
+    counter _counters[counter_stripes];
+
+    logger* get_logger() const noexcept override;
+
+    inline size_t hash_of(const tkey& key) const;
+
+    inline bool equal_keys(const tkey& lhs, const tkey& rhs) const;
+
+    table* create_table(size_t count);
+
+    void count(ptrdiff_t delta) noexcept;
+
+    /*
+     * Links array of twice the size behind live array t unless some growth is already running. Array being filled
+     * by migration does not grow, otherwise its buckets could move on before receiving all their keys
+     */
+    void grow(table* t);
+
+    /*
+     * Moves next chunk of buckets of t to its successor, publishes successor when last bucket is moved
+     */
+    void help_migrate(table* t) const;
+
+    void migrate_bucket(table* t, table* next, size_t index) const;
+
+    static node* find_in_chain(const concurrent_hash_table& owner, node* head, const tkey& key, size_t hash_value);
+
+    /*
+     * Calls visit with locked bucket of hash_value in the newest array holding it
+     */
+    template<bool exclusive, typename visitor>
+    auto visit_bucket(size_t hash_value, visitor&& visit) const;
+
+    void destroy() noexcept;
+
+public:
+
+    // region constructors declaration
+
+    explicit concurrent_hash_table(size_t bucket_count = default_bucket_count, double max_load_factor = 1.0, pp_allocator<value_type> alloc = pp_allocator<value_type>(), logger* logger = nullptr);
+
+    // endregion constructors declaration
+
+    // region five declaration
+
+    concurrent_hash_table(const concurrent_hash_table& other) = delete;
+
+    concurrent_hash_table& operator=(const concurrent_hash_table& other) = delete;
+
+    /*
+     * Must not run concurrently with any other operation
+     */
+    ~concurrent_hash_table() noexcept;
+
+    // endregion five declaration
+
+    // region lookup declaration
+
+    /*
+     * Exact only while no modification runs
+     */
+    size_t size() const noexcept;
+    bool empty() const noexcept;
+
+    /*
+     * Copy of value, empty if not exist
+     */
+    std::optional<tvalue> find(const tkey& key) const;
+
+    bool contains(const tkey& key) const;
+
+    // endregion lookup declaration
+
+    // region modifiers declaration
+
+    /*
+     * Does nothing if key exists, returns true when inserted
+     */
+    bool insert(const tkey& key, const tvalue& value);
+
+    /*
+     * Returns true when inserted, false when existing value was replaced
+     */
+    bool insert_or_assign(const tkey& key, const tvalue& value);
+
+    bool erase(const tkey& key);
+
+    // endregion modifiers declaration
+
+    // region hash policy declaration
+
+    double max_load_factor() const noexcept;
+
+    double load_factor() const noexcept;
+
+    size_t bucket_count() const noexcept;
+
+    /*
+     * Grows table to hold count elements within max load factor and finishes migration
+     */
+    void reserve(size_t count);
+
+    // endregion hash policy declaration
+};
+
+template<typename tkey, typename tvalue, typename hash, typename equal>
+template<typename ...Args>
+concurrent_hash_table<tkey, tvalue, hash, equal>::node::node(size_t hash_value, node* next, Args&&... args)
+    : data(std::forward<Args>(args)...), hash_value(hash_value), next(next)
+{
+}
+
+template<typename tkey, typename tvalue, typename hash, typename equal>
+concurrent_hash_table<tkey, tvalue, hash, equal>::table::table(size_t count, pp_allocator<bucket> alloc)
+    : buckets(count, alloc), mask(count - 1)
+{
+}
+
+// region private implementation
+
+template<typename tkey, typename tvalue, typename hash, typename equal>
+logger* concurrent_hash_table<tkey, tvalue, hash, equal>::get_logger() const noexcept
+{
+    return _logger;
+}
+
+template<typename tkey, typename tvalue, typename hash, typename equal>
+size_t concurrent_hash_table<tkey, tvalue, hash, equal>::hash_of(const tkey& key) const
+{
+    // Bucket is picked by low bits, so poor low bits of identity hashes are mixed with high ones
+    uint64_t value = static_cast<uint64_t>(hash::operator()(key)) * 0x9E3779B97F4A7C15ull;
+    return static_cast<size_t>(value ^ (value >> 32));
+}
+
+template<typename tkey, typename tvalue, typename hash, typename equal>
+bool concurrent_hash_table<tkey, tvalue, hash, equal>::equal_keys(const tkey& lhs, const tkey& rhs) const
+{
+    return equal::operator()(lhs, rhs);
+}
+
+template<typename tkey, typename tvalue, typename hash, typename equal>
+typename concurrent_hash_table<tkey, tvalue, hash, equal>::table* concurrent_hash_table<tkey, tvalue, hash, equal>::create_table(size_t count)
+{
+    return _alloc.template new_object<table>(count, pp_allocator<bucket>(_alloc));
+}
+
+template<typename tkey, typename tvalue, typename hash, typename equal>
+void concurrent_hash_table<tkey, tvalue, hash, equal>::count(ptrdiff_t delta) noexcept
+{
+    static thread_local const size_t stripe = std::hash<std::thread::id>()(std::this_thread::get_id()) % counter_stripes;
+    _counters[stripe].value.fetch_add(delta, std::memory_order_relaxed);
+}
+
+template<typename tkey, typename tvalue, typename hash, typename equal>
+void concurrent_hash_table<tkey, tvalue, hash, equal>::grow(table* t)
+{
+    if (_table.load(std::memory_order_acquire) != t || t->next.load(std::memory_order_acquire) != nullptr)
+    {
+        return;
+    }
+
+    table* next = create_table(t->buckets.size() * 2);
+    table* expected = nullptr;
+
+    if (!t->next.compare_exchange_strong(expected, next, std::memory_order_acq_rel))
+    {
+        _alloc.delete_object(next);
+    }
+}
+
+template<typename tkey, typename tvalue, typename hash, typename equal>
+void concurrent_hash_table<tkey, tvalue, hash, equal>::help_migrate(table* t) const
+{
+    table* next = t->next.load(std::memory_order_acquire);
+    size_t total = t->buckets.size();
+    size_t begin = t->claimed.fetch_add(migration_chunk, std::memory_order_relaxed);
+
+    if (next == nullptr || begin >= total)
+    {
+        return;
+    }
+
+    size_t end = std::min(begin + migration_chunk, total);
+
+    for (size_t i = begin; i < end; ++i)
+    {
+        migrate_bucket(t, next, i);
+    }
+
+    if (t->migrated.fetch_add(end - begin, std::memory_order_acq_rel) + (end - begin) == total)
+    {
+        _table.compare_exchange_strong(t, next, std::memory_order_release);
+    }
+}
+
+template<typename tkey, typename tvalue, typename hash, typename equal>
+void concurrent_hash_table<tkey, tvalue, hash, equal>::migrate_bucket(table* t, table* next, size_t index) const
+{
+    bucket& source = t->buckets[index];
+    source.lock.lock();
+
+    // Array is doubled, so keys of one old bucket go to two new ones nobody else can reach until this one is moved
+    node* current = source.head;
+
+    while (current != nullptr)
+    {
+        node* following = current->next;
+        bucket& target = next->buckets[current->hash_value & next->mask];
+
+        target.lock.lock();
+        current->next = target.head;
+        target.head = current;
+        target.lock.unlock();
+
+        current = following;
+    }
+
+    source.head = nullptr;
+    source.moved = true;
+    source.lock.unlock();
+}
+
+template<typename tkey, typename tvalue, typename hash, typename equal>
+typename concurrent_hash_table<tkey, tvalue, hash, equal>::node* concurrent_hash_table<tkey, tvalue, hash, equal>::find_in_chain(const concurrent_hash_table& owner, node* head, const tkey& key, size_t hash_value)
+{
+    for (; head != nullptr; head = head->next)
+    {
+        if (head->hash_value == hash_value && owner.equal_keys(head->data.first, key))
+        {
+            return head;
+        }
+    }
+
+    return nullptr;
+}
+
+template<typename tkey, typename tvalue, typename hash, typename equal>
+template<bool exclusive, typename visitor>
+auto concurrent_hash_table<tkey, tvalue, hash, equal>::visit_bucket(size_t hash_value, visitor&& visit) const
+{
+    table* t = _table.load(std::memory_order_acquire);
+
+    if (t->next.load(std::memory_order_acquire) != nullptr)
+    {
+        help_migrate(t);
+    }
+
+    while (true)
+    {
+        bucket& target = t->buckets[hash_value & t->mask];
+
+        if constexpr (exclusive)
+        {
+            target.lock.lock();
+        } else
+        {
+            target.lock.lock_shared();
+        }
+
+        if (!target.moved)
+        {
+            // Lock is released on the way out whether visit returns or throws
+            struct unlocker
+            {
+                bucket& locked;
+
+                ~unlocker()
+                {
+                    if constexpr (exclusive)
+                    {
+                        locked.lock.unlock();
+                    } else
+                    {
+                        locked.lock.unlock_shared();
+                    }
+                }
+            } guard{target};
+
+            return visit(target, t);
+        }
+
+        if constexpr (exclusive)
+        {
+            target.lock.unlock();
+        } else
+        {
+            target.lock.unlock_shared();
+        }
+
+        t = t->next.load(std::memory_order_acquire);
+    }
+}
+
+template<typename tkey, typename tvalue, typename hash, typename equal>
+void concurrent_hash_table<tkey, tvalue, hash, equal>::destroy() noexcept
+{
+    table* live = _table.load(std::memory_order_acquire);
+
+    for (auto& item : live->buckets)
+    {
+        for (node* current = item.head; current != nullptr;)
+        {
+            node* following = current->next;
+            _alloc.delete_object(current);
+            current = following;
+        }
+    }
+
+    // Growth started but not finished leaves nodes in both arrays, the unmoved ones were freed above
+    for (table* next = live->next.load(std::memory_order_acquire); next != nullptr; next = next->next.load(std::memory_order_acquire))
+    {
+        for (auto& item : next->buckets)
+        {
+            for (node* current = item.head; current != nullptr;)
+            {
+                node* following = current->next;
+                _alloc.delete_object(current);
+                current = following;
+            }
+        }
+    }
+
+    for (table* current = _oldest; current != nullptr;)
+    {
+        table* following = current->next.load(std::memory_order_acquire);
+        _alloc.delete_object(current);
+        current = following;
+    }
+}
+
+// endregion private implementation
+
+// region constructors implementation
+
+template<typename tkey, typename tvalue, typename hash, typename equal>
+concurrent_hash_table<tkey, tvalue, hash, equal>::concurrent_hash_table(size_t bucket_count, double max_load_factor, pp_allocator<value_type> alloc, logger* logger)
+    : _alloc(alloc), _logger(logger), _max_load_factor(max_load_factor), _table(nullptr), _oldest(nullptr)
+{
+    if (!(max_load_factor > 0))
+    {
+        throw std::invalid_argument("max load factor must be positive");
+    }
+
+    _oldest = create_table(std::bit_ceil(std::max<size_t>(bucket_count, 1)));
+    _table.store(_oldest, std::memory_order_release);
+}
+
+// endregion constructors implementation
+
+// region five implementation
+
+template<typename tkey, typename tvalue, typename hash, typename equal>
+concurrent_hash_table<tkey, tvalue, hash, equal>::~concurrent_hash_table() noexcept
+{
+    destroy();
+}
+
+// endregion five implementation
+
+// region lookup implementation
+
+template<typename tkey, typename tvalue, typename hash, typename equal>
+size_t concurrent_hash_table<tkey, tvalue, hash, equal>::size() const noexcept
+{
+    ptrdiff_t result = 0;
+
+    for (auto& item : _counters)
+    {
+        result += item.value.load(std::memory_order_relaxed);
+    }
+
+    return result < 0 ? 0 : static_cast<size_t>(result);
+}
+
+template<typename tkey, typename tvalue, typename hash, typename equal>
+bool concurrent_hash_table<tkey, tvalue, hash, equal>::empty() const noexcept
+{
+    return size() == 0;
+}
+
+template<typename tkey, typename tvalue, typename hash, typename equal>
+std::optional<tvalue> concurrent_hash_table<tkey, tvalue, hash, equal>::find(const tkey& key) const
+{
+    size_t hash_value = hash_of(key);
+
+    return visit_bucket<false>(hash_value, [&](bucket& target, table*) -> std::optional<tvalue>
+    {
+        node* found = find_in_chain(*this, target.head, key, hash_value);
+
+        if (found == nullptr)
+        {
+            return std::nullopt;
+        }
+
+        return found->data.second;
+    });
+}
+
+template<typename tkey, typename tvalue, typename hash, typename equal>
+bool concurrent_hash_table<tkey, tvalue, hash, equal>::contains(const tkey& key) const
+{
+    size_t hash_value = hash_of(key);
+
+    return visit_bucket<false>(hash_value, [&](bucket& target, table*)
+    {
+        return find_in_chain(*this, target.head, key, hash_value) != nullptr;
+    });
+}
+
+// endregion lookup implementation
+
+// region modifiers implementation
+
+template<typename tkey, typename tvalue, typename hash, typename equal>
+bool concurrent_hash_table<tkey, tvalue, hash, equal>::insert(const tkey& key, const tvalue& value)
+{
+    size_t hash_value = hash_of(key);
+    table* grown = nullptr;
+
+    bool inserted = visit_bucket<true>(hash_value, [&](bucket& target, table* t)
+    {
+        if (find_in_chain(*this, target.head, key, hash_value) != nullptr)
+        {
+            return false;
+        }
+
+        // Growth is considered only when chain gets long, so that counters are not summed on every insert
+        if (target.head != nullptr)
+        {
+            grown = t;
+        }
+
+        target.head = _alloc.template new_object<node>(hash_value, target.head, key, value);
+        return true;
+    });
+
+    if (inserted)
+    {
+        count(1);
+
+        if (grown != nullptr && size() > _max_load_factor * grown->buckets.size())
+        {
+            grow(grown);
+        }
+    }
+
+    return inserted;
+}
+
+template<typename tkey, typename tvalue, typename hash, typename equal>
+bool concurrent_hash_table<tkey, tvalue, hash, equal>::insert_or_assign(const tkey& key, const tvalue& value)
+{
+    size_t hash_value = hash_of(key);
+    table* grown = nullptr;
+
+    bool inserted = visit_bucket<true>(hash_value, [&](bucket& target, table* t)
+    {
+        node* found = find_in_chain(*this, target.head, key, hash_value);
+
+        if (found != nullptr)
+        {
+            found->data.second = value;
+            return false;
+        }
+
+        if (target.head != nullptr)
+        {
+            grown = t;
+        }
+
+        target.head = _alloc.template new_object<node>(hash_value, target.head, key, value);
+        return true;
+    });
+
+    if (inserted)
+    {
+        count(1);
+
+        if (grown != nullptr && size() > _max_load_factor * grown->buckets.size())
+        {
+            grow(grown);
+        }
+    }
+
+    return inserted;
+}
+
+template<typename tkey, typename tvalue, typename hash, typename equal>
+bool concurrent_hash_table<tkey, tvalue, hash, equal>::erase(const tkey& key)
+{
+    size_t hash_value = hash_of(key);
+
+    bool erased = visit_bucket<true>(hash_value, [&](bucket& target, table*)
+    {
+        for (node** link = &target.head; *link != nullptr; link = &(*link)->next)
+        {
+            if ((*link)->hash_value == hash_value && equal_keys((*link)->data.first, key))
+            {
+                node* found = *link;
+                *link = found->next;
+                _alloc.delete_object(found);
+                return true;
+            }
+        }
+
+        return false;
+    });
+
+    if (erased)
+    {
+        count(-1);
+    }
+
+    return erased;
+}
+
+// endregion modifiers implementation
+
+// region hash policy implementation
+
+template<typename tkey, typename tvalue, typename hash, typename equal>
+double concurrent_hash_table<tkey, tvalue, hash, equal>::max_load_factor() const noexcept
+{
+    return _max_load_factor;
+}
+
+template<typename tkey, typename tvalue, typename hash, typename equal>
+double concurrent_hash_table<tkey, tvalue, hash, equal>::load_factor() const noexcept
+{
+    return static_cast<double>(size()) / bucket_count();
+}
+
+template<typename tkey, typename tvalue, typename hash, typename equal>
+size_t concurrent_hash_table<tkey, tvalue, hash, equal>::bucket_count() const noexcept
+{
+    return _table.load(std::memory_order_acquire)->buckets.size();
+}
+
+template<typename tkey, typename tvalue, typename hash, typename equal>
+void concurrent_hash_table<tkey, tvalue, hash, equal>::reserve(size_t count)
+{
+    while (true)
+    {
+        table* t = _table.load(std::memory_order_acquire);
+
+        if (t->next.load(std::memory_order_acquire) != nullptr)
+        {
+            help_migrate(t);
+            std::this_thread::yield();
+        } else if (count > _max_load_factor * t->buckets.size())
+        {
+            grow(t);
+        } else
+        {
+            return;
+        }
+    }
+}
+
+// endregion hash policy implementation
+
+#endif //MP_OS_WORKBENCH_CONCURRENT_HASH_TABLE_H
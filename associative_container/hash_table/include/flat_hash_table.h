@@ -0,0 +1,1699 @@
+#ifndef MP_OS_WORKBENCH_FLAT_HASH_TABLE_H
+#define MP_OS_WORKBENCH_FLAT_HASH_TABLE_H
+
+#include <algorithm>
+#include <bit>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <span>
+#include <stdexcept>
+#include <utility>
+#include <hash_table.h>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define MP_OS_FLAT_HASH_TABLE_SSE2
+#endif
+
+/**
+ * Open addressing storage policy for hash_table. Elements live inline in one slot array, and every slot has control
+ * byte holding either seven bits of element hash or empty/deleted marker. Slots are probed in aligned groups of
+ * sixteen, and control bytes of whole group are matched against hash at once, so most lookups compare one key.
+ * Switching hash_table<tkey, tvalue> to hash_table<tkey, tvalue, flat_storage<>> keeps its interface, except that
+ * insertion and rehash move elements and so invalidate iterators and references.
+**/
+template<typename equal = std::equal_to<>>
+struct flat_storage
+{
+    using storage_policy_tag = void;
+    using key_equal = equal;
+};
+
+/**
+ * Hash and key equality both marked with is_transparent, so that lookup_key is hashed and compared as it is and
+ * lookups make no tkey temporary. Hash of lookup_key must be equal to hash of tkey equal to it
+**/
+template<typename hash, typename equal, typename lookup_key, typename tkey>
+concept transparent_hash_for = requires(const hash h, const equal eq, const lookup_key& key, const tkey& stored)
+                               {
+                                   typename hash::is_transparent;
+                                   typename equal::is_transparent;
+                                   {h(key)} -> std::convertible_to<size_t>;
+                                   {eq(stored, key)} -> std::convertible_to<bool>;
+                               };
+
+namespace __detail
+{
+    using ctrl_t = int8_t;
+
+    inline constexpr const ctrl_t ctrl_empty = -128;
+    inline constexpr const ctrl_t ctrl_deleted = -2;
+
+    /**
+     * Sixteen control bytes matched at once. Full slots hold non-negative hash bits, so high bit alone tells free
+     * slots from full ones. Every match returns bit mask with bit i set for slot i of group
+    **/
+    class ctrl_group
+    {
+    public:
+
+        static constexpr const size_t width = 16;
+
+    private:
+
+#ifdef MP_OS_FLAT_HASH_TABLE_SSE2
+        __m128i _ctrl;
+#else
+        const ctrl_t* _ctrl;
+
+        template<typename predicate>
+        uint32_t match_if(predicate pred) const noexcept
+        {
+            uint32_t mask = 0;
+
+            for (size_t i = 0; i < width; ++i)
+            {
+                mask |= static_cast<uint32_t>(pred(_ctrl[i])) << i;
+            }
+
+            return mask;
+        }
+#endif
+
+    public:
+
+#ifdef MP_OS_FLAT_HASH_TABLE_SSE2
+        explicit ctrl_group(const ctrl_t* ctrl) noexcept : _ctrl(_mm_load_si128(reinterpret_cast<const __m128i*>(ctrl)))
+        {
+        }
+
+        uint32_t match(ctrl_t h2) const noexcept
+        {
+            return static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(_ctrl, _mm_set1_epi8(h2))));
+        }
+
+        uint32_t match_empty() const noexcept
+        {
+            return static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(_ctrl, _mm_set1_epi8(ctrl_empty))));
+        }
+
+        uint32_t match_free() const noexcept
+        {
+            return static_cast<uint32_t>(_mm_movemask_epi8(_ctrl));
+        }
+#else
+        explicit ctrl_group(const ctrl_t* ctrl) noexcept : _ctrl(ctrl)
+        {
+        }
+
+        uint32_t match(ctrl_t h2) const noexcept
+        {
+            return match_if([h2](ctrl_t c) { return c == h2; });
+        }
+
+        uint32_t match_empty() const noexcept
+        {
+            return match_if([](ctrl_t c) { return c == ctrl_empty; });
+        }
+
+        uint32_t match_free() const noexcept
+        {
+            return match_if([](ctrl_t c) { return c < 0; });
+        }
+#endif
+
+        uint32_t match_full() const noexcept
+        {
+            return ~match_free() & ((1u << width) - 1);
+        }
+    };
+
+    /*
+     * Asks for cache line holding data to be loaded ahead of use, does nothing where not supported
+     */
+    inline void prefetch_line(const void* data) noexcept
+    {
+#if defined(__GNUC__) || defined(__clang__)
+        __builtin_prefetch(data);
+#elif defined(MP_OS_FLAT_HASH_TABLE_SSE2)
+        _mm_prefetch(static_cast<const char*>(data), _MM_HINT_T0);
+#endif
+    }
+}
+
+template<typename tkey, typename tvalue, typename equal, typename hash>
+class hash_table<tkey, tvalue, flat_storage<equal>, hash> final : private hash, private equal
+{
+public:
+
+    using value_type = std::pair<const tkey, tvalue>;
+
+private:
+
+    using ctrl_t = __detail::ctrl_t;
+    using group = __detail::ctrl_group;
+
+    static constexpr const double default_max_load_factor = 0.875;
+
+    /*
+     * Keys of batched lookup whose cache misses are overlapped
+     */
+    static constexpr const size_t batch_width = 16;
+
+    struct slot_array
+    {
+        ctrl_t* ctrl = nullptr;
+        value_type* slots = nullptr;
+        size_t capacity = 0;
+    };
+
+    slot_array _table;
+
+    // Array drained into _table by incremental rehash, groups before _migrated are already moved
+    slot_array _old;
+    size_t _migrated;
+
+    // Capacity asked for by rehash or reserve during migration, next migration starts with it once _old drains
+    size_t _pending_capacity;
+    size_t _rehash_step;
+
+    size_t _size;
+    size_t _tombstones;
+    pp_allocator<value_type> _alloc;
+    double _max_load_factor;
+    logger* _logger;
+
+    template<typename lookup_key>
+    inline size_t hash_of(const lookup_key& key) const;
+
+    static ctrl_t h2(size_t hash_value) noexcept;
+
+    size_t growth_limit(size_t capacity) const noexcept;
+
+    /*
+     * Smallest capacity holding count elements within max load factor
+     */
+    size_t capacity_for(size_t count) const noexcept;
+
+    slot_array allocate_array(size_t capacity);
+
+    slot_array copy_array(const slot_array& other);
+
+    /*
+     * Destroys elements and frees memory of array
+     */
+    void release_array(slot_array& array) noexcept;
+
+    /*
+     * Index of slot holding key, capacity of array if not exist
+     */
+    template<typename lookup_key>
+    size_t probe(const slot_array& array, const lookup_key& key, size_t hash_value) const;
+
+    /*
+     * First empty or deleted slot on probe sequence, array must have one
+     */
+    static size_t find_free(const slot_array& array, size_t hash_value) noexcept;
+
+    /*
+     * Array and index of slot holding key, null array if not exist
+     */
+    template<typename lookup_key>
+    std::pair<const slot_array*, size_t> locate(const lookup_key& key, size_t hash_value) const;
+
+    /*
+     * Prefetches control bytes of home group of hash
+     */
+    void prefetch_group(size_t hash_value) const noexcept;
+
+    /*
+     * Prefetches first slot of home group whose control bits match hash, control bytes should be in cache already
+     */
+    void prefetch_candidate(size_t hash_value) const noexcept;
+
+    /*
+     * Calls visit(i, array, index) with result of locate for every keys[i]. Keys go in groups of batch_width: all of
+     * them are hashed and their control bytes prefetched, then candidate slots prefetched, and only then keys are
+     * compared, so cache misses of different keys overlap instead of following one another
+     */
+    template<typename visitor>
+    void locate_batch(std::span<const tkey> keys, visitor&& visit) const;
+
+    template<typename ...Args>
+    size_t emplace_in_table(size_t hash_value, Args&&... args);
+
+    /*
+     * Moves all elements to fresh array of given capacity, dropping tombstones. Keeps table intact on exception
+     */
+    void rebuild(size_t capacity);
+
+    /*
+     * Makes array of given capacity live and leaves current one to be drained by insertions
+     */
+    void start_migration(size_t capacity);
+
+    /*
+     * Moves next groups of drained array, frees it once empty. Moved slots become tombstones, so probe sequences
+     * of keys not moved yet stay intact
+     */
+    void migrate(size_t groups);
+
+    /*
+     * Rebuilds at once, or incrementally when rehash step is set and no migration is running
+     */
+    void resize(size_t capacity);
+
+    /*
+     * Resize asked for by user, which waits for running migration instead of rebuilding at once
+     */
+    void request_capacity(size_t capacity);
+
+    /*
+     * Makes room for one more element
+     */
+    void prepare_insert();
+
+    template<typename value>
+    auto insert_value(value&& data, bool assign);
+
+    void erase_at(slot_array& array, size_t index) noexcept;
+
+    void destroy() noexcept;
+
+public:
+
+    // region constructors declaration
+
+    explicit hash_table(pp_allocator<value_type> = pp_allocator<value_type>(), logger* logger = nullptr);
+
+    hash_table(std::initializer_list<std::pair<tkey, tvalue>> data, pp_allocator<value_type> = pp_allocator<value_type>(), logger* logger = nullptr);
+
+    // endregion constructors declaration
+
+    // region five declaration
+
+    hash_table(const hash_table& other);
+
+    hash_table(hash_table&& other) noexcept;
+
+    hash_table& operator=(const hash_table& other);
+
+    hash_table& operator=(hash_table&& other) noexcept;
+
+    ~hash_table() noexcept;
+
+    // endregion five declaration
+
+    // region iterator
+
+    class const_iterator;
+
+    /**
+     * Walks live array, then array being drained, if any
+    **/
+    class iterator final
+    {
+        const ctrl_t* _ctrl;
+        const ctrl_t* _ctrl_end;
+        hash_table::value_type* _slot;
+
+        const ctrl_t* _next_ctrl;
+        const ctrl_t* _next_ctrl_end;
+        hash_table::value_type* _next_slot;
+
+        friend class hash_table;
+        friend class const_iterator;
+
+        void skip_free() noexcept;
+
+    public:
+
+        using value_type = std::pair<const tkey, tvalue>;
+        using difference_type = ptrdiff_t;
+        using reference = value_type&;
+        using pointer = value_type *;
+        using iterator_category = std::forward_iterator_tag;
+        using self = iterator;
+
+        reference operator*() const noexcept;
+        pointer operator->() const noexcept;
+
+        self& operator++();
+        self operator++(int);
+
+        bool operator==(const self& other) const noexcept;
+        bool operator!=(const self& other) const noexcept;
+
+        explicit iterator(const ctrl_t* ctrl = nullptr, const ctrl_t* ctrl_end = nullptr, value_type* slot = nullptr,
+                          const ctrl_t* next_ctrl = nullptr, const ctrl_t* next_ctrl_end = nullptr, value_type* next_slot = nullptr);
+    };
+
+    class const_iterator final
+    {
+        const ctrl_t* _ctrl;
+        const ctrl_t* _ctrl_end;
+        const hash_table::value_type* _slot;
+
+        const ctrl_t* _next_ctrl;
+        const ctrl_t* _next_ctrl_end;
+        const hash_table::value_type* _next_slot;
+
+        friend class hash_table;
+
+        void skip_free() noexcept;
+
+    public:
+
+        using value_type = std::pair<const tkey, tvalue>;
+        using difference_type = ptrdiff_t;
+        using reference = const value_type&;
+        using pointer = const value_type *;
+        using iterator_category = std::forward_iterator_tag;
+        using self = const_iterator;
+
+        reference operator*() const noexcept;
+        pointer operator->() const noexcept;
+
+        self& operator++();
+        self operator++(int);
+
+        bool operator==(const self& other) const noexcept;
+        bool operator!=(const self& other) const noexcept;
+
+        const_iterator(const iterator&);
+        explicit const_iterator(const ctrl_t* ctrl = nullptr, const ctrl_t* ctrl_end = nullptr, const value_type* slot = nullptr,
+                                const ctrl_t* next_ctrl = nullptr, const ctrl_t* next_ctrl_end = nullptr, const value_type* next_slot = nullptr);
+    };
+
+    friend class iterator;
+    friend class const_iterator;
+
+    // endregion iterator
+
+private:
+
+    iterator make_iterator(const slot_array* array, size_t index);
+    const_iterator make_iterator(const slot_array* array, size_t index) const;
+
+    iterator unconst(const_iterator it) noexcept;
+
+public:
+
+    // region element access declaration
+
+    /*
+     * Returns a reference to the mapped value of the element with specified key. If no such element exists, an exception of type std::out_of_range is thrown.
+     */
+    tvalue& at(const tkey&);
+    const tvalue& at(const tkey&) const;
+
+    /*
+     * Lookup by key of other type, when hash and key equality are transparent
+     */
+    template<typename lookup_key> requires transparent_hash_for<hash, equal, lookup_key, tkey>
+    tvalue& at(const lookup_key& key);
+
+    template<typename lookup_key> requires transparent_hash_for<hash, equal, lookup_key, tkey>
+    const tvalue& at(const lookup_key& key) const;
+
+    /*
+     * If key not exists, makes default initialization of value
+     */
+    tvalue& operator[](const tkey& key);
+    tvalue& operator[](tkey&& key);
+
+    // endregion element access declaration
+
+    // region iterator begins declaration
+
+    iterator begin();
+    iterator end();
+
+    const_iterator begin() const;
+    const_iterator end() const;
+
+    const_iterator cbegin() const;
+    const_iterator cend() const;
+
+    // endregion iterator begins declaration
+
+    // region lookup declaration
+
+    size_t size() const noexcept;
+    bool empty() const noexcept;
+
+    /*
+     * Returns end() if not exist
+     */
+    iterator find(const tkey& key);
+    const_iterator find(const tkey& key) const;
+
+    bool contains(const tkey& key) const;
+
+    template<typename lookup_key> requires transparent_hash_for<hash, equal, lookup_key, tkey>
+    iterator find(const lookup_key& key);
+
+    template<typename lookup_key> requires transparent_hash_for<hash, equal, lookup_key, tkey>
+    const_iterator find(const lookup_key& key) const;
+
+    template<typename lookup_key> requires transparent_hash_for<hash, equal, lookup_key, tkey>
+    bool contains(const lookup_key& key) const;
+
+    /*
+     * Writes find(keys[i]) to result[i]. Misses of independent lookups overlap, so probing with many keys at once
+     * is several times faster than calling find for each. Throws std::invalid_argument if spans differ in size
+     */
+    void find_batch(std::span<const tkey> keys, std::span<iterator> result);
+    void find_batch(std::span<const tkey> keys, std::span<const_iterator> result) const;
+
+    // endregion lookup declaration
+
+    // region modifiers declaration
+
+    void clear() noexcept;
+
+    /*
+     * Does nothing if key exists.
+     * Second return value is true, when inserted
+     */
+    std::pair<iterator, bool> insert(const value_type & data);
+    std::pair<iterator, bool> insert(value_type && data);
+
+    template <typename ...Args>
+    std::pair<iterator, bool> emplace(Args&&... args);
+
+    /*
+     * Updates value if key exists
+     */
+    iterator insert_or_assign(const value_type & data);
+    iterator insert_or_assign(value_type && data);
+
+    template <typename ...Args>
+    iterator emplace_or_assign(Args&&... args);
+
+    /*
+     * Return iterator to node next ro removed or end() if key not exists. Erase never moves other elements
+     */
+    iterator erase(iterator pos);
+    iterator erase(const_iterator pos);
+
+    iterator erase(iterator beg, iterator en);
+    iterator erase(const_iterator beg, const_iterator en);
+
+    iterator erase(const tkey& key);
+
+    // endregion modifiers declaration
+
+    // region hash policy
+
+    double max_load_factor() const;
+
+    /*
+     * Open addressing needs free slots, so ml must lie in (0, 1]
+     */
+    void max_load_factor(double ml);
+
+    double load_factor() const;
+
+    /*
+     * Count of slots in live array, always power of two and multiple of group width
+     */
+    size_t bucket_count() const noexcept;
+
+    void rehash(size_t count);
+    void reserve(size_t count);
+
+    /*
+     * Count of slot groups moved by every insertion while table grows, 0 (default) moves all elements at once.
+     * Lookups and erasures never move elements, so iterators stay valid across them during migration. Capacity
+     * asked for by rehash or reserve during migration is taken by the next migration once this one ends
+     */
+    size_t rehash_step() const noexcept;
+    void rehash_step(size_t groups);
+
+    /*
+     * True while elements of replaced array are still being moved
+     */
+    bool rehashing() const noexcept;
+
+    // endregion hash policy
+};
+
+// region private implementation
+
+template<typename tkey, typename tvalue, typename equal, typename hash>
+template<typename lookup_key>
+size_t hash_table<tkey, tvalue, flat_storage<equal>, hash>::hash_of(const lookup_key& key) const
+{
+    // Both group index and control bits are taken from hash, so identity hashes are mixed first
+    uint64_t value = static_cast<uint64_t>(hash::operator()(key)) * 0x9E3779B97F4A7C15ull;
+    return static_cast<size_t>(value ^ (value >> 32));
+}
+
+template<typename tkey, typename tvalue, typename equal, typename hash>
+typename hash_table<tkey, tvalue, flat_storage<equal>, hash>::ctrl_t hash_table<tkey, tvalue, flat_storage<equal>, hash>::h2(size_t hash_value) noexcept
+{
+    return static_cast<ctrl_t>(hash_value & 0x7F);
+}
+
+template<typename tkey, typename tvalue, typename equal, typename hash>
+size_t hash_table<tkey, tvalue, flat_storage<equal>, hash>::growth_limit(size_t capacity) const noexcept
+{
+    return static_cast<size_t>(static_cast<double>(capacity) * _max_load_factor);
+}
+
+template<typename tkey, typename tvalue, typename equal, typename hash>
+size_t hash_table<tkey, tvalue, flat_storage<equal>, hash>::capacity_for(size_t count) const noexcept
+{
+    size_t capacity = group::width;
+
+    while (growth_limit(capacity) < count)
+    {
+        capacity <<= 1;
+    }
+
+    return capacity;
+}
+
+template<typename tkey, typename tvalue, typename equal, typename hash>
+typename hash_table<tkey, tvalue, flat_storage<equal>, hash>::slot_array hash_table<tkey, tvalue, flat_storage<equal>, hash>::allocate_array(size_t capacity)
+{
+    pp_allocator<ctrl_t> ctrl_alloc(_alloc);
+    slot_array array;
+
+    // Groups are loaded with aligned loads
+    array.ctrl = static_cast<ctrl_t*>(ctrl_alloc.allocate_bytes(capacity, group::width));
+
+    try
+    {
+        array.slots = _alloc.allocate(capacity);
+    }
+    catch (...)
+    {
+        ctrl_alloc.deallocate_bytes(array.ctrl, capacity, group::width);
+        throw;
+    }
+
+    array.capacity = capacity;
+    std::memset(array.ctrl, static_cast<unsigned char>(__detail::ctrl_empty), capacity);
+
+    return array;
+}
+
+template<typename tkey, typename tvalue, typename equal, typename hash>
+typename hash_table<tkey, tvalue, flat_storage<equal>, hash>::slot_array hash_table<tkey, tvalue, flat_storage<equal>, hash>::copy_array(const slot_array& other)
+{
+    if (other.capacity == 0)
+    {
+        return slot_array();
+    }
+
+    slot_array array = allocate_array(other.capacity);
+
+    // Slots are filled in the same places, tombstones are kept so that probe sequences stay intact
+    try
+    {
+        for (size_t i = 0; i < other.capacity; ++i)
+        {
+            if (other.ctrl[i] >= 0)
+            {
+                std::construct_at(array.slots + i, other.slots[i]);
+            }
+
+            array.ctrl[i] = other.ctrl[i];
+        }
+    }
+    catch (...)
+    {
+        release_array(array);
+        throw;
+    }
+
+    return array;
+}
+
+template<typename tkey, typename tvalue, typename equal, typename hash>
+void hash_table<tkey, tvalue, flat_storage<equal>, hash>::release_array(slot_array& array) noexcept
+{
+    if (array.capacity == 0)
+    {
+        return;
+    }
+
+    for (size_t i = 0; i < array.capacity; ++i)
+    {
+        if (array.ctrl[i] >= 0)
+        {
+            std::destroy_at(array.slots + i);
+        }
+    }
+
+    _alloc.deallocate(array.slots, array.capacity);
+    pp_allocator<ctrl_t>(_alloc).deallocate_bytes(array.ctrl, array.capacity, group::width);
+
+    array = slot_array();
+}
+
+template<typename tkey, typename tvalue, typename equal, typename hash>
+template<typename lookup_key>
+size_t hash_table<tkey, tvalue, flat_storage<equal>, hash>::probe(const slot_array& array, const lookup_key& key, size_t hash_value) const
+{
+    if (array.capacity == 0)
+    {
+        return 0;
+    }
+
+    size_t mask = array.capacity / group::width - 1;
+    size_t index = (hash_value >> 7) & mask;
+
+    // Triangular steps visit every group once when group count is power of two
+    for (size_t step = 1; step <= mask + 1; ++step)
+    {
+        group g(array.ctrl + index * group::width);
+
+        for (uint32_t bits = g.match(h2(hash_value)); bits != 0; bits &= bits - 1)
+        {
+            size_t slot = index * group::width + std::countr_zero(bits);
+
+            if (equal::operator()(array.slots[slot].first, key))
+            {
+                return slot;
+            }
+        }
+
+        if (g.match_empty() != 0)
+        {
+            break;
+        }
+
+        index = (index + step) & mask;
+    }
+
+    return array.capacity;
+}
+
+template<typename tkey, typename tvalue, typename equal, typename hash>
+size_t hash_table<tkey, tvalue, flat_storage<equal>, hash>::find_free(const slot_array& array, size_t hash_value) noexcept
+{
+    size_t mask = array.capacity / group::width - 1;
+    size_t index = (hash_value >> 7) & mask;
+
+    for (size_t step = 1; ; ++step)
+    {
+        uint32_t bits = group(array.ctrl + index * group::width).match_free();
+
+        if (bits != 0)
+        {
+            return index * group::width + std::countr_zero(bits);
+        }
+
+        index = (index + step) & mask;
+    }
+}
+
+template<typename tkey, typename tvalue, typename equal, typename hash>
+template<typename lookup_key>
+std::pair<const typename hash_table<tkey, tvalue, flat_storage<equal>, hash>::slot_array*, size_t> hash_table<tkey, tvalue, flat_storage<equal>, hash>::locate(const lookup_key& key, size_t hash_value) const
+{
+    size_t index = probe(_table, key, hash_value);
+
+    if (index != _table.capacity)
+    {
+        return {&_table, index};
+    }
+
+    if (_old.capacity != 0)
+    {
+        index = probe(_old, key, hash_value);
+
+        if (index != _old.capacity)
+        {
+            return {&_old, index};
+        }
+    }
+
+    return {nullptr, 0};
+}
+
+template<typename tkey, typename tvalue, typename equal, typename hash>
+void hash_table<tkey, tvalue, flat_storage<equal>, hash>::prefetch_group(size_t hash_value) const noexcept
+{
+    if (_table.capacity != 0)
+    {
+        size_t mask = _table.capacity / group::width - 1;
+        __detail::prefetch_line(_table.ctrl + ((hash_value >> 7) & mask) * group::width);
+    }
+}
+
+template<typename tkey, typename tvalue, typename equal, typename hash>
+void hash_table<tkey, tvalue, flat_storage<equal>, hash>::prefetch_candidate(size_t hash_value) const noexcept
+{
+    if (_table.capacity != 0)
+    {
+        size_t mask = _table.capacity / group::width - 1;
+        size_t index = (hash_value >> 7) & mask;
+        uint32_t bits = group(_table.ctrl + index * group::width).match(h2(hash_value));
+
+        if (bits != 0)
+        {
+            __detail::prefetch_line(_table.slots + index * group::width + std::countr_zero(bits));
+        }
+    }
+}
+
+template<typename tkey, typename tvalue, typename equal, typename hash>
+template<typename visitor>
+void hash_table<tkey, tvalue, flat_storage<equal>, hash>::locate_batch(std::span<const tkey> keys, visitor&& visit) const
+{
+    size_t hashes[batch_width];
+
+    for (size_t first = 0; first < keys.size(); first += batch_width)
+    {
+        size_t count = std::min(batch_width, keys.size() - first);
+
+        for (size_t i = 0; i < count; ++i)
+        {
+            hashes[i] = hash_of(keys[first + i]);
+            prefetch_group(hashes[i]);
+        }
+
+        for (size_t i = 0; i < count; ++i)
+        {
+            prefetch_candidate(hashes[i]);
+        }
+
+        for (size_t i = 0; i < count; ++i)
+        {
+            auto [array, index] = locate(keys[first + i], hashes[i]);
+            visit(first + i, array, index);
+        }
+    }
+}
+
+template<typename tkey, typename tvalue, typename equal, typename hash>
+template<typename ...Args>
+size_t hash_table<tkey, tvalue, flat_storage<equal>, hash>::emplace_in_table(size_t hash_value, Args&&... args)
+{
+    size_t index = find_free(_table, hash_value);
+
+    std::construct_at(_table.slots + index, std::forward<Args>(args)...);
+
+    if (_table.ctrl[index] == __detail::ctrl_deleted)
+    {
+        --_tombstones;
+    }
+
+    _table.ctrl[index] = h2(hash_value);
+
+    return index;
+}
+
+template<typename tkey, typename tvalue, typename equal, typename hash>
+void hash_table<tkey, tvalue, flat_storage<equal>, hash>::rebuild(size_t capacity)
+{
+    slot_array array = allocate_array(capacity);
+
+    try
+    {
+        for (slot_array* source: {&_table, &_old})
+        {
+            for (size_t i = 0; i < source->capacity; ++i)
+            {
+                if (source->ctrl[i] < 0)
+                {
+                    continue;
+                }
+
+                size_t hash_value = hash_of(source->slots[i].first);
+                size_t slot = find_free(array, hash_value);
+
+                std::construct_at(array.slots + slot, std::move_if_noexcept(source->slots[i]));
+                array.ctrl[slot] = h2(hash_value);
+            }
+        }
+    }
+    catch (...)
+    {
+        release_array(array);
+        throw;
+    }
+
+    release_array(_table);
+    release_array(_old);
+
+    _table = array;
+    _migrated = 0;
+    _tombstones = 0;
+}
+
+template<typename tkey, typename tvalue, typename equal, typename hash>
+void hash_table<tkey, tvalue, flat_storage<equal>, hash>::start_migration(size_t capacity)
+{
+    slot_array array = allocate_array(capacity);
+
+    _old = _table;
+    _table = array;
+    _migrated = 0;
+    _tombstones = 0;
+}
+
+template<typename tkey, typename tvalue, typename equal, typename hash>
+void hash_table<tkey, tvalue, flat_storage<equal>, hash>::migrate(size_t groups)
+{
+    if (_old.capacity == 0)
+    {
+        return;
+    }
+
+    size_t old_groups = _old.capacity / group::width;
+
+    for (size_t last = std::min(_migrated + groups, old_groups); _migrated < last; ++_migrated)
+    {
+        size_t first = _migrated * group::width;
+
+        for (uint32_t bits = group(_old.ctrl + first).match_full(); bits != 0; bits &= bits - 1)
+        {
+            size_t index = first + std::countr_zero(bits);
+
+            emplace_in_table(hash_of(_old.slots[index].first), std::move_if_noexcept(_old.slots[index]));
+            std::destroy_at(_old.slots + index);
+            _old.ctrl[index] = __detail::ctrl_deleted;
+        }
+    }
+
+    if (_migrated == old_groups)
+    {
+        release_array(_old);
+        _migrated = 0;
+
+        if (_pending_capacity != 0)
+        {
+            resize(std::max(std::exchange(_pending_capacity, 0), capacity_for(_size)));
+        }
+    }
+}
+
+template<typename tkey, typename tvalue, typename equal, typename hash>
+void hash_table<tkey, tvalue, flat_storage<equal>, hash>::resize(size_t capacity)
+{
+    if (_rehash_step == 0 || _old.capacity != 0 || _size == 0)
+    {
+        rebuild(capacity);
+    } else
+    {
+        start_migration(capacity);
+    }
+}
+
+template<typename tkey, typename tvalue, typename equal, typename hash>
+void hash_table<tkey, tvalue, flat_storage<equal>, hash>::request_capacity(size_t capacity)
+{
+    if (_rehash_step != 0 && _old.capacity != 0)
+    {
+        _pending_capacity = capacity;
+    } else
+    {
+        resize(capacity);
+    }
+}
+
+template<typename tkey, typename tvalue, typename equal, typename hash>
+void hash_table<tkey, tvalue, flat_storage<equal>, hash>::prepare_insert()
+{
+    // Elements still in drained array are counted as if already moved, so migration always finds room
+    if (_size + _tombstones < growth_limit(_table.capacity))
+    {
+        return;
+    }
+
+    // Table mostly filled with tombstones is rebuilt at the same size, otherwise it doubles
+    if (_tombstones * 2 > _size)
+    {
+        resize(capacity_for(_size + 1));
+    } else
+    {
+        resize(std::max(capacity_for(_size + 1), _table.capacity * 2));
+    }
+}
+
+template<typename tkey, typename tvalue, typename equal, typename hash>
+template<typename value>
+auto hash_table<tkey, tvalue, flat_storage<equal>, hash>::insert_value(value&& data, bool assign)
+{
+    migrate(_rehash_step);
+
+    size_t hash_value = hash_of(data.first);
+    auto [array, index] = locate(data.first, hash_value);
+
+    if (array != nullptr)
+    {
+        if (assign)
+        {
+            array->slots[index].second = std::forward<value>(data).second;
+        }
+
+        return std::make_pair(make_iterator(array, index), false);
+    }
+
+    prepare_insert();
+    index = emplace_in_table(hash_value, std::forward<value>(data));
+    ++_size;
+
+    return std::make_pair(make_iterator(&_table, index), true);
+}
+
+template<typename tkey, typename tvalue, typename equal, typename hash>
+void hash_table<tkey, tvalue, flat_storage<equal>, hash>::erase_at(slot_array& array, size_t index) noexcept
+{
+    std::destroy_at(array.slots + index);
+    --_size;
+
+    // Probe reaching group with empty slot stops there anyway, so slot may become empty instead of tombstone
+    if (group(array.ctrl + index / group::width * group::width).match_empty() != 0)
+    {
+        array.ctrl[index] = __detail::ctrl_empty;
+    } else
+    {
+        array.ctrl[index] = __detail::ctrl_deleted;
+
+        // Tombstones of drained array go away with it
+        if (&array == &_table)
+        {
+            ++_tombstones;
+        }
+    }
+}
+
+template<typename tkey, typename tvalue, typename equal, typename hash>
+void hash_table<tkey, tvalue, flat_storage<equal>, hash>::destroy() noexcept
+{
+    release_array(_table);
+    release_array(_old);
+
+    _migrated = 0;
+    _pending_capacity = 0;
+    _size = 0;
+    _tombstones = 0;
+}
+
+template<typename tkey, typename tvalue, typename equal, typename hash>
+typename hash_table<tkey, tvalue, flat_storage<equal>, hash>::iterator hash_table<tkey, tvalue, flat_storage<equal>, hash>::make_iterator(const slot_array* array, size_t index)
+{
+    if (array == nullptr)
+    {
+        return end();
+    }
+
+    if (array == &_old)
+    {
+        return iterator(_old.ctrl + index, _old.ctrl + _old.capacity, _old.slots + index);
+    }
+
+    return iterator(_table.ctrl + index, _table.ctrl + _table.capacity, _table.slots + index,
+                    _old.ctrl, _old.ctrl + _old.capacity, _old.slots);
+}
+
+template<typename tkey, typename tvalue, typename equal, typename hash>
+typename hash_table<tkey, tvalue, flat_storage<equal>, hash>::const_iterator hash_table<tkey, tvalue, flat_storage<equal>, hash>::make_iterator(const slot_array* array, size_t index) const
+{
+    if (array == nullptr)
+    {
+        return end();
+    }
+
+    if (array == &_old)
+    {
+        return const_iterator(_old.ctrl + index, _old.ctrl + _old.capacity, _old.slots + index);
+    }
+
+    return const_iterator(_table.ctrl + index, _table.ctrl + _table.capacity, _table.slots + index,
+                          _old.ctrl, _old.ctrl + _old.capacity, _old.slots);
+}
+
+template<typename tkey, typename tvalue, typename equal, typename hash>
+typename hash_table<tkey, tvalue, flat_storage<equal>, hash>::iterator hash_table<tkey, tvalue, flat_storage<equal>, hash>::unconst(const_iterator it) noexcept
+{
+    return iterator(it._ctrl, it._ctrl_end, const_cast<value_type*>(it._slot),
+                    it._next_ctrl, it._next_ctrl_end, const_cast<value_type*>(it._next_slot));
+}
+
+// endregion private implementation
+
+// region constructors implementation
+
+template<typename tkey, typename tvalue, typename equal, typename hash>
+hash_table<tkey, tvalue, flat_storage<equal>, hash>::hash_table(pp_allocator<value_type> allocator, logger* logger)
+    : _migrated(0), _pending_capacity(0), _rehash_step(0), _size(0), _tombstones(0), _alloc(allocator),
+      _max_load_factor(default_max_load_factor), _logger(logger)
+{
+}
+
+template<typename tkey, typename tvalue, typename equal, typename hash>
+hash_table<tkey, tvalue, flat_storage<equal>, hash>::hash_table(std::initializer_list<std::pair<tkey, tvalue>> data, pp_allocator<value_type> allocator, logger* logger)
+    : hash_table(allocator, logger)
+{
+    reserve(data.size());
+
+    for (auto& item: data)
+    {
+        emplace(item.first, item.second);
+    }
+}
+
+// endregion constructors implementation
+
+// region five implementation
+
+template<typename tkey, typename tvalue, typename equal, typename hash>
+hash_table<tkey, tvalue, flat_storage<equal>, hash>::hash_table(const hash_table& other)
+    : hash(other), equal(other), _migrated(other._migrated), _pending_capacity(other._pending_capacity),
+      _rehash_step(other._rehash_step), _size(other._size), _tombstones(other._tombstones), _alloc(other._alloc.select_on_container_copy_construction()),
+      _max_load_factor(other._max_load_factor), _logger(other._logger)
+{
+    _table = copy_array(other._table);
+
+    try
+    {
+        _old = copy_array(other._old);
+    }
+    catch (...)
+    {
+        release_array(_table);
+        throw;
+    }
+}
+
+template<typename tkey, typename tvalue, typename equal, typename hash>
+hash_table<tkey, tvalue, flat_storage<equal>, hash>::hash_table(hash_table&& other) noexcept
+    : hash(std::move(other)), equal(std::move(other)), _table(std::exchange(other._table, slot_array())),
+      _old(std::exchange(other._old, slot_array())), _migrated(std::exchange(other._migrated, 0)),
+      _pending_capacity(std::exchange(other._pending_capacity, 0)), _rehash_step(other._rehash_step), _size(std::exchange(other._size, 0)),
+      _tombstones(std::exchange(other._tombstones, 0)), _alloc(other._alloc),
+      _max_load_factor(other._max_load_factor), _logger(other._logger)
+{
+}
+
+template<typename tkey, typename tvalue, typename equal, typename hash>
+hash_table<tkey, tvalue, flat_storage<equal>, hash>& hash_table<tkey, tvalue, flat_storage<equal>, hash>::operator=(const hash_table& other)
+{
+    if (this != &other)
+    {
+        *this = hash_table(other);
+    }
+
+    return *this;
+}
+
+template<typename tkey, typename tvalue, typename equal, typename hash>
+hash_table<tkey, tvalue, flat_storage<equal>, hash>& hash_table<tkey, tvalue, flat_storage<equal>, hash>::operator=(hash_table&& other) noexcept
+{
+    if (this != &other)
+    {
+        destroy();
+
+        static_cast<hash&>(*this) = std::move(static_cast<hash&>(other));
+        static_cast<equal&>(*this) = std::move(static_cast<equal&>(other));
+        _table = std::exchange(other._table, slot_array());
+        _old = std::exchange(other._old, slot_array());
+        _migrated = std::exchange(other._migrated, 0);
+        _pending_capacity = std::exchange(other._pending_capacity, 0);
+        _rehash_step = other._rehash_step;
+        _size = std::exchange(other._size, 0);
+        _tombstones = std::exchange(other._tombstones, 0);
+        _alloc = other._alloc;
+        _max_load_factor = other._max_load_factor;
+        _logger = other._logger;
+    }
+
+    return *this;
+}
+
+template<typename tkey, typename tvalue, typename equal, typename hash>
+hash_table<tkey, tvalue, flat_storage<equal>, hash>::~hash_table() noexcept
+{
+    destroy();
+}
+
+// endregion five implementation
+
+// region iterator implementation
+
+template<typename tkey, typename tvalue, typename equal, typename hash>
+hash_table<tkey, tvalue, flat_storage<equal>, hash>::iterator::iterator(const ctrl_t* ctrl, const ctrl_t* ctrl_end, value_type* slot,
+                                                                         const ctrl_t* next_ctrl, const ctrl_t* next_ctrl_end, value_type* next_slot)
+    : _ctrl(ctrl), _ctrl_end(ctrl_end), _slot(slot), _next_ctrl(next_ctrl), _next_ctrl_end(next_ctrl_end), _next_slot(next_slot)
+{
+}
+
+template<typename tkey, typename tvalue, typename equal, typename hash>
+void hash_table<tkey, tvalue, flat_storage<equal>, hash>::iterator::skip_free() noexcept
+{
+    while (true)
+    {
+        while (_ctrl != _ctrl_end && *_ctrl < 0)
+        {
+            ++_ctrl;
+            ++_slot;
+        }
+
+        if (_ctrl != _ctrl_end || _next_ctrl == nullptr)
+        {
+            return;
+        }
+
+        _ctrl = std::exchange(_next_ctrl, nullptr);
+        _ctrl_end = _next_ctrl_end;
+        _slot = _next_slot;
+    }
+}
+
+template<typename tkey, typename tvalue, typename equal, typename hash>
+typename hash_table<tkey, tvalue, flat_storage<equal>, hash>::iterator& hash_table<tkey, tvalue, flat_storage<equal>, hash>::iterator::operator++()
+{
+    ++_ctrl;
+    ++_slot;
+    skip_free();
+    return *this;
+}
+
+template<typename tkey, typename tvalue, typename equal, typename hash>
+typename hash_table<tkey, tvalue, flat_storage<equal>, hash>::iterator hash_table<tkey, tvalue, flat_storage<equal>, hash>::iterator::operator++(int)
+{
+    auto copy = *this;
+    ++*this;
+    return copy;
+}
+
+template<typename tkey, typename tvalue, typename equal, typename hash>
+typename hash_table<tkey, tvalue, flat_storage<equal>, hash>::iterator::reference hash_table<tkey, tvalue, flat_storage<equal>, hash>::iterator::operator*() const noexcept
+{
+    return *_slot;
+}
+
+template<typename tkey, typename tvalue, typename equal, typename hash>
+typename hash_table<tkey, tvalue, flat_storage<equal>, hash>::iterator::pointer hash_table<tkey, tvalue, flat_storage<equal>, hash>::iterator::operator->() const noexcept
+{
+    return _slot;
+}
+
+template<typename tkey, typename tvalue, typename equal, typename hash>
+bool hash_table<tkey, tvalue, flat_storage<equal>, hash>::iterator::operator==(const self& other) const noexcept
+{
+    return _ctrl == other._ctrl;
+}
+
+template<typename tkey, typename tvalue, typename equal, typename hash>
+bool hash_table<tkey, tvalue, flat_storage<equal>, hash>::iterator::operator!=(const self& other) const noexcept
+{
+    return !(*this == other);
+}
+
+template<typename tkey, typename tvalue, typename equal, typename hash>
+hash_table<tkey, tvalue, flat_storage<equal>, hash>::const_iterator::const_iterator(const ctrl_t* ctrl, const ctrl_t* ctrl_end, const value_type* slot,
+                                                                                     const ctrl_t* next_ctrl, const ctrl_t* next_ctrl_end, const value_type* next_slot)
+    : _ctrl(ctrl), _ctrl_end(ctrl_end), _slot(slot), _next_ctrl(next_ctrl), _next_ctrl_end(next_ctrl_end), _next_slot(next_slot)
+{
+}
+
+template<typename tkey, typename tvalue, typename equal, typename hash>
+hash_table<tkey, tvalue, flat_storage<equal>, hash>::const_iterator::const_iterator(const iterator& other)
+    : _ctrl(other._ctrl), _ctrl_end(other._ctrl_end), _slot(other._slot),
+      _next_ctrl(other._next_ctrl), _next_ctrl_end(other._next_ctrl_end), _next_slot(other._next_slot)
+{
+}
+
+template<typename tkey, typename tvalue, typename equal, typename hash>
+void hash_table<tkey, tvalue, flat_storage<equal>, hash>::const_iterator::skip_free() noexcept
+{
+    while (true)
+    {
+        while (_ctrl != _ctrl_end && *_ctrl < 0)
+        {
+            ++_ctrl;
+            ++_slot;
+        }
+
+        if (_ctrl != _ctrl_end || _next_ctrl == nullptr)
+        {
+            return;
+        }
+
+        _ctrl = std::exchange(_next_ctrl, nullptr);
+        _ctrl_end = _next_ctrl_end;
+        _slot = _next_slot;
+    }
+}
+
+template<typename tkey, typename tvalue, typename equal, typename hash>
+typename hash_table<tkey, tvalue, flat_storage<equal>, hash>::const_iterator& hash_table<tkey, tvalue, flat_storage<equal>, hash>::const_iterator::operator++()
+{
+    ++_ctrl;
+    ++_slot;
+    skip_free();
+    return *this;
+}
+
+template<typename tkey, typename tvalue, typename equal, typename hash>
+typename hash_table<tkey, tvalue, flat_storage<equal>, hash>::const_iterator hash_table<tkey, tvalue, flat_storage<equal>, hash>::const_iterator::operator++(int)
+{
+    auto copy = *this;
+    ++*this;
+    return copy;
+}
+
+template<typename tkey, typename tvalue, typename equal, typename hash>
+typename hash_table<tkey, tvalue, flat_storage<equal>, hash>::const_iterator::reference hash_table<tkey, tvalue, flat_storage<equal>, hash>::const_iterator::operator*() const noexcept
+{
+    return *_slot;
+}
+
+template<typename tkey, typename tvalue, typename equal, typename hash>
+typename hash_table<tkey, tvalue, flat_storage<equal>, hash>::const_iterator::pointer hash_table<tkey, tvalue, flat_storage<equal>, hash>::const_iterator::operator->() const noexcept
+{
+    return _slot;
+}
+
+template<typename tkey, typename tvalue, typename equal, typename hash>
+bool hash_table<tkey, tvalue, flat_storage<equal>, hash>::const_iterator::operator==(const self& other) const noexcept
+{
+    return _ctrl == other._ctrl;
+}
+
+template<typename tkey, typename tvalue, typename equal, typename hash>
+bool hash_table<tkey, tvalue, flat_storage<equal>, hash>::const_iterator::operator!=(const self& other) const noexcept
+{
+    return !(*this == other);
+}
+
+// endregion iterator implementation
+
+// region element access implementation
+
+template<typename tkey, typename tvalue, typename equal, typename hash>
+tvalue& hash_table<tkey, tvalue, flat_storage<equal>, hash>::at(const tkey& key)
+{
+    auto [array, index] = locate(key, hash_of(key));
+
+    if (array == nullptr)
+    {
+        throw std::out_of_range("key not found");
+    }
+
+    return array->slots[index].second;
+}
+
+template<typename tkey, typename tvalue, typename equal, typename hash>
+const tvalue& hash_table<tkey, tvalue, flat_storage<equal>, hash>::at(const tkey& key) const
+{
+    auto [array, index] = locate(key, hash_of(key));
+
+    if (array == nullptr)
+    {
+        throw std::out_of_range("key not found");
+    }
+
+    return array->slots[index].second;
+}
+
+template<typename tkey, typename tvalue, typename equal, typename hash>
+template<typename lookup_key> requires transparent_hash_for<hash, equal, lookup_key, tkey>
+tvalue& hash_table<tkey, tvalue, flat_storage<equal>, hash>::at(const lookup_key& key)
+{
+    auto [array, index] = locate(key, hash_of(key));
+
+    if (array == nullptr)
+    {
+        throw std::out_of_range("key not found");
+    }
+
+    return array->slots[index].second;
+}
+
+template<typename tkey, typename tvalue, typename equal, typename hash>
+template<typename lookup_key> requires transparent_hash_for<hash, equal, lookup_key, tkey>
+const tvalue& hash_table<tkey, tvalue, flat_storage<equal>, hash>::at(const lookup_key& key) const
+{
+    auto [array, index] = locate(key, hash_of(key));
+
+    if (array == nullptr)
+    {
+        throw std::out_of_range("key not found");
+    }
+
+    return array->slots[index].second;
+}
+
+template<typename tkey, typename tvalue, typename equal, typename hash>
+tvalue& hash_table<tkey, tvalue, flat_storage<equal>, hash>::operator[](const tkey& key)
+{
+    auto [array, index] = locate(key, hash_of(key));
+
+    if (array != nullptr)
+    {
+        return array->slots[index].second;
+    }
+
+    return insert_value(value_type(key, tvalue()), false).first->second;
+}
+
+template<typename tkey, typename tvalue, typename equal, typename hash>
+tvalue& hash_table<tkey, tvalue, flat_storage<equal>, hash>::operator[](tkey&& key)
+{
+    auto [array, index] = locate(key, hash_of(key));
+
+    if (array != nullptr)
+    {
+        return array->slots[index].second;
+    }
+
+    return insert_value(value_type(std::move(key), tvalue()), false).first->second;
+}
+
+// endregion element access implementation
+
+// region iterator begins implementation
+
+template<typename tkey, typename tvalue, typename equal, typename hash>
+typename hash_table<tkey, tvalue, flat_storage<equal>, hash>::iterator hash_table<tkey, tvalue, flat_storage<equal>, hash>::begin()
+{
+    iterator it = make_iterator(&_table, 0);
+    it.skip_free();
+    return it;
+}
+
+template<typename tkey, typename tvalue, typename equal, typename hash>
+typename hash_table<tkey, tvalue, flat_storage<equal>, hash>::iterator hash_table<tkey, tvalue, flat_storage<equal>, hash>::end()
+{
+    const slot_array& last = _old.capacity != 0 ? _old : _table;
+    return iterator(last.ctrl + last.capacity, last.ctrl + last.capacity, last.slots + last.capacity);
+}
+
+template<typename tkey, typename tvalue, typename equal, typename hash>
+typename hash_table<tkey, tvalue, flat_storage<equal>, hash>::const_iterator hash_table<tkey, tvalue, flat_storage<equal>, hash>::begin() const
+{
+    const_iterator it = make_iterator(&_table, 0);
+    it.skip_free();
+    return it;
+}
+
+template<typename tkey, typename tvalue, typename equal, typename hash>
+typename hash_table<tkey, tvalue, flat_storage<equal>, hash>::const_iterator hash_table<tkey, tvalue, flat_storage<equal>, hash>::end() const
+{
+    const slot_array& last = _old.capacity != 0 ? _old : _table;
+    return const_iterator(last.ctrl + last.capacity, last.ctrl + last.capacity, last.slots + last.capacity);
+}
+
+template<typename tkey, typename tvalue, typename equal, typename hash>
+typename hash_table<tkey, tvalue, flat_storage<equal>, hash>::const_iterator hash_table<tkey, tvalue, flat_storage<equal>, hash>::cbegin() const
+{
+    return begin();
+}
+
+template<typename tkey, typename tvalue, typename equal, typename hash>
+typename hash_table<tkey, tvalue, flat_storage<equal>, hash>::const_iterator hash_table<tkey, tvalue, flat_storage<equal>, hash>::cend() const
+{
+    return end();
+}
+
+// endregion iterator begins implementation
+
+// region lookup implementation
+
+template<typename tkey, typename tvalue, typename equal, typename hash>
+size_t hash_table<tkey, tvalue, flat_storage<equal>, hash>::size() const noexcept
+{
+    return _size;
+}
+
+template<typename tkey, typename tvalue, typename equal, typename hash>
+bool hash_table<tkey, tvalue, flat_storage<equal>, hash>::empty() const noexcept
+{
+    return _size == 0;
+}
+
+template<typename tkey, typename tvalue, typename equal, typename hash>
+typename hash_table<tkey, tvalue, flat_storage<equal>, hash>::iterator hash_table<tkey, tvalue, flat_storage<equal>, hash>::find(const tkey& key)
+{
+    auto [array, index] = locate(key, hash_of(key));
+    return make_iterator(array, index);
+}
+
+template<typename tkey, typename tvalue, typename equal, typename hash>
+typename hash_table<tkey, tvalue, flat_storage<equal>, hash>::const_iterator hash_table<tkey, tvalue, flat_storage<equal>, hash>::find(const tkey& key) const
+{
+    auto [array, index] = locate(key, hash_of(key));
+    return make_iterator(array, index);
+}
+
+template<typename tkey, typename tvalue, typename equal, typename hash>
+bool hash_table<tkey, tvalue, flat_storage<equal>, hash>::contains(const tkey& key) const
+{
+    return locate(key, hash_of(key)).first != nullptr;
+}
+
+template<typename tkey, typename tvalue, typename equal, typename hash>
+template<typename lookup_key> requires transparent_hash_for<hash, equal, lookup_key, tkey>
+typename hash_table<tkey, tvalue, flat_storage<equal>, hash>::iterator hash_table<tkey, tvalue, flat_storage<equal>, hash>::find(const lookup_key& key)
+{
+    auto [array, index] = locate(key, hash_of(key));
+    return make_iterator(array, index);
+}
+
+template<typename tkey, typename tvalue, typename equal, typename hash>
+template<typename lookup_key> requires transparent_hash_for<hash, equal, lookup_key, tkey>
+typename hash_table<tkey, tvalue, flat_storage<equal>, hash>::const_iterator hash_table<tkey, tvalue, flat_storage<equal>, hash>::find(const lookup_key& key) const
+{
+    auto [array, index] = locate(key, hash_of(key));
+    return make_iterator(array, index);
+}
+
+template<typename tkey, typename tvalue, typename equal, typename hash>
+template<typename lookup_key> requires transparent_hash_for<hash, equal, lookup_key, tkey>
+bool hash_table<tkey, tvalue, flat_storage<equal>, hash>::contains(const lookup_key& key) const
+{
+    return locate(key, hash_of(key)).first != nullptr;
+}
+
+template<typename tkey, typename tvalue, typename equal, typename hash>
+void hash_table<tkey, tvalue, flat_storage<equal>, hash>::find_batch(std::span<const tkey> keys, std::span<iterator> result)
+{
+    if (keys.size() != result.size())
+    {
+        throw std::invalid_argument("keys and result of batch lookup differ in size");
+    }
+
+    locate_batch(keys, [this, result](size_t i, const slot_array* array, size_t index)
+    {
+        result[i] = make_iterator(array, index);
+    });
+}
+
+template<typename tkey, typename tvalue, typename equal, typename hash>
+void hash_table<tkey, tvalue, flat_storage<equal>, hash>::find_batch(std::span<const tkey> keys, std::span<const_iterator> result) const
+{
+    if (keys.size() != result.size())
+    {
+        throw std::invalid_argument("keys and result of batch lookup differ in size");
+    }
+
+    locate_batch(keys, [this, result](size_t i, const slot_array* array, size_t index)
+    {
+        result[i] = make_iterator(array, index);
+    });
+}
+
+// endregion lookup implementation
+
+// region modifiers implementation
+
+template<typename tkey, typename tvalue, typename equal, typename hash>
+void hash_table<tkey, tvalue, flat_storage<equal>, hash>::clear() noexcept
+{
+    release_array(_old);
+    _migrated = 0;
+    _pending_capacity = 0;
+
+    for (size_t i = 0; i < _table.capacity; ++i)
+    {
+        if (_table.ctrl[i] >= 0)
+        {
+            std::destroy_at(_table.slots + i);
+        }
+    }
+
+    if (_table.capacity != 0)
+    {
+        std::memset(_table.ctrl, static_cast<unsigned char>(__detail::ctrl_empty), _table.capacity);
+    }
+
+    _size = 0;
+    _tombstones = 0;
+}
+
+template<typename tkey, typename tvalue, typename equal, typename hash>
+std::pair<typename hash_table<tkey, tvalue, flat_storage<equal>, hash>::iterator, bool> hash_table<tkey, tvalue, flat_storage<equal>, hash>::insert(const value_type& data)
+{
+    return insert_value(data, false);
+}
+
+template<typename tkey, typename tvalue, typename equal, typename hash>
+std::pair<typename hash_table<tkey, tvalue, flat_storage<equal>, hash>::iterator, bool> hash_table<tkey, tvalue, flat_storage<equal>, hash>::insert(value_type&& data)
+{
+    return insert_value(std::move(data), false);
+}
+
+template<typename tkey, typename tvalue, typename equal, typename hash>
+template<typename ...Args>
+std::pair<typename hash_table<tkey, tvalue, flat_storage<equal>, hash>::iterator, bool> hash_table<tkey, tvalue, flat_storage<equal>, hash>::emplace(Args&&... args)
+{
+    return insert(value_type(std::forward<Args>(args)...));
+}
+
+template<typename tkey, typename tvalue, typename equal, typename hash>
+typename hash_table<tkey, tvalue, flat_storage<equal>, hash>::iterator hash_table<tkey, tvalue, flat_storage<equal>, hash>::insert_or_assign(const value_type& data)
+{
+    return insert_value(data, true).first;
+}
+
+template<typename tkey, typename tvalue, typename equal, typename hash>
+typename hash_table<tkey, tvalue, flat_storage<equal>, hash>::iterator hash_table<tkey, tvalue, flat_storage<equal>, hash>::insert_or_assign(value_type&& data)
+{
+    return insert_value(std::move(data), true).first;
+}
+
+template<typename tkey, typename tvalue, typename equal, typename hash>
+template<typename ...Args>
+typename hash_table<tkey, tvalue, flat_storage<equal>, hash>::iterator hash_table<tkey, tvalue, flat_storage<equal>, hash>::emplace_or_assign(Args&&... args)
+{
+    return insert_or_assign(value_type(std::forward<Args>(args)...));
+}
+
+template<typename tkey, typename tvalue, typename equal, typename hash>
+typename hash_table<tkey, tvalue, flat_storage<equal>, hash>::iterator hash_table<tkey, tvalue, flat_storage<equal>, hash>::erase(iterator pos)
+{
+    bool in_table = std::less_equal<const ctrl_t*>()(_table.ctrl, pos._ctrl) && std::less<const ctrl_t*>()(pos._ctrl, _table.ctrl + _table.capacity);
+    slot_array& array = in_table ? _table : _old;
+
+    erase_at(array, pos._ctrl - array.ctrl);
+    ++pos;
+    return pos;
+}
+
+template<typename tkey, typename tvalue, typename equal, typename hash>
+typename hash_table<tkey, tvalue, flat_storage<equal>, hash>::iterator hash_table<tkey, tvalue, flat_storage<equal>, hash>::erase(const_iterator pos)
+{
+    return erase(unconst(pos));
+}
+
+template<typename tkey, typename tvalue, typename equal, typename hash>
+typename hash_table<tkey, tvalue, flat_storage<equal>, hash>::iterator hash_table<tkey, tvalue, flat_storage<equal>, hash>::erase(iterator beg, iterator en)
+{
+    while (beg != en)
+    {
+        beg = erase(beg);
+    }
+
+    return en;
+}
+
+template<typename tkey, typename tvalue, typename equal, typename hash>
+typename hash_table<tkey, tvalue, flat_storage<equal>, hash>::iterator hash_table<tkey, tvalue, flat_storage<equal>, hash>::erase(const_iterator beg, const_iterator en)
+{
+    return erase(unconst(beg), unconst(en));
+}
+
+template<typename tkey, typename tvalue, typename equal, typename hash>
+typename hash_table<tkey, tvalue, flat_storage<equal>, hash>::iterator hash_table<tkey, tvalue, flat_storage<equal>, hash>::erase(const tkey& key)
+{
+    auto it = find(key);
+    return it == end() ? it : erase(it);
+}
+
+// endregion modifiers implementation
+
+// region hash policy implementation
+
+template<typename tkey, typename tvalue, typename equal, typename hash>
+double hash_table<tkey, tvalue, flat_storage<equal>, hash>::max_load_factor() const
+{
+    return _max_load_factor;
+}
+
+template<typename tkey, typename tvalue, typename equal, typename hash>
+void hash_table<tkey, tvalue, flat_storage<equal>, hash>::max_load_factor(double ml)
+{
+    if (!(ml > 0 && ml <= 1))
+    {
+        throw std::invalid_argument("max load factor of open addressing table must lie in (0, 1]");
+    }
+
+    _max_load_factor = ml;
+
+    if (_size + _tombstones > growth_limit(_table.capacity))
+    {
+        resize(capacity_for(_size));
+    }
+}
+
+template<typename tkey, typename tvalue, typename equal, typename hash>
+double hash_table<tkey, tvalue, flat_storage<equal>, hash>::load_factor() const
+{
+    return _table.capacity == 0 ? 0 : static_cast<double>(_size) / static_cast<double>(_table.capacity);
+}
+
+template<typename tkey, typename tvalue, typename equal, typename hash>
+size_t hash_table<tkey, tvalue, flat_storage<equal>, hash>::bucket_count() const noexcept
+{
+    return _table.capacity;
+}
+
+template<typename tkey, typename tvalue, typename equal, typename hash>
+void hash_table<tkey, tvalue, flat_storage<equal>, hash>::rehash(size_t count)
+{
+    if (_size == 0 && count == 0)
+    {
+        destroy();
+        return;
+    }
+
+    request_capacity(std::max(capacity_for(_size), std::bit_ceil(std::max(count, group::width))));
+}
+
+template<typename tkey, typename tvalue, typename equal, typename hash>
+void hash_table<tkey, tvalue, flat_storage<equal>, hash>::reserve(size_t count)
+{
+    size_t capacity = capacity_for(count);
+
+    if (capacity > _table.capacity)
+    {
+        request_capacity(capacity);
+    }
+}
+
+template<typename tkey, typename tvalue, typename equal, typename hash>
+size_t hash_table<tkey, tvalue, flat_storage<equal>, hash>::rehash_step() const noexcept
+{
+    return _rehash_step;
+}
+
+template<typename tkey, typename tvalue, typename equal, typename hash>
+void hash_table<tkey, tvalue, flat_storage<equal>, hash>::rehash_step(size_t groups)
+{
+    _rehash_step = groups;
+
+    if (groups == 0 && _old.capacity != 0)
+    {
+        rebuild(std::max(_table.capacity, std::exchange(_pending_capacity, 0)));
+    }
+}
+
+template<typename tkey, typename tvalue, typename equal, typename hash>
+bool hash_table<tkey, tvalue, flat_storage<equal>, hash>::rehashing() const noexcept
+{
+    return _old.capacity != 0;
+}
+
+// endregion hash policy implementation
+
+#endif //MP_OS_WORKBENCH_FLAT_HASH_TABLE_H
@@ -20,7 +20,16 @@ concept search_ds_for = std::same_as<typename T::value_type, std::pair<const tke
                 {t.erase(key)} -> std::forward_iterator;
             };
 
-template<typename tkey, typename tvalue, search_ds_for<tkey, tvalue> sds = std::map<tkey, tvalue, std::less<tkey>, pp_allocator<std::pair<const tkey, tvalue>>>, typename hash = std::hash<tkey>>
+/*
+ * Storage policy replaces per-bucket containers as a whole, hash_table is specialized for every policy
+ */
+template<typename T>
+concept hash_storage_policy = requires { typename T::storage_policy_tag; };
+
+template<typename T, typename tkey, typename tvalue>
+concept hash_table_storage = search_ds_for<T, tkey, tvalue> || hash_storage_policy<T>;
+
+template<typename tkey, typename tvalue, hash_table_storage<tkey, tvalue> sds = std::map<tkey, tvalue, std::less<tkey>, pp_allocator<std::pair<const tkey, tvalue>>>, typename hash = std::hash<tkey>>
 class hash_table final
 {
     template< std::ranges::range R >
@@ -250,20 +259,20 @@ public:
 };
 
 // region constructors implementation
-template<typename tkey, typename tvalue, search_ds_for<tkey, tvalue> sds, typename hash>
+template<typename tkey, typename tvalue, hash_table_storage<tkey, tvalue> sds, typename hash>
 hash_table<tkey, tvalue, sds, hash>::hash_table(pp_allocator<value_type> allocator, logger* logger)
 {
     throw not_implemented("template<typename tkey, typename tvalue, search_ds_for<tkey, tvalue> sds, typename hash> hash_table<tkey, tvalue, sds, hash>::hash_table(pp_allocator<value_type>, logger*)", "your code should be here...");
 }
 
-// template<typename tkey, typename tvalue, search_ds_for<tkey, tvalue> sds, typename hash>
+// template<typename tkey, typename tvalue, hash_table_storage<tkey, tvalue> sds, typename hash>
 // template<input_iterator_for_pair<tkey, tvalue> iterator>
 // hash_table<tkey, tvalue, sds, hash>::hash_table(iterator begin, iterator end, pp_allocator<value_type> allocator, logger* logger)
 // {
 //     throw not_implemented("template<typename tkey, typename tvalue, search_ds_for<tkey, tvalue> sds, typename hash> template<input_iterator_for_pair<tkey, tvalue> iterator> hash_table<tkey, tvalue, sds, hash>::hash_table(iterator , iterator , pp_allocator<value_type>, logger*)", "your code should be here...");
 // }
 
-template<typename tkey, typename tvalue, search_ds_for<tkey, tvalue> sds, typename hash>
+template<typename tkey, typename tvalue, hash_table_storage<tkey, tvalue> sds, typename hash>
 hash_table<tkey, tvalue, sds, hash>::hash_table(std::initializer_list<std::pair<tkey, tvalue>> data, pp_allocator<value_type> allocator, logger* logger)
 {
     throw not_implemented("template<typename tkey, typename tvalue, search_ds_for<tkey, tvalue> sds, typename hash> hash_table<tkey, tvalue, sds, hash>::hash_table(std::initializer_list<std::pair<tkey, tvalue>>, pp_allocator<value_type>, logger* )", "your code should be here...");
@@ -272,31 +281,31 @@ hash_table<tkey, tvalue, sds, hash>::hash_table(std::initializer_list<std::pair<
 // endregion constructors implementation
 
 // region five implementation
-template<typename tkey, typename tvalue, search_ds_for<tkey, tvalue> sds, typename hash>
+template<typename tkey, typename tvalue, hash_table_storage<tkey, tvalue> sds, typename hash>
 hash_table<tkey, tvalue, sds, hash>::hash_table(const hash_table& other)
 {
     throw not_implemented("template<typename tkey, typename tvalue, search_ds_for<tkey, tvalue> sds, typename hash> hash_table<tkey, tvalue, sds, hash>::hash_table(const hash_table&)", "your code should be here...");
 }
 
-template<typename tkey, typename tvalue, search_ds_for<tkey, tvalue> sds, typename hash>
+template<typename tkey, typename tvalue, hash_table_storage<tkey, tvalue> sds, typename hash>
 hash_table<tkey, tvalue, sds, hash>::hash_table(hash_table&& other) noexcept
 {
     throw not_implemented("template<typename tkey, typename tvalue, search_ds_for<tkey, tvalue> sds, typename hash> hash_table<tkey, tvalue, sds, hash>::hash_table(hash_table&&) noexcept", "your code should be here...");
 }
 
-template<typename tkey, typename tvalue, search_ds_for<tkey, tvalue> sds, typename hash>
+template<typename tkey, typename tvalue, hash_table_storage<tkey, tvalue> sds, typename hash>
 hash_table<tkey, tvalue, sds, hash>& hash_table<tkey, tvalue, sds, hash>::operator=(const hash_table& other)
 {
     throw not_implemented("template<typename tkey, typename tvalue, search_ds_for<tkey, tvalue> sds, typename hash> hash_table<tkey, tvalue, sds, hash>& hash_table<tkey, tvalue, sds, hash>::operator=(const hash_table&)", "your code should be here...");
 }
 
-template<typename tkey, typename tvalue, search_ds_for<tkey, tvalue> sds, typename hash>
+template<typename tkey, typename tvalue, hash_table_storage<tkey, tvalue> sds, typename hash>
 hash_table<tkey, tvalue, sds, hash>& hash_table<tkey, tvalue, sds, hash>::operator=(hash_table&& other) noexcept
 {
     throw not_implemented("template<typename tkey, typename tvalue, search_ds_for<tkey, tvalue> sds, typename hash> hash_table<tkey, tvalue, sds, hash>& hash_table<tkey, tvalue, sds, hash>::operator=(hash_table&&) noexcept", "your code should be here...");
 }
 
-template<typename tkey, typename tvalue, search_ds_for<tkey, tvalue> sds, typename hash>
+template<typename tkey, typename tvalue, hash_table_storage<tkey, tvalue> sds, typename hash>
 hash_table<tkey, tvalue, sds, hash>::~hash_table() noexcept
 {
     throw not_implemented("template<typename tkey, typename tvalue, search_ds_for<tkey, tvalue> sds, typename hash> hash_table<tkey, tvalue, sds, hash>::~hash_table() noexcept", "your code should be here...");
@@ -305,105 +314,105 @@ hash_table<tkey, tvalue, sds, hash>::~hash_table() noexcept
 // endregion five implementation
 
 // region iterator implementation
-template<typename tkey, typename tvalue, search_ds_for<tkey, tvalue> sds, typename hash>
+template<typename tkey, typename tvalue, hash_table_storage<tkey, tvalue> sds, typename hash>
 typename hash_table<tkey, tvalue, sds, hash>::iterator& hash_table<tkey, tvalue, sds, hash>::iterator::operator++()
 {
     throw not_implemented("template<typename tkey, typename tvalue, search_ds_for<tkey, tvalue> sds, typename hash> typename hash_table<tkey, tvalue, sds, hash>::iterator& hash_table<tkey, tvalue, sds, hash>::iterator::operator++()", "your code should be here...");
 }
 
-template<typename tkey, typename tvalue, search_ds_for<tkey, tvalue> sds, typename hash>
+template<typename tkey, typename tvalue, hash_table_storage<tkey, tvalue> sds, typename hash>
 typename hash_table<tkey, tvalue, sds, hash>::iterator hash_table<tkey, tvalue, sds, hash>::iterator::operator++(int)
 {
     throw not_implemented("template<typename tkey, typename tvalue, search_ds_for<tkey, tvalue> sds, typename hash> typename hash_table<tkey, tvalue, sds, hash>::iterator hash_table<tkey, tvalue, sds, hash>::iterator::operator++(int)", "your code should be here...");
 }
 
-template<typename tkey, typename tvalue, search_ds_for<tkey, tvalue> sds, typename hash>
+template<typename tkey, typename tvalue, hash_table_storage<tkey, tvalue> sds, typename hash>
 typename hash_table<tkey, tvalue, sds, hash>::iterator::reference hash_table<tkey, tvalue, sds, hash>::iterator::operator*() const noexcept
 {
     throw not_implemented("template<typename tkey, typename tvalue, search_ds_for<tkey, tvalue> sds, typename hash> typename hash_table<tkey, tvalue, sds, hash>::iterator::reference hash_table<tkey, tvalue, sds, hash>::iterator::operator*() const noexcept", "your code should be here...");
 }
 
-template<typename tkey, typename tvalue, search_ds_for<tkey, tvalue> sds, typename hash>
+template<typename tkey, typename tvalue, hash_table_storage<tkey, tvalue> sds, typename hash>
 typename hash_table<tkey, tvalue, sds, hash>::iterator::pointer hash_table<tkey, tvalue, sds, hash>::iterator::operator->() const noexcept
 {
     throw not_implemented("template<typename tkey, typename tvalue, search_ds_for<tkey, tvalue> sds, typename hash> typename hash_table<tkey, tvalue, sds, hash>::iterator::pointer hash_table<tkey, tvalue, sds, hash>::iterator::operator->() const noexcept", "your code should be here...");
 }
 
-template<typename tkey, typename tvalue, search_ds_for<tkey, tvalue> sds, typename hash>
+template<typename tkey, typename tvalue, hash_table_storage<tkey, tvalue> sds, typename hash>
 bool hash_table<tkey, tvalue, sds, hash>::iterator::operator==(const iterator& other) const noexcept
 {
     throw not_implemented("template<typename tkey, typename tvalue, search_ds_for<tkey, tvalue> sds, typename hash> bool hash_table<tkey, tvalue, sds, hash>::iterator::operator==(const iterator& other) const noexcept", "your code should be here...");
 }
 
-template<typename tkey, typename tvalue, search_ds_for<tkey, tvalue> sds, typename hash>
+template<typename tkey, typename tvalue, hash_table_storage<tkey, tvalue> sds, typename hash>
 bool hash_table<tkey, tvalue, sds, hash>::iterator::operator!=(const iterator& other) const noexcept
 {
     throw not_implemented("template<typename tkey, typename tvalue, search_ds_for<tkey, tvalue> sds, typename hash> bool hash_table<tkey, tvalue, sds, hash>::iterator::operator!=(const iterator& other) const noexcept", "your code should be here...");
 }
 
 // const iterator methods
-template<typename tkey, typename tvalue, search_ds_for<tkey, tvalue> sds, typename hash>
+template<typename tkey, typename tvalue, hash_table_storage<tkey, tvalue> sds, typename hash>
 typename hash_table<tkey, tvalue, sds, hash>::const_iterator& hash_table<tkey, tvalue, sds, hash>::const_iterator::operator++()
 {
     throw not_implemented("template<typename tkey, typename tvalue, search_ds_for<tkey, tvalue> sds, typename hash> typename hash_table<tkey, tvalue, sds, hash>::const_iterator& hash_table<tkey, tvalue, sds, hash>::const_iterator::operator++()", "your code should be here...");
 }
 
-template<typename tkey, typename tvalue, search_ds_for<tkey, tvalue> sds, typename hash>
+template<typename tkey, typename tvalue, hash_table_storage<tkey, tvalue> sds, typename hash>
 typename hash_table<tkey, tvalue, sds, hash>::const_iterator hash_table<tkey, tvalue, sds, hash>::const_iterator::operator++(int)
 {
     throw not_implemented("template<typename tkey, typename tvalue, search_ds_for<tkey, tvalue> sds, typename hash> typename hash_table<tkey, tvalue, sds, hash>::const_iterator hash_table<tkey, tvalue, sds, hash>::const_iterator::operator++(int)", "your code should be here...");
 }
 
-template<typename tkey, typename tvalue, search_ds_for<tkey, tvalue> sds, typename hash>
+template<typename tkey, typename tvalue, hash_table_storage<tkey, tvalue> sds, typename hash>
 typename hash_table<tkey, tvalue, sds, hash>::const_iterator::reference hash_table<tkey, tvalue, sds, hash>::const_iterator::operator*() const noexcept
 {
     throw not_implemented("template<typename tkey, typename tvalue, search_ds_for<tkey, tvalue> sds, typename hash> typename hash_table<tkey, tvalue, sds, hash>::const_iterator::reference hash_table<tkey, tvalue, sds, hash>::const_iterator::operator*() const noexcept", "your code should be here...");
 }
 
-template<typename tkey, typename tvalue, search_ds_for<tkey, tvalue> sds, typename hash>
+template<typename tkey, typename tvalue, hash_table_storage<tkey, tvalue> sds, typename hash>
 typename hash_table<tkey, tvalue, sds, hash>::const_iterator::pointer hash_table<tkey, tvalue, sds, hash>::const_iterator::operator->() const noexcept
 {
     throw not_implemented("template<typename tkey, typename tvalue, search_ds_for<tkey, tvalue> sds, typename hash> typename hash_table<tkey, tvalue, sds, hash>::const_iterator::pointer hash_table<tkey, tvalue, sds, hash>::const_iterator::operator->() const noexcept", "your code should be here...");
 }
 
-template<typename tkey, typename tvalue, search_ds_for<tkey, tvalue> sds, typename hash>
+template<typename tkey, typename tvalue, hash_table_storage<tkey, tvalue> sds, typename hash>
 bool hash_table<tkey, tvalue, sds, hash>::const_iterator::operator==(const const_iterator& other) const noexcept
 {
     throw not_implemented("template<typename tkey, typename tvalue, search_ds_for<tkey, tvalue> sds, typename hash> bool hash_table<tkey, tvalue, sds, hash>::const_iterator::operator==(const const_iterator& other) const noexcept", "your code should be here...");
 }
 
-template<typename tkey, typename tvalue, search_ds_for<tkey, tvalue> sds, typename hash>
+template<typename tkey, typename tvalue, hash_table_storage<tkey, tvalue> sds, typename hash>
 bool hash_table<tkey, tvalue, sds, hash>::const_iterator::operator!=(const const_iterator& other) const noexcept
 {
     throw not_implemented("template<typename tkey, typename tvalue, search_ds_for<tkey, tvalue> sds, typename hash> bool hash_table<tkey, tvalue, sds, hash>::const_iterator::operator!=(const const_iterator& other) const noexcept", "your code should be here...");
 }
 
 // constructors iterators
-template<typename tkey, typename tvalue, search_ds_for<tkey, tvalue> sds, typename hash>
+template<typename tkey, typename tvalue, hash_table_storage<tkey, tvalue> sds, typename hash>
 hash_table<tkey, tvalue, sds, hash>::iterator::iterator(vector::iterator begin, vector::iterator end)
 {
     throw not_implemented("template<typename tkey, typename tvalue, search_ds_for<tkey, tvalue> sds, typename hash> hash_table<tkey, tvalue, sds, hash>::iterator::iterator(vector::iterator , vector::iterator )", "your code should be here...");
 }
 
-template<typename tkey, typename tvalue, search_ds_for<tkey, tvalue> sds, typename hash>
+template<typename tkey, typename tvalue, hash_table_storage<tkey, tvalue> sds, typename hash>
 hash_table<tkey, tvalue, sds, hash>::iterator::iterator(vector::iterator begin, vector::iterator end, sds_it data_beg)
 {
     throw not_implemented("template<typename tkey, typename tvalue, search_ds_for<tkey, tvalue> sds, typename hash> hash_table<tkey, tvalue, sds, hash>::iterator::iterator(vector::iterator begin, vector::iterator end, sds_it data_beg)", "your code should be here...");
 }
 
-template<typename tkey, typename tvalue, search_ds_for<tkey, tvalue> sds, typename hash>
+template<typename tkey, typename tvalue, hash_table_storage<tkey, tvalue> sds, typename hash>
 hash_table<tkey, tvalue, sds, hash>::const_iterator::const_iterator(vector::const_iterator begin, vector::const_iterator end)
 {
     throw not_implemented("template<typename tkey, typename tvalue, search_ds_for<tkey, tvalue> sds, typename hash> hash_table<tkey, tvalue, sds, hash>::const_iterator::const_iterator(vector::const_iterator , vector::const_iterator )", "your code should be here...");
 }
 
-template<typename tkey, typename tvalue, search_ds_for<tkey, tvalue> sds, typename hash>
+template<typename tkey, typename tvalue, hash_table_storage<tkey, tvalue> sds, typename hash>
 hash_table<tkey, tvalue, sds, hash>::const_iterator::const_iterator(vector::const_iterator begin, vector::const_iterator end, sds_cit data_beg)
 {
     throw not_implemented("template<typename tkey, typename tvalue, search_ds_for<tkey, tvalue> sds, typename hash> hash_table<tkey, tvalue, sds, hash>::const_iterator::const_iterator(vector::const_iterator begin, vector::const_iterator end, sds_cit data_beg)", "your code should be here...");
 }
 
-template<typename tkey, typename tvalue, search_ds_for<tkey, tvalue> sds, typename hash>
+template<typename tkey, typename tvalue, hash_table_storage<tkey, tvalue> sds, typename hash>
 hash_table<tkey, tvalue, sds, hash>::const_iterator::const_iterator(const iterator& other)
 {
     throw not_implemented("template<typename tkey, typename tvalue, search_ds_for<tkey, tvalue> sds, typename hash> hash_table<tkey, tvalue, sds, hash>::const_iterator::const_iterator(const iterator&)", "your code should be here...");
@@ -413,25 +422,25 @@ hash_table<tkey, tvalue, sds, hash>::const_iterator::const_iterator(const iterat
 
 // region element access implementation
 
-template<typename tkey, typename tvalue, search_ds_for<tkey, tvalue> sds, typename hash>
+template<typename tkey, typename tvalue, hash_table_storage<tkey, tvalue> sds, typename hash>
 tvalue& hash_table<tkey, tvalue, sds, hash>::at(const tkey& key)
 {
     throw not_implemented("template<typename tkey, typename tvalue, search_ds_for<tkey, tvalue> sds, typename hash> tvalue& hash_table<tkey, tvalue, sds, hash>::at(const tkey& )", "your code should be here...");
 }
 
-template<typename tkey, typename tvalue, search_ds_for<tkey, tvalue> sds, typename hash>
+template<typename tkey, typename tvalue, hash_table_storage<tkey, tvalue> sds, typename hash>
 const tvalue& hash_table<tkey, tvalue, sds, hash>::at(const tkey& key) const
 {
     throw not_implemented("template<typename tkey, typename tvalue, search_ds_for<tkey, tvalue> sds, typename hash> const tvalue& hash_table<tkey, tvalue, sds, hash>::at(const tkey&) const", "your code should be here...");
 }
 
-template<typename tkey, typename tvalue, search_ds_for<tkey, tvalue> sds, typename hash>
+template<typename tkey, typename tvalue, hash_table_storage<tkey, tvalue> sds, typename hash>
 tvalue& hash_table<tkey, tvalue, sds, hash>::operator[](const tkey& key)
 {
     throw not_implemented("template<typename tkey, typename tvalue, search_ds_for<tkey, tvalue> sds, typename hash> tvalue& hash_table<tkey, tvalue, sds, hash>::operator[](const tkey&)", "your code should be here...");
 }
 
-template<typename tkey, typename tvalue, search_ds_for<tkey, tvalue> sds, typename hash>
+template<typename tkey, typename tvalue, hash_table_storage<tkey, tvalue> sds, typename hash>
 tvalue& hash_table<tkey, tvalue, sds, hash>::operator[](tkey&& key)
 {
     throw not_implemented("template<typename tkey, typename tvalue, search_ds_for<tkey, tvalue> sds, typename hash> tvalue& hash_table<tkey, tvalue, sds, hash>::operator[](tkey&&)", "your code should be here...");
@@ -441,49 +450,49 @@ tvalue& hash_table<tkey, tvalue, sds, hash>::operator[](tkey&& key)
 
 // region iterator begins implementation
 
-template<typename tkey, typename tvalue, search_ds_for<tkey, tvalue> sds, typename hash>
+template<typename tkey, typename tvalue, hash_table_storage<tkey, tvalue> sds, typename hash>
 typename hash_table<tkey, tvalue, sds, hash>::iterator hash_table<tkey, tvalue, sds, hash>::begin()
 {
     throw not_implemented("template<typename tkey, typename tvalue, search_ds_for<tkey, tvalue> sds, typename hash> typename hash_table<tkey, tvalue, sds, hash>::iterator hash_table<tkey, tvalue, sds, hash>::begin()", "your code should be here...");
 }
 
-template<typename tkey, typename tvalue, search_ds_for<tkey, tvalue> sds, typename hash>
+template<typename tkey, typename tvalue, hash_table_storage<tkey, tvalue> sds, typename hash>
 typename hash_table<tkey, tvalue, sds, hash>::iterator hash_table<tkey, tvalue, sds, hash>::end()
 {
     throw not_implemented("template<typename tkey, typename tvalue, search_ds_for<tkey, tvalue> sds, typename hash> typename hash_table<tkey, tvalue, sds, hash>::iterator hash_table<tkey, tvalue, sds, hash>::end()", "your code should be here...");
 }
 
-template<typename tkey, typename tvalue, search_ds_for<tkey, tvalue> sds, typename hash>
+template<typename tkey, typename tvalue, hash_table_storage<tkey, tvalue> sds, typename hash>
 typename hash_table<tkey, tvalue, sds, hash>::const_iterator hash_table<tkey, tvalue, sds, hash>::begin() const
 {
     throw not_implemented("template<typename tkey, typename tvalue, search_ds_for<tkey, tvalue> sds, typename hash> typename hash_table<tkey, tvalue, sds, hash>::const_iterator hash_table<tkey, tvalue, sds, hash>::begin() const", "your code should be here...");
 }
 
-template<typename tkey, typename tvalue, search_ds_for<tkey, tvalue> sds, typename hash>
+template<typename tkey, typename tvalue, hash_table_storage<tkey, tvalue> sds, typename hash>
 typename hash_table<tkey, tvalue, sds, hash>::const_iterator hash_table<tkey, tvalue, sds, hash>::end() const
 {
     throw not_implemented("template<typename tkey, typename tvalue, search_ds_for<tkey, tvalue> sds, typename hash> typename hash_table<tkey, tvalue, sds, hash>::const_iterator hash_table<tkey, tvalue, sds, hash>::end() const", "your code should be here...");
 }
 
-template<typename tkey, typename tvalue, search_ds_for<tkey, tvalue> sds, typename hash>
+template<typename tkey, typename tvalue, hash_table_storage<tkey, tvalue> sds, typename hash>
 typename hash_table<tkey, tvalue, sds, hash>::const_iterator hash_table<tkey, tvalue, sds, hash>::cbegin() const
 {
     throw not_implemented("template<typename tkey, typename tvalue, search_ds_for<tkey, tvalue> sds, typename hash> typename hash_table<tkey, tvalue, sds, hash>::const_iterator hash_table<tkey, tvalue, sds, hash>::cbegin() const", "your code should be here...");
 }
 
-template<typename tkey, typename tvalue, search_ds_for<tkey, tvalue> sds, typename hash>
+template<typename tkey, typename tvalue, hash_table_storage<tkey, tvalue> sds, typename hash>
 typename hash_table<tkey, tvalue, sds, hash>::const_iterator hash_table<tkey, tvalue, sds, hash>::cend() const
 {
     throw not_implemented("template<typename tkey, typename tvalue, search_ds_for<tkey, tvalue> sds, typename hash> typename hash_table<tkey, tvalue, sds, hash>::const_iterator hash_table<tkey, tvalue, sds, hash>::cend() const", "your code should be here...");
 }
 
-template<typename tkey, typename tvalue, search_ds_for<tkey, tvalue> sds, typename hash>
+template<typename tkey, typename tvalue, hash_table_storage<tkey, tvalue> sds, typename hash>
 typename hash_table<tkey, tvalue, sds, hash>::const_iterator hash_table<tkey, tvalue, sds, hash>::cbegin()
 {
     throw not_implemented("template<typename tkey, typename tvalue, search_ds_for<tkey, tvalue> sds, typename hash> typename hash_table<tkey, tvalue, sds, hash>::const_iterator hash_table<tkey, tvalue, sds, hash>::cbegin()", "your code should be here...");
 }
 
-template<typename tkey, typename tvalue, search_ds_for<tkey, tvalue> sds, typename hash>
+template<typename tkey, typename tvalue, hash_table_storage<tkey, tvalue> sds, typename hash>
 typename hash_table<tkey, tvalue, sds, hash>::const_iterator hash_table<tkey, tvalue, sds, hash>::cend()
 {
     throw not_implemented("template<typename tkey, typename tvalue, search_ds_for<tkey, tvalue> sds, typename hash> typename hash_table<tkey, tvalue, sds, hash>::const_iterator hash_table<tkey, tvalue, sds, hash>::cend()", "your code should be here...");
@@ -493,56 +502,56 @@ typename hash_table<tkey, tvalue, sds, hash>::const_iterator hash_table<tkey, tv
 
 // region lookup implementation
 
-template<typename tkey, typename tvalue, search_ds_for<tkey, tvalue> sds, typename hash>
+template<typename tkey, typename tvalue, hash_table_storage<tkey, tvalue> sds, typename hash>
 size_t hash_table<tkey, tvalue, sds, hash>::size() const noexcept
 {
     throw not_implemented("template<typename tkey, typename tvalue, search_ds_for<tkey, tvalue> sds, typename hash> size_t hash_table<tkey, tvalue, sds, hash>::size() const noexcept", "your code should be here...");
 }
 
-template<typename tkey, typename tvalue, search_ds_for<tkey, tvalue> sds, typename hash>
+template<typename tkey, typename tvalue, hash_table_storage<tkey, tvalue> sds, typename hash>
 bool hash_table<tkey, tvalue, sds, hash>::empty() const noexcept
 {
     throw not_implemented("template<typename tkey, typename tvalue, search_ds_for<tkey, tvalue> sds, typename hash> bool hash_table<tkey, tvalue, sds, hash>::empty() const noexcept", "your code should be here...");
 }
 
-template<typename tkey, typename tvalue, search_ds_for<tkey, tvalue> sds, typename hash>
+template<typename tkey, typename tvalue, hash_table_storage<tkey, tvalue> sds, typename hash>
 typename hash_table<tkey, tvalue, sds, hash>::iterator hash_table<tkey, tvalue, sds, hash>::find(const tkey& key)
 {
     throw not_implemented("template<typename tkey, typename tvalue, search_ds_for<tkey, tvalue> sds, typename hash> typename hash_table<tkey, tvalue, sds, hash>::iterator hash_table<tkey, tvalue, sds, hash>::find(const tkey& key)", "your code should be here...");
 }
 
-template<typename tkey, typename tvalue, search_ds_for<tkey, tvalue> sds, typename hash>
+template<typename tkey, typename tvalue, hash_table_storage<tkey, tvalue> sds, typename hash>
 typename hash_table<tkey, tvalue, sds, hash>::const_iterator hash_table<tkey, tvalue, sds, hash>::find(const tkey& key) const
 {
     throw not_implemented("template<typename tkey, typename tvalue, search_ds_for<tkey, tvalue> sds, typename hash> typename hash_table<tkey, tvalue, sds, hash>::const_iterator hash_table<tkey, tvalue, sds, hash>::find(const tkey& key) const", "your code should be here...");
 }
 
 
-template<typename tkey, typename tvalue, search_ds_for<tkey, tvalue> sds, typename hash>
+template<typename tkey, typename tvalue, hash_table_storage<tkey, tvalue> sds, typename hash>
 typename hash_table<tkey, tvalue, sds, hash>::iterator hash_table<tkey, tvalue, sds, hash>::lower_bound(const tkey& key)
 {
     throw not_implemented("template<typename tkey, typename tvalue, search_ds_for<tkey, tvalue> sds, typename hash> typename hash_table<tkey, tvalue, sds, hash>::iterator hash_table<tkey, tvalue, sds, hash>::lower_bound(const tkey& key)", "your code should be here...");
 }
 
-template<typename tkey, typename tvalue, search_ds_for<tkey, tvalue> sds, typename hash>
+template<typename tkey, typename tvalue, hash_table_storage<tkey, tvalue> sds, typename hash>
 typename hash_table<tkey, tvalue, sds, hash>::const_iterator hash_table<tkey, tvalue, sds, hash>::lower_bound(const tkey& key) const
 {
     throw not_implemented("template<typename tkey, typename tvalue, search_ds_for<tkey, tvalue> sds, typename hash> typename hash_table<tkey, tvalue, sds, hash>::const_iterator hash_table<tkey, tvalue, sds, hash>::lower_bound(const tkey& key) const", "your code should be here...");
 }
 
-template<typename tkey, typename tvalue, search_ds_for<tkey, tvalue> sds, typename hash>
+template<typename tkey, typename tvalue, hash_table_storage<tkey, tvalue> sds, typename hash>
 typename hash_table<tkey, tvalue, sds, hash>::iterator hash_table<tkey, tvalue, sds, hash>::upper_bound(const tkey& key)
 {
     throw not_implemented("template<typename tkey, typename tvalue, search_ds_for<tkey, tvalue> sds, typename hash> typename hash_table<tkey, tvalue, sds, hash>::iterator hash_table<tkey, tvalue, sds, hash>::upper_bound(const tkey& key)", "your code should be here...");
 }
 
-template<typename tkey, typename tvalue, search_ds_for<tkey, tvalue> sds, typename hash>
+template<typename tkey, typename tvalue, hash_table_storage<tkey, tvalue> sds, typename hash>
 typename hash_table<tkey, tvalue, sds, hash>::const_iterator hash_table<tkey, tvalue, sds, hash>::upper_bound(const tkey& key) const
 {
     throw not_implemented("template<typename tkey, typename tvalue, search_ds_for<tkey, tvalue> sds, typename hash> typename hash_table<tkey, tvalue, sds, hash>::const_iterator hash_table<tkey, tvalue, sds, hash>::upper_bound(const tkey&) const", "your code should be here...");
 }
 
-template<typename tkey, typename tvalue, search_ds_for<tkey, tvalue> sds, typename hash>
+template<typename tkey, typename tvalue, hash_table_storage<tkey, tvalue> sds, typename hash>
 bool hash_table<tkey, tvalue, sds, hash>::contains(const tkey& key) const
 {
     throw not_implemented("template<typename tkey, typename tvalue, search_ds_for<tkey, tvalue> sds, typename hash> bool hash_table<tkey, tvalue, sds, hash>::contains(const tkey& ) const", "your code should be here...");
@@ -552,75 +561,75 @@ bool hash_table<tkey, tvalue, sds, hash>::contains(const tkey& key) const
 
 // region modifiers implementation
 
-template<typename tkey, typename tvalue, search_ds_for<tkey, tvalue> sds, typename hash>
+template<typename tkey, typename tvalue, hash_table_storage<tkey, tvalue> sds, typename hash>
 void hash_table<tkey, tvalue, sds, hash>::clear() noexcept
 {
     throw not_implemented("template<typename tkey, typename tvalue, search_ds_for<tkey, tvalue> sds, typename hash> void hash_table<tkey, tvalue, sds, hash>::clear() noexcept", "your code should be here...");
 }
 
-template<typename tkey, typename tvalue, search_ds_for<tkey, tvalue> sds, typename hash>
+template<typename tkey, typename tvalue, hash_table_storage<tkey, tvalue> sds, typename hash>
 std::pair<typename hash_table<tkey, tvalue, sds, hash>::iterator, bool> hash_table<tkey, tvalue, sds, hash>::insert(const value_type& data)
 {
     throw not_implemented("template<typename tkey, typename tvalue, search_ds_for<tkey, tvalue> sds, typename hash> std::pair<typename hash_table<tkey, tvalue, sds, hash>::iterator, bool> hash_table<tkey, tvalue, sds, hash>::insert(const value_type& data)", "your code should be here...");
 }
 
-template<typename tkey, typename tvalue, search_ds_for<tkey, tvalue> sds, typename hash>
+template<typename tkey, typename tvalue, hash_table_storage<tkey, tvalue> sds, typename hash>
 std::pair<typename hash_table<tkey, tvalue, sds, hash>::iterator, bool> hash_table<tkey, tvalue, sds, hash>::insert(value_type&& data)
 {
     throw not_implemented("template<typename tkey, typename tvalue, search_ds_for<tkey, tvalue> sds, typename hash> std::pair<typename hash_table<tkey, tvalue, sds, hash>::iterator, bool> hash_table<tkey, tvalue, sds, hash>::insert(value_type&&)", "your code should be here...");
 }
 
-template<typename tkey, typename tvalue, search_ds_for<tkey, tvalue> sds, typename hash>
+template<typename tkey, typename tvalue, hash_table_storage<tkey, tvalue> sds, typename hash>
 template<typename ...Args>
 std::pair<typename hash_table<tkey, tvalue, sds, hash>::iterator, bool> hash_table<tkey, tvalue, sds, hash>::emplace(Args&&... args)
 {
     throw not_implemented("template<typename tkey, typename tvalue, search_ds_for<tkey, tvalue> sds, typename hash> template<typename ...Args> std::pair<typename hash_table<tkey, tvalue, sds, hash>::iterator, bool> hash_table<tkey, tvalue, sds, hash>::emplace(Args&&... args)", "your code should be here...");
 }
 
-template<typename tkey, typename tvalue, search_ds_for<tkey, tvalue> sds, typename hash>
+template<typename tkey, typename tvalue, hash_table_storage<tkey, tvalue> sds, typename hash>
 typename hash_table<tkey, tvalue, sds, hash>::iterator hash_table<tkey, tvalue, sds, hash>::insert_or_assign(const value_type & data)
 {
     throw not_implemented("template<typename tkey, typename tvalue, search_ds_for<tkey, tvalue> sds, typename hash> typename hash_table<tkey, tvalue, sds, hash>::iterator hash_table<tkey, tvalue, sds, hash>::insert_or_assign(const value_type &)", "your code should be here...");
 }
 
-template<typename tkey, typename tvalue, search_ds_for<tkey, tvalue> sds, typename hash>
+template<typename tkey, typename tvalue, hash_table_storage<tkey, tvalue> sds, typename hash>
 typename hash_table<tkey, tvalue, sds, hash>::iterator hash_table<tkey, tvalue, sds, hash>::insert_or_assign(value_type && data)
 {
     throw not_implemented("template<typename tkey, typename tvalue, search_ds_for<tkey, tvalue> sds, typename hash> typename hash_table<tkey, tvalue, sds, hash>::iterator hash_table<tkey, tvalue, sds, hash>::insert_or_assign(value_type &&)", "your code should be here...");
 }
 
-template<typename tkey, typename tvalue, search_ds_for<tkey, tvalue> sds, typename hash>
+template<typename tkey, typename tvalue, hash_table_storage<tkey, tvalue> sds, typename hash>
 template<typename ...Args>
 typename hash_table<tkey, tvalue, sds, hash>::iterator hash_table<tkey, tvalue, sds, hash>::emplace_or_assign(Args&&... args)
 {
     throw not_implemented("template<typename tkey, typename tvalue, search_ds_for<tkey, tvalue> sds, typename hash> template<typename ...Args> typename hash_table<tkey, tvalue, sds, hash>::iterator hash_table<tkey, tvalue, sds, hash>::emplace_or_assign(Args&&... args)", "your code should be here...");
 }
 
-template<typename tkey, typename tvalue, search_ds_for<tkey, tvalue> sds, typename hash>
+template<typename tkey, typename tvalue, hash_table_storage<tkey, tvalue> sds, typename hash>
 typename hash_table<tkey, tvalue, sds, hash>::iterator hash_table<tkey, tvalue, sds, hash>::erase(iterator pos)
 {
     throw not_implemented("template<typename tkey, typename tvalue, search_ds_for<tkey, tvalue> sds, typename hash> typename hash_table<tkey, tvalue, sds, hash>::iterator hash_table<tkey, tvalue, sds, hash>::erase(iterator )", "your code should be here...");
 }
 
-template<typename tkey, typename tvalue, search_ds_for<tkey, tvalue> sds, typename hash>
+template<typename tkey, typename tvalue, hash_table_storage<tkey, tvalue> sds, typename hash>
 typename hash_table<tkey, tvalue, sds, hash>::iterator hash_table<tkey, tvalue, sds, hash>::erase(const_iterator pos)
 {
     throw not_implemented("template<typename tkey, typename tvalue, search_ds_for<tkey, tvalue> sds, typename hash> typename hash_table<tkey, tvalue, sds, hash>::iterator hash_table<tkey, tvalue, sds, hash>::erase(const_iterator)", "your code should be here...");
 }
 
-template<typename tkey, typename tvalue, search_ds_for<tkey, tvalue> sds, typename hash>
+template<typename tkey, typename tvalue, hash_table_storage<tkey, tvalue> sds, typename hash>
 typename hash_table<tkey, tvalue, sds, hash>::iterator hash_table<tkey, tvalue, sds, hash>::erase(iterator beg, iterator en)
 {
     throw not_implemented("template<typename tkey, typename tvalue, search_ds_for<tkey, tvalue> sds, typename hash> typename hash_table<tkey, tvalue, sds, hash>::iterator hash_table<tkey, tvalue, sds, hash>::erase(iterator , iterator )", "your code should be here...");
 }
 
-template<typename tkey, typename tvalue, search_ds_for<tkey, tvalue> sds, typename hash>
+template<typename tkey, typename tvalue, hash_table_storage<tkey, tvalue> sds, typename hash>
 typename hash_table<tkey, tvalue, sds, hash>::iterator hash_table<tkey, tvalue, sds, hash>::erase(const_iterator beg, const_iterator en)
 {
     throw not_implemented("template<typename tkey, typename tvalue, search_ds_for<tkey, tvalue> sds, typename hash> typename hash_table<tkey, tvalue, sds, hash>::iterator hash_table<tkey, tvalue, sds, hash>::erase(const_iterator , const_iterator )", "your code should be here...");
 }
 
-template<typename tkey, typename tvalue, search_ds_for<tkey, tvalue> sds, typename hash>
+template<typename tkey, typename tvalue, hash_table_storage<tkey, tvalue> sds, typename hash>
 typename hash_table<tkey, tvalue, sds, hash>::iterator hash_table<tkey, tvalue, sds, hash>::erase(const tkey& key)
 {
     throw not_implemented("emplate<typename tkey, typename tvalue, search_ds_for<tkey, tvalue> sds, typename hash> typename hash_table<tkey, tvalue, sds, hash>::iterator hash_table<tkey, tvalue, sds, hash>::erase(const tkey&)", "your code should be here...");
@@ -630,31 +639,31 @@ typename hash_table<tkey, tvalue, sds, hash>::iterator hash_table<tkey, tvalue,
 
 // region hash policy implementation
 
-template<typename tkey, typename tvalue, search_ds_for<tkey, tvalue> sds, typename hash>
+template<typename tkey, typename tvalue, hash_table_storage<tkey, tvalue> sds, typename hash>
 double hash_table<tkey, tvalue, sds, hash>::max_load_factor() const
 {
     throw not_implemented("template<typename tkey, typename tvalue, search_ds_for<tkey, tvalue> sds, typename hash> double hash_table<tkey, tvalue, sds, hash>::max_load_factor() const", "your code should be here...");
 }
 
-template<typename tkey, typename tvalue, search_ds_for<tkey, tvalue> sds, typename hash>
+template<typename tkey, typename tvalue, hash_table_storage<tkey, tvalue> sds, typename hash>
 void hash_table<tkey, tvalue, sds, hash>::max_load_factor(double ml)
 {
     throw not_implemented("template<typename tkey, typename tvalue, search_ds_for<tkey, tvalue> sds, typename hash> void hash_table<tkey, tvalue, sds, hash>::max_load_factor(double )", "your code should be here...");
 }
 
-template<typename tkey, typename tvalue, search_ds_for<tkey, tvalue> sds, typename hash>
+template<typename tkey, typename tvalue, hash_table_storage<tkey, tvalue> sds, typename hash>
 double hash_table<tkey, tvalue, sds, hash>::load_factor() const
 {
     throw not_implemented("template<typename tkey, typename tvalue, search_ds_for<tkey, tvalue> sds, typename hash> double hash_table<tkey, tvalue, sds, hash>::load_factor() const", "your code should be here...");
 }
 
-template<typename tkey, typename tvalue, search_ds_for<tkey, tvalue> sds, typename hash>
+template<typename tkey, typename tvalue, hash_table_storage<tkey, tvalue> sds, typename hash>
 void hash_table<tkey, tvalue, sds, hash>::rehash(size_t count)
 {
     throw not_implemented("template<typename tkey, typename tvalue, search_ds_for<tkey, tvalue> sds, typename hash> void hash_table<tkey, tvalue, sds, hash>::rehash(size_t count)", "your code should be here...");
 }
 
-template<typename tkey, typename tvalue, search_ds_for<tkey, tvalue> sds, typename hash>
+template<typename tkey, typename tvalue, hash_table_storage<tkey, tvalue> sds, typename hash>
 void hash_table<tkey, tvalue, sds, hash>::reserve(size_t count)
 {
     throw not_implemented("template<typename tkey, typename tvalue, search_ds_for<tkey, tvalue> sds, typename hash> void hash_table<tkey, tvalue, sds, hash>::reserve(size_t )", "your code should be here...");
@@ -1,5 +1,363 @@
 #include <gtest/gtest.h>
 
+#include <atomic>
+#include <map>
+#include <random>
+#include <span>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+#include <concurrent_hash_table.h>
+#include <flat_hash_table.h>
+
+TEST(concurrentHashTableTests, test1)
+{
+    concurrent_hash_table<int, std::string> table(2);
+    std::unordered_map<int, std::string> expected;
+    std::mt19937 gen(5);
+
+    for (int i = 0; i < 20000; ++i)
+    {
+        int key = static_cast<int>(gen() % 3000);
+        std::string value = std::to_string(i);
+
+        switch (gen() % 3)
+        {
+            case 0:
+                EXPECT_EQ(table.insert(key, value), expected.emplace(key, value).second);
+                break;
+            case 1:
+                EXPECT_EQ(table.erase(key), expected.erase(key) == 1);
+                break;
+            default:
+                EXPECT_EQ(table.insert_or_assign(key, value), !expected.contains(key));
+                expected[key] = value;
+                break;
+        }
+    }
+
+    EXPECT_EQ(table.size(), expected.size());
+    EXPECT_LE(table.load_factor(), table.max_load_factor() * 2);
+
+    for (int key = 0; key < 3000; ++key)
+    {
+        auto it = expected.find(key);
+        EXPECT_EQ(table.find(key), it == expected.end() ? std::nullopt : std::optional<std::string>(it->second));
+    }
+
+    table.reserve(100000);
+    EXPECT_GE(table.bucket_count() * table.max_load_factor(), 100000);
+    EXPECT_EQ(table.size(), expected.size());
+}
+
+TEST(concurrentHashTableTests, test2)
+{
+    constexpr int threads_count = 4;
+    constexpr int keys_per_thread = 50000;
+
+    // Table starts small, so that every thread keeps meeting migration
+    concurrent_hash_table<int, int> table(1);
+    std::atomic<size_t> mismatches = 0;
+    std::vector<std::thread> threads;
+
+    for (int t = 0; t < threads_count; ++t)
+    {
+        threads.emplace_back([&, t]()
+        {
+            for (int i = 0; i < keys_per_thread; ++i)
+            {
+                int key = i * threads_count + t;
+
+                if (!table.insert(key, -key) || table.find(key) != std::optional<int>(-key))
+                {
+                    ++mismatches;
+                }
+
+                // Every third key is erased again by its owner
+                if (i % 3 == 0 && !table.erase(key))
+                {
+                    ++mismatches;
+                }
+            }
+        });
+    }
+
+    for (auto &thread: threads)
+    {
+        thread.join();
+    }
+
+    EXPECT_EQ(mismatches.load(), 0);
+
+    size_t expected_size = 0;
+
+    for (int key = 0; key < threads_count * keys_per_thread; ++key)
+    {
+        bool present = (key / threads_count) % 3 != 0;
+        expected_size += present;
+        EXPECT_EQ(table.contains(key), present);
+    }
+
+    EXPECT_EQ(table.size(), expected_size);
+}
+
+TEST(flatHashTableTests, test1)
+{
+    hash_table<int, std::string, flat_storage<>> table;
+    std::unordered_map<int, std::string> expected;
+    std::mt19937 gen(7);
+
+    for (int i = 0; i < 50000; ++i)
+    {
+        int key = static_cast<int>(gen() % 5000);
+        std::string value = std::to_string(i);
+
+        switch (gen() % 3)
+        {
+            case 0:
+                EXPECT_EQ(table.insert(std::make_pair(key, value)).second, expected.emplace(key, value).second);
+                break;
+            case 1:
+                EXPECT_EQ(table.contains(key), expected.contains(key));
+                table.erase(key);
+                expected.erase(key);
+                break;
+            default:
+                EXPECT_EQ(table.insert_or_assign(std::make_pair(key, value))->second, value);
+                expected[key] = value;
+                break;
+        }
+    }
+
+    EXPECT_EQ(table.size(), expected.size());
+    EXPECT_LE(table.load_factor(), table.max_load_factor());
+    EXPECT_EQ(static_cast<size_t>(std::distance(table.begin(), table.end())), expected.size());
+
+    for (auto& [key, value]: table)
+    {
+        EXPECT_EQ(expected.at(key), value);
+    }
+
+    for (int key = 0; key < 5000; ++key)
+    {
+        EXPECT_EQ(table.contains(key), expected.contains(key));
+    }
+
+    table.reserve(100000);
+    EXPECT_GE(table.bucket_count() * table.max_load_factor(), 100000);
+
+    table.rehash(0);
+    EXPECT_LE(table.bucket_count(), 2 * expected.size() / table.max_load_factor());
+    EXPECT_THROW(table.max_load_factor(1.5), std::invalid_argument);
+    EXPECT_THROW(table.at(-1), std::out_of_range);
+
+    table.max_load_factor(1.0);
+    auto copy = table;
+    auto moved = std::move(table);
+
+    EXPECT_EQ(copy.size(), expected.size());
+    EXPECT_EQ(moved.size(), expected.size());
+    EXPECT_TRUE(table.empty());
+
+    for (auto& [key, value]: expected)
+    {
+        EXPECT_EQ(copy.at(key), value);
+        EXPECT_EQ(moved.find(key)->second, value);
+    }
+}
+
+TEST(flatHashTableTests, test2)
+{
+    hash_table<std::string, int, flat_storage<>> table{{"a", 1}, {"b", 2}};
+
+    EXPECT_EQ(table["a"], 1);
+    EXPECT_EQ(table["c"], 0);
+    EXPECT_EQ(table.size(), 3);
+
+    table.clear();
+
+    // Erasing behind inserting leaves tombstones, table must reuse them without growing without bound
+    for (int i = 0; i < 100000; ++i)
+    {
+        table.emplace(std::to_string(i), i);
+
+        if (i >= 100)
+        {
+            table.erase(std::to_string(i - 100));
+        }
+    }
+
+    EXPECT_EQ(table.size(), 100);
+    EXPECT_LE(table.bucket_count(), 512);
+
+    std::map<std::string, int> items(table.cbegin(), table.cend());
+    EXPECT_EQ(items.size(), 100);
+    EXPECT_EQ(items.begin()->second, 99900);
+
+    for (auto it = table.begin(); it != table.end();)
+    {
+        it = it->second % 2 == 0 ? table.erase(it) : std::next(it);
+    }
+
+    EXPECT_EQ(table.size(), 50);
+    EXPECT_FALSE(table.contains("99998"));
+    EXPECT_TRUE(table.contains("99999"));
+}
+
+TEST(flatHashTableTests, test3)
+{
+    hash_table<int, int, flat_storage<>> table;
+    table.rehash_step(1);
+
+    size_t migrating_inserts = 0;
+
+    for (int i = 0; i < 100000; ++i)
+    {
+        table.emplace(i, i * 2);
+        migrating_inserts += table.rehashing();
+
+        // Lookups and iteration must see elements of both arrays while migration runs
+        if (table.rehashing() && i % 997 == 0)
+        {
+            EXPECT_EQ(static_cast<size_t>(std::distance(table.cbegin(), table.cend())), table.size());
+
+            for (int key = 0; key <= i; key += 101)
+            {
+                EXPECT_EQ(table.at(key), key * 2);
+            }
+        }
+    }
+
+    EXPECT_GT(migrating_inserts, 0);
+    EXPECT_EQ(table.size(), 100000);
+
+    while (!table.rehashing())
+    {
+        table.emplace(static_cast<int>(table.size()), 0);
+    }
+
+    // Erasure does not move elements, so erasing while iterating is safe during migration
+    size_t before = table.size();
+    size_t count = 0;
+
+    for (auto it = table.begin(); it != table.end(); ++count)
+    {
+        it = it->first % 3 == 0 ? table.erase(it) : std::next(it);
+    }
+
+    EXPECT_TRUE(table.rehashing());
+    EXPECT_EQ(count, before);
+    EXPECT_EQ(static_cast<size_t>(std::distance(table.begin(), table.end())), table.size());
+
+    for (int key = 0; key < 100000; ++key)
+    {
+        EXPECT_EQ(table.contains(key), key % 3 != 0);
+    }
+
+    // Reserve during migration waits for it to end and starts the next one, nothing is moved at once
+    size_t buckets = table.bucket_count();
+    table.reserve(buckets * 2);
+
+    EXPECT_TRUE(table.rehashing());
+    EXPECT_EQ(table.bucket_count(), buckets);
+
+    for (int key = -1; table.bucket_count() == buckets; --key)
+    {
+        table.emplace(key, key);
+    }
+
+    EXPECT_TRUE(table.rehashing());
+    EXPECT_GE(table.bucket_count(), buckets * 2);
+
+    auto copy = table;
+    table.rehash_step(0);
+
+    EXPECT_FALSE(table.rehashing());
+    EXPECT_EQ(copy.size(), table.size());
+
+    for (auto& [key, value]: copy)
+    {
+        EXPECT_EQ(table.at(key), value);
+    }
+}
+
+struct transparent_string_hash
+{
+    using is_transparent = void;
+
+    size_t operator()(std::string_view key) const noexcept
+    {
+        return std::hash<std::string_view>{}(key);
+    }
+};
+
+TEST(flatHashTableTests, test4)
+{
+    hash_table<std::string, int, flat_storage<std::equal_to<>>, transparent_string_hash> table;
+
+    for (int i = 0; i < 1000; ++i)
+    {
+        table.emplace(std::to_string(i), i);
+    }
+
+    const auto& ctable = table;
+
+    for (int i = 0; i < 1000; ++i)
+    {
+        std::string key = std::to_string(i);
+        std::string_view view = key;
+
+        EXPECT_TRUE(table.contains(view));
+        EXPECT_EQ(table.find(view)->second, i);
+        EXPECT_EQ(ctable.at(view), i);
+        EXPECT_EQ(ctable.find(key.c_str())->first, key);
+    }
+
+    table.at(std::string_view("7")) = -7;
+
+    EXPECT_EQ(table.at("7"), -7);
+    EXPECT_FALSE(table.contains(std::string_view("1000")));
+    EXPECT_EQ(table.find("-1"), table.end());
+    EXPECT_THROW(table.at(std::string_view("x")), std::out_of_range);
+}
+
+TEST(flatHashTableTests, test5)
+{
+    hash_table<int, int, flat_storage<>> table;
+    table.rehash_step(4);
+
+    // Batch is longer than one group and crosses migration, so keys are found in both arrays
+    int last = 0;
+
+    for (; last < 20000 || !table.rehashing(); last += 2)
+    {
+        table.emplace(last, -last);
+    }
+
+    std::vector<int> keys;
+
+    for (int i = -3; i < last + 3; i += 3)
+    {
+        keys.push_back(i);
+    }
+
+    std::vector<decltype(table)::iterator> result(keys.size());
+    table.find_batch(keys, result);
+
+    std::vector<decltype(table)::const_iterator> const_result(keys.size());
+    std::as_const(table).find_batch(keys, const_result);
+
+    for (size_t i = 0; i < keys.size(); ++i)
+    {
+        EXPECT_EQ(result[i], table.find(keys[i]));
+        EXPECT_EQ(const_result[i], result[i]);
+    }
+
+    EXPECT_THROW(table.find_batch(keys, std::span(result).first(1)), std::invalid_argument);
+}
+
 int main(
     int argc,
     char **argv)
@@ -7,4 +365,4 @@ int main(
     testing::InitGoogleTest(&argc, argv);
 
     return RUN_ALL_TESTS();
-}
\ No newline at end of file
+}
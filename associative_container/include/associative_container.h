@@ -11,9 +11,31 @@ concept compator = requires(const compare c, const tkey& lhs, const tkey& rhs)
                        {c(lhs, rhs)} -> std::same_as<bool>;
                    } && std::copyable<compare> && std::default_initializable<compare>;
 
+/**
+ * Comparator marked with is_transparent, which orders lookup_key against stored keys directly, so lookups by
+ * lookup_key make no tkey temporary
+**/
+template<typename compare, typename lookup_key, typename tkey>
+concept transparent_compator_for = requires(const compare c, const lookup_key& key, const tkey& stored)
+                                   {
+                                       typename compare::is_transparent;
+                                       {c(key, stored)} -> std::convertible_to<bool>;
+                                       {c(stored, key)} -> std::convertible_to<bool>;
+                                   };
+
 template<typename f_iter, typename tkey, typename tval>
 concept input_iterator_for_pair = std::input_iterator<f_iter> && std::same_as<typename std::iterator_traits<f_iter>::value_type, std::pair<tkey, tval>>;
 
+/**
+ * Tag for constructors whose input is already sorted by key and has no duplicate keys
+**/
+struct sorted_unique_t
+{
+    explicit sorted_unique_t() = default;
+};
+
+inline constexpr sorted_unique_t sorted_unique{};
+
 
 /**
  * You will strongly need this while doing your cursal work
@@ -0,0 +1,259 @@
+#ifndef MATH_PRACTICE_AND_OPERATING_SYSTEMS_RCU_AVL_TREE_H
+#define MATH_PRACTICE_AND_OPERATING_SYSTEMS_RCU_AVL_TREE_H
+
+#include <algorithm>
+#include <rcu_search_tree.h>
+
+namespace __detail
+{
+    class AVL_TAG;
+
+    /**
+     * Path-copying AVL insert and erase. Node balance holds height of its subtree, rotations own every node they
+     * relink, so published version is never touched. Heights and counts are recalculated together.
+    **/
+    template<typename tkey, typename tvalue, typename compare>
+    class rcu_impl<tkey, tvalue, compare, AVL_TAG>
+    {
+        friend class rcu_search_tree<tkey, tvalue, compare, AVL_TAG>;
+
+        using tree = rcu_search_tree<tkey, tvalue, compare, AVL_TAG>;
+        using node = typename tree::node;
+        using path_copier = typename tree::path_copier;
+
+        static size_t height(const node* subtree) noexcept;
+
+        /*
+         * Height and count of owned node from its children
+         */
+        static void recalculate(node* subtree) noexcept;
+
+        static node* rotate_left(path_copier& copier, node* subtree);
+
+        static node* rotate_right(path_copier& copier, node* subtree);
+
+        /*
+         * Restores balance of owned subtree whose children differ in height by two at most
+         */
+        static node* rebalance(path_copier& copier, node* subtree);
+
+        static node* insert(path_copier& copier, node* subtree, const tkey& key, const tvalue& value);
+
+        static node* erase(path_copier& copier, node* subtree, const tkey& key);
+
+        static node* erase_minimum(path_copier& copier, node* subtree, node*& minimum);
+
+        /*
+         * Hangs pivot with shorter tree down the spine of taller one, where heights differ by one at most, and
+         * rebalances the way back
+         */
+        static node* join(path_copier& copier, node* less, node* pivot, node* greater);
+
+        static node* join_right(path_copier& copier, node* less, node* pivot, node* greater);
+
+        static node* join_left(path_copier& copier, node* less, node* pivot, node* greater);
+    };
+}
+
+template<typename tkey, typename tvalue, compator<tkey> compare = std::less<tkey>>
+using rcu_AVL_tree = rcu_search_tree<tkey, tvalue, compare, __detail::AVL_TAG>;
+
+template<typename tkey, typename tvalue, typename compare>
+size_t __detail::rcu_impl<tkey, tvalue, compare, __detail::AVL_TAG>::height(const node* subtree) noexcept
+{
+    return subtree == nullptr ? 0 : subtree->balance;
+}
+
+template<typename tkey, typename tvalue, typename compare>
+void __detail::rcu_impl<tkey, tvalue, compare, __detail::AVL_TAG>::recalculate(node* subtree) noexcept
+{
+    subtree->balance = std::max(height(subtree->left_subtree), height(subtree->right_subtree)) + 1;
+    tree::recount(subtree);
+}
+
+template<typename tkey, typename tvalue, typename compare>
+typename __detail::rcu_impl<tkey, tvalue, compare, __detail::AVL_TAG>::node* __detail::rcu_impl<tkey, tvalue, compare, __detail::AVL_TAG>::rotate_left(path_copier& copier, node* subtree)
+{
+    node* right = copier.own(subtree->right_subtree);
+
+    subtree->right_subtree = right->left_subtree;
+    recalculate(subtree);
+    right->left_subtree = subtree;
+    recalculate(right);
+
+    return right;
+}
+
+template<typename tkey, typename tvalue, typename compare>
+typename __detail::rcu_impl<tkey, tvalue, compare, __detail::AVL_TAG>::node* __detail::rcu_impl<tkey, tvalue, compare, __detail::AVL_TAG>::rotate_right(path_copier& copier, node* subtree)
+{
+    node* left = copier.own(subtree->left_subtree);
+
+    subtree->left_subtree = left->right_subtree;
+    recalculate(subtree);
+    left->right_subtree = subtree;
+    recalculate(left);
+
+    return left;
+}
+
+template<typename tkey, typename tvalue, typename compare>
+typename __detail::rcu_impl<tkey, tvalue, compare, __detail::AVL_TAG>::node* __detail::rcu_impl<tkey, tvalue, compare, __detail::AVL_TAG>::rebalance(path_copier& copier, node* subtree)
+{
+    size_t left = height(subtree->left_subtree);
+    size_t right = height(subtree->right_subtree);
+
+    if (right > left + 1)
+    {
+        if (height(subtree->right_subtree->left_subtree) > height(subtree->right_subtree->right_subtree))
+        {
+            subtree->right_subtree = rotate_right(copier, copier.own(subtree->right_subtree));
+        }
+
+        return rotate_left(copier, subtree);
+    }
+
+    if (left > right + 1)
+    {
+        if (height(subtree->left_subtree->right_subtree) > height(subtree->left_subtree->left_subtree))
+        {
+            subtree->left_subtree = rotate_left(copier, copier.own(subtree->left_subtree));
+        }
+
+        return rotate_right(copier, subtree);
+    }
+
+    recalculate(subtree);
+    return subtree;
+}
+
+template<typename tkey, typename tvalue, typename compare>
+typename __detail::rcu_impl<tkey, tvalue, compare, __detail::AVL_TAG>::node* __detail::rcu_impl<tkey, tvalue, compare, __detail::AVL_TAG>::insert(path_copier& copier, node* subtree, const tkey& key, const tvalue& value)
+{
+    if (subtree == nullptr)
+    {
+        return copier.create(key, value, 1);
+    }
+
+    subtree = copier.own(subtree);
+
+    if (copier.compare_keys(key, subtree->key))
+    {
+        subtree->left_subtree = insert(copier, subtree->left_subtree, key, value);
+    } else
+    {
+        subtree->right_subtree = insert(copier, subtree->right_subtree, key, value);
+    }
+
+    return rebalance(copier, subtree);
+}
+
+template<typename tkey, typename tvalue, typename compare>
+typename __detail::rcu_impl<tkey, tvalue, compare, __detail::AVL_TAG>::node* __detail::rcu_impl<tkey, tvalue, compare, __detail::AVL_TAG>::erase(path_copier& copier, node* subtree, const tkey& key)
+{
+    if (copier.compare_keys(key, subtree->key))
+    {
+        subtree = copier.own(subtree);
+        subtree->left_subtree = erase(copier, subtree->left_subtree, key);
+        return rebalance(copier, subtree);
+    }
+
+    if (copier.compare_keys(subtree->key, key))
+    {
+        subtree = copier.own(subtree);
+        subtree->right_subtree = erase(copier, subtree->right_subtree, key);
+        return rebalance(copier, subtree);
+    }
+
+    if (subtree->left_subtree == nullptr || subtree->right_subtree == nullptr)
+    {
+        node* child = subtree->left_subtree != nullptr ? subtree->left_subtree : subtree->right_subtree;
+        copier.dispose(subtree);
+        return child;
+    }
+
+    subtree = copier.own(subtree);
+
+    node* minimum;
+    subtree->right_subtree = erase_minimum(copier, subtree->right_subtree, minimum);
+    subtree->key = minimum->key;
+    subtree->value = minimum->value;
+    copier.dispose(minimum);
+
+    return rebalance(copier, subtree);
+}
+
+template<typename tkey, typename tvalue, typename compare>
+typename __detail::rcu_impl<tkey, tvalue, compare, __detail::AVL_TAG>::node* __detail::rcu_impl<tkey, tvalue, compare, __detail::AVL_TAG>::erase_minimum(path_copier& copier, node* subtree, node*& minimum)
+{
+    if (subtree->left_subtree == nullptr)
+    {
+        minimum = subtree;
+        return subtree->right_subtree;
+    }
+
+    subtree = copier.own(subtree);
+    subtree->left_subtree = erase_minimum(copier, subtree->left_subtree, minimum);
+    return rebalance(copier, subtree);
+}
+
+template<typename tkey, typename tvalue, typename compare>
+typename __detail::rcu_impl<tkey, tvalue, compare, __detail::AVL_TAG>::node* __detail::rcu_impl<tkey, tvalue, compare, __detail::AVL_TAG>::join(path_copier& copier, node* less, node* pivot, node* greater)
+{
+    if (height(less) > height(greater) + 1)
+    {
+        return join_right(copier, less, pivot, greater);
+    }
+
+    if (height(greater) > height(less) + 1)
+    {
+        return join_left(copier, less, pivot, greater);
+    }
+
+    pivot->left_subtree = less;
+    pivot->right_subtree = greater;
+    recalculate(pivot);
+
+    return pivot;
+}
+
+template<typename tkey, typename tvalue, typename compare>
+typename __detail::rcu_impl<tkey, tvalue, compare, __detail::AVL_TAG>::node* __detail::rcu_impl<tkey, tvalue, compare, __detail::AVL_TAG>::join_right(path_copier& copier, node* less, node* pivot, node* greater)
+{
+    less = copier.own(less);
+
+    if (height(less->right_subtree) <= height(greater) + 1)
+    {
+        pivot->left_subtree = less->right_subtree;
+        pivot->right_subtree = greater;
+        recalculate(pivot);
+        less->right_subtree = pivot;
+    } else
+    {
+        less->right_subtree = join_right(copier, less->right_subtree, pivot, greater);
+    }
+
+    // Right subtree grew by one at most
+    return rebalance(copier, less);
+}
+
+template<typename tkey, typename tvalue, typename compare>
+typename __detail::rcu_impl<tkey, tvalue, compare, __detail::AVL_TAG>::node* __detail::rcu_impl<tkey, tvalue, compare, __detail::AVL_TAG>::join_left(path_copier& copier, node* less, node* pivot, node* greater)
+{
+    greater = copier.own(greater);
+
+    if (height(greater->left_subtree) <= height(less) + 1)
+    {
+        pivot->left_subtree = less;
+        pivot->right_subtree = greater->left_subtree;
+        recalculate(pivot);
+        greater->left_subtree = pivot;
+    } else
+    {
+        greater->left_subtree = join_left(copier, less, pivot, greater->left_subtree);
+    }
+
+    return rebalance(copier, greater);
+}
+
+#endif //MATH_PRACTICE_AND_OPERATING_SYSTEMS_RCU_AVL_TREE_H
@@ -0,0 +1,78 @@
+#ifndef MATH_PRACTICE_AND_OPERATING_SYSTEMS_EPOCH_RECLAIMER_H
+#define MATH_PRACTICE_AND_OPERATING_SYSTEMS_EPOCH_RECLAIMER_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * Epoch based reclamation for structures with lock-free readers. Reader pins current epoch for the time it holds
+ * pointers into structure; writer retires unlinked memory with epoch read after unlinking and frees it once epoch
+ * has advanced twice past it. Epoch advances only when no reader of the previous one is left, so neither readers
+ * nor writer ever wait. Readers are counted in striped per-epoch-parity counters to keep them off one cache line.
+**/
+class epoch_reclaimer final
+{
+public:
+
+    class guard final
+    {
+        friend class epoch_reclaimer;
+
+        std::atomic<size_t>* _counter;
+
+        explicit guard(std::atomic<size_t>* counter) noexcept;
+
+    public:
+
+        guard(const guard&) = delete;
+        guard& operator=(const guard&) = delete;
+
+        guard(guard&& other) noexcept;
+        guard& operator=(guard&& other) noexcept;
+
+        ~guard() noexcept;
+    };
+
+    /*
+     * Number of epochs retired memory lives through, so that owner may keep one retire list per epoch modulo it
+     */
+    static constexpr const size_t epochs_in_flight = 3;
+
+private:
+
+    static constexpr const size_t stripes = 32;
+    static constexpr const size_t cache_line = 64;
+
+    struct alignas(cache_line) stripe
+    {
+        std::atomic<size_t> _readers[2];
+    };
+
+    std::atomic<uint64_t> _epoch;
+    mutable stripe _stripes[stripes];
+
+    static size_t stripe_index() noexcept;
+
+public:
+
+    epoch_reclaimer() noexcept;
+
+    epoch_reclaimer(const epoch_reclaimer&) = delete;
+    epoch_reclaimer& operator=(const epoch_reclaimer&) = delete;
+
+    /*
+     * Keeps memory retired from now on alive until guard is destroyed
+     */
+    guard pin() const noexcept;
+
+    uint64_t current() const noexcept;
+
+    /*
+     * Moves to next epoch if no reader of previous one is left. Memory retired in epoch current() - 2 may be freed
+     * afterwards. Must not be called concurrently with itself
+     */
+    bool try_advance() noexcept;
+};
+
+#endif //MATH_PRACTICE_AND_OPERATING_SYSTEMS_EPOCH_RECLAIMER_H
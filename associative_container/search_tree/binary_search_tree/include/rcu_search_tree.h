@@ -0,0 +1,1329 @@
+#ifndef MATH_PRACTICE_AND_OPERATING_SYSTEMS_RCU_SEARCH_TREE_H
+#define MATH_PRACTICE_AND_OPERATING_SYSTEMS_RCU_SEARCH_TREE_H
+
+#include <algorithm>
+#include <atomic>
+#include <concepts>
+#include <functional>
+#include <future>
+#include <mutex>
+#include <optional>
+#include <stack>
+#include <thread>
+#include <utility>
+#include <vector>
+#include <logger.h>
+#include <logger_guardant.h>
+#include <search_tree.h>
+#include <pp_allocator.h>
+#include <epoch_reclaimer.h>
+
+namespace __detail
+{
+    template<typename tkey, typename tvalue, typename compare, typename tag>
+    class rcu_impl;
+
+    class BST_TAG;
+}
+
+/**
+ * Search tree for many readers and one writer at a time. Published nodes are never changed: writer copies the path
+ * it changes, links copies into new version and publishes its root with release store, so readers walk whatever
+ * version they have loaded without locks. Nodes of older versions are retired and given back to allocator once no
+ * reader pinned before their removal is left. Balancing is chosen by tag, the same way as for binary_search_tree.
+**/
+template<typename tkey, typename tvalue, compator<tkey> compare = std::less<tkey>, typename tag = __detail::BST_TAG>
+class rcu_search_tree final : private logger_guardant, private compare
+{
+public:
+
+    using value_type = std::pair<const tkey, tvalue>;
+    using tree_data_type = std::pair<tkey, tvalue>;
+
+    friend class __detail::rcu_impl<tkey, tvalue, compare, tag>;
+
+private:
+
+    struct node
+    {
+        tkey key;
+        tvalue value;
+
+        node* left_subtree;
+        node* right_subtree;
+
+        /*
+         * Balance data of tag: height, color
+         */
+        size_t balance;
+
+        /*
+         * Nodes in subtree, so that keys can be found by their position in order
+         */
+        size_t count;
+
+        /*
+         * Number of write which created node, node of running write may still be changed in place
+         */
+        uint64_t write;
+
+        node(const tkey& key, const tvalue& value, node* left, node* right, size_t balance, uint64_t write);
+    };
+
+    /**
+     * Copy-on-write view of tree for one write. Balancing works on it through own(), which gives node safe to
+     * change, and dispose(), which drops node from new version.
+    **/
+    class path_copier
+    {
+        rcu_search_tree& _tree;
+        uint64_t _write;
+        std::vector<node*> _created;
+        std::vector<node*> _replaced;
+
+        /*
+         * Nodes of this write dropped from it, freed on publishing
+         */
+        std::vector<node*> _dropped;
+
+        /*
+         * Room for one more node made before node is allocated, so that it is never lost. Grows geometrically, bulk
+         * writes track O(n) nodes
+         */
+        static void reserve_one(std::vector<node*>& nodes);
+
+    public:
+
+        /*
+         * Copiers of the same write may build disjoint parts of one version in parallel
+         */
+        path_copier(rcu_search_tree& tree, uint64_t write) noexcept;
+
+        path_copier(const path_copier&) = delete;
+
+        /*
+         * Drops nodes of unpublished version if write failed
+         */
+        ~path_copier() noexcept;
+
+        bool compare_keys(const tkey& lhs, const tkey& rhs) const;
+
+        node* create(const tkey& key, const tvalue& value, size_t balance = 0);
+
+        node* own(node* n);
+
+        void dispose(node* n);
+
+        uint64_t write() const noexcept;
+
+        /*
+         * Takes over nodes of other copier of the same write once its part is linked into this one
+         */
+        void adopt(path_copier& other);
+
+        void publish(node* root);
+    };
+
+    struct split_result
+    {
+        node* less;
+        node* equal;
+        node* greater;
+    };
+
+    using bulk_operation = node* (rcu_search_tree::*)(path_copier&, node*, const node*, size_t);
+
+    /*
+     * Halves smaller than this are not worth a thread
+     */
+    static constexpr const size_t parallel_grain = 4096;
+
+    pp_allocator<value_type> _allocator;
+    logger* _logger;
+    std::atomic<node*> _root;
+    std::atomic<size_t> _size;
+
+    std::mutex _writer_guard;
+    uint64_t _writes;
+    epoch_reclaimer _epochs;
+    std::vector<node*> _retired[epoch_reclaimer::epochs_in_flight];
+
+    logger* get_logger() const noexcept override;
+
+    /* Keys may be of other type than tkey for transparent comparators */
+    template<typename lhs_key, typename rhs_key>
+    inline bool compare_keys(const lhs_key& lhs, const rhs_key& rhs) const;
+
+    template<typename lookup_key>
+    const node* find_node(const node* subtree, const lookup_key& key) const;
+
+    node* assign(path_copier& copier, node* subtree, const tkey& key, const tvalue& value);
+
+    /*
+     * Frees nodes no reader can reach any more. Called under writer guard
+     */
+    void collect() noexcept;
+
+    void destroy_subtree(node* subtree) noexcept;
+
+    /*
+     * Split and join are the only primitives of bulk operations, balance is kept by join of tag
+     */
+    split_result split(path_copier& copier, node* subtree, const tkey& key);
+
+    node* join(path_copier& copier, node* less, node* pivot, node* greater);
+
+    node* join(path_copier& copier, node* less, node* greater);
+
+    node* split_last(path_copier& copier, node* subtree, node*& last);
+
+    node* copy_subtree(path_copier& copier, const node* other);
+
+    void dispose_subtree(path_copier& copier, node* subtree);
+
+    /*
+     * Split subtree around root of other and run operation on both halves, in parallel if threads allow
+     */
+    std::pair<node*, node*> both_halves(path_copier& copier, bulk_operation operation, const split_result& parts, const node* other, size_t threads);
+
+    node* unite_subtrees(path_copier& copier, node* subtree, const node* other, size_t threads);
+
+    node* intersect_subtrees(path_copier& copier, node* subtree, const node* other, size_t threads);
+
+    node* subtract_subtrees(path_copier& copier, node* subtree, const node* other, size_t threads);
+
+    void bulk_write(const rcu_search_tree& other, bulk_operation operation, size_t threads);
+
+    static size_t count(const node* subtree) noexcept;
+
+    /*
+     * Count of owned node from its children. Balancing calls it for every node whose children it changes
+     */
+    static void recount(node* subtree) noexcept;
+
+public:
+
+    /**
+     * Consistent version of tree pinned for reading. Nodes it reaches stay alive while it exists, so long-living
+     * snapshots hold back reclamation.
+    **/
+    class snapshot
+    {
+        friend class rcu_search_tree;
+
+        const rcu_search_tree* _tree;
+        epoch_reclaimer::guard _guard;
+        const node* _root;
+
+        snapshot(const rcu_search_tree* tree, epoch_reclaimer::guard&& guard) noexcept;
+
+        template<typename lookup_key>
+        const node* lower_bound_node(const lookup_key& key) const;
+
+        template<typename lookup_key>
+        size_t rank_of(const lookup_key& key) const;
+
+        template<typename result, typename callback>
+        static result fold_subtree(const node* subtree, const result& empty, callback& visit);
+
+    public:
+
+        std::optional<tvalue> find(const tkey& key) const;
+
+        bool contains(const tkey& key) const;
+
+        /*
+         * Copy of pair with smallest key not less than key, empty if not exist
+         */
+        std::optional<tree_data_type> lower_bound(const tkey& key) const;
+
+        /*
+         * Lookups by key of other type, when comparator is transparent
+         */
+        template<typename lookup_key> requires transparent_compator_for<compare, lookup_key, tkey>
+        std::optional<tvalue> find(const lookup_key& key) const;
+
+        template<typename lookup_key> requires transparent_compator_for<compare, lookup_key, tkey>
+        bool contains(const lookup_key& key) const;
+
+        template<typename lookup_key> requires transparent_compator_for<compare, lookup_key, tkey>
+        std::optional<tree_data_type> lower_bound(const lookup_key& key) const;
+
+        /*
+         * Copy of pair with index-th smallest key counting from 0, empty if tree is not that large
+         */
+        std::optional<tree_data_type> nth(size_t index) const;
+
+        /*
+         * Number of keys less than key
+         */
+        size_t rank(const tkey& key) const;
+
+        /*
+         * Number of keys in [lower, upper), 0 if upper is not greater than lower
+         */
+        size_t count_range(const tkey& lower, const tkey& upper) const;
+
+        template<typename lookup_key> requires transparent_compator_for<compare, lookup_key, tkey>
+        size_t rank(const lookup_key& key) const;
+
+        template<typename lookup_key> requires transparent_compator_for<compare, lookup_key, tkey>
+        size_t count_range(const lookup_key& lower, const lookup_key& upper) const;
+
+        /*
+         * Calls visit for pairs in key order
+         */
+        template<std::invocable<const tkey&, const tvalue&> callback>
+        void for_each(callback&& visit) const;
+
+        /*
+         * Folds version bottom-up to check its shape. visit gets key, balance and count of node with results of
+         * its children, empty subtree gives empty
+         */
+        template<typename result, typename callback>
+        result fold(const result& empty, callback&& visit) const;
+    };
+
+    // region constructors declaration
+
+    explicit rcu_search_tree(const compare& cmp = compare(), pp_allocator<value_type> alloc = pp_allocator<value_type>(), logger* logger = nullptr);
+
+    // endregion constructors declaration
+
+    // region five declaration
+
+    rcu_search_tree(const rcu_search_tree& other) = delete;
+
+    rcu_search_tree& operator=(const rcu_search_tree& other) = delete;
+
+    /*
+     * Must not run concurrently with any other operation or outlive any snapshot
+     */
+    ~rcu_search_tree() noexcept override;
+
+    // endregion five declaration
+
+    // region lookup declaration
+
+    size_t size() const noexcept;
+    bool empty() const noexcept;
+
+    snapshot get_snapshot() const noexcept;
+
+    std::optional<tvalue> find(const tkey& key) const;
+
+    bool contains(const tkey& key) const;
+
+    std::optional<tree_data_type> lower_bound(const tkey& key) const;
+
+    /*
+     * Lookups by key of other type, when comparator is transparent
+     */
+    template<typename lookup_key> requires transparent_compator_for<compare, lookup_key, tkey>
+    std::optional<tvalue> find(const lookup_key& key) const;
+
+    template<typename lookup_key> requires transparent_compator_for<compare, lookup_key, tkey>
+    bool contains(const lookup_key& key) const;
+
+    template<typename lookup_key> requires transparent_compator_for<compare, lookup_key, tkey>
+    std::optional<tree_data_type> lower_bound(const lookup_key& key) const;
+
+    /*
+     * Order statistics in O(log n), every node knows size of its subtree
+     */
+    std::optional<tree_data_type> nth(size_t index) const;
+
+    size_t rank(const tkey& key) const;
+
+    size_t count_range(const tkey& lower, const tkey& upper) const;
+
+    template<typename lookup_key> requires transparent_compator_for<compare, lookup_key, tkey>
+    size_t rank(const lookup_key& key) const;
+
+    template<typename lookup_key> requires transparent_compator_for<compare, lookup_key, tkey>
+    size_t count_range(const lookup_key& lower, const lookup_key& upper) const;
+
+    // endregion lookup declaration
+
+    // region modifiers declaration
+
+    /*
+     * Returns false and leaves tree unchanged if key exists
+     */
+    bool insert(const tkey& key, const tvalue& value);
+
+    /*
+     * Returns true if key was inserted, false if existing value was replaced
+     */
+    bool insert_or_assign(const tkey& key, const tvalue& value);
+
+    bool erase(const tkey& key);
+
+    /*
+     * Frees retired nodes which are no longer reachable without waiting for next write
+     */
+    void reclaim();
+
+    /*
+     * Set operations with other tree, published as one write. Equal keys keep values of this tree. Work is
+     * O(m log(n / m + 1)) for AVL trees of m and n keys, red-black join counts black heights and adds log n factor;
+     * nodes copied from other tree or dropped from this one come on top. Halves of recursion run on up to threads
+     * threads, 0 means one per hardware thread; more than one needs allocator which may be used from several threads
+     */
+    void unite(const rcu_search_tree& other, size_t threads = 1);
+
+    void intersect(const rcu_search_tree& other, size_t threads = 1);
+
+    void subtract(const rcu_search_tree& other, size_t threads = 1);
+
+    // endregion modifiers declaration
+};
+
+namespace __detail
+{
+    /**
+     * Path-copying insert and erase of unbalanced tree. Specializations for tags keep their balance on the way up.
+     * Both get key whose presence was already checked.
+    **/
+    template<typename tkey, typename tvalue, typename compare, typename tag>
+    class rcu_impl
+    {
+        friend class rcu_search_tree<tkey, tvalue, compare, tag>;
+
+        using tree = rcu_search_tree<tkey, tvalue, compare, tag>;
+        using node = typename tree::node;
+        using path_copier = typename tree::path_copier;
+
+        static node* insert(path_copier& copier, node* subtree, const tkey& key, const tvalue& value);
+
+        static node* erase(path_copier& copier, node* subtree, const tkey& key);
+
+        static node* erase_minimum(path_copier& copier, node* subtree, node*& minimum);
+
+        /*
+         * Tree of less, owned pivot and greater, whose keys are ordered so
+         */
+        static node* join(path_copier& copier, node* less, node* pivot, node* greater);
+    };
+}
+
+// region rcu_impl implementation
+
+template<typename tkey, typename tvalue, typename compare, typename tag>
+typename __detail::rcu_impl<tkey, tvalue, compare, tag>::node* __detail::rcu_impl<tkey, tvalue, compare, tag>::insert(path_copier& copier, node* subtree, const tkey& key, const tvalue& value)
+{
+    if (subtree == nullptr)
+    {
+        return copier.create(key, value);
+    }
+
+    subtree = copier.own(subtree);
+
+    if (copier.compare_keys(key, subtree->key))
+    {
+        subtree->left_subtree = insert(copier, subtree->left_subtree, key, value);
+    } else
+    {
+        subtree->right_subtree = insert(copier, subtree->right_subtree, key, value);
+    }
+
+    tree::recount(subtree);
+    return subtree;
+}
+
+template<typename tkey, typename tvalue, typename compare, typename tag>
+typename __detail::rcu_impl<tkey, tvalue, compare, tag>::node* __detail::rcu_impl<tkey, tvalue, compare, tag>::erase(path_copier& copier, node* subtree, const tkey& key)
+{
+    if (copier.compare_keys(key, subtree->key))
+    {
+        subtree = copier.own(subtree);
+        subtree->left_subtree = erase(copier, subtree->left_subtree, key);
+        tree::recount(subtree);
+        return subtree;
+    }
+
+    if (copier.compare_keys(subtree->key, key))
+    {
+        subtree = copier.own(subtree);
+        subtree->right_subtree = erase(copier, subtree->right_subtree, key);
+        tree::recount(subtree);
+        return subtree;
+    }
+
+    if (subtree->left_subtree == nullptr || subtree->right_subtree == nullptr)
+    {
+        node* child = subtree->left_subtree != nullptr ? subtree->left_subtree : subtree->right_subtree;
+        copier.dispose(subtree);
+        return child;
+    }
+
+    subtree = copier.own(subtree);
+
+    node* minimum;
+    subtree->right_subtree = erase_minimum(copier, subtree->right_subtree, minimum);
+    subtree->key = minimum->key;
+    subtree->value = minimum->value;
+    copier.dispose(minimum);
+
+    tree::recount(subtree);
+    return subtree;
+}
+
+template<typename tkey, typename tvalue, typename compare, typename tag>
+typename __detail::rcu_impl<tkey, tvalue, compare, tag>::node* __detail::rcu_impl<tkey, tvalue, compare, tag>::erase_minimum(path_copier& copier, node* subtree, node*& minimum)
+{
+    if (subtree->left_subtree == nullptr)
+    {
+        minimum = subtree;
+        return subtree->right_subtree;
+    }
+
+    subtree = copier.own(subtree);
+    subtree->left_subtree = erase_minimum(copier, subtree->left_subtree, minimum);
+    tree::recount(subtree);
+    return subtree;
+}
+
+template<typename tkey, typename tvalue, typename compare, typename tag>
+typename __detail::rcu_impl<tkey, tvalue, compare, tag>::node* __detail::rcu_impl<tkey, tvalue, compare, tag>::join(path_copier& copier, node* less, node* pivot, node* greater)
+{
+    pivot->left_subtree = less;
+    pivot->right_subtree = greater;
+    tree::recount(pivot);
+    return pivot;
+}
+
+// endregion rcu_impl implementation
+
+// region path_copier implementation
+
+template<typename tkey, typename tvalue, compator<tkey> compare, typename tag>
+rcu_search_tree<tkey, tvalue, compare, tag>::node::node(const tkey& key, const tvalue& value, node* left, node* right, size_t balance, uint64_t write)
+    : key(key), value(value), left_subtree(left), right_subtree(right), balance(balance), count(1), write(write)
+{
+}
+
+template<typename tkey, typename tvalue, compator<tkey> compare, typename tag>
+rcu_search_tree<tkey, tvalue, compare, tag>::path_copier::path_copier(rcu_search_tree& tree, uint64_t write) noexcept
+    : _tree(tree), _write(write)
+{
+}
+
+template<typename tkey, typename tvalue, compator<tkey> compare, typename tag>
+rcu_search_tree<tkey, tvalue, compare, tag>::path_copier::~path_copier() noexcept
+{
+    for (auto n : _created)
+    {
+        _tree._allocator.delete_object(n);
+    }
+}
+
+template<typename tkey, typename tvalue, compator<tkey> compare, typename tag>
+void rcu_search_tree<tkey, tvalue, compare, tag>::path_copier::reserve_one(std::vector<node*>& nodes)
+{
+    if (nodes.size() == nodes.capacity())
+    {
+        nodes.reserve(std::max<size_t>(nodes.capacity() * 2, 8));
+    }
+}
+
+template<typename tkey, typename tvalue, compator<tkey> compare, typename tag>
+bool rcu_search_tree<tkey, tvalue, compare, tag>::path_copier::compare_keys(const tkey& lhs, const tkey& rhs) const
+{
+    return _tree.compare_keys(lhs, rhs);
+}
+
+template<typename tkey, typename tvalue, compator<tkey> compare, typename tag>
+typename rcu_search_tree<tkey, tvalue, compare, tag>::node* rcu_search_tree<tkey, tvalue, compare, tag>::path_copier::create(const tkey& key, const tvalue& value, size_t balance)
+{
+    reserve_one(_created);
+
+    node* result = _tree._allocator.template new_object<node>(key, value, nullptr, nullptr, balance, _write);
+    _created.push_back(result);
+    return result;
+}
+
+template<typename tkey, typename tvalue, compator<tkey> compare, typename tag>
+typename rcu_search_tree<tkey, tvalue, compare, tag>::node* rcu_search_tree<tkey, tvalue, compare, tag>::path_copier::own(node* n)
+{
+    if (n == nullptr || n->write == _write)
+    {
+        return n;
+    }
+
+    reserve_one(_replaced);
+
+    node* result = create(n->key, n->value, n->balance);
+    result->left_subtree = n->left_subtree;
+    result->right_subtree = n->right_subtree;
+    result->count = n->count;
+    _replaced.push_back(n);
+    return result;
+}
+
+template<typename tkey, typename tvalue, compator<tkey> compare, typename tag>
+void rcu_search_tree<tkey, tvalue, compare, tag>::path_copier::dispose(node* n)
+{
+    // Node of this write stays on list of created ones until publishing, so that dropping it is O(1)
+    if (n->write == _write)
+    {
+        _dropped.push_back(n);
+    } else
+    {
+        reserve_one(_replaced);
+        _replaced.push_back(n);
+    }
+}
+
+template<typename tkey, typename tvalue, compator<tkey> compare, typename tag>
+uint64_t rcu_search_tree<tkey, tvalue, compare, tag>::path_copier::write() const noexcept
+{
+    return _write;
+}
+
+template<typename tkey, typename tvalue, compator<tkey> compare, typename tag>
+void rcu_search_tree<tkey, tvalue, compare, tag>::path_copier::adopt(path_copier& other)
+{
+    _created.insert(_created.end(), other._created.begin(), other._created.end());
+    other._created.clear();
+    _replaced.insert(_replaced.end(), other._replaced.begin(), other._replaced.end());
+    other._replaced.clear();
+    _dropped.insert(_dropped.end(), other._dropped.begin(), other._dropped.end());
+    other._dropped.clear();
+}
+
+template<typename tkey, typename tvalue, compator<tkey> compare, typename tag>
+void rcu_search_tree<tkey, tvalue, compare, tag>::path_copier::publish(node* root)
+{
+    // Epoch advances only under writer guard, so list to retire into is known before publishing
+    auto& retired = _tree._retired[_tree._epochs.current() % epoch_reclaimer::epochs_in_flight];
+    retired.reserve(retired.size() + _replaced.size());
+
+    _tree._root.store(root, std::memory_order_release);
+    _created.clear();
+
+    for (auto n : _dropped)
+    {
+        _tree._allocator.delete_object(n);
+    }
+
+    _dropped.clear();
+
+    // Readers which loaded old root have pinned this epoch or earlier one
+    retired.insert(retired.end(), _replaced.begin(), _replaced.end());
+    _replaced.clear();
+}
+
+// endregion path_copier implementation
+
+// region rcu_search_tree implementation
+
+template<typename tkey, typename tvalue, compator<tkey> compare, typename tag>
+logger* rcu_search_tree<tkey, tvalue, compare, tag>::get_logger() const noexcept
+{
+    return _logger;
+}
+
+template<typename tkey, typename tvalue, compator<tkey> compare, typename tag>
+template<typename lhs_key, typename rhs_key>
+bool rcu_search_tree<tkey, tvalue, compare, tag>::compare_keys(const lhs_key& lhs, const rhs_key& rhs) const
+{
+    return compare::operator()(lhs, rhs);
+}
+
+template<typename tkey, typename tvalue, compator<tkey> compare, typename tag>
+template<typename lookup_key>
+const typename rcu_search_tree<tkey, tvalue, compare, tag>::node* rcu_search_tree<tkey, tvalue, compare, tag>::find_node(const node* subtree, const lookup_key& key) const
+{
+    while (subtree != nullptr)
+    {
+        if (compare_keys(key, subtree->key))
+        {
+            subtree = subtree->left_subtree;
+        } else if (compare_keys(subtree->key, key))
+        {
+            subtree = subtree->right_subtree;
+        } else
+        {
+            return subtree;
+        }
+    }
+
+    return nullptr;
+}
+
+template<typename tkey, typename tvalue, compator<tkey> compare, typename tag>
+typename rcu_search_tree<tkey, tvalue, compare, tag>::node* rcu_search_tree<tkey, tvalue, compare, tag>::assign(path_copier& copier, node* subtree, const tkey& key, const tvalue& value)
+{
+    subtree = copier.own(subtree);
+
+    if (compare_keys(key, subtree->key))
+    {
+        subtree->left_subtree = assign(copier, subtree->left_subtree, key, value);
+    } else if (compare_keys(subtree->key, key))
+    {
+        subtree->right_subtree = assign(copier, subtree->right_subtree, key, value);
+    } else
+    {
+        subtree->value = value;
+    }
+
+    return subtree;
+}
+
+template<typename tkey, typename tvalue, compator<tkey> compare, typename tag>
+void rcu_search_tree<tkey, tvalue, compare, tag>::collect() noexcept
+{
+    if (!_epochs.try_advance())
+    {
+        return;
+    }
+
+    // Nodes retired two epochs ago, which is the slot after the current one
+    auto& retired = _retired[(_epochs.current() + 1) % epoch_reclaimer::epochs_in_flight];
+
+    for (auto n : retired)
+    {
+        _allocator.delete_object(n);
+    }
+
+    retired.clear();
+}
+
+template<typename tkey, typename tvalue, compator<tkey> compare, typename tag>
+void rcu_search_tree<tkey, tvalue, compare, tag>::destroy_subtree(node* subtree) noexcept
+{
+    if (subtree == nullptr)
+    {
+        return;
+    }
+
+    destroy_subtree(subtree->left_subtree);
+    destroy_subtree(subtree->right_subtree);
+    _allocator.delete_object(subtree);
+}
+
+template<typename tkey, typename tvalue, compator<tkey> compare, typename tag>
+typename rcu_search_tree<tkey, tvalue, compare, tag>::split_result rcu_search_tree<tkey, tvalue, compare, tag>::split(path_copier& copier, node* subtree, const tkey& key)
+{
+    if (subtree == nullptr)
+    {
+        return {nullptr, nullptr, nullptr};
+    }
+
+    if (compare_keys(key, subtree->key))
+    {
+        auto parts = split(copier, subtree->left_subtree, key);
+        parts.greater = join(copier, parts.greater, subtree, subtree->right_subtree);
+        return parts;
+    }
+
+    if (compare_keys(subtree->key, key))
+    {
+        auto parts = split(copier, subtree->right_subtree, key);
+        parts.less = join(copier, subtree->left_subtree, subtree, parts.less);
+        return parts;
+    }
+
+    return {subtree->left_subtree, subtree, subtree->right_subtree};
+}
+
+template<typename tkey, typename tvalue, compator<tkey> compare, typename tag>
+typename rcu_search_tree<tkey, tvalue, compare, tag>::node* rcu_search_tree<tkey, tvalue, compare, tag>::join(path_copier& copier, node* less, node* pivot, node* greater)
+{
+    return __detail::rcu_impl<tkey, tvalue, compare, tag>::join(copier, less, copier.own(pivot), greater);
+}
+
+template<typename tkey, typename tvalue, compator<tkey> compare, typename tag>
+typename rcu_search_tree<tkey, tvalue, compare, tag>::node* rcu_search_tree<tkey, tvalue, compare, tag>::join(path_copier& copier, node* less, node* greater)
+{
+    if (less == nullptr)
+    {
+        return greater;
+    }
+
+    node* last;
+    less = split_last(copier, less, last);
+    return join(copier, less, last, greater);
+}
+
+template<typename tkey, typename tvalue, compator<tkey> compare, typename tag>
+typename rcu_search_tree<tkey, tvalue, compare, tag>::node* rcu_search_tree<tkey, tvalue, compare, tag>::split_last(path_copier& copier, node* subtree, node*& last)
+{
+    if (subtree->right_subtree == nullptr)
+    {
+        last = subtree;
+        return subtree->left_subtree;
+    }
+
+    node* rest = split_last(copier, subtree->right_subtree, last);
+    return join(copier, subtree->left_subtree, subtree, rest);
+}
+
+template<typename tkey, typename tvalue, compator<tkey> compare, typename tag>
+typename rcu_search_tree<tkey, tvalue, compare, tag>::node* rcu_search_tree<tkey, tvalue, compare, tag>::copy_subtree(path_copier& copier, const node* other)
+{
+    if (other == nullptr)
+    {
+        return nullptr;
+    }
+
+    // Both trees keep balance of the same tag, so copy keeps it as is
+    node* result = copier.create(other->key, other->value, other->balance);
+    result->count = other->count;
+    result->left_subtree = copy_subtree(copier, other->left_subtree);
+    result->right_subtree = copy_subtree(copier, other->right_subtree);
+
+    return result;
+}
+
+template<typename tkey, typename tvalue, compator<tkey> compare, typename tag>
+void rcu_search_tree<tkey, tvalue, compare, tag>::dispose_subtree(path_copier& copier, node* subtree)
+{
+    if (subtree == nullptr)
+    {
+        return;
+    }
+
+    dispose_subtree(copier, subtree->left_subtree);
+    dispose_subtree(copier, subtree->right_subtree);
+    copier.dispose(subtree);
+}
+
+template<typename tkey, typename tvalue, compator<tkey> compare, typename tag>
+std::pair<typename rcu_search_tree<tkey, tvalue, compare, tag>::node*, typename rcu_search_tree<tkey, tvalue, compare, tag>::node*> rcu_search_tree<tkey, tvalue, compare, tag>::both_halves(path_copier& copier, bulk_operation operation, const split_result& parts, const node* other, size_t threads)
+{
+    if (threads < 2 || count(parts.less) + count(parts.greater) + count(other) < parallel_grain)
+    {
+        node* less = (this->*operation)(copier, parts.less, other->left_subtree, 1);
+        return {less, (this->*operation)(copier, parts.greater, other->right_subtree, 1)};
+    }
+
+    // Halves share no node, each is built by its own copier of the same write. Future is declared after copier, so
+    // that unwinding waits for task before its nodes are freed
+    path_copier forked(*this, copier.write());
+    auto less = std::async(std::launch::async, operation, this, std::ref(forked), parts.less, other->left_subtree, threads / 2);
+    node* greater = (this->*operation)(copier, parts.greater, other->right_subtree, threads - threads / 2);
+    node* result = less.get();
+    copier.adopt(forked);
+
+    return {result, greater};
+}
+
+template<typename tkey, typename tvalue, compator<tkey> compare, typename tag>
+typename rcu_search_tree<tkey, tvalue, compare, tag>::node* rcu_search_tree<tkey, tvalue, compare, tag>::unite_subtrees(path_copier& copier, node* subtree, const node* other, size_t threads)
+{
+    if (other == nullptr)
+    {
+        return subtree;
+    }
+
+    if (subtree == nullptr)
+    {
+        return copy_subtree(copier, other);
+    }
+
+    auto parts = split(copier, subtree, other->key);
+    auto [less, greater] = both_halves(copier, &rcu_search_tree::unite_subtrees, parts, other, threads);
+    node* pivot = parts.equal != nullptr ? parts.equal : copier.create(other->key, other->value);
+
+    return join(copier, less, pivot, greater);
+}
+
+template<typename tkey, typename tvalue, compator<tkey> compare, typename tag>
+typename rcu_search_tree<tkey, tvalue, compare, tag>::node* rcu_search_tree<tkey, tvalue, compare, tag>::intersect_subtrees(path_copier& copier, node* subtree, const node* other, size_t threads)
+{
+    if (subtree == nullptr)
+    {
+        return nullptr;
+    }
+
+    if (other == nullptr)
+    {
+        dispose_subtree(copier, subtree);
+        return nullptr;
+    }
+
+    auto parts = split(copier, subtree, other->key);
+    auto [less, greater] = both_halves(copier, &rcu_search_tree::intersect_subtrees, parts, other, threads);
+
+    return parts.equal != nullptr ? join(copier, less, parts.equal, greater) : join(copier, less, greater);
+}
+
+template<typename tkey, typename tvalue, compator<tkey> compare, typename tag>
+typename rcu_search_tree<tkey, tvalue, compare, tag>::node* rcu_search_tree<tkey, tvalue, compare, tag>::subtract_subtrees(path_copier& copier, node* subtree, const node* other, size_t threads)
+{
+    if (subtree == nullptr || other == nullptr)
+    {
+        return subtree;
+    }
+
+    auto parts = split(copier, subtree, other->key);
+    auto [less, greater] = both_halves(copier, &rcu_search_tree::subtract_subtrees, parts, other, threads);
+
+    if (parts.equal != nullptr)
+    {
+        copier.dispose(parts.equal);
+    }
+
+    return join(copier, less, greater);
+}
+
+template<typename tkey, typename tvalue, compator<tkey> compare, typename tag>
+void rcu_search_tree<tkey, tvalue, compare, tag>::bulk_write(const rcu_search_tree& other, bulk_operation operation, size_t threads)
+{
+    if (threads == 0)
+    {
+        threads = std::max(std::thread::hardware_concurrency(), 1u);
+    }
+
+    std::lock_guard lock(_writer_guard);
+
+    // Other tree may be written meanwhile, pinned version of it is read. It may also be this tree, whose published
+    // nodes are not changed by write either
+    auto version = other.get_snapshot();
+    node* root = _root.load(std::memory_order_relaxed);
+
+    path_copier copier(*this, ++_writes);
+    root = (this->*operation)(copier, root, version._root, threads);
+    copier.publish(root);
+    _size.store(count(root), std::memory_order_relaxed);
+    collect();
+}
+
+template<typename tkey, typename tvalue, compator<tkey> compare, typename tag>
+size_t rcu_search_tree<tkey, tvalue, compare, tag>::count(const node* subtree) noexcept
+{
+    return subtree == nullptr ? 0 : subtree->count;
+}
+
+template<typename tkey, typename tvalue, compator<tkey> compare, typename tag>
+void rcu_search_tree<tkey, tvalue, compare, tag>::recount(node* subtree) noexcept
+{
+    subtree->count = count(subtree->left_subtree) + count(subtree->right_subtree) + 1;
+}
+
+template<typename tkey, typename tvalue, compator<tkey> compare, typename tag>
+rcu_search_tree<tkey, tvalue, compare, tag>::snapshot::snapshot(const rcu_search_tree* tree, epoch_reclaimer::guard&& guard) noexcept
+    : _tree(tree), _guard(std::move(guard)), _root(tree->_root.load(std::memory_order_acquire))
+{
+}
+
+template<typename tkey, typename tvalue, compator<tkey> compare, typename tag>
+template<typename lookup_key>
+const typename rcu_search_tree<tkey, tvalue, compare, tag>::node* rcu_search_tree<tkey, tvalue, compare, tag>::snapshot::lower_bound_node(const lookup_key& key) const
+{
+    const node* current = _root;
+    const node* result = nullptr;
+
+    while (current != nullptr)
+    {
+        if (_tree->compare_keys(current->key, key))
+        {
+            current = current->right_subtree;
+        } else
+        {
+            result = current;
+            current = current->left_subtree;
+        }
+    }
+
+    return result;
+}
+
+template<typename tkey, typename tvalue, compator<tkey> compare, typename tag>
+template<typename lookup_key>
+size_t rcu_search_tree<tkey, tvalue, compare, tag>::snapshot::rank_of(const lookup_key& key) const
+{
+    const node* current = _root;
+    size_t result = 0;
+
+    // Going right passes node and its whole left subtree
+    while (current != nullptr)
+    {
+        if (_tree->compare_keys(current->key, key))
+        {
+            result += count(current->left_subtree) + 1;
+            current = current->right_subtree;
+        } else
+        {
+            current = current->left_subtree;
+        }
+    }
+
+    return result;
+}
+
+template<typename tkey, typename tvalue, compator<tkey> compare, typename tag>
+template<typename result, typename callback>
+result rcu_search_tree<tkey, tvalue, compare, tag>::snapshot::fold_subtree(const node* subtree, const result& empty, callback& visit)
+{
+    if (subtree == nullptr)
+    {
+        return empty;
+    }
+
+    result left = fold_subtree(subtree->left_subtree, empty, visit);
+    result right = fold_subtree(subtree->right_subtree, empty, visit);
+
+    return std::invoke(visit, subtree->key, subtree->balance, subtree->count, left, right);
+}
+
+template<typename tkey, typename tvalue, compator<tkey> compare, typename tag>
+std::optional<tvalue> rcu_search_tree<tkey, tvalue, compare, tag>::snapshot::find(const tkey& key) const
+{
+    const node* result = _tree->find_node(_root, key);
+
+    if (result == nullptr)
+    {
+        return std::nullopt;
+    }
+
+    return result->value;
+}
+
+template<typename tkey, typename tvalue, compator<tkey> compare, typename tag>
+bool rcu_search_tree<tkey, tvalue, compare, tag>::snapshot::contains(const tkey& key) const
+{
+    return _tree->find_node(_root, key) != nullptr;
+}
+
+template<typename tkey, typename tvalue, compator<tkey> compare, typename tag>
+std::optional<typename rcu_search_tree<tkey, tvalue, compare, tag>::tree_data_type> rcu_search_tree<tkey, tvalue, compare, tag>::snapshot::lower_bound(const tkey& key) const
+{
+    const node* result = lower_bound_node(key);
+
+    if (result == nullptr)
+    {
+        return std::nullopt;
+    }
+
+    return tree_data_type(result->key, result->value);
+}
+
+template<typename tkey, typename tvalue, compator<tkey> compare, typename tag>
+template<typename lookup_key> requires transparent_compator_for<compare, lookup_key, tkey>
+std::optional<tvalue> rcu_search_tree<tkey, tvalue, compare, tag>::snapshot::find(const lookup_key& key) const
+{
+    const node* result = _tree->find_node(_root, key);
+
+    if (result == nullptr)
+    {
+        return std::nullopt;
+    }
+
+    return result->value;
+}
+
+template<typename tkey, typename tvalue, compator<tkey> compare, typename tag>
+template<typename lookup_key> requires transparent_compator_for<compare, lookup_key, tkey>
+bool rcu_search_tree<tkey, tvalue, compare, tag>::snapshot::contains(const lookup_key& key) const
+{
+    return _tree->find_node(_root, key) != nullptr;
+}
+
+template<typename tkey, typename tvalue, compator<tkey> compare, typename tag>
+template<typename lookup_key> requires transparent_compator_for<compare, lookup_key, tkey>
+std::optional<typename rcu_search_tree<tkey, tvalue, compare, tag>::tree_data_type> rcu_search_tree<tkey, tvalue, compare, tag>::snapshot::lower_bound(const lookup_key& key) const
+{
+    const node* result = lower_bound_node(key);
+
+    if (result == nullptr)
+    {
+        return std::nullopt;
+    }
+
+    return tree_data_type(result->key, result->value);
+}
+
+template<typename tkey, typename tvalue, compator<tkey> compare, typename tag>
+std::optional<typename rcu_search_tree<tkey, tvalue, compare, tag>::tree_data_type> rcu_search_tree<tkey, tvalue, compare, tag>::snapshot::nth(size_t index) const
+{
+    const node* current = _root;
+
+    while (current != nullptr)
+    {
+        size_t left = count(current->left_subtree);
+
+        if (index < left)
+        {
+            current = current->left_subtree;
+        } else if (index == left)
+        {
+            return tree_data_type(current->key, current->value);
+        } else
+        {
+            index -= left + 1;
+            current = current->right_subtree;
+        }
+    }
+
+    return std::nullopt;
+}
+
+template<typename tkey, typename tvalue, compator<tkey> compare, typename tag>
+size_t rcu_search_tree<tkey, tvalue, compare, tag>::snapshot::rank(const tkey& key) const
+{
+    return rank_of(key);
+}
+
+template<typename tkey, typename tvalue, compator<tkey> compare, typename tag>
+size_t rcu_search_tree<tkey, tvalue, compare, tag>::snapshot::count_range(const tkey& lower, const tkey& upper) const
+{
+    size_t below_upper = rank_of(upper);
+    size_t below_lower = rank_of(lower);
+
+    return below_upper > below_lower ? below_upper - below_lower : 0;
+}
+
+template<typename tkey, typename tvalue, compator<tkey> compare, typename tag>
+template<typename lookup_key> requires transparent_compator_for<compare, lookup_key, tkey>
+size_t rcu_search_tree<tkey, tvalue, compare, tag>::snapshot::rank(const lookup_key& key) const
+{
+    return rank_of(key);
+}
+
+template<typename tkey, typename tvalue, compator<tkey> compare, typename tag>
+template<typename lookup_key> requires transparent_compator_for<compare, lookup_key, tkey>
+size_t rcu_search_tree<tkey, tvalue, compare, tag>::snapshot::count_range(const lookup_key& lower, const lookup_key& upper) const
+{
+    size_t below_upper = rank_of(upper);
+    size_t below_lower = rank_of(lower);
+
+    return below_upper > below_lower ? below_upper - below_lower : 0;
+}
+
+template<typename tkey, typename tvalue, compator<tkey> compare, typename tag>
+template<std::invocable<const tkey&, const tvalue&> callback>
+void rcu_search_tree<tkey, tvalue, compare, tag>::snapshot::for_each(callback&& visit) const
+{
+    std::stack<const node*> path;
+    const node* current = _root;
+
+    while (current != nullptr || !path.empty())
+    {
+        while (current != nullptr)
+        {
+            path.push(current);
+            current = current->left_subtree;
+        }
+
+        current = path.top();
+        path.pop();
+        std::invoke(visit, current->key, current->value);
+        current = current->right_subtree;
+    }
+}
+
+template<typename tkey, typename tvalue, compator<tkey> compare, typename tag>
+template<typename result, typename callback>
+result rcu_search_tree<tkey, tvalue, compare, tag>::snapshot::fold(const result& empty, callback&& visit) const
+{
+    return fold_subtree(_root, empty, visit);
+}
+
+template<typename tkey, typename tvalue, compator<tkey> compare, typename tag>
+rcu_search_tree<tkey, tvalue, compare, tag>::rcu_search_tree(const compare& cmp, pp_allocator<value_type> alloc, logger* logger)
+    : compare(cmp), _allocator(alloc), _logger(logger), _root(nullptr), _size(0), _writes(0)
+{
+}
+
+template<typename tkey, typename tvalue, compator<tkey> compare, typename tag>
+rcu_search_tree<tkey, tvalue, compare, tag>::~rcu_search_tree() noexcept
+{
+    destroy_subtree(_root.load(std::memory_order_acquire));
+
+    for (auto& retired : _retired)
+    {
+        for (auto n : retired)
+        {
+            _allocator.delete_object(n);
+        }
+    }
+}
+
+template<typename tkey, typename tvalue, compator<tkey> compare, typename tag>
+size_t rcu_search_tree<tkey, tvalue, compare, tag>::size() const noexcept
+{
+    return _size.load(std::memory_order_relaxed);
+}
+
+template<typename tkey, typename tvalue, compator<tkey> compare, typename tag>
+bool rcu_search_tree<tkey, tvalue, compare, tag>::empty() const noexcept
+{
+    return size() == 0;
+}
+
+template<typename tkey, typename tvalue, compator<tkey> compare, typename tag>
+typename rcu_search_tree<tkey, tvalue, compare, tag>::snapshot rcu_search_tree<tkey, tvalue, compare, tag>::get_snapshot() const noexcept
+{
+    // Epoch is pinned before root is loaded, so that nodes of loaded version are not freed
+    return snapshot(this, _epochs.pin());
+}
+
+template<typename tkey, typename tvalue, compator<tkey> compare, typename tag>
+std::optional<tvalue> rcu_search_tree<tkey, tvalue, compare, tag>::find(const tkey& key) const
+{
+    return get_snapshot().find(key);
+}
+
+template<typename tkey, typename tvalue, compator<tkey> compare, typename tag>
+bool rcu_search_tree<tkey, tvalue, compare, tag>::contains(const tkey& key) const
+{
+    return get_snapshot().contains(key);
+}
+
+template<typename tkey, typename tvalue, compator<tkey> compare, typename tag>
+std::optional<typename rcu_search_tree<tkey, tvalue, compare, tag>::tree_data_type> rcu_search_tree<tkey, tvalue, compare, tag>::lower_bound(const tkey& key) const
+{
+    return get_snapshot().lower_bound(key);
+}
+
+template<typename tkey, typename tvalue, compator<tkey> compare, typename tag>
+template<typename lookup_key> requires transparent_compator_for<compare, lookup_key, tkey>
+std::optional<tvalue> rcu_search_tree<tkey, tvalue, compare, tag>::find(const lookup_key& key) const
+{
+    return get_snapshot().find(key);
+}
+
+template<typename tkey, typename tvalue, compator<tkey> compare, typename tag>
+template<typename lookup_key> requires transparent_compator_for<compare, lookup_key, tkey>
+bool rcu_search_tree<tkey, tvalue, compare, tag>::contains(const lookup_key& key) const
+{
+    return get_snapshot().contains(key);
+}
+
+template<typename tkey, typename tvalue, compator<tkey> compare, typename tag>
+template<typename lookup_key> requires transparent_compator_for<compare, lookup_key, tkey>
+std::optional<typename rcu_search_tree<tkey, tvalue, compare, tag>::tree_data_type> rcu_search_tree<tkey, tvalue, compare, tag>::lower_bound(const lookup_key& key) const
+{
+    return get_snapshot().lower_bound(key);
+}
+
+template<typename tkey, typename tvalue, compator<tkey> compare, typename tag>
+std::optional<typename rcu_search_tree<tkey, tvalue, compare, tag>::tree_data_type> rcu_search_tree<tkey, tvalue, compare, tag>::nth(size_t index) const
+{
+    return get_snapshot().nth(index);
+}
+
+template<typename tkey, typename tvalue, compator<tkey> compare, typename tag>
+size_t rcu_search_tree<tkey, tvalue, compare, tag>::rank(const tkey& key) const
+{
+    return get_snapshot().rank(key);
+}
+
+template<typename tkey, typename tvalue, compator<tkey> compare, typename tag>
+size_t rcu_search_tree<tkey, tvalue, compare, tag>::count_range(const tkey& lower, const tkey& upper) const
+{
+    return get_snapshot().count_range(lower, upper);
+}
+
+template<typename tkey, typename tvalue, compator<tkey> compare, typename tag>
+template<typename lookup_key> requires transparent_compator_for<compare, lookup_key, tkey>
+size_t rcu_search_tree<tkey, tvalue, compare, tag>::rank(const lookup_key& key) const
+{
+    return get_snapshot().rank(key);
+}
+
+template<typename tkey, typename tvalue, compator<tkey> compare, typename tag>
+template<typename lookup_key> requires transparent_compator_for<compare, lookup_key, tkey>
+size_t rcu_search_tree<tkey, tvalue, compare, tag>::count_range(const lookup_key& lower, const lookup_key& upper) const
+{
+    return get_snapshot().count_range(lower, upper);
+}
+
+template<typename tkey, typename tvalue, compator<tkey> compare, typename tag>
+bool rcu_search_tree<tkey, tvalue, compare, tag>::insert(const tkey& key, const tvalue& value)
+{
+    std::lock_guard lock(_writer_guard);
+
+    // Only writer frees nodes, so it reads current version without pinning
+    node* root = _root.load(std::memory_order_relaxed);
+
+    if (find_node(root, key) != nullptr)
+    {
+        return false;
+    }
+
+    path_copier copier(*this, ++_writes);
+    copier.publish(__detail::rcu_impl<tkey, tvalue, compare, tag>::insert(copier, root, key, value));
+    _size.fetch_add(1, std::memory_order_relaxed);
+    collect();
+
+    return true;
+}
+
+template<typename tkey, typename tvalue, compator<tkey> compare, typename tag>
+bool rcu_search_tree<tkey, tvalue, compare, tag>::insert_or_assign(const tkey& key, const tvalue& value)
+{
+    std::lock_guard lock(_writer_guard);
+
+    node* root = _root.load(std::memory_order_relaxed);
+    path_copier copier(*this, ++_writes);
+    bool inserted = find_node(root, key) == nullptr;
+
+    if (inserted)
+    {
+        copier.publish(__detail::rcu_impl<tkey, tvalue, compare, tag>::insert(copier, root, key, value));
+        _size.fetch_add(1, std::memory_order_relaxed);
+    } else
+    {
+        copier.publish(assign(copier, root, key, value));
+    }
+
+    collect();
+
+    return inserted;
+}
+
+template<typename tkey, typename tvalue, compator<tkey> compare, typename tag>
+bool rcu_search_tree<tkey, tvalue, compare, tag>::erase(const tkey& key)
+{
+    std::lock_guard lock(_writer_guard);
+
+    node* root = _root.load(std::memory_order_relaxed);
+
+    if (find_node(root, key) == nullptr)
+    {
+        return false;
+    }
+
+    path_copier copier(*this, ++_writes);
+    copier.publish(__detail::rcu_impl<tkey, tvalue, compare, tag>::erase(copier, root, key));
+    _size.fetch_sub(1, std::memory_order_relaxed);
+    collect();
+
+    return true;
+}
+
+template<typename tkey, typename tvalue, compator<tkey> compare, typename tag>
+void rcu_search_tree<tkey, tvalue, compare, tag>::reclaim()
+{
+    std::lock_guard lock(_writer_guard);
+
+    // Everything retired so far is freed after two advances, if readers let them happen
+    collect();
+    collect();
+}
+
+template<typename tkey, typename tvalue, compator<tkey> compare, typename tag>
+void rcu_search_tree<tkey, tvalue, compare, tag>::unite(const rcu_search_tree& other, size_t threads)
+{
+    bulk_write(other, &rcu_search_tree::unite_subtrees, threads);
+}
+
+template<typename tkey, typename tvalue, compator<tkey> compare, typename tag>
+void rcu_search_tree<tkey, tvalue, compare, tag>::intersect(const rcu_search_tree& other, size_t threads)
+{
+    bulk_write(other, &rcu_search_tree::intersect_subtrees, threads);
+}
+
+template<typename tkey, typename tvalue, compator<tkey> compare, typename tag>
+void rcu_search_tree<tkey, tvalue, compare, tag>::subtract(const rcu_search_tree& other, size_t threads)
+{
+    bulk_write(other, &rcu_search_tree::subtract_subtrees, threads);
+}
+
+// endregion rcu_search_tree implementation
+
+#endif //MATH_PRACTICE_AND_OPERATING_SYSTEMS_RCU_SEARCH_TREE_H
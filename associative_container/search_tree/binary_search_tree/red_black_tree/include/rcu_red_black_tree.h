@@ -0,0 +1,389 @@
+#ifndef MATH_PRACTICE_AND_OPERATING_SYSTEMS_RCU_RED_BLACK_TREE_H
+#define MATH_PRACTICE_AND_OPERATING_SYSTEMS_RCU_RED_BLACK_TREE_H
+
+#include <rcu_search_tree.h>
+
+namespace __detail
+{
+    class RB_TAG;
+
+    /**
+     * Path-copying red-black insert and erase in left-leaning form, which fixes balance on the way back up the
+     * recursion and so fits copying the path. Node balance is 1 for red and 0 for black.
+    **/
+    template<typename tkey, typename tvalue, typename compare>
+    class rcu_impl<tkey, tvalue, compare, RB_TAG>
+    {
+        friend class rcu_search_tree<tkey, tvalue, compare, RB_TAG>;
+
+        using tree = rcu_search_tree<tkey, tvalue, compare, RB_TAG>;
+        using node = typename tree::node;
+        using path_copier = typename tree::path_copier;
+
+        static constexpr const size_t black = 0;
+        static constexpr const size_t red = 1;
+
+        static bool is_red(const node* subtree) noexcept;
+
+        static node* rotate_left(path_copier& copier, node* subtree);
+
+        static node* rotate_right(path_copier& copier, node* subtree);
+
+        static void flip_colors(path_copier& copier, node* subtree);
+
+        static node* fix_up(path_copier& copier, node* subtree);
+
+        static node* move_red_left(path_copier& copier, node* subtree);
+
+        static node* move_red_right(path_copier& copier, node* subtree);
+
+        static node* insert_node(path_copier& copier, node* subtree, const tkey& key, const tvalue& value);
+
+        static node* erase_node(path_copier& copier, node* subtree, const tkey& key);
+
+        static node* erase_minimum(path_copier& copier, node* subtree, node*& minimum);
+
+        static node* insert(path_copier& copier, node* subtree, const tkey& key, const tvalue& value);
+
+        static node* erase(path_copier& copier, node* subtree, const tkey& key);
+
+        /*
+         * Black nodes on path from subtree down to leaf. Heights are not stored in nodes, so join counts them along
+         * left spine in O(log n)
+         */
+        static size_t black_height(const node* subtree) noexcept;
+
+        static node* blacken(path_copier& copier, node* subtree);
+
+        /*
+         * Hangs pivot as red node with shorter tree down the spine of taller one, where black heights are equal, and
+         * fixes the way back as insert does
+         */
+        static node* join(path_copier& copier, node* less, node* pivot, node* greater);
+
+        static node* join_right(path_copier& copier, node* less, node* pivot, node* greater, size_t less_height, size_t greater_height);
+
+        static node* join_left(path_copier& copier, node* less, node* pivot, node* greater, size_t less_height, size_t greater_height);
+    };
+}
+
+template<typename tkey, typename tvalue, compator<tkey> compare = std::less<tkey>>
+using rcu_red_black_tree = rcu_search_tree<tkey, tvalue, compare, __detail::RB_TAG>;
+
+template<typename tkey, typename tvalue, typename compare>
+bool __detail::rcu_impl<tkey, tvalue, compare, __detail::RB_TAG>::is_red(const node* subtree) noexcept
+{
+    return subtree != nullptr && subtree->balance == red;
+}
+
+template<typename tkey, typename tvalue, typename compare>
+typename __detail::rcu_impl<tkey, tvalue, compare, __detail::RB_TAG>::node* __detail::rcu_impl<tkey, tvalue, compare, __detail::RB_TAG>::rotate_left(path_copier& copier, node* subtree)
+{
+    node* right = copier.own(subtree->right_subtree);
+
+    subtree->right_subtree = right->left_subtree;
+    right->left_subtree = subtree;
+    right->balance = subtree->balance;
+    subtree->balance = red;
+    tree::recount(subtree);
+    tree::recount(right);
+
+    return right;
+}
+
+template<typename tkey, typename tvalue, typename compare>
+typename __detail::rcu_impl<tkey, tvalue, compare, __detail::RB_TAG>::node* __detail::rcu_impl<tkey, tvalue, compare, __detail::RB_TAG>::rotate_right(path_copier& copier, node* subtree)
+{
+    node* left = copier.own(subtree->left_subtree);
+
+    subtree->left_subtree = left->right_subtree;
+    left->right_subtree = subtree;
+    left->balance = subtree->balance;
+    subtree->balance = red;
+    tree::recount(subtree);
+    tree::recount(left);
+
+    return left;
+}
+
+template<typename tkey, typename tvalue, typename compare>
+void __detail::rcu_impl<tkey, tvalue, compare, __detail::RB_TAG>::flip_colors(path_copier& copier, node* subtree)
+{
+    subtree->balance ^= 1;
+
+    if (subtree->left_subtree != nullptr)
+    {
+        subtree->left_subtree = copier.own(subtree->left_subtree);
+        subtree->left_subtree->balance ^= 1;
+    }
+
+    if (subtree->right_subtree != nullptr)
+    {
+        subtree->right_subtree = copier.own(subtree->right_subtree);
+        subtree->right_subtree->balance ^= 1;
+    }
+}
+
+template<typename tkey, typename tvalue, typename compare>
+typename __detail::rcu_impl<tkey, tvalue, compare, __detail::RB_TAG>::node* __detail::rcu_impl<tkey, tvalue, compare, __detail::RB_TAG>::fix_up(path_copier& copier, node* subtree)
+{
+    // Every node whose child was replaced on the way down comes back through here
+    tree::recount(subtree);
+
+    if (is_red(subtree->right_subtree) && !is_red(subtree->left_subtree))
+    {
+        subtree = rotate_left(copier, subtree);
+    }
+
+    if (is_red(subtree->left_subtree) && is_red(subtree->left_subtree->left_subtree))
+    {
+        subtree = rotate_right(copier, subtree);
+    }
+
+    if (is_red(subtree->left_subtree) && is_red(subtree->right_subtree))
+    {
+        flip_colors(copier, subtree);
+    }
+
+    return subtree;
+}
+
+template<typename tkey, typename tvalue, typename compare>
+typename __detail::rcu_impl<tkey, tvalue, compare, __detail::RB_TAG>::node* __detail::rcu_impl<tkey, tvalue, compare, __detail::RB_TAG>::move_red_left(path_copier& copier, node* subtree)
+{
+    flip_colors(copier, subtree);
+
+    if (is_red(subtree->right_subtree->left_subtree))
+    {
+        subtree->right_subtree = rotate_right(copier, subtree->right_subtree);
+        subtree = rotate_left(copier, subtree);
+        flip_colors(copier, subtree);
+    }
+
+    return subtree;
+}
+
+template<typename tkey, typename tvalue, typename compare>
+typename __detail::rcu_impl<tkey, tvalue, compare, __detail::RB_TAG>::node* __detail::rcu_impl<tkey, tvalue, compare, __detail::RB_TAG>::move_red_right(path_copier& copier, node* subtree)
+{
+    flip_colors(copier, subtree);
+
+    if (is_red(subtree->left_subtree->left_subtree))
+    {
+        subtree = rotate_right(copier, subtree);
+        flip_colors(copier, subtree);
+    }
+
+    return subtree;
+}
+
+template<typename tkey, typename tvalue, typename compare>
+typename __detail::rcu_impl<tkey, tvalue, compare, __detail::RB_TAG>::node* __detail::rcu_impl<tkey, tvalue, compare, __detail::RB_TAG>::insert_node(path_copier& copier, node* subtree, const tkey& key, const tvalue& value)
+{
+    if (subtree == nullptr)
+    {
+        return copier.create(key, value, red);
+    }
+
+    subtree = copier.own(subtree);
+
+    if (copier.compare_keys(key, subtree->key))
+    {
+        subtree->left_subtree = insert_node(copier, subtree->left_subtree, key, value);
+    } else
+    {
+        subtree->right_subtree = insert_node(copier, subtree->right_subtree, key, value);
+    }
+
+    return fix_up(copier, subtree);
+}
+
+template<typename tkey, typename tvalue, typename compare>
+typename __detail::rcu_impl<tkey, tvalue, compare, __detail::RB_TAG>::node* __detail::rcu_impl<tkey, tvalue, compare, __detail::RB_TAG>::erase_node(path_copier& copier, node* subtree, const tkey& key)
+{
+    subtree = copier.own(subtree);
+
+    if (copier.compare_keys(key, subtree->key))
+    {
+        if (!is_red(subtree->left_subtree) && !is_red(subtree->left_subtree->left_subtree))
+        {
+            subtree = move_red_left(copier, subtree);
+        }
+
+        subtree->left_subtree = erase_node(copier, subtree->left_subtree, key);
+        return fix_up(copier, subtree);
+    }
+
+    if (is_red(subtree->left_subtree))
+    {
+        subtree = rotate_right(copier, subtree);
+    }
+
+    if (!copier.compare_keys(subtree->key, key) && subtree->right_subtree == nullptr)
+    {
+        // Left-leaning node without right child has no left child either
+        copier.dispose(subtree);
+        return nullptr;
+    }
+
+    if (!is_red(subtree->right_subtree) && !is_red(subtree->right_subtree->left_subtree))
+    {
+        subtree = move_red_right(copier, subtree);
+    }
+
+    if (!copier.compare_keys(subtree->key, key))
+    {
+        node* minimum;
+        subtree->right_subtree = erase_minimum(copier, subtree->right_subtree, minimum);
+        subtree->key = minimum->key;
+        subtree->value = minimum->value;
+        copier.dispose(minimum);
+    } else
+    {
+        subtree->right_subtree = erase_node(copier, subtree->right_subtree, key);
+    }
+
+    return fix_up(copier, subtree);
+}
+
+template<typename tkey, typename tvalue, typename compare>
+typename __detail::rcu_impl<tkey, tvalue, compare, __detail::RB_TAG>::node* __detail::rcu_impl<tkey, tvalue, compare, __detail::RB_TAG>::erase_minimum(path_copier& copier, node* subtree, node*& minimum)
+{
+    if (subtree->left_subtree == nullptr)
+    {
+        minimum = subtree;
+        return nullptr;
+    }
+
+    subtree = copier.own(subtree);
+
+    if (!is_red(subtree->left_subtree) && !is_red(subtree->left_subtree->left_subtree))
+    {
+        subtree = move_red_left(copier, subtree);
+    }
+
+    subtree->left_subtree = erase_minimum(copier, subtree->left_subtree, minimum);
+    return fix_up(copier, subtree);
+}
+
+template<typename tkey, typename tvalue, typename compare>
+typename __detail::rcu_impl<tkey, tvalue, compare, __detail::RB_TAG>::node* __detail::rcu_impl<tkey, tvalue, compare, __detail::RB_TAG>::insert(path_copier& copier, node* subtree, const tkey& key, const tvalue& value)
+{
+    node* root = insert_node(copier, subtree, key, value);
+    root->balance = black;
+    return root;
+}
+
+template<typename tkey, typename tvalue, typename compare>
+typename __detail::rcu_impl<tkey, tvalue, compare, __detail::RB_TAG>::node* __detail::rcu_impl<tkey, tvalue, compare, __detail::RB_TAG>::erase(path_copier& copier, node* subtree, const tkey& key)
+{
+    subtree = copier.own(subtree);
+
+    if (!is_red(subtree->left_subtree) && !is_red(subtree->right_subtree))
+    {
+        subtree->balance = red;
+    }
+
+    node* root = erase_node(copier, subtree, key);
+
+    if (root != nullptr)
+    {
+        root->balance = black;
+    }
+
+    return root;
+}
+
+template<typename tkey, typename tvalue, typename compare>
+size_t __detail::rcu_impl<tkey, tvalue, compare, __detail::RB_TAG>::black_height(const node* subtree) noexcept
+{
+    size_t result = 0;
+
+    for (; subtree != nullptr; subtree = subtree->left_subtree)
+    {
+        if (!is_red(subtree))
+        {
+            ++result;
+        }
+    }
+
+    return result;
+}
+
+template<typename tkey, typename tvalue, typename compare>
+typename __detail::rcu_impl<tkey, tvalue, compare, __detail::RB_TAG>::node* __detail::rcu_impl<tkey, tvalue, compare, __detail::RB_TAG>::blacken(path_copier& copier, node* subtree)
+{
+    if (is_red(subtree))
+    {
+        subtree = copier.own(subtree);
+        subtree->balance = black;
+    }
+
+    return subtree;
+}
+
+template<typename tkey, typename tvalue, typename compare>
+typename __detail::rcu_impl<tkey, tvalue, compare, __detail::RB_TAG>::node* __detail::rcu_impl<tkey, tvalue, compare, __detail::RB_TAG>::join(path_copier& copier, node* less, node* pivot, node* greater)
+{
+    // Split leaves subtrees whose roots may be red, black roots keep both trees valid and make spines start black
+    less = blacken(copier, less);
+    greater = blacken(copier, greater);
+
+    size_t less_height = black_height(less);
+    size_t greater_height = black_height(greater);
+    node* result;
+
+    if (less_height > greater_height)
+    {
+        result = join_right(copier, less, pivot, greater, less_height, greater_height);
+    } else if (greater_height > less_height)
+    {
+        result = join_left(copier, less, pivot, greater, less_height, greater_height);
+    } else
+    {
+        pivot->left_subtree = less;
+        pivot->right_subtree = greater;
+        pivot->balance = black;
+        tree::recount(pivot);
+        result = pivot;
+    }
+
+    return blacken(copier, result);
+}
+
+template<typename tkey, typename tvalue, typename compare>
+typename __detail::rcu_impl<tkey, tvalue, compare, __detail::RB_TAG>::node* __detail::rcu_impl<tkey, tvalue, compare, __detail::RB_TAG>::join_right(path_copier& copier, node* less, node* pivot, node* greater, size_t less_height, size_t greater_height)
+{
+    if (!is_red(less) && less_height == greater_height)
+    {
+        pivot->left_subtree = less;
+        pivot->right_subtree = greater;
+        pivot->balance = red;
+        tree::recount(pivot);
+        return pivot;
+    }
+
+    less = copier.own(less);
+    less->right_subtree = join_right(copier, less->right_subtree, pivot, greater, is_red(less) ? less_height : less_height - 1, greater_height);
+    return fix_up(copier, less);
+}
+
+template<typename tkey, typename tvalue, typename compare>
+typename __detail::rcu_impl<tkey, tvalue, compare, __detail::RB_TAG>::node* __detail::rcu_impl<tkey, tvalue, compare, __detail::RB_TAG>::join_left(path_copier& copier, node* less, node* pivot, node* greater, size_t less_height, size_t greater_height)
+{
+    // Left spine may have red nodes, which do not count in black height
+    if (!is_red(greater) && greater_height == less_height)
+    {
+        pivot->left_subtree = less;
+        pivot->right_subtree = greater;
+        pivot->balance = red;
+        tree::recount(pivot);
+        return pivot;
+    }
+
+    greater = copier.own(greater);
+    greater->left_subtree = join_left(copier, less, pivot, greater->left_subtree, less_height, is_red(greater) ? greater_height : greater_height - 1);
+    return fix_up(copier, greater);
+}
+
+#endif //MATH_PRACTICE_AND_OPERATING_SYSTEMS_RCU_RED_BLACK_TREE_H
@@ -0,0 +1,299 @@
+#include "gtest/gtest.h"
+#include <rcu_red_black_tree.h>
+#include <atomic>
+#include <optional>
+#include <random>
+#include <thread>
+#include <tuple>
+#include <algorithm>
+#include <map>
+
+/*
+ * Checks that current version is left-leaning red-black tree: no red right child, no red node with red left child,
+ * equal black height on every path, and stored counts add up to size of tree. Node balance is 1 for red
+ */
+template<typename tree_type>
+bool balanced(const tree_type &tree)
+{
+    // Black height, count and color of subtree, nullopt once any node below breaks them
+    using shape = std::optional<std::tuple<size_t, size_t, size_t>>;
+
+    auto root = tree.get_snapshot().fold(shape(std::make_tuple(0, 0, 0)), [](auto const &, size_t balance, size_t count, const shape &left, const shape &right) -> shape
+    {
+        if (!left.has_value() || !right.has_value())
+        {
+            return std::nullopt;
+        }
+
+        auto [left_height, left_count, left_color] = *left;
+        auto [right_height, right_count, right_color] = *right;
+
+        if (balance > 1 || right_color == 1 || (balance == 1 && left_color == 1) || left_height != right_height || count != left_count + right_count + 1)
+        {
+            return std::nullopt;
+        }
+
+        return std::make_tuple(left_height + (balance == 0 ? 1 : 0), count, balance);
+    });
+
+    return root.has_value() && std::get<1>(*root) == tree.size();
+}
+
+TEST(rcuRedBlackTreeTests, test1)
+{
+    rcu_red_black_tree<int, int> tree;
+    std::map<int, int> expected;
+    std::mt19937 gen(11);
+
+    for (int i = 0; i < 20000; ++i)
+    {
+        int key = static_cast<int>(gen() % 1000);
+
+        switch (gen() % 3)
+        {
+            case 0:
+                EXPECT_EQ(tree.insert(key, i), expected.emplace(key, i).second);
+                break;
+            case 1:
+                EXPECT_EQ(tree.erase(key), expected.erase(key) == 1);
+                break;
+            default:
+                EXPECT_EQ(tree.insert_or_assign(key, i), !expected.contains(key));
+                expected[key] = i;
+                break;
+        }
+    }
+
+    std::vector<std::pair<const int, int>> actual;
+    tree.get_snapshot().for_each([&actual](int key, int value)
+    {
+        actual.emplace_back(key, value);
+    });
+
+    EXPECT_EQ(tree.size(), expected.size());
+    EXPECT_TRUE(std::equal(actual.begin(), actual.end(), expected.begin(), expected.end()));
+    EXPECT_TRUE(balanced(tree));
+
+    auto bound = expected.lower_bound(500);
+    EXPECT_EQ(tree.lower_bound(500), std::make_optional(std::make_pair(bound->first, bound->second)));
+}
+
+TEST(rcuRedBlackTreeTests, test2)
+{
+    constexpr int readers = 4;
+    constexpr int keys = 20000;
+
+    rcu_red_black_tree<int, int> tree;
+    std::atomic<int> published = 0;
+    std::atomic<bool> done = false;
+    std::atomic<size_t> misses = 0;
+
+    // Even keys stay once inserted, odd ones come and go, so readers may check even keys below published
+    std::vector<std::thread> threads;
+
+    for (int r = 0; r < readers; ++r)
+    {
+        threads.emplace_back([&, r]()
+        {
+            std::mt19937 gen(r);
+
+            while (!done.load())
+            {
+                int bound = published.load();
+
+                if (bound == 0)
+                {
+                    continue;
+                }
+
+                auto snapshot = tree.get_snapshot();
+                int key = static_cast<int>(gen() % bound) & ~1;
+
+                if (snapshot.find(key) != std::optional<int>(key) || snapshot.find(key) != tree.find(key))
+                {
+                    ++misses;
+                }
+            }
+        });
+    }
+
+    for (int key = 0; key < keys; ++key)
+    {
+        tree.insert(key, key);
+
+        if (key % 2 == 1)
+        {
+            tree.erase(key - 2);
+        }
+
+        published.store(key + 1);
+    }
+
+    done.store(true);
+
+    for (auto &thread: threads)
+    {
+        thread.join();
+    }
+
+    tree.reclaim();
+
+    EXPECT_EQ(misses.load(), 0);
+    EXPECT_EQ(tree.size(), size_t(keys / 2 + 1));
+    EXPECT_TRUE(balanced(tree));
+}
+
+TEST(rcuRedBlackTreeTests, test3)
+{
+    rcu_red_black_tree<int, int> tree;
+    std::map<int, int> expected;
+    std::mt19937 gen(32);
+
+    auto check = [&tree, &expected, &gen]()
+    {
+        ASSERT_TRUE(balanced(tree));
+        ASSERT_EQ(tree.nth(expected.size()), std::nullopt);
+
+        size_t index = 0;
+
+        for (auto &[key, value]: expected)
+        {
+            ASSERT_EQ(tree.nth(index), std::make_optional(std::make_pair(key, value)));
+            ASSERT_EQ(tree.rank(key), index);
+            ++index;
+        }
+
+        for (int i = 0; i < 100; ++i)
+        {
+            int lower = static_cast<int>(gen() % 1100) - 50;
+            int upper = static_cast<int>(gen() % 1100) - 50;
+
+            auto first = expected.lower_bound(lower);
+            auto last = expected.lower_bound(upper);
+
+            EXPECT_EQ(tree.rank(lower), static_cast<size_t>(std::distance(expected.begin(), first)));
+            EXPECT_EQ(tree.count_range(lower, upper), lower < upper ? static_cast<size_t>(std::distance(first, last)) : 0);
+        }
+    };
+
+    for (int round = 0; round < 10; ++round)
+    {
+        for (int i = 0; i < 1000; ++i)
+        {
+            int key = static_cast<int>(gen() % 1000);
+
+            if (gen() % 3 == 0)
+            {
+                EXPECT_EQ(tree.erase(key), expected.erase(key) == 1);
+            } else
+            {
+                tree.insert_or_assign(key, i);
+                expected[key] = i;
+            }
+        }
+
+        check();
+    }
+
+    // Snapshot keeps counts of its own version while tree changes
+    auto snapshot = tree.get_snapshot();
+    size_t before = expected.size();
+
+    for (int key = 0; key < 1000; key += 2)
+    {
+        tree.erase(key);
+    }
+
+    EXPECT_EQ(snapshot.count_range(0, 1000), before);
+    EXPECT_EQ(snapshot.nth(before - 1)->first, expected.rbegin()->first);
+    EXPECT_EQ(tree.count_range(0, 1000), tree.size());
+    EXPECT_TRUE(balanced(tree));
+}
+
+TEST(rcuRedBlackTreeTests, test4)
+{
+    std::mt19937 gen(64);
+
+    auto fill = [&gen](auto &tree, std::map<int, int> &expected, int keys, int value)
+    {
+        for (int i = 0; i < keys; ++i)
+        {
+            int key = static_cast<int>(gen() % 30000);
+            tree.insert(key, value);
+            expected.emplace(key, value);
+        }
+    };
+
+    auto equal = [](const auto &tree, const std::map<int, int> &expected)
+    {
+        std::vector<std::pair<const int, int>> actual;
+        tree.get_snapshot().for_each([&actual](int key, int value)
+        {
+            actual.emplace_back(key, value);
+        });
+
+        EXPECT_EQ(tree.size(), expected.size());
+        EXPECT_TRUE(std::equal(actual.begin(), actual.end(), expected.begin(), expected.end()));
+        EXPECT_TRUE(balanced(tree));
+
+        if (!expected.empty())
+        {
+            auto middle = std::next(expected.begin(), static_cast<long>(expected.size() / 2));
+            EXPECT_EQ(tree.nth(expected.size() / 2), std::make_optional(std::make_pair(middle->first, middle->second)));
+            EXPECT_EQ(tree.rank(middle->first), expected.size() / 2);
+        }
+    };
+
+    for (size_t threads: {1, 4})
+    {
+        rcu_red_black_tree<int, int> tree, other;
+        std::map<int, int> expected, added;
+
+        fill(tree, expected, 12000, 1);
+        fill(other, added, 9000, 2);
+
+        // Snapshot taken before keeps its version, equal keys keep values of tree
+        auto before = tree.get_snapshot();
+        size_t size = expected.size();
+
+        tree.unite(other, threads);
+        expected.insert(added.begin(), added.end());
+        equal(tree, expected);
+        EXPECT_EQ(before.count_range(0, 30000), size);
+
+        std::map<int, int> removed;
+        rcu_red_black_tree<int, int> subtrahend;
+        fill(subtrahend, removed, 8000, 3);
+
+        tree.subtract(subtrahend, threads);
+        std::erase_if(expected, [&removed](auto &pair) { return removed.contains(pair.first); });
+        equal(tree, expected);
+
+        tree.intersect(other, threads);
+        std::erase_if(expected, [&added](auto &pair) { return !added.contains(pair.first); });
+        equal(tree, expected);
+
+        // Result stays balanced enough for usual writes
+        for (int key = 0; key < 30000; key += 7)
+        {
+            EXPECT_EQ(tree.erase(key), expected.erase(key) == 1);
+        }
+
+        equal(tree, expected);
+
+        tree.subtract(tree, threads);
+        EXPECT_TRUE(tree.empty());
+
+        tree.unite(other, threads);
+        equal(tree, added);
+    }
+}
+
+int main(
+    int argc,
+    char **argv)
+{
+    testing::InitGoogleTest(&argc, argv);
+
+    return RUN_ALL_TESTS();
+}
\ No newline at end of file
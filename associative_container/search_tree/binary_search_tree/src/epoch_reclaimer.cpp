@@ -0,0 +1,97 @@
+#include <functional>
+#include <thread>
+#include "../include/epoch_reclaimer.h"
+
+epoch_reclaimer::guard::guard(std::atomic<size_t>* counter) noexcept
+    : _counter(counter)
+{
+}
+
+epoch_reclaimer::guard::guard(guard&& other) noexcept
+    : _counter(other._counter)
+{
+    other._counter = nullptr;
+}
+
+epoch_reclaimer::guard& epoch_reclaimer::guard::operator=(guard&& other) noexcept
+{
+    if (this != &other)
+    {
+        if (_counter != nullptr)
+        {
+            _counter->fetch_sub(1, std::memory_order_release);
+        }
+
+        _counter = other._counter;
+        other._counter = nullptr;
+    }
+
+    return *this;
+}
+
+epoch_reclaimer::guard::~guard() noexcept
+{
+    if (_counter != nullptr)
+    {
+        _counter->fetch_sub(1, std::memory_order_release);
+    }
+}
+
+epoch_reclaimer::epoch_reclaimer() noexcept
+    : _epoch(0)
+{
+    for (auto& item : _stripes)
+    {
+        item._readers[0].store(0, std::memory_order_relaxed);
+        item._readers[1].store(0, std::memory_order_relaxed);
+    }
+}
+
+size_t epoch_reclaimer::stripe_index() noexcept
+{
+    static thread_local const size_t index = std::hash<std::thread::id>()(std::this_thread::get_id()) % stripes;
+    return index;
+}
+
+epoch_reclaimer::guard epoch_reclaimer::pin() const noexcept
+{
+    auto& readers = _stripes[stripe_index()]._readers;
+
+    while (true)
+    {
+        uint64_t epoch = _epoch.load();
+        auto& counter = readers[epoch & 1];
+
+        counter.fetch_add(1);
+
+        // Writer may have checked this parity and advanced in between, then it counts readers of another epoch
+        if (_epoch.load() == epoch)
+        {
+            return guard(&counter);
+        }
+
+        counter.fetch_sub(1, std::memory_order_release);
+    }
+}
+
+uint64_t epoch_reclaimer::current() const noexcept
+{
+    return _epoch.load();
+}
+
+bool epoch_reclaimer::try_advance() noexcept
+{
+    uint64_t epoch = _epoch.load();
+    size_t previous = (epoch + 1) & 1;
+
+    for (auto& item : _stripes)
+    {
+        if (item._readers[previous].load() != 0)
+        {
+            return false;
+        }
+    }
+
+    _epoch.store(epoch + 1);
+    return true;
+}
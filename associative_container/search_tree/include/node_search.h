@@ -0,0 +1,263 @@
+#ifndef MATH_PRACTICE_AND_OPERATING_SYSTEMS_NODE_SEARCH_H
+#define MATH_PRACTICE_AND_OPERATING_SYSTEMS_NODE_SEARCH_H
+
+#include <bit>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <type_traits>
+#include <boost/container/static_vector.hpp>
+
+#if defined(__SSE2__) || defined(_M_X64) || defined(_M_IX86)
+#include <immintrin.h>
+#endif
+
+/**
+ * Tells whether in-node search for tkey ordered by compare may run over plain key array with vector compares
+ * instead of comparator calls. True for 4 and 8 byte arithmetic keys with default ordering, can be specialized
+ * for own key types which are ordered the same way as one of those.
+**/
+template<typename tkey, typename compare>
+struct vectorized_key_search : std::bool_constant<
+        (std::same_as<compare, std::less<tkey>> || std::same_as<compare, std::less<>>) &&
+        (std::integral<tkey> || std::floating_point<tkey>) && !std::same_as<tkey, bool> &&
+        (sizeof(tkey) == 4 || sizeof(tkey) == 8)>
+{
+};
+
+template<typename tkey, typename compare>
+inline constexpr bool vectorized_key_search_v = vectorized_key_search<tkey, compare>::value;
+
+namespace __detail
+{
+    /*
+     * Counts keys below key in sorted keys[0, count), "below" is "<" or "<=" when or_equal.
+     * Every element is compared, so there are no branches depending on data.
+     */
+    template<bool or_equal, typename tkey>
+    size_t count_below_linear(const tkey* keys, size_t count, tkey key) noexcept
+    {
+        size_t result = 0, i = 0;
+
+#if defined(__AVX2__)
+        if constexpr (std::integral<tkey> && sizeof(tkey) == 4)
+        {
+            // Unsigned keys are compared as signed ones with flipped sign bit
+            const __m256i flip = _mm256_set1_epi32(std::is_signed_v<tkey> ? 0 : INT32_MIN);
+            const __m256i needle = _mm256_xor_si256(_mm256_set1_epi32(static_cast<int32_t>(key)), flip);
+
+            for (; i + 8 <= count; i += 8)
+            {
+                __m256i item = _mm256_xor_si256(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(keys + i)), flip);
+                __m256i mask = or_equal ? _mm256_cmpgt_epi32(item, needle) : _mm256_cmpgt_epi32(needle, item);
+                size_t bits = std::popcount(static_cast<unsigned>(_mm256_movemask_ps(_mm256_castsi256_ps(mask))));
+                result += or_equal ? 8 - bits : bits;
+            }
+        } else if constexpr (std::integral<tkey> && sizeof(tkey) == 8)
+        {
+            const __m256i flip = _mm256_set1_epi64x(std::is_signed_v<tkey> ? 0 : INT64_MIN);
+            const __m256i needle = _mm256_xor_si256(_mm256_set1_epi64x(static_cast<int64_t>(key)), flip);
+
+            for (; i + 4 <= count; i += 4)
+            {
+                __m256i item = _mm256_xor_si256(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(keys + i)), flip);
+                __m256i mask = or_equal ? _mm256_cmpgt_epi64(item, needle) : _mm256_cmpgt_epi64(needle, item);
+                size_t bits = std::popcount(static_cast<unsigned>(_mm256_movemask_pd(_mm256_castsi256_pd(mask))));
+                result += or_equal ? 4 - bits : bits;
+            }
+        } else if constexpr (std::same_as<tkey, float>)
+        {
+            const __m256 needle = _mm256_set1_ps(key);
+
+            for (; i + 8 <= count; i += 8)
+            {
+                __m256 item = _mm256_loadu_ps(keys + i);
+                __m256 mask = or_equal ? _mm256_cmp_ps(item, needle, _CMP_LE_OQ) : _mm256_cmp_ps(item, needle, _CMP_LT_OQ);
+                result += std::popcount(static_cast<unsigned>(_mm256_movemask_ps(mask)));
+            }
+        } else if constexpr (std::same_as<tkey, double>)
+        {
+            const __m256d needle = _mm256_set1_pd(key);
+
+            for (; i + 4 <= count; i += 4)
+            {
+                __m256d item = _mm256_loadu_pd(keys + i);
+                __m256d mask = or_equal ? _mm256_cmp_pd(item, needle, _CMP_LE_OQ) : _mm256_cmp_pd(item, needle, _CMP_LT_OQ);
+                result += std::popcount(static_cast<unsigned>(_mm256_movemask_pd(mask)));
+            }
+        }
+#elif defined(__SSE2__)
+        if constexpr (std::integral<tkey> && sizeof(tkey) == 4)
+        {
+            const __m128i flip = _mm_set1_epi32(std::is_signed_v<tkey> ? 0 : INT32_MIN);
+            const __m128i needle = _mm_xor_si128(_mm_set1_epi32(static_cast<int32_t>(key)), flip);
+
+            for (; i + 4 <= count; i += 4)
+            {
+                __m128i item = _mm_xor_si128(_mm_loadu_si128(reinterpret_cast<const __m128i*>(keys + i)), flip);
+                __m128i mask = or_equal ? _mm_cmpgt_epi32(item, needle) : _mm_cmpgt_epi32(needle, item);
+                size_t bits = std::popcount(static_cast<unsigned>(_mm_movemask_ps(_mm_castsi128_ps(mask))));
+                result += or_equal ? 4 - bits : bits;
+            }
+        }
+#if defined(__SSE4_2__)
+        else if constexpr (std::integral<tkey> && sizeof(tkey) == 8)
+        {
+            const __m128i flip = _mm_set1_epi64x(std::is_signed_v<tkey> ? 0 : INT64_MIN);
+            const __m128i needle = _mm_xor_si128(_mm_set1_epi64x(static_cast<int64_t>(key)), flip);
+
+            for (; i + 2 <= count; i += 2)
+            {
+                __m128i item = _mm_xor_si128(_mm_loadu_si128(reinterpret_cast<const __m128i*>(keys + i)), flip);
+                __m128i mask = or_equal ? _mm_cmpgt_epi64(item, needle) : _mm_cmpgt_epi64(needle, item);
+                size_t bits = std::popcount(static_cast<unsigned>(_mm_movemask_pd(_mm_castsi128_pd(mask))));
+                result += or_equal ? 2 - bits : bits;
+            }
+        }
+#endif
+        else if constexpr (std::same_as<tkey, float>)
+        {
+            const __m128 needle = _mm_set1_ps(key);
+
+            for (; i + 4 <= count; i += 4)
+            {
+                __m128 item = _mm_loadu_ps(keys + i);
+                __m128 mask = or_equal ? _mm_cmple_ps(item, needle) : _mm_cmplt_ps(item, needle);
+                result += std::popcount(static_cast<unsigned>(_mm_movemask_ps(mask)));
+            }
+        } else if constexpr (std::same_as<tkey, double>)
+        {
+            const __m128d needle = _mm_set1_pd(key);
+
+            for (; i + 2 <= count; i += 2)
+            {
+                __m128d item = _mm_loadu_pd(keys + i);
+                __m128d mask = or_equal ? _mm_cmple_pd(item, needle) : _mm_cmplt_pd(item, needle);
+                result += std::popcount(static_cast<unsigned>(_mm_movemask_pd(mask)));
+            }
+        }
+#endif
+
+        for (; i < count; ++i)
+        {
+            result += or_equal ? !(key < keys[i]) : keys[i] < key;
+        }
+
+        return result;
+    }
+
+    /*
+     * Branchless binary search narrows sorted keys down to a couple of cache lines, which are then scanned linearly.
+     */
+    template<bool or_equal, typename tkey>
+    size_t count_below(const tkey* keys, size_t count, tkey key) noexcept
+    {
+        constexpr size_t window = 128 / sizeof(tkey);
+
+        const tkey* base = keys;
+
+        while (count > window)
+        {
+            size_t half = count / 2;
+            base = (or_equal ? !(key < base[half]) : base[half] < key) ? base + half : base;
+            count -= half;
+        }
+
+        return static_cast<size_t>(base - keys) + count_below_linear<or_equal>(base, count, key);
+    }
+
+    /*
+     * Asks for cache lines of [data, data + bytes) to be loaded ahead of use, does nothing where not supported
+     */
+    inline void prefetch(const void* data, size_t bytes) noexcept
+    {
+        constexpr size_t cache_line = 64;
+
+        for (size_t offset = 0; offset < bytes; offset += cache_line)
+        {
+#if defined(__GNUC__) || defined(__clang__)
+            __builtin_prefetch(static_cast<const char*>(data) + offset);
+#elif defined(_M_X64) || defined(_M_IX86)
+            _mm_prefetch(static_cast<const char*>(data) + offset, _MM_HINT_T0);
+#endif
+        }
+    }
+
+    /*
+     * Index of the first key not less than key
+     */
+    template<typename tkey>
+    size_t keys_lower_bound(const tkey* keys, size_t count, tkey key) noexcept
+    {
+        return count_below<false>(keys, count, key);
+    }
+
+    /*
+     * Index of the first key greater than key
+     */
+    template<typename tkey>
+    size_t keys_upper_bound(const tkey* keys, size_t count, tkey key) noexcept
+    {
+        return count_below<true>(keys, count, key);
+    }
+}
+
+/**
+ * Keys of node stored apart from their values, so that search reads only keys. Owner node has to keep it equal to
+ * keys of its key-value pairs. Holds nothing when search is not vectorized.
+**/
+template<typename tkey, size_t capacity, bool enabled>
+struct node_search_keys
+{
+    boost::container::static_vector<tkey, capacity> _keys;
+
+    template<typename pairs>
+    void assign(const pairs& data)
+    {
+        _keys.clear();
+        for (auto const& item : data)
+        {
+            _keys.push_back(item.first);
+        }
+    }
+
+    void insert(size_t index, const tkey& key)
+    {
+        _keys.insert(_keys.begin() + index, key);
+    }
+
+    void erase(size_t index)
+    {
+        _keys.erase(_keys.begin() + index);
+    }
+
+    size_t lower_bound(const tkey& key) const noexcept
+    {
+        return __detail::keys_lower_bound(_keys.data(), _keys.size(), key);
+    }
+
+    size_t upper_bound(const tkey& key) const noexcept
+    {
+        return __detail::keys_upper_bound(_keys.data(), _keys.size(), key);
+    }
+};
+
+template<typename tkey, size_t capacity>
+struct node_search_keys<tkey, capacity, false>
+{
+    template<typename pairs>
+    void assign(const pairs&) noexcept
+    {
+    }
+
+    void insert(size_t, const tkey&) noexcept
+    {
+    }
+
+    void erase(size_t) noexcept
+    {
+    }
+};
+
+#endif //MATH_PRACTICE_AND_OPERATING_SYSTEMS_NODE_SEARCH_H
@@ -1,18 +1,148 @@
 #include <iterator>
+#include <algorithm>
+#include <stdexcept>
 #include <utility>
 #include <vector>
 #include <boost/container/static_vector.hpp>
 #include <concepts>
+#include <span>
 #include <stack>
+#include <string>
 #include <pp_allocator.h>
 #include <search_tree.h>
+#include <node_search.h>
 #include <initializer_list>
 #include <logger_guardant.h>
 
 #ifndef MP_OS_B_PLUS_TREE_H
 #define MP_OS_B_PLUS_TREE_H
 
-template <typename tkey, typename tvalue, compator<tkey> compare = std::less<tkey>, std::size_t t = 5>
+/**
+ * Layout policy of BP_tree nodes. node_bytes == 0 means fanout is taken from degree t, otherwise every node holds
+ * as many keys as fit into node_bytes and t is ignored.
+**/
+template<typename layout>
+concept bptree_node_layout = requires
+                             {
+                                 {layout::node_bytes} -> std::convertible_to<size_t>;
+                             };
+
+/**
+ * Every node holds from t - 1 to 2t - 1 keys
+**/
+struct bptree_degree_layout
+{
+    static constexpr const size_t node_bytes = 0;
+};
+
+/**
+ * Node fits into bytes, e.g. 64 * k for cache lines or 4096 for pages. Middle nodes store only keys and pointers,
+ * so they get larger fanout than leaves.
+**/
+template<size_t bytes>
+struct bptree_sized_layout
+{
+    static constexpr const size_t node_bytes = bytes;
+};
+
+/**
+ * Separator put into middle node between neighbour leaves, lhs being the last key of left leaf and rhs the first key
+ * of right one. Any key s with lhs < s <= rhs keeps descent right, shorter ones take less memory in middle nodes.
+ * Primary template keeps rhs
+**/
+template<typename tkey, typename compare>
+struct bptree_separator
+{
+    static tkey shorten(const tkey&, const tkey& rhs)
+    {
+        return rhs;
+    }
+};
+
+/**
+ * Strings ordered by characters are cut right after the first character where rhs differs from lhs
+**/
+template<typename char_type, typename traits, typename allocator, typename compare>
+    requires std::same_as<compare, std::less<std::basic_string<char_type, traits, allocator>>> ||
+             std::same_as<compare, std::less<>>
+struct bptree_separator<std::basic_string<char_type, traits, allocator>, compare>
+{
+    using string_type = std::basic_string<char_type, traits, allocator>;
+
+    static string_type shorten(const string_type& lhs, const string_type& rhs)
+    {
+        size_t common = 0;
+
+        while (common < lhs.size() && common < rhs.size() && traits::eq(lhs[common], rhs[common]))
+        {
+            ++common;
+        }
+
+        // lhs < rhs, so rhs is longer than common part and its next character is greater or lhs has ended
+        return common < rhs.size() ? rhs.substr(0, common + 1) : rhs;
+    }
+};
+
+namespace __detail
+{
+    constexpr size_t bptree_round_up(size_t bytes, size_t alignment) noexcept
+    {
+        return (bytes + alignment - 1) / alignment * alignment;
+    }
+
+    /*
+     * Upper estimate of static_vector<T, capacity> size: size counter followed by storage
+     */
+    template<typename T>
+    constexpr size_t bptree_vector_bytes(size_t capacity) noexcept
+    {
+        return bptree_round_up(bptree_round_up(sizeof(size_t), alignof(T)) + capacity * sizeof(T),
+                               std::max(alignof(T), alignof(size_t)));
+    }
+
+    /*
+     * Largest number of keys at which node of node_bytes(keys) bytes still fits into bytes, but at least 3
+     */
+    template<typename node_bytes>
+    constexpr size_t bptree_sized_fanout(size_t bytes, node_bytes size) noexcept
+    {
+        size_t keys = 3;
+
+        while (size(keys + 1) <= bytes)
+        {
+            ++keys;
+        }
+
+        return keys;
+    }
+
+    template<typename tkey, typename tvalue, bool search_keys>
+    constexpr size_t bptree_leaf_fanout(size_t bytes) noexcept
+    {
+        constexpr size_t alignment = std::max({alignof(tkey), alignof(tvalue), alignof(void*), alignof(size_t)});
+
+        return bptree_sized_fanout(bytes, [](size_t keys)
+        {
+            return alignment + bptree_round_up(sizeof(void*), alignment) +
+                   bptree_round_up(bptree_vector_bytes<std::pair<tkey, tvalue>>(keys + 1), alignment) +
+                   (search_keys ? bptree_round_up(bptree_vector_bytes<tkey>(keys + 1), alignment) : 0);
+        });
+    }
+
+    template<typename tkey>
+    constexpr size_t bptree_middle_fanout(size_t bytes) noexcept
+    {
+        constexpr size_t alignment = std::max({alignof(tkey), alignof(void*), alignof(size_t)});
+
+        return bptree_sized_fanout(bytes, [](size_t keys)
+        {
+            return alignment + bptree_round_up(bptree_vector_bytes<tkey>(keys + 1), alignment) +
+                   bptree_round_up(bptree_vector_bytes<void*>(keys + 2), alignment);
+        });
+    }
+}
+
+template <typename tkey, typename tvalue, compator<tkey> compare = std::less<tkey>, std::size_t t = 5, bptree_node_layout layout = bptree_degree_layout>
 class BP_tree final : private logger_guardant, private compare
 {
 public:
@@ -23,22 +153,33 @@ public:
 
 private:
 
-    static constexpr const size_t minimum_keys_in_node = t - 1;
-    static constexpr const size_t maximum_keys_in_node = 2 * t - 1;
+    static constexpr const bool vectorized_search = vectorized_key_search_v<tkey, compare>;
+
+    // Leaves and middle nodes get own fanout, minimum keeps both splits and merges possible
+    static constexpr const size_t maximum_keys_in_leaf = layout::node_bytes == 0 ? 2 * t - 1 :
+            __detail::bptree_leaf_fanout<tkey, tvalue, vectorized_search>(layout::node_bytes);
+    static constexpr const size_t minimum_keys_in_leaf = (maximum_keys_in_leaf - 1) / 2;
+    static constexpr const size_t maximum_keys_in_middle = layout::node_bytes == 0 ? 2 * t - 1 :
+            __detail::bptree_middle_fanout<tkey>(layout::node_bytes);
+    static constexpr const size_t minimum_keys_in_middle = (maximum_keys_in_middle - 1) / 2;
 
     // region comparators declaration
 
-    inline bool compare_keys(const tkey& lhs, const tkey& rhs) const;
+    /* Keys may be of other type than tkey for transparent comparators */
+    template<typename lhs_key, typename rhs_key>
+    inline bool compare_keys(const lhs_key& lhs, const rhs_key& rhs) const;
     inline bool compare_pairs(const tree_data_type& lhs, const tree_data_type& rhs) const;
 
     // endregion comparators declaration
 
+    /*
+     * Kind of node is told by _is_terminate tag, nodes have no vtable. Use destroy_node to delete node by base pointer
+     */
     struct bptree_node_base
     {
         bool _is_terminate;
 
         bptree_node_base() noexcept;
-        virtual ~bptree_node_base() =default;
     };
 
     struct bptree_node_term : public bptree_node_base
@@ -48,7 +189,9 @@ private:
 //
 //        bptree_node_term(pp_allocator<tree_data_type> al);
 
-        boost::container::static_vector<tree_data_type, maximum_keys_in_node + 1> _data;
+        boost::container::static_vector<tree_data_type, maximum_keys_in_leaf + 1> _data;
+        /* Copy of keys from _data for vectorized search, changed together with _data */
+        [[no_unique_address]] node_search_keys<tkey, maximum_keys_in_leaf + 1, vectorized_search> _search_keys;
         bptree_node_term() noexcept;
     };
 
@@ -60,11 +203,31 @@ private:
 //        bptree_node_middle(pp_allocator<tkey> al);
 
 
-        boost::container::static_vector<tkey, maximum_keys_in_node + 1> _keys;
-        boost::container::static_vector<bptree_node_base*, maximum_keys_in_node + 2> _pointers;
+        boost::container::static_vector<tkey, maximum_keys_in_middle + 1> _keys;
+        boost::container::static_vector<bptree_node_base*, maximum_keys_in_middle + 2> _pointers;
         bptree_node_middle() noexcept;
     };
 
+    static_assert(layout::node_bytes == 0 ||
+                  (sizeof(bptree_node_term) <= layout::node_bytes && sizeof(bptree_node_middle) <= layout::node_bytes),
+                  "node_bytes is too small for three keys per node");
+
+    // Degree layout keeps classic bounds, sized one must not leave room for one more key in node_bytes
+    static_assert(layout::node_bytes != 0 ||
+                  (maximum_keys_in_leaf == 2 * t - 1 && maximum_keys_in_middle == 2 * t - 1),
+                  "degree layout must give 2t - 1 keys to every node");
+    static_assert(layout::node_bytes == 0 || maximum_keys_in_leaf == 3 ||
+                  sizeof(bptree_node_term) + sizeof(tree_data_type) + (vectorized_search ? sizeof(tkey) : 0) +
+                          alignof(bptree_node_term) > layout::node_bytes,
+                  "leaf fanout of layout leaves room for one more key");
+    static_assert(layout::node_bytes == 0 || maximum_keys_in_middle == 3 ||
+                  sizeof(bptree_node_middle) + sizeof(tkey) + sizeof(bptree_node_base*) +
+                          alignof(bptree_node_middle) > layout::node_bytes,
+                  "middle fanout of layout leaves room for one more key");
+
+    void destroy_node(bptree_node_base* node) noexcept;
+    void destroy_subtree(bptree_node_base* node) noexcept;
+
     pp_allocator<value_type> _allocator;
     logger* _logger;
     bptree_node_base* _root;
@@ -73,6 +236,71 @@ private:
     logger* get_logger() const noexcept override;
     pp_allocator<value_type> get_allocator() const noexcept;
 
+    // region bulk load declaration
+
+    static constexpr const double default_fill_factor = 1.0;
+
+    /** Number of nodes one level of count items is packed into, each node gets between minimum and maximum items
+     */
+    static size_t bulk_nodes_count(size_t count, size_t capacity, size_t minimum, size_t maximum) noexcept;
+
+    /** Builds empty tree bottom-up from count strictly increasing items, leaves are linked in one pass
+     */
+    template<std::forward_iterator iterator>
+    void bulk_load(iterator begin, size_t count, double fill_factor);
+
+    // endregion bulk load declaration
+
+    // region node search declaration
+
+    /** Index of the child of middle node which may hold key
+     */
+    template<typename lookup_key>
+    size_t node_upper_bound(const bptree_node_middle* node, const lookup_key& key) const;
+
+    /** Index of the first key of leaf not less than key
+     */
+    template<typename lookup_key>
+    size_t node_lower_bound(const bptree_node_term* node, const lookup_key& key) const;
+
+    /** Leaf which holds key if it is present
+     */
+    template<typename lookup_key>
+    bptree_node_term* find_leaf(const lookup_key& key) const;
+
+    /** Pair with given key or nullptr
+     */
+    template<typename lookup_key>
+    const tree_data_type* find_data(const lookup_key& key) const;
+
+    template<typename lookup_key>
+    tree_data_type* find_data(const lookup_key& key);
+
+    /* Batched lookup walks this many keys down together, only the head of each node is requested ahead */
+    static constexpr const size_t batch_width = 16;
+    static constexpr const size_t batch_prefetch_bytes = 256;
+
+    /** Writes pointer to value of keys[i] or nullptr to result[i]. All leaves are at one depth, so every round moves
+     * whole batch one level down and prefetches nodes it lands on before any of them is searched
+     */
+    template<typename value_pointer>
+    void find_batch_values(std::span<const tkey> keys, std::span<value_pointer> result) const;
+
+    // endregion node search declaration
+
+    // region scan declaration
+
+    /* Scan keeps the leaf after the one being read in flight, only its head is requested */
+    static constexpr const size_t scan_prefetch_bytes = 256;
+
+    static void prefetch_ahead(const bptree_node_term* leaf) noexcept;
+
+    /** Index past the last pair of leaf with key less than hi
+     */
+    size_t scan_end(const bptree_node_term* leaf, const tkey& hi) const;
+
+    // endregion scan declaration
+
 public:
 
     // region constructors declaration
@@ -86,6 +314,13 @@ public:
 
     BP_tree(std::initializer_list<std::pair<tkey, tvalue>> data, const compare& cmp = compare(), pp_allocator<value_type> = pp_allocator<value_type>(), logger* logger = nullptr);
 
+    /*
+     * Bulk load of input sorted by key without duplicates, nodes are filled to fill_factor of their capacity.
+     * Throws std::logic_error if input is not strictly increasing
+     */
+    template<input_iterator_for_pair<tkey, tvalue> iterator>
+    explicit BP_tree(sorted_unique_t, iterator begin, iterator end, double fill_factor = default_fill_factor, const compare& cmp = compare(), pp_allocator<value_type> = pp_allocator<value_type>(), logger* logger = nullptr);
+
     // endregion constructors declaration
 
     // region five declaration
@@ -186,6 +421,15 @@ public:
     tvalue& at(const tkey&);
     const tvalue& at(const tkey&) const;
 
+    /*
+     * Lookup by key of other type, when comparator is transparent
+     */
+    template<typename lookup_key> requires transparent_compator_for<compare, lookup_key, tkey>
+    tvalue& at(const lookup_key& key);
+
+    template<typename lookup_key> requires transparent_compator_for<compare, lookup_key, tkey>
+    const tvalue& at(const lookup_key& key) const;
+
     /*
      * If key not exists, makes default initialization of value
      */
@@ -226,8 +470,57 @@ public:
 
     bool contains(const tkey& key) const;
 
+    template<typename lookup_key> requires transparent_compator_for<compare, lookup_key, tkey>
+    bool contains(const lookup_key& key) const;
+
+    /*
+     * Writes pointer to value of keys[i] to result[i], nullptr if not exist. Descents of a batch of keys are
+     * interleaved, so their cache misses overlap. Throws std::invalid_argument if spans differ in size
+     */
+    void find_batch(std::span<const tkey> keys, std::span<tvalue*> result);
+    void find_batch(std::span<const tkey> keys, std::span<const tvalue*> result) const;
+
     // endregion lookup declaration
 
+    // region scan declaration
+
+    class bptree_scan_cursor;
+
+    /*
+     * Calls visit(key, value) for every pair with key in [lo, hi) in key order, walking leaf chain with prefetch of next
+     * leaves. If visit returns bool, false stops the scan. Returns number of visited pairs
+     */
+    template<std::invocable<const tkey&, const tvalue&> callback>
+    size_t scan(const tkey& lo, const tkey& hi, callback&& visit) const;
+
+    /*
+     * Cursor over pairs with key in [lo, hi), which copies them out by batches
+     */
+    bptree_scan_cursor scan(const tkey& lo, const tkey& hi) const;
+
+    class bptree_scan_cursor final
+    {
+        const BP_tree* _tree;
+        bptree_node_term* _node;
+        size_t _index;
+        tkey _hi;
+
+        bptree_scan_cursor(const BP_tree* tree, bptree_node_term* node, size_t index, const tkey& hi);
+
+    public:
+
+        friend class BP_tree;
+
+        /*
+         * Copies next pairs of range into buffer while it has room, returns their count, 0 once range is exhausted
+         */
+        size_t fetch(std::span<tree_data_type> buffer);
+
+        bool done() const noexcept;
+    };
+
+    // endregion scan declaration
+
     // region modifiers declaration
 
     void clear() noexcept;
@@ -275,415 +568,987 @@ template<typename tkey, typename tvalue, compator<tkey> compare = std::less<tkey
 BP_tree(std::initializer_list<std::pair<tkey, tvalue>> data, const compare &cmp = compare(), pp_allocator<U> = pp_allocator<U>(),
         logger *logger = nullptr) -> BP_tree<tkey, tvalue, compare, t>;
 
-template<typename tkey, typename tvalue, compator<tkey> compare, std::size_t t>
-bool BP_tree<tkey, tvalue, compare, t>::compare_pairs(const BP_tree::tree_data_type &lhs,
+template<typename tkey, typename tvalue, compator<tkey> compare, std::size_t t, bptree_node_layout layout>
+bool BP_tree<tkey, tvalue, compare, t, layout>::compare_pairs(const BP_tree::tree_data_type &lhs,
                                                      const BP_tree::tree_data_type &rhs) const
 {
     return compare_keys(lhs.first, rhs.first);
 }
 
-template<typename tkey, typename tvalue, compator<tkey> compare, std::size_t t>
-BP_tree<tkey, tvalue, compare, t>::bptree_node_base::bptree_node_base() noexcept
+template<typename tkey, typename tvalue, compator<tkey> compare, std::size_t t, bptree_node_layout layout>
+BP_tree<tkey, tvalue, compare, t, layout>::bptree_node_base::bptree_node_base() noexcept
+    : _is_terminate(false)
 {
-    throw not_implemented("too laazyy", "your code should be here...");
 }
 
-template<typename tkey, typename tvalue, compator<tkey> compare, std::size_t t>
-BP_tree<tkey, tvalue, compare, t>::bptree_node_term::bptree_node_term() noexcept
+template<typename tkey, typename tvalue, compator<tkey> compare, std::size_t t, bptree_node_layout layout>
+BP_tree<tkey, tvalue, compare, t, layout>::bptree_node_term::bptree_node_term() noexcept
+    : _next(nullptr)
 {
-    throw not_implemented("too laazyy", "your code should be here...");
+    this->_is_terminate = true;
 }
 
-template<typename tkey, typename tvalue, compator<tkey> compare, std::size_t t>
-BP_tree<tkey, tvalue, compare, t>::bptree_node_middle::bptree_node_middle() noexcept
+template<typename tkey, typename tvalue, compator<tkey> compare, std::size_t t, bptree_node_layout layout>
+BP_tree<tkey, tvalue, compare, t, layout>::bptree_node_middle::bptree_node_middle() noexcept
 {
-    throw not_implemented("too laazyy", "your code should be here...");
 }
 
-template<typename tkey, typename tvalue, compator<tkey> compare, std::size_t t>
-logger * BP_tree<tkey, tvalue, compare, t>::get_logger() const noexcept
+template<typename tkey, typename tvalue, compator<tkey> compare, std::size_t t, bptree_node_layout layout>
+logger * BP_tree<tkey, tvalue, compare, t, layout>::get_logger() const noexcept
 {
-    throw not_implemented("too laazyy", "your code should be here...");
+    return _logger;
 }
 
-template<typename tkey, typename tvalue, compator<tkey> compare, std::size_t t>
-pp_allocator<typename BP_tree<tkey, tvalue, compare, t>::value_type> BP_tree<tkey, tvalue, compare, t>::
+template<typename tkey, typename tvalue, compator<tkey> compare, std::size_t t, bptree_node_layout layout>
+pp_allocator<typename BP_tree<tkey, tvalue, compare, t, layout>::value_type> BP_tree<tkey, tvalue, compare, t, layout>::
 get_allocator() const noexcept
 {
-    throw not_implemented("too laazyy", "your code should be here...");
+    return _allocator;
 }
 
-template<typename tkey, typename tvalue, compator<tkey> compare, std::size_t t>
-typename BP_tree<tkey, tvalue, compare, t>::bptree_iterator::reference BP_tree<tkey, tvalue, compare, t>::
+template<typename tkey, typename tvalue, compator<tkey> compare, std::size_t t, bptree_node_layout layout>
+typename BP_tree<tkey, tvalue, compare, t, layout>::bptree_iterator::reference BP_tree<tkey, tvalue, compare, t, layout>::
 bptree_iterator::operator*() const noexcept
 {
-    throw not_implemented("too laazyy", "your code should be here...");
+    return *operator->();
 }
 
-template<typename tkey, typename tvalue, compator<tkey> compare, std::size_t t>
-typename BP_tree<tkey, tvalue, compare, t>::bptree_iterator::pointer BP_tree<tkey, tvalue, compare, t>::bptree_iterator
+template<typename tkey, typename tvalue, compator<tkey> compare, std::size_t t, bptree_node_layout layout>
+typename BP_tree<tkey, tvalue, compare, t, layout>::bptree_iterator::pointer BP_tree<tkey, tvalue, compare, t, layout>::bptree_iterator
 ::operator->() const noexcept
 {
-    throw not_implemented("too laazyy", "your code should be here...");
+    return reinterpret_cast<pointer>(&_node->_data[_index]);
 }
 
-template<typename tkey, typename tvalue, compator<tkey> compare, std::size_t t>
-typename BP_tree<tkey, tvalue, compare, t>::bptree_iterator::self & BP_tree<tkey, tvalue, compare, t>::bptree_iterator::
+template<typename tkey, typename tvalue, compator<tkey> compare, std::size_t t, bptree_node_layout layout>
+typename BP_tree<tkey, tvalue, compare, t, layout>::bptree_iterator::self & BP_tree<tkey, tvalue, compare, t, layout>::bptree_iterator::
 operator++()
 {
-    throw not_implemented("too laazyy", "your code should be here...");
+    if (++_index == _node->_data.size())
+    {
+        _node = _node->_next;
+        _index = 0;
+    }
+
+    return *this;
 }
 
-template<typename tkey, typename tvalue, compator<tkey> compare, std::size_t t>
-typename BP_tree<tkey, tvalue, compare, t>::bptree_iterator::self BP_tree<tkey, tvalue, compare, t>::bptree_iterator::
+template<typename tkey, typename tvalue, compator<tkey> compare, std::size_t t, bptree_node_layout layout>
+typename BP_tree<tkey, tvalue, compare, t, layout>::bptree_iterator::self BP_tree<tkey, tvalue, compare, t, layout>::bptree_iterator::
 operator++(int)
 {
-    throw not_implemented("too laazyy", "your code should be here...");
+    self copy = *this;
+    ++*this;
+    return copy;
 }
 
-template<typename tkey, typename tvalue, compator<tkey> compare, std::size_t t>
-bool BP_tree<tkey, tvalue, compare, t>::bptree_iterator::operator==(const self &other) const noexcept
+template<typename tkey, typename tvalue, compator<tkey> compare, std::size_t t, bptree_node_layout layout>
+bool BP_tree<tkey, tvalue, compare, t, layout>::bptree_iterator::operator==(const self &other) const noexcept
 {
-    throw not_implemented("too laazyy", "your code should be here...");
+    return _node == other._node && _index == other._index;
 }
 
-template<typename tkey, typename tvalue, compator<tkey> compare, std::size_t t>
-bool BP_tree<tkey, tvalue, compare, t>::bptree_iterator::operator!=(const self &other) const noexcept
+template<typename tkey, typename tvalue, compator<tkey> compare, std::size_t t, bptree_node_layout layout>
+bool BP_tree<tkey, tvalue, compare, t, layout>::bptree_iterator::operator!=(const self &other) const noexcept
 {
-    throw not_implemented("too laazyy", "your code should be here...");
+    return !(*this == other);
 }
 
-template<typename tkey, typename tvalue, compator<tkey> compare, std::size_t t>
-size_t BP_tree<tkey, tvalue, compare, t>::bptree_iterator::current_node_keys_count() const noexcept
+template<typename tkey, typename tvalue, compator<tkey> compare, std::size_t t, bptree_node_layout layout>
+size_t BP_tree<tkey, tvalue, compare, t, layout>::bptree_iterator::current_node_keys_count() const noexcept
 {
-    throw not_implemented("too laazyy", "your code should be here...");
+    return _node == nullptr ? 0 : _node->_data.size();
 }
 
-template<typename tkey, typename tvalue, compator<tkey> compare, std::size_t t>
-size_t BP_tree<tkey, tvalue, compare, t>::bptree_iterator::index() const noexcept
+template<typename tkey, typename tvalue, compator<tkey> compare, std::size_t t, bptree_node_layout layout>
+size_t BP_tree<tkey, tvalue, compare, t, layout>::bptree_iterator::index() const noexcept
 {
-    throw not_implemented("too laazyy", "your code should be here...");
+    return _index;
 }
 
-template<typename tkey, typename tvalue, compator<tkey> compare, std::size_t t>
-BP_tree<tkey, tvalue, compare, t>::bptree_iterator::bptree_iterator(bptree_node_term *node, size_t index)
+template<typename tkey, typename tvalue, compator<tkey> compare, std::size_t t, bptree_node_layout layout>
+BP_tree<tkey, tvalue, compare, t, layout>::bptree_iterator::bptree_iterator(bptree_node_term *node, size_t index)
+    : _node(node), _index(index)
 {
-    throw not_implemented("too laazyy", "your code should be here...");
 }
 
-template<typename tkey, typename tvalue, compator<tkey> compare, std::size_t t>
-BP_tree<tkey, tvalue, compare, t>::bptree_const_iterator::bptree_const_iterator(const bptree_iterator &it) noexcept
+template<typename tkey, typename tvalue, compator<tkey> compare, std::size_t t, bptree_node_layout layout>
+BP_tree<tkey, tvalue, compare, t, layout>::bptree_const_iterator::bptree_const_iterator(const bptree_iterator &it) noexcept
+    : _node(it._node), _index(it._index)
 {
-    throw not_implemented("too laazyy", "your code should be here...");
 }
 
-template<typename tkey, typename tvalue, compator<tkey> compare, std::size_t t>
-typename BP_tree<tkey, tvalue, compare, t>::bptree_const_iterator::reference BP_tree<tkey, tvalue, compare, t>::
+template<typename tkey, typename tvalue, compator<tkey> compare, std::size_t t, bptree_node_layout layout>
+typename BP_tree<tkey, tvalue, compare, t, layout>::bptree_const_iterator::reference BP_tree<tkey, tvalue, compare, t, layout>::
 bptree_const_iterator::operator*() const noexcept
 {
-    throw not_implemented("too laazyy", "your code should be here...");
+    return *operator->();
 }
 
-template<typename tkey, typename tvalue, compator<tkey> compare, std::size_t t>
-typename BP_tree<tkey, tvalue, compare, t>::bptree_const_iterator::pointer BP_tree<tkey, tvalue, compare, t>::
+template<typename tkey, typename tvalue, compator<tkey> compare, std::size_t t, bptree_node_layout layout>
+typename BP_tree<tkey, tvalue, compare, t, layout>::bptree_const_iterator::pointer BP_tree<tkey, tvalue, compare, t, layout>::
 bptree_const_iterator::operator->() const noexcept
 {
-    throw not_implemented("too laazyy", "your code should be here...");
+    return reinterpret_cast<pointer>(&_node->_data[_index]);
 }
 
-template<typename tkey, typename tvalue, compator<tkey> compare, std::size_t t>
-typename BP_tree<tkey, tvalue, compare, t>::bptree_const_iterator::self & BP_tree<tkey, tvalue, compare, t>::
+template<typename tkey, typename tvalue, compator<tkey> compare, std::size_t t, bptree_node_layout layout>
+typename BP_tree<tkey, tvalue, compare, t, layout>::bptree_const_iterator::self & BP_tree<tkey, tvalue, compare, t, layout>::
 bptree_const_iterator::operator++()
 {
-    throw not_implemented("too laazyy", "your code should be here...");
+    if (++_index == _node->_data.size())
+    {
+        _node = _node->_next;
+        _index = 0;
+    }
+
+    return *this;
 }
 
-template<typename tkey, typename tvalue, compator<tkey> compare, std::size_t t>
-typename BP_tree<tkey, tvalue, compare, t>::bptree_const_iterator::self BP_tree<tkey, tvalue, compare, t>::
+template<typename tkey, typename tvalue, compator<tkey> compare, std::size_t t, bptree_node_layout layout>
+typename BP_tree<tkey, tvalue, compare, t, layout>::bptree_const_iterator::self BP_tree<tkey, tvalue, compare, t, layout>::
 bptree_const_iterator::operator++(int)
 {
-    throw not_implemented("too laazyy", "your code should be here...");
+    self copy = *this;
+    ++*this;
+    return copy;
 }
 
-template<typename tkey, typename tvalue, compator<tkey> compare, std::size_t t>
-bool BP_tree<tkey, tvalue, compare, t>::bptree_const_iterator::operator==(const self &other) const noexcept
+template<typename tkey, typename tvalue, compator<tkey> compare, std::size_t t, bptree_node_layout layout>
+bool BP_tree<tkey, tvalue, compare, t, layout>::bptree_const_iterator::operator==(const self &other) const noexcept
 {
-    throw not_implemented("too laazyy", "your code should be here...");
+    return _node == other._node && _index == other._index;
 }
 
-template<typename tkey, typename tvalue, compator<tkey> compare, std::size_t t>
-bool BP_tree<tkey, tvalue, compare, t>::bptree_const_iterator::operator!=(const self &other) const noexcept
+template<typename tkey, typename tvalue, compator<tkey> compare, std::size_t t, bptree_node_layout layout>
+bool BP_tree<tkey, tvalue, compare, t, layout>::bptree_const_iterator::operator!=(const self &other) const noexcept
 {
-    throw not_implemented("too laazyy", "your code should be here...");
+    return !(*this == other);
 }
 
-template<typename tkey, typename tvalue, compator<tkey> compare, std::size_t t>
-size_t BP_tree<tkey, tvalue, compare, t>::bptree_const_iterator::current_node_keys_count() const noexcept
+template<typename tkey, typename tvalue, compator<tkey> compare, std::size_t t, bptree_node_layout layout>
+size_t BP_tree<tkey, tvalue, compare, t, layout>::bptree_const_iterator::current_node_keys_count() const noexcept
 {
-    throw not_implemented("too laazyy", "your code should be here...");
+    return _node == nullptr ? 0 : _node->_data.size();
 }
 
-template<typename tkey, typename tvalue, compator<tkey> compare, std::size_t t>
-size_t BP_tree<tkey, tvalue, compare, t>::bptree_const_iterator::index() const noexcept
+template<typename tkey, typename tvalue, compator<tkey> compare, std::size_t t, bptree_node_layout layout>
+size_t BP_tree<tkey, tvalue, compare, t, layout>::bptree_const_iterator::index() const noexcept
 {
-    throw not_implemented("too laazyy", "your code should be here...");
+    return _index;
 }
 
-template<typename tkey, typename tvalue, compator<tkey> compare, std::size_t t>
-BP_tree<tkey, tvalue, compare, t>::bptree_const_iterator::bptree_const_iterator(bptree_node_term *node, size_t index)
+template<typename tkey, typename tvalue, compator<tkey> compare, std::size_t t, bptree_node_layout layout>
+BP_tree<tkey, tvalue, compare, t, layout>::bptree_const_iterator::bptree_const_iterator(bptree_node_term *node, size_t index)
+    : _node(node), _index(index)
 {
-    throw not_implemented("too laazyy", "your code should be here...");
 }
 
-template<typename tkey, typename tvalue, compator<tkey> compare, std::size_t t>
-tvalue & BP_tree<tkey, tvalue, compare, t>::at(const tkey &)
+template<typename tkey, typename tvalue, compator<tkey> compare, std::size_t t, bptree_node_layout layout>
+tvalue & BP_tree<tkey, tvalue, compare, t, layout>::at(const tkey& key)
 {
-    throw not_implemented("too laazyy", "your code should be here...");
+    tree_data_type* data = find_data(key);
+
+    if (data == nullptr)
+    {
+        throw std::out_of_range("key not found");
+    }
+
+    return data->second;
 }
 
-template<typename tkey, typename tvalue, compator<tkey> compare, std::size_t t>
-const tvalue & BP_tree<tkey, tvalue, compare, t>::at(const tkey &) const
+template<typename tkey, typename tvalue, compator<tkey> compare, std::size_t t, bptree_node_layout layout>
+const tvalue & BP_tree<tkey, tvalue, compare, t, layout>::at(const tkey& key) const
 {
-    throw not_implemented("too laazyy", "your code should be here...");
+    const tree_data_type* data = find_data(key);
+
+    if (data == nullptr)
+    {
+        throw std::out_of_range("key not found");
+    }
+
+    return data->second;
+}
+
+template<typename tkey, typename tvalue, compator<tkey> compare, std::size_t t, bptree_node_layout layout>
+template<typename lookup_key> requires transparent_compator_for<compare, lookup_key, tkey>
+tvalue & BP_tree<tkey, tvalue, compare, t, layout>::at(const lookup_key& key)
+{
+    tree_data_type* data = find_data(key);
+
+    if (data == nullptr)
+    {
+        throw std::out_of_range("key not found");
+    }
+
+    return data->second;
+}
+
+template<typename tkey, typename tvalue, compator<tkey> compare, std::size_t t, bptree_node_layout layout>
+template<typename lookup_key> requires transparent_compator_for<compare, lookup_key, tkey>
+const tvalue & BP_tree<tkey, tvalue, compare, t, layout>::at(const lookup_key& key) const
+{
+    const tree_data_type* data = find_data(key);
+
+    if (data == nullptr)
+    {
+        throw std::out_of_range("key not found");
+    }
+
+    return data->second;
 }
 
-template<typename tkey, typename tvalue, compator<tkey> compare, std::size_t t>
-tvalue & BP_tree<tkey, tvalue, compare, t>::operator[](const tkey &key)
+template<typename tkey, typename tvalue, compator<tkey> compare, std::size_t t, bptree_node_layout layout>
+tvalue & BP_tree<tkey, tvalue, compare, t, layout>::operator[](const tkey &key)
 {
     throw not_implemented("too laazyy", "your code should be here...");
 }
 
-template<typename tkey, typename tvalue, compator<tkey> compare, std::size_t t>
-tvalue & BP_tree<tkey, tvalue, compare, t>::operator[](tkey &&key)
+template<typename tkey, typename tvalue, compator<tkey> compare, std::size_t t, bptree_node_layout layout>
+tvalue & BP_tree<tkey, tvalue, compare, t, layout>::operator[](tkey &&key)
 {
     throw not_implemented("too laazyy", "your code should be here...");
 }
 
-template<typename tkey, typename tvalue, compator<tkey> compare, std::size_t t>
-std::pair<typename BP_tree<tkey, tvalue, compare, t>::bptree_iterator, bool> BP_tree<tkey, tvalue, compare, t>::insert(
+template<typename tkey, typename tvalue, compator<tkey> compare, std::size_t t, bptree_node_layout layout>
+std::pair<typename BP_tree<tkey, tvalue, compare, t, layout>::bptree_iterator, bool> BP_tree<tkey, tvalue, compare, t, layout>::insert(
     const tree_data_type &data)
 {
     throw not_implemented("too laazyy", "your code should be here...");
 }
 
-template<typename tkey, typename tvalue, compator<tkey> compare, std::size_t t>
-bool BP_tree<tkey, tvalue, compare, t>::compare_keys(const tkey &lhs, const tkey &rhs) const
+template<typename tkey, typename tvalue, compator<tkey> compare, std::size_t t, bptree_node_layout layout>
+template<typename lhs_key, typename rhs_key>
+bool BP_tree<tkey, tvalue, compare, t, layout>::compare_keys(const lhs_key &lhs, const rhs_key &rhs) const
 {
     return compare::operator()(lhs, rhs);
 }
 
 
-template<typename tkey, typename tvalue, compator<tkey> compare, std::size_t t>
-BP_tree<tkey, tvalue, compare, t>::BP_tree(const compare& cmp, pp_allocator<value_type> alloc, logger* logger)
+template<typename tkey, typename tvalue, compator<tkey> compare, std::size_t t, bptree_node_layout layout>
+BP_tree<tkey, tvalue, compare, t, layout>::BP_tree(const compare& cmp, pp_allocator<value_type> alloc, logger* logger)
+    : compare(cmp), _allocator(alloc), _logger(logger), _root(nullptr), _size(0)
 {
-    throw not_implemented("template<typename tkey, typename tvalue, compator<tkey> compare, std::size_t t> BP_tree<tkey, tvalue, compare, t>::BP_tree(const compare& cmp, pp_allocator<value_type> alloc, logger* logger)", "your code should be here...");
 }
 
-template<typename tkey, typename tvalue, compator<tkey> compare, std::size_t t>
-BP_tree<tkey, tvalue, compare, t>::BP_tree(pp_allocator<value_type> alloc, const compare& cmp, logger* logger)
+template<typename tkey, typename tvalue, compator<tkey> compare, std::size_t t, bptree_node_layout layout>
+BP_tree<tkey, tvalue, compare, t, layout>::BP_tree(pp_allocator<value_type> alloc, const compare& cmp, logger* logger)
+    : compare(cmp), _allocator(alloc), _logger(logger), _root(nullptr), _size(0)
 {
-    throw not_implemented("template<typename tkey, typename tvalue, compator<tkey> compare, std::size_t t> BP_tree<tkey, tvalue, compare, t>::BP_tree(pp_allocator<value_type> alloc, const compare& cmp, logger* logger)", "your code should be here...");
 }
 
-template<typename tkey, typename tvalue, compator<tkey> compare, std::size_t t>
+template<typename tkey, typename tvalue, compator<tkey> compare, std::size_t t, bptree_node_layout layout>
 template<input_iterator_for_pair<tkey, tvalue> iterator>
-BP_tree<tkey, tvalue, compare, t>::BP_tree(iterator begin, iterator end, const compare& cmp, pp_allocator<value_type> alloc, logger* logger)
+BP_tree<tkey, tvalue, compare, t, layout>::BP_tree(iterator begin, iterator end, const compare& cmp, pp_allocator<value_type> alloc, logger* logger)
+    : compare(cmp), _allocator(alloc), _logger(logger), _root(nullptr), _size(0)
 {
-    throw not_implemented("template<typename tkey, typename tvalue, compator<tkey> compare, std::size_t t> template<input_iterator_for_pair<tkey, tvalue> iterator> BP_tree<tkey, tvalue, compare, t>::BP_tree(iterator begin, iterator end, const compare& cmp, pp_allocator<value_type> alloc, logger* logger)", "your code should be here...");
+    auto unordered = [this](const tree_data_type& lhs, const tree_data_type& rhs)
+    {
+        return !compare_pairs(lhs, rhs);
+    };
+
+    if constexpr (std::forward_iterator<iterator>)
+    {
+        if (std::adjacent_find(begin, end, unordered) == end)
+        {
+            bulk_load(begin, std::distance(begin, end), default_fill_factor);
+            return;
+        }
+    }
+
+    // Other input is sorted here, first of equal keys is kept as insert would keep it
+    std::vector<tree_data_type> data(begin, end);
+
+    std::stable_sort(data.begin(), data.end(), [this](const tree_data_type& lhs, const tree_data_type& rhs)
+    {
+        return compare_pairs(lhs, rhs);
+    });
+    data.erase(std::unique(data.begin(), data.end(), unordered), data.end());
+
+    bulk_load(data.begin(), data.size(), default_fill_factor);
+}
+
+template<typename tkey, typename tvalue, compator<tkey> compare, std::size_t t, bptree_node_layout layout>
+BP_tree<tkey, tvalue, compare, t, layout>::BP_tree(std::initializer_list<std::pair<tkey, tvalue>> data, const compare& cmp, pp_allocator<value_type> alloc, logger* logger)
+    : BP_tree(data.begin(), data.end(), cmp, alloc, logger)
+{
+}
+
+template<typename tkey, typename tvalue, compator<tkey> compare, std::size_t t, bptree_node_layout layout>
+template<input_iterator_for_pair<tkey, tvalue> iterator>
+BP_tree<tkey, tvalue, compare, t, layout>::BP_tree(sorted_unique_t, iterator begin, iterator end, double fill_factor, const compare& cmp, pp_allocator<value_type> alloc, logger* logger)
+    : compare(cmp), _allocator(alloc), _logger(logger), _root(nullptr), _size(0)
+{
+    if constexpr (std::forward_iterator<iterator>)
+    {
+        bulk_load(begin, std::distance(begin, end), fill_factor);
+    } else
+    {
+        std::vector<tree_data_type> data(begin, end);
+        bulk_load(data.begin(), data.size(), fill_factor);
+    }
+}
+
+template<typename tkey, typename tvalue, compator<tkey> compare, std::size_t t, bptree_node_layout layout>
+BP_tree<tkey, tvalue, compare, t, layout>::BP_tree(const BP_tree& other)
+{
+    throw not_implemented("template<typename tkey, typename tvalue, compator<tkey> compare, std::size_t t, bptree_node_layout layout> BP_tree<tkey, tvalue, compare, t, layout>::BP_tree(const BP_tree& other)", "your code should be here...");
+}
+
+template<typename tkey, typename tvalue, compator<tkey> compare, std::size_t t, bptree_node_layout layout>
+BP_tree<tkey, tvalue, compare, t, layout>::BP_tree(BP_tree&& other) noexcept
+{
+    throw not_implemented("template<typename tkey, typename tvalue, compator<tkey> compare, std::size_t t, bptree_node_layout layout> BP_tree<tkey, tvalue, compare, t, layout>::BP_tree(BP_tree&& other) noexcept", "your code should be here...");
 }
 
-template<typename tkey, typename tvalue, compator<tkey> compare, std::size_t t>
-BP_tree<tkey, tvalue, compare, t>::BP_tree(std::initializer_list<std::pair<tkey, tvalue>> data, const compare& cmp, pp_allocator<value_type> alloc, logger* logger)
+template<typename tkey, typename tvalue, compator<tkey> compare, std::size_t t, bptree_node_layout layout>
+BP_tree<tkey, tvalue, compare, t, layout>& BP_tree<tkey, tvalue, compare, t, layout>::operator=(const BP_tree& other)
 {
-    throw not_implemented("template<typename tkey, typename tvalue, compator<tkey> compare, std::size_t t> BP_tree<tkey, tvalue, compare, t>::BP_tree(std::initializer_list<std::pair<tkey, tvalue>> data, const compare& cmp, pp_allocator<value_type> alloc, logger* logger)", "your code should be here...");
+    throw not_implemented("template<typename tkey, typename tvalue, compator<tkey> compare, std::size_t t, bptree_node_layout layout> BP_tree<tkey, tvalue, compare, t, layout>& BP_tree<tkey, tvalue, compare, t, layout>::operator=(const BP_tree& other)", "your code should be here...");
 }
 
-template<typename tkey, typename tvalue, compator<tkey> compare, std::size_t t>
-BP_tree<tkey, tvalue, compare, t>::BP_tree(const BP_tree& other)
+template<typename tkey, typename tvalue, compator<tkey> compare, std::size_t t, bptree_node_layout layout>
+BP_tree<tkey, tvalue, compare, t, layout>& BP_tree<tkey, tvalue, compare, t, layout>::operator=(BP_tree&& other) noexcept
 {
-    throw not_implemented("template<typename tkey, typename tvalue, compator<tkey> compare, std::size_t t> BP_tree<tkey, tvalue, compare, t>::BP_tree(const BP_tree& other)", "your code should be here...");
+    throw not_implemented("template<typename tkey, typename tvalue, compator<tkey> compare, std::size_t t, bptree_node_layout layout> BP_tree<tkey, tvalue, compare, t, layout>& BP_tree<tkey, tvalue, compare, t, layout>::operator=(BP_tree&& other) noexcept", "your code should be here...");
 }
 
-template<typename tkey, typename tvalue, compator<tkey> compare, std::size_t t>
-BP_tree<tkey, tvalue, compare, t>::BP_tree(BP_tree&& other) noexcept
+template<typename tkey, typename tvalue, compator<tkey> compare, std::size_t t, bptree_node_layout layout>
+BP_tree<tkey, tvalue, compare, t, layout>::~BP_tree() noexcept
 {
-    throw not_implemented("template<typename tkey, typename tvalue, compator<tkey> compare, std::size_t t> BP_tree<tkey, tvalue, compare, t>::BP_tree(BP_tree&& other) noexcept", "your code should be here...");
+    clear();
 }
 
-template<typename tkey, typename tvalue, compator<tkey> compare, std::size_t t>
-BP_tree<tkey, tvalue, compare, t>& BP_tree<tkey, tvalue, compare, t>::operator=(const BP_tree& other)
+template<typename tkey, typename tvalue, compator<tkey> compare, std::size_t t, bptree_node_layout layout>
+typename BP_tree<tkey, tvalue, compare, t, layout>::bptree_iterator BP_tree<tkey, tvalue, compare, t, layout>::begin()
 {
-    throw not_implemented("template<typename tkey, typename tvalue, compator<tkey> compare, std::size_t t> BP_tree<tkey, tvalue, compare, t>& BP_tree<tkey, tvalue, compare, t>::operator=(const BP_tree& other)", "your code should be here...");
+    if (_root == nullptr)
+    {
+        return bptree_iterator();
+    }
+
+    bptree_node_base* node = _root;
+
+    while (!node->_is_terminate)
+    {
+        node = static_cast<bptree_node_middle*>(node)->_pointers.front();
+    }
+
+    return bptree_iterator(static_cast<bptree_node_term*>(node), 0);
 }
 
-template<typename tkey, typename tvalue, compator<tkey> compare, std::size_t t>
-BP_tree<tkey, tvalue, compare, t>& BP_tree<tkey, tvalue, compare, t>::operator=(BP_tree&& other) noexcept
+template<typename tkey, typename tvalue, compator<tkey> compare, std::size_t t, bptree_node_layout layout>
+typename BP_tree<tkey, tvalue, compare, t, layout>::bptree_iterator BP_tree<tkey, tvalue, compare, t, layout>::end()
 {
-    throw not_implemented("template<typename tkey, typename tvalue, compator<tkey> compare, std::size_t t> BP_tree<tkey, tvalue, compare, t>& BP_tree<tkey, tvalue, compare, t>::operator=(BP_tree&& other) noexcept", "your code should be here...");
+    return bptree_iterator();
 }
 
-template<typename tkey, typename tvalue, compator<tkey> compare, std::size_t t>
-BP_tree<tkey, tvalue, compare, t>::~BP_tree() noexcept
+template<typename tkey, typename tvalue, compator<tkey> compare, std::size_t t, bptree_node_layout layout>
+typename BP_tree<tkey, tvalue, compare, t, layout>::bptree_const_iterator BP_tree<tkey, tvalue, compare, t, layout>::begin() const
 {
-    throw not_implemented("template<typename tkey, typename tvalue, compator<tkey> compare, std::size_t t> BP_tree<tkey, tvalue, compare, t>::~BP_tree() noexcept", "your code should be here...");
+    return const_cast<BP_tree*>(this)->begin();
 }
 
-template<typename tkey, typename tvalue, compator<tkey> compare, std::size_t t>
-typename BP_tree<tkey, tvalue, compare, t>::bptree_iterator BP_tree<tkey, tvalue, compare, t>::begin()
+template<typename tkey, typename tvalue, compator<tkey> compare, std::size_t t, bptree_node_layout layout>
+typename BP_tree<tkey, tvalue, compare, t, layout>::bptree_const_iterator BP_tree<tkey, tvalue, compare, t, layout>::end() const
 {
-    throw not_implemented("template<typename tkey, typename tvalue, compator<tkey> compare, std::size_t t> typename BP_tree<tkey, tvalue, compare, t>::bptree_iterator BP_tree<tkey, tvalue, compare, t>::begin()", "your code should be here...");
+    return bptree_const_iterator();
 }
 
-template<typename tkey, typename tvalue, compator<tkey> compare, std::size_t t>
-typename BP_tree<tkey, tvalue, compare, t>::bptree_iterator BP_tree<tkey, tvalue, compare, t>::end()
+template<typename tkey, typename tvalue, compator<tkey> compare, std::size_t t, bptree_node_layout layout>
+typename BP_tree<tkey, tvalue, compare, t, layout>::bptree_const_iterator BP_tree<tkey, tvalue, compare, t, layout>::cbegin() const
 {
-    throw not_implemented("template<typename tkey, typename tvalue, compator<tkey> compare, std::size_t t> typename BP_tree<tkey, tvalue, compare, t>::bptree_iterator BP_tree<tkey, tvalue, compare, t>::end()", "your code should be here...");
+    return begin();
 }
 
-template<typename tkey, typename tvalue, compator<tkey> compare, std::size_t t>
-typename BP_tree<tkey, tvalue, compare, t>::bptree_const_iterator BP_tree<tkey, tvalue, compare, t>::begin() const
+template<typename tkey, typename tvalue, compator<tkey> compare, std::size_t t, bptree_node_layout layout>
+typename BP_tree<tkey, tvalue, compare, t, layout>::bptree_const_iterator BP_tree<tkey, tvalue, compare, t, layout>::cend() const
 {
-    throw not_implemented("template<typename tkey, typename tvalue, compator<tkey> compare, std::size_t t> typename BP_tree<tkey, tvalue, compare, t>::bptree_const_iterator BP_tree<tkey, tvalue, compare, t>::begin() const", "your code should be here...");
+    return end();
 }
 
-template<typename tkey, typename tvalue, compator<tkey> compare, std::size_t t>
-typename BP_tree<tkey, tvalue, compare, t>::bptree_const_iterator BP_tree<tkey, tvalue, compare, t>::end() const
+template<typename tkey, typename tvalue, compator<tkey> compare, std::size_t t, bptree_node_layout layout>
+size_t BP_tree<tkey, tvalue, compare, t, layout>::size() const noexcept
 {
-    throw not_implemented("template<typename tkey, typename tvalue, compator<tkey> compare, std::size_t t> typename BP_tree<tkey, tvalue, compare, t>::bptree_const_iterator BP_tree<tkey, tvalue, compare, t>::end() const", "your code should be here...");
+    return _size;
 }
 
-template<typename tkey, typename tvalue, compator<tkey> compare, std::size_t t>
-typename BP_tree<tkey, tvalue, compare, t>::bptree_const_iterator BP_tree<tkey, tvalue, compare, t>::cbegin() const
+template<typename tkey, typename tvalue, compator<tkey> compare, std::size_t t, bptree_node_layout layout>
+bool BP_tree<tkey, tvalue, compare, t, layout>::empty() const noexcept
 {
-    throw not_implemented("template<typename tkey, typename tvalue, compator<tkey> compare, std::size_t t> typename BP_tree<tkey, tvalue, compare, t>::bptree_const_iterator BP_tree<tkey, tvalue, compare, t>::cbegin() const", "your code should be here...");
+    return _size == 0;
 }
 
-template<typename tkey, typename tvalue, compator<tkey> compare, std::size_t t>
-typename BP_tree<tkey, tvalue, compare, t>::bptree_const_iterator BP_tree<tkey, tvalue, compare, t>::cend() const
+template<typename tkey, typename tvalue, compator<tkey> compare, std::size_t t, bptree_node_layout layout>
+typename BP_tree<tkey, tvalue, compare, t, layout>::bptree_iterator BP_tree<tkey, tvalue, compare, t, layout>::find(const tkey& key)
 {
-    throw not_implemented("template<typename tkey, typename tvalue, compator<tkey> compare, std::size_t t> typename BP_tree<tkey, tvalue, compare, t>::bptree_const_iterator BP_tree<tkey, tvalue, compare, t>::cend() const", "your code should be here...");
+    throw not_implemented("template<typename tkey, typename tvalue, compator<tkey> compare, std::size_t t, bptree_node_layout layout> typename BP_tree<tkey, tvalue, compare, t, layout>::bptree_iterator BP_tree<tkey, tvalue, compare, t, layout>::find(const tkey& key)", "your code should be here...");
 }
 
-template<typename tkey, typename tvalue, compator<tkey> compare, std::size_t t>
-size_t BP_tree<tkey, tvalue, compare, t>::size() const noexcept
+template<typename tkey, typename tvalue, compator<tkey> compare, std::size_t t, bptree_node_layout layout>
+typename BP_tree<tkey, tvalue, compare, t, layout>::bptree_const_iterator BP_tree<tkey, tvalue, compare, t, layout>::find(const tkey& key) const
 {
-    throw not_implemented("template<typename tkey, typename tvalue, compator<tkey> compare, std::size_t t> size_t BP_tree<tkey, tvalue, compare, t>::size() const noexcept", "your code should be here...");
+    throw not_implemented("template<typename tkey, typename tvalue, compator<tkey> compare, std::size_t t, bptree_node_layout layout> typename BP_tree<tkey, tvalue, compare, t, layout>::bptree_const_iterator BP_tree<tkey, tvalue, compare, t, layout>::find(const tkey& key) const", "your code should be here...");
 }
 
-template<typename tkey, typename tvalue, compator<tkey> compare, std::size_t t>
-bool BP_tree<tkey, tvalue, compare, t>::empty() const noexcept
+template<typename tkey, typename tvalue, compator<tkey> compare, std::size_t t, bptree_node_layout layout>
+typename BP_tree<tkey, tvalue, compare, t, layout>::bptree_iterator BP_tree<tkey, tvalue, compare, t, layout>::lower_bound(const tkey& key)
 {
-    throw not_implemented("template<typename tkey, typename tvalue, compator<tkey> compare, std::size_t t> bool BP_tree<tkey, tvalue, compare, t>::empty() const noexcept", "your code should be here...");
+    throw not_implemented("template<typename tkey, typename tvalue, compator<tkey> compare, std::size_t t, bptree_node_layout layout> typename BP_tree<tkey, tvalue, compare, t, layout>::bptree_iterator BP_tree<tkey, tvalue, compare, t, layout>::lower_bound(const tkey& key)", "your code should be here...");
 }
 
-template<typename tkey, typename tvalue, compator<tkey> compare, std::size_t t>
-typename BP_tree<tkey, tvalue, compare, t>::bptree_iterator BP_tree<tkey, tvalue, compare, t>::find(const tkey& key)
+template<typename tkey, typename tvalue, compator<tkey> compare, std::size_t t, bptree_node_layout layout>
+typename BP_tree<tkey, tvalue, compare, t, layout>::bptree_const_iterator BP_tree<tkey, tvalue, compare, t, layout>::lower_bound(const tkey& key) const
 {
-    throw not_implemented("template<typename tkey, typename tvalue, compator<tkey> compare, std::size_t t> typename BP_tree<tkey, tvalue, compare, t>::bptree_iterator BP_tree<tkey, tvalue, compare, t>::find(const tkey& key)", "your code should be here...");
+    throw not_implemented("template<typename tkey, typename tvalue, compator<tkey> compare, std::size_t t, bptree_node_layout layout> typename BP_tree<tkey, tvalue, compare, t, layout>::bptree_const_iterator BP_tree<tkey, tvalue, compare, t, layout>::lower_bound(const tkey& key) const", "your code should be here...");
 }
 
-template<typename tkey, typename tvalue, compator<tkey> compare, std::size_t t>
-typename BP_tree<tkey, tvalue, compare, t>::bptree_const_iterator BP_tree<tkey, tvalue, compare, t>::find(const tkey& key) const
+template<typename tkey, typename tvalue, compator<tkey> compare, std::size_t t, bptree_node_layout layout>
+typename BP_tree<tkey, tvalue, compare, t, layout>::bptree_iterator BP_tree<tkey, tvalue, compare, t, layout>::upper_bound(const tkey& key)
 {
-    throw not_implemented("template<typename tkey, typename tvalue, compator<tkey> compare, std::size_t t> typename BP_tree<tkey, tvalue, compare, t>::bptree_const_iterator BP_tree<tkey, tvalue, compare, t>::find(const tkey& key) const", "your code should be here...");
+    throw not_implemented("template<typename tkey, typename tvalue, compator<tkey> compare, std::size_t t, bptree_node_layout layout> typename BP_tree<tkey, tvalue, compare, t, layout>::bptree_iterator BP_tree<tkey, tvalue, compare, t, layout>::upper_bound(const tkey& key)", "your code should be here...");
 }
 
-template<typename tkey, typename tvalue, compator<tkey> compare, std::size_t t>
-typename BP_tree<tkey, tvalue, compare, t>::bptree_iterator BP_tree<tkey, tvalue, compare, t>::lower_bound(const tkey& key)
+template<typename tkey, typename tvalue, compator<tkey> compare, std::size_t t, bptree_node_layout layout>
+typename BP_tree<tkey, tvalue, compare, t, layout>::bptree_const_iterator BP_tree<tkey, tvalue, compare, t, layout>::upper_bound(const tkey& key) const
 {
-    throw not_implemented("template<typename tkey, typename tvalue, compator<tkey> compare, std::size_t t> typename BP_tree<tkey, tvalue, compare, t>::bptree_iterator BP_tree<tkey, tvalue, compare, t>::lower_bound(const tkey& key)", "your code should be here...");
+    throw not_implemented("template<typename tkey, typename tvalue, compator<tkey> compare, std::size_t t, bptree_node_layout layout> typename BP_tree<tkey, tvalue, compare, t, layout>::bptree_const_iterator BP_tree<tkey, tvalue, compare, t, layout>::upper_bound(const tkey& key) const", "your code should be here...");
 }
 
-template<typename tkey, typename tvalue, compator<tkey> compare, std::size_t t>
-typename BP_tree<tkey, tvalue, compare, t>::bptree_const_iterator BP_tree<tkey, tvalue, compare, t>::lower_bound(const tkey& key) const
+template<typename tkey, typename tvalue, compator<tkey> compare, std::size_t t, bptree_node_layout layout>
+bool BP_tree<tkey, tvalue, compare, t, layout>::contains(const tkey& key) const
 {
-    throw not_implemented("template<typename tkey, typename tvalue, compator<tkey> compare, std::size_t t> typename BP_tree<tkey, tvalue, compare, t>::bptree_const_iterator BP_tree<tkey, tvalue, compare, t>::lower_bound(const tkey& key) const", "your code should be here...");
+    return find_data(key) != nullptr;
 }
 
-template<typename tkey, typename tvalue, compator<tkey> compare, std::size_t t>
-typename BP_tree<tkey, tvalue, compare, t>::bptree_iterator BP_tree<tkey, tvalue, compare, t>::upper_bound(const tkey& key)
+template<typename tkey, typename tvalue, compator<tkey> compare, std::size_t t, bptree_node_layout layout>
+template<typename lookup_key> requires transparent_compator_for<compare, lookup_key, tkey>
+bool BP_tree<tkey, tvalue, compare, t, layout>::contains(const lookup_key& key) const
 {
-    throw not_implemented("template<typename tkey, typename tvalue, compator<tkey> compare, std::size_t t> typename BP_tree<tkey, tvalue, compare, t>::bptree_iterator BP_tree<tkey, tvalue, compare, t>::upper_bound(const tkey& key)", "your code should be here...");
+    return find_data(key) != nullptr;
 }
 
-template<typename tkey, typename tvalue, compator<tkey> compare, std::size_t t>
-typename BP_tree<tkey, tvalue, compare, t>::bptree_const_iterator BP_tree<tkey, tvalue, compare, t>::upper_bound(const tkey& key) const
+template<typename tkey, typename tvalue, compator<tkey> compare, std::size_t t, bptree_node_layout layout>
+void BP_tree<tkey, tvalue, compare, t, layout>::find_batch(std::span<const tkey> keys, std::span<tvalue*> result)
 {
-    throw not_implemented("template<typename tkey, typename tvalue, compator<tkey> compare, std::size_t t> typename BP_tree<tkey, tvalue, compare, t>::bptree_const_iterator BP_tree<tkey, tvalue, compare, t>::upper_bound(const tkey& key) const", "your code should be here...");
+    find_batch_values(keys, result);
 }
 
-template<typename tkey, typename tvalue, compator<tkey> compare, std::size_t t>
-bool BP_tree<tkey, tvalue, compare, t>::contains(const tkey& key) const
+template<typename tkey, typename tvalue, compator<tkey> compare, std::size_t t, bptree_node_layout layout>
+void BP_tree<tkey, tvalue, compare, t, layout>::find_batch(std::span<const tkey> keys, std::span<const tvalue*> result) const
 {
-    throw not_implemented("template<typename tkey, typename tvalue, compator<tkey> compare, std::size_t t> bool BP_tree<tkey, tvalue, compare, t>::contains(const tkey& key) const", "your code should be here...");
+    find_batch_values(keys, result);
 }
 
-template<typename tkey, typename tvalue, compator<tkey> compare, std::size_t t>
-void BP_tree<tkey, tvalue, compare, t>::clear() noexcept
+template<typename tkey, typename tvalue, compator<tkey> compare, std::size_t t, bptree_node_layout layout>
+void BP_tree<tkey, tvalue, compare, t, layout>::clear() noexcept
 {
-    throw not_implemented("template<typename tkey, typename tvalue, compator<tkey> compare, std::size_t t> void BP_tree<tkey, tvalue, compare, t>::clear() noexcept", "your code should be here...");
+    destroy_subtree(_root);
+    _root = nullptr;
+    _size = 0;
 }
 
-template<typename tkey, typename tvalue, compator<tkey> compare, std::size_t t>
-std::pair<typename BP_tree<tkey, tvalue, compare, t>::bptree_iterator, bool> BP_tree<tkey, tvalue, compare, t>::insert(tree_data_type&& data)
+template<typename tkey, typename tvalue, compator<tkey> compare, std::size_t t, bptree_node_layout layout>
+std::pair<typename BP_tree<tkey, tvalue, compare, t, layout>::bptree_iterator, bool> BP_tree<tkey, tvalue, compare, t, layout>::insert(tree_data_type&& data)
 {
-    throw not_implemented("template<typename tkey, typename tvalue, compator<tkey> compare, std::size_t t> std::pair<typename BP_tree<tkey, tvalue, compare, t>::bptree_iterator, bool> BP_tree<tkey, tvalue, compare, t>::insert(tree_data_type&& data)", "your code should be here...");
+    throw not_implemented("template<typename tkey, typename tvalue, compator<tkey> compare, std::size_t t, bptree_node_layout layout> std::pair<typename BP_tree<tkey, tvalue, compare, t, layout>::bptree_iterator, bool> BP_tree<tkey, tvalue, compare, t, layout>::insert(tree_data_type&& data)", "your code should be here...");
 }
 
-template<typename tkey, typename tvalue, compator<tkey> compare, std::size_t t>
+template<typename tkey, typename tvalue, compator<tkey> compare, std::size_t t, bptree_node_layout layout>
 template <typename ...Args>
-std::pair<typename BP_tree<tkey, tvalue, compare, t>::bptree_iterator, bool> BP_tree<tkey, tvalue, compare, t>::emplace(Args&&... args)
+std::pair<typename BP_tree<tkey, tvalue, compare, t, layout>::bptree_iterator, bool> BP_tree<tkey, tvalue, compare, t, layout>::emplace(Args&&... args)
 {
-    throw not_implemented("template<typename tkey, typename tvalue, compator<tkey> compare, std::size_t t> template <typename ...Args> std::pair<typename BP_tree<tkey, tvalue, compare, t>::bptree_iterator, bool> BP_tree<tkey, tvalue, compare, t>::emplace(Args&&... args)", "your code should be here...");
+    throw not_implemented("template<typename tkey, typename tvalue, compator<tkey> compare, std::size_t t, bptree_node_layout layout> template <typename ...Args> std::pair<typename BP_tree<tkey, tvalue, compare, t, layout>::bptree_iterator, bool> BP_tree<tkey, tvalue, compare, t, layout>::emplace(Args&&... args)", "your code should be here...");
 }
 
-template<typename tkey, typename tvalue, compator<tkey> compare, std::size_t t>
-typename BP_tree<tkey, tvalue, compare, t>::bptree_iterator BP_tree<tkey, tvalue, compare, t>::insert_or_assign(const tree_data_type& data)
+template<typename tkey, typename tvalue, compator<tkey> compare, std::size_t t, bptree_node_layout layout>
+typename BP_tree<tkey, tvalue, compare, t, layout>::bptree_iterator BP_tree<tkey, tvalue, compare, t, layout>::insert_or_assign(const tree_data_type& data)
 {
-    throw not_implemented("template<typename tkey, typename tvalue, compator<tkey> compare, std::size_t t> typename BP_tree<tkey, tvalue, compare, t>::bptree_iterator BP_tree<tkey, tvalue, compare, t>::insert_or_assign(const tree_data_type& data)", "your code should be here...");
+    throw not_implemented("template<typename tkey, typename tvalue, compator<tkey> compare, std::size_t t, bptree_node_layout layout> typename BP_tree<tkey, tvalue, compare, t, layout>::bptree_iterator BP_tree<tkey, tvalue, compare, t, layout>::insert_or_assign(const tree_data_type& data)", "your code should be here...");
 }
 
-template<typename tkey, typename tvalue, compator<tkey> compare, std::size_t t>
-typename BP_tree<tkey, tvalue, compare, t>::bptree_iterator BP_tree<tkey, tvalue, compare, t>::insert_or_assign(tree_data_type&& data)
+template<typename tkey, typename tvalue, compator<tkey> compare, std::size_t t, bptree_node_layout layout>
+typename BP_tree<tkey, tvalue, compare, t, layout>::bptree_iterator BP_tree<tkey, tvalue, compare, t, layout>::insert_or_assign(tree_data_type&& data)
 {
-    throw not_implemented("template<typename tkey, typename tvalue, compator<tkey> compare, std::size_t t> typename BP_tree<tkey, tvalue, compare, t>::bptree_iterator BP_tree<tkey, tvalue, compare, t>::insert_or_assign(tree_data_type&& data)", "your code should be here...");
+    throw not_implemented("template<typename tkey, typename tvalue, compator<tkey> compare, std::size_t t, bptree_node_layout layout> typename BP_tree<tkey, tvalue, compare, t, layout>::bptree_iterator BP_tree<tkey, tvalue, compare, t, layout>::insert_or_assign(tree_data_type&& data)", "your code should be here...");
 }
 
-template<typename tkey, typename tvalue, compator<tkey> compare, std::size_t t>
+template<typename tkey, typename tvalue, compator<tkey> compare, std::size_t t, bptree_node_layout layout>
 template <typename ...Args>
-typename BP_tree<tkey, tvalue, compare, t>::bptree_iterator BP_tree<tkey, tvalue, compare, t>::emplace_or_assign(Args&&... args)
+typename BP_tree<tkey, tvalue, compare, t, layout>::bptree_iterator BP_tree<tkey, tvalue, compare, t, layout>::emplace_or_assign(Args&&... args)
 {
-    throw not_implemented("template<typename tkey, typename tvalue, compator<tkey> compare, std::size_t t> template <typename ...Args> typename BP_tree<tkey, tvalue, compare, t>::bptree_iterator BP_tree<tkey, tvalue, compare, t>::emplace_or_assign(Args&&... args)", "your code should be here...");
+    throw not_implemented("template<typename tkey, typename tvalue, compator<tkey> compare, std::size_t t, bptree_node_layout layout> template <typename ...Args> typename BP_tree<tkey, tvalue, compare, t, layout>::bptree_iterator BP_tree<tkey, tvalue, compare, t, layout>::emplace_or_assign(Args&&... args)", "your code should be here...");
 }
 
-template<typename tkey, typename tvalue, compator<tkey> compare, std::size_t t>
-typename BP_tree<tkey, tvalue, compare, t>::bptree_iterator BP_tree<tkey, tvalue, compare, t>::erase(bptree_iterator pos)
+template<typename tkey, typename tvalue, compator<tkey> compare, std::size_t t, bptree_node_layout layout>
+typename BP_tree<tkey, tvalue, compare, t, layout>::bptree_iterator BP_tree<tkey, tvalue, compare, t, layout>::erase(bptree_iterator pos)
 {
-    throw not_implemented("template<typename tkey, typename tvalue, compator<tkey> compare, std::size_t t> typename BP_tree<tkey, tvalue, compare, t>::bptree_iterator BP_tree<tkey, tvalue, compare, t>::erase(bptree_iterator pos)", "your code should be here...");
+    throw not_implemented("template<typename tkey, typename tvalue, compator<tkey> compare, std::size_t t, bptree_node_layout layout> typename BP_tree<tkey, tvalue, compare, t, layout>::bptree_iterator BP_tree<tkey, tvalue, compare, t, layout>::erase(bptree_iterator pos)", "your code should be here...");
 }
 
-template<typename tkey, typename tvalue, compator<tkey> compare, std::size_t t>
-typename BP_tree<tkey, tvalue, compare, t>::bptree_iterator BP_tree<tkey, tvalue, compare, t>::erase(bptree_const_iterator pos)
+template<typename tkey, typename tvalue, compator<tkey> compare, std::size_t t, bptree_node_layout layout>
+typename BP_tree<tkey, tvalue, compare, t, layout>::bptree_iterator BP_tree<tkey, tvalue, compare, t, layout>::erase(bptree_const_iterator pos)
 {
-    throw not_implemented("template<typename tkey, typename tvalue, compator<tkey> compare, std::size_t t> typename BP_tree<tkey, tvalue, compare, t>::bptree_iterator BP_tree<tkey, tvalue, compare, t>::erase(bptree_const_iterator pos)", "your code should be here...");
+    throw not_implemented("template<typename tkey, typename tvalue, compator<tkey> compare, std::size_t t, bptree_node_layout layout> typename BP_tree<tkey, tvalue, compare, t, layout>::bptree_iterator BP_tree<tkey, tvalue, compare, t, layout>::erase(bptree_const_iterator pos)", "your code should be here...");
 }
 
-template<typename tkey, typename tvalue, compator<tkey> compare, std::size_t t>
-typename BP_tree<tkey, tvalue, compare, t>::bptree_iterator BP_tree<tkey, tvalue, compare, t>::erase(bptree_iterator beg, bptree_iterator en)
+template<typename tkey, typename tvalue, compator<tkey> compare, std::size_t t, bptree_node_layout layout>
+typename BP_tree<tkey, tvalue, compare, t, layout>::bptree_iterator BP_tree<tkey, tvalue, compare, t, layout>::erase(bptree_iterator beg, bptree_iterator en)
 {
-    throw not_implemented("template<typename tkey, typename tvalue, compator<tkey> compare, std::size_t t> typename BP_tree<tkey, tvalue, compare, t>::bptree_iterator BP_tree<tkey, tvalue, compare, t>::erase(bptree_iterator beg, bptree_iterator en)", "your code should be here...");
+    throw not_implemented("template<typename tkey, typename tvalue, compator<tkey> compare, std::size_t t, bptree_node_layout layout> typename BP_tree<tkey, tvalue, compare, t, layout>::bptree_iterator BP_tree<tkey, tvalue, compare, t, layout>::erase(bptree_iterator beg, bptree_iterator en)", "your code should be here...");
 }
 
-template<typename tkey, typename tvalue, compator<tkey> compare, std::size_t t>
-typename BP_tree<tkey, tvalue, compare, t>::bptree_iterator BP_tree<tkey, tvalue, compare, t>::erase(bptree_const_iterator beg, bptree_const_iterator en)
+template<typename tkey, typename tvalue, compator<tkey> compare, std::size_t t, bptree_node_layout layout>
+typename BP_tree<tkey, tvalue, compare, t, layout>::bptree_iterator BP_tree<tkey, tvalue, compare, t, layout>::erase(bptree_const_iterator beg, bptree_const_iterator en)
 {
-    throw not_implemented("template<typename tkey, typename tvalue, compator<tkey> compare, std::size_t t> typename BP_tree<tkey, tvalue, compare, t>::bptree_iterator BP_tree<tkey, tvalue, compare, t>::erase(bptree_const_iterator beg, bptree_const_iterator en)", "your code should be here...");
+    throw not_implemented("template<typename tkey, typename tvalue, compator<tkey> compare, std::size_t t, bptree_node_layout layout> typename BP_tree<tkey, tvalue, compare, t, layout>::bptree_iterator BP_tree<tkey, tvalue, compare, t, layout>::erase(bptree_const_iterator beg, bptree_const_iterator en)", "your code should be here...");
 }
 
-template<typename tkey, typename tvalue, compator<tkey> compare, std::size_t t>
-typename BP_tree<tkey, tvalue, compare, t>::bptree_iterator BP_tree<tkey, tvalue, compare, t>::erase(const tkey& key)
+template<typename tkey, typename tvalue, compator<tkey> compare, std::size_t t, bptree_node_layout layout>
+typename BP_tree<tkey, tvalue, compare, t, layout>::bptree_iterator BP_tree<tkey, tvalue, compare, t, layout>::erase(const tkey& key)
 {
-    throw not_implemented("template<typename tkey, typename tvalue, compator<tkey> compare, std::size_t t> typename BP_tree<tkey, tvalue, compare, t>::bptree_iterator BP_tree<tkey, tvalue, compare, t>::erase(const tkey& key)", "your code should be here...");
+    throw not_implemented("template<typename tkey, typename tvalue, compator<tkey> compare, std::size_t t, bptree_node_layout layout> typename BP_tree<tkey, tvalue, compare, t, layout>::bptree_iterator BP_tree<tkey, tvalue, compare, t, layout>::erase(const tkey& key)", "your code should be here...");
+}
+
+template<typename tkey, typename tvalue, compator<tkey> compare, std::size_t t, bptree_node_layout layout>
+void BP_tree<tkey, tvalue, compare, t, layout>::destroy_node(bptree_node_base* node) noexcept
+{
+    if (node->_is_terminate)
+    {
+        _allocator.delete_object(static_cast<bptree_node_term*>(node));
+    } else
+    {
+        _allocator.delete_object(static_cast<bptree_node_middle*>(node));
+    }
 }
 
+template<typename tkey, typename tvalue, compator<tkey> compare, std::size_t t, bptree_node_layout layout>
+void BP_tree<tkey, tvalue, compare, t, layout>::destroy_subtree(bptree_node_base* node) noexcept
+{
+    if (node == nullptr)
+    {
+        return;
+    }
+
+    if (!node->_is_terminate)
+    {
+        for (bptree_node_base* child : static_cast<bptree_node_middle*>(node)->_pointers)
+        {
+            destroy_subtree(child);
+        }
+    }
+
+    destroy_node(node);
+}
+
+// region node search implementation
+
+template<typename tkey, typename tvalue, compator<tkey> compare, std::size_t t, bptree_node_layout layout>
+template<typename lookup_key>
+size_t BP_tree<tkey, tvalue, compare, t, layout>::node_upper_bound(const bptree_node_middle* node, const lookup_key& key) const
+{
+    // Keys of middle nodes are stored without values already
+    if constexpr (vectorized_search && std::same_as<lookup_key, tkey>)
+    {
+        return __detail::keys_upper_bound(node->_keys.data(), node->_keys.size(), key);
+    } else
+    {
+        auto it = std::upper_bound(node->_keys.begin(), node->_keys.end(), key, [this](const lookup_key& needle, const tkey& item)
+        {
+            return compare_keys(needle, item);
+        });
+        return std::distance(node->_keys.begin(), it);
+    }
+}
+
+template<typename tkey, typename tvalue, compator<tkey> compare, std::size_t t, bptree_node_layout layout>
+template<typename lookup_key>
+size_t BP_tree<tkey, tvalue, compare, t, layout>::node_lower_bound(const bptree_node_term* node, const lookup_key& key) const
+{
+    if constexpr (vectorized_search && std::same_as<lookup_key, tkey>)
+    {
+        return node->_search_keys.lower_bound(key);
+    } else
+    {
+        auto it = std::lower_bound(node->_data.begin(), node->_data.end(), key, [this](const tree_data_type& item, const lookup_key& needle)
+        {
+            return compare_keys(item.first, needle);
+        });
+        return std::distance(node->_data.begin(), it);
+    }
+}
+
+template<typename tkey, typename tvalue, compator<tkey> compare, std::size_t t, bptree_node_layout layout>
+template<typename lookup_key>
+typename BP_tree<tkey, tvalue, compare, t, layout>::bptree_node_term* BP_tree<tkey, tvalue, compare, t, layout>::find_leaf(const lookup_key& key) const
+{
+    if (_root == nullptr)
+    {
+        return nullptr;
+    }
+
+    bptree_node_base* node = _root;
+
+    while (!node->_is_terminate)
+    {
+        auto middle = static_cast<bptree_node_middle*>(node);
+        node = middle->_pointers[node_upper_bound(middle, key)];
+    }
+
+    return static_cast<bptree_node_term*>(node);
+}
+
+template<typename tkey, typename tvalue, compator<tkey> compare, std::size_t t, bptree_node_layout layout>
+template<typename lookup_key>
+const typename BP_tree<tkey, tvalue, compare, t, layout>::tree_data_type* BP_tree<tkey, tvalue, compare, t, layout>::find_data(const lookup_key& key) const
+{
+    const bptree_node_term* leaf = find_leaf(key);
+
+    if (leaf == nullptr)
+    {
+        return nullptr;
+    }
+
+    size_t index = node_lower_bound(leaf, key);
+
+    if (index < leaf->_data.size() && !compare_keys(key, leaf->_data[index].first))
+    {
+        return &leaf->_data[index];
+    }
+
+    return nullptr;
+}
+
+template<typename tkey, typename tvalue, compator<tkey> compare, std::size_t t, bptree_node_layout layout>
+template<typename value_pointer>
+void BP_tree<tkey, tvalue, compare, t, layout>::find_batch_values(std::span<const tkey> keys, std::span<value_pointer> result) const
+{
+    if (keys.size() != result.size())
+    {
+        throw std::invalid_argument("keys and result of batch lookup differ in size");
+    }
+
+    constexpr size_t node_bytes = std::min(std::max(sizeof(bptree_node_term), sizeof(bptree_node_middle)), batch_prefetch_bytes);
+    bptree_node_base* nodes[batch_width];
+
+    for (size_t first = 0; first < keys.size(); first += batch_width)
+    {
+        size_t count = std::min(batch_width, keys.size() - first);
+
+        if (_root == nullptr)
+        {
+            std::fill_n(result.begin() + first, count, nullptr);
+            continue;
+        }
+
+        std::fill_n(nodes, count, _root);
+
+        while (!nodes[0]->_is_terminate)
+        {
+            for (size_t i = 0; i < count; ++i)
+            {
+                auto middle = static_cast<bptree_node_middle*>(nodes[i]);
+                nodes[i] = middle->_pointers[node_upper_bound(middle, keys[first + i])];
+                __detail::prefetch(nodes[i], node_bytes);
+            }
+        }
+
+        for (size_t i = 0; i < count; ++i)
+        {
+            auto leaf = static_cast<bptree_node_term*>(nodes[i]);
+            size_t index = node_lower_bound(leaf, keys[first + i]);
+
+            result[first + i] = index < leaf->_data.size() && !compare_keys(keys[first + i], leaf->_data[index].first)
+                    ? &leaf->_data[index].second : nullptr;
+        }
+    }
+}
+
+template<typename tkey, typename tvalue, compator<tkey> compare, std::size_t t, bptree_node_layout layout>
+template<typename lookup_key>
+typename BP_tree<tkey, tvalue, compare, t, layout>::tree_data_type* BP_tree<tkey, tvalue, compare, t, layout>::find_data(const lookup_key& key)
+{
+    return const_cast<tree_data_type*>(std::as_const(*this).find_data(key));
+}
+
+// endregion node search implementation
+
+// region scan implementation
+
+template<typename tkey, typename tvalue, compator<tkey> compare, std::size_t t, bptree_node_layout layout>
+void BP_tree<tkey, tvalue, compare, t, layout>::prefetch_ahead(const bptree_node_term* leaf) noexcept
+{
+    // Link is read from the leaf being scanned, going further would wait for the leaf just requested
+    if (leaf->_next != nullptr)
+    {
+        __detail::prefetch(leaf->_next, std::min(sizeof(bptree_node_term), scan_prefetch_bytes));
+    }
+}
+
+template<typename tkey, typename tvalue, compator<tkey> compare, std::size_t t, bptree_node_layout layout>
+size_t BP_tree<tkey, tvalue, compare, t, layout>::scan_end(const bptree_node_term* leaf, const tkey& hi) const
+{
+    if (leaf->_data.empty() || compare_keys(leaf->_data.back().first, hi))
+    {
+        return leaf->_data.size();
+    }
+
+    return node_lower_bound(leaf, hi);
+}
+
+template<typename tkey, typename tvalue, compator<tkey> compare, std::size_t t, bptree_node_layout layout>
+template<std::invocable<const tkey&, const tvalue&> callback>
+size_t BP_tree<tkey, tvalue, compare, t, layout>::scan(const tkey& lo, const tkey& hi, callback&& visit) const
+{
+    if (!compare_keys(lo, hi))
+    {
+        return 0;
+    }
+
+    bptree_node_term* leaf = find_leaf(lo);
+    size_t index = leaf == nullptr ? 0 : node_lower_bound(leaf, lo);
+    size_t visited = 0;
+
+    while (leaf != nullptr)
+    {
+        prefetch_ahead(leaf);
+
+        size_t end = scan_end(leaf, hi);
+
+        for (; index < end; ++index)
+        {
+            const tree_data_type& item = leaf->_data[index];
+            ++visited;
+
+            if constexpr (std::same_as<std::invoke_result_t<callback&, const tkey&, const tvalue&>, bool>)
+            {
+                if (!visit(item.first, item.second))
+                {
+                    return visited;
+                }
+            } else
+            {
+                visit(item.first, item.second);
+            }
+        }
+
+        if (end < leaf->_data.size())
+        {
+            break;
+        }
+
+        leaf = leaf->_next;
+        index = 0;
+    }
+
+    return visited;
+}
+
+template<typename tkey, typename tvalue, compator<tkey> compare, std::size_t t, bptree_node_layout layout>
+typename BP_tree<tkey, tvalue, compare, t, layout>::bptree_scan_cursor BP_tree<tkey, tvalue, compare, t, layout>::scan(const tkey& lo, const tkey& hi) const
+{
+    if (!compare_keys(lo, hi))
+    {
+        return bptree_scan_cursor(this, nullptr, 0, hi);
+    }
+
+    bptree_node_term* leaf = find_leaf(lo);
+
+    if (leaf != nullptr)
+    {
+        prefetch_ahead(leaf);
+    }
+
+    return bptree_scan_cursor(this, leaf, leaf == nullptr ? 0 : node_lower_bound(leaf, lo), hi);
+}
+
+template<typename tkey, typename tvalue, compator<tkey> compare, std::size_t t, bptree_node_layout layout>
+BP_tree<tkey, tvalue, compare, t, layout>::bptree_scan_cursor::bptree_scan_cursor(const BP_tree* tree, bptree_node_term* node, size_t index, const tkey& hi)
+    : _tree(tree), _node(node), _index(index), _hi(hi)
+{
+}
+
+template<typename tkey, typename tvalue, compator<tkey> compare, std::size_t t, bptree_node_layout layout>
+size_t BP_tree<tkey, tvalue, compare, t, layout>::bptree_scan_cursor::fetch(std::span<tree_data_type> buffer)
+{
+    size_t count = 0;
+
+    while (_node != nullptr && count < buffer.size())
+    {
+        size_t end = _tree->scan_end(_node, _hi);
+        size_t taken = std::min(end - std::min(_index, end), buffer.size() - count);
+
+        std::copy_n(_node->_data.begin() + _index, taken, buffer.begin() + count);
+        count += taken;
+        _index += taken;
+
+        if (_index < end)
+        {
+            break;
+        }
+
+        if (end < _node->_data.size())
+        {
+            _node = nullptr;
+            break;
+        }
+
+        _node = _node->_next;
+        _index = 0;
+
+        if (_node != nullptr)
+        {
+            prefetch_ahead(_node);
+        }
+    }
+
+    return count;
+}
+
+template<typename tkey, typename tvalue, compator<tkey> compare, std::size_t t, bptree_node_layout layout>
+bool BP_tree<tkey, tvalue, compare, t, layout>::bptree_scan_cursor::done() const noexcept
+{
+    return _node == nullptr;
+}
+
+// endregion scan implementation
+
+// region bulk load implementation
+
+template<typename tkey, typename tvalue, compator<tkey> compare, std::size_t t, bptree_node_layout layout>
+size_t BP_tree<tkey, tvalue, compare, t, layout>::bulk_nodes_count(size_t count, size_t capacity, size_t minimum, size_t maximum) noexcept
+{
+    if (count <= maximum)
+    {
+        return 1;
+    }
+
+    size_t packed = (count + capacity - 1) / capacity;
+    size_t sparsest = count / std::max<size_t>(minimum, 1);
+
+    return std::max<size_t>(std::min(packed, sparsest), 2);
+}
+
+template<typename tkey, typename tvalue, compator<tkey> compare, std::size_t t, bptree_node_layout layout>
+template<std::forward_iterator iterator>
+void BP_tree<tkey, tvalue, compare, t, layout>::bulk_load(iterator begin, size_t count, double fill_factor)
+{
+    if (!(fill_factor > 0 && fill_factor <= 1))
+    {
+        throw std::invalid_argument("fill factor must be in (0, 1]");
+    }
+
+    if (count == 0)
+    {
+        return;
+    }
+
+    const size_t leaf_capacity = std::clamp<size_t>(static_cast<size_t>(fill_factor * maximum_keys_in_leaf),
+                                                    std::max<size_t>(minimum_keys_in_leaf, 1), maximum_keys_in_leaf);
+    const size_t middle_capacity = std::clamp<size_t>(static_cast<size_t>(fill_factor * maximum_keys_in_middle),
+                                                      std::max<size_t>(minimum_keys_in_middle, 1), maximum_keys_in_middle);
+
+    std::vector<bptree_node_base*> created;
+
+    try
+    {
+        size_t nodes = bulk_nodes_count(count, leaf_capacity, minimum_keys_in_leaf, maximum_keys_in_leaf);
+
+        std::vector<bptree_node_base*> level;
+        std::vector<tkey> lows;
+        level.reserve(nodes);
+        lows.reserve(nodes);
+
+        const tkey* previous = nullptr;
+        bptree_node_term* previous_leaf = nullptr;
+
+        for (size_t i = 0; i < nodes; ++i)
+        {
+            bptree_node_term* leaf = _allocator.template new_object<bptree_node_term>();
+            created.push_back(leaf);
+            leaf->_is_terminate = true;
+            leaf->_next = nullptr;
+
+            for (size_t j = 0, size = count / nodes + (i < count % nodes ? 1 : 0); j < size; ++j, ++begin)
+            {
+                auto&& item = *begin;
+
+                if (previous != nullptr && !compare_keys(*previous, item.first))
+                {
+                    throw std::logic_error("bulk load input must be strictly increasing by key");
+                }
+
+                leaf->_data.emplace_back(std::forward<decltype(item)>(item));
+                previous = &leaf->_data.back().first;
+            }
+            leaf->_search_keys.assign(leaf->_data);
+
+            if (previous_leaf != nullptr)
+            {
+                previous_leaf->_next = leaf;
+            }
+            previous_leaf = leaf;
+
+            // Separator only has to be above the last key of previous leaf, so it may be shorter than key it precedes
+            if (level.empty())
+            {
+                lows.push_back(leaf->_data.front().first);
+            } else
+            {
+                lows.push_back(bptree_separator<tkey, compare>::shorten(
+                        static_cast<bptree_node_term*>(level.back())->_data.back().first, leaf->_data.front().first));
+            }
+            level.push_back(leaf);
+        }
+
+        // Every child but the first one of a node is separated by low bound of its keys
+        while (level.size() > 1)
+        {
+            nodes = bulk_nodes_count(level.size(), middle_capacity + 1, minimum_keys_in_middle + 1, maximum_keys_in_middle + 1);
+
+            std::vector<bptree_node_base*> next_level;
+            std::vector<tkey> next_lows;
+            next_level.reserve(nodes);
+            next_lows.reserve(nodes);
+
+            size_t child = 0;
+
+            for (size_t i = 0; i < nodes; ++i)
+            {
+                bptree_node_middle* node = _allocator.template new_object<bptree_node_middle>();
+                created.push_back(node);
+                node->_is_terminate = false;
+
+                next_lows.push_back(std::move(lows[child]));
+                node->_pointers.push_back(level[child++]);
+
+                for (size_t j = 1, size = level.size() / nodes + (i < level.size() % nodes ? 1 : 0); j < size; ++j)
+                {
+                    node->_keys.push_back(std::move(lows[child]));
+                    node->_pointers.push_back(level[child++]);
+                }
+
+                next_level.push_back(node);
+            }
+
+            level = std::move(next_level);
+            lows = std::move(next_lows);
+        }
+
+        _root = level.front();
+        _size = count;
+    }
+    catch (...)
+    {
+        for (auto node : created)
+        {
+            destroy_node(node);
+        }
+        throw;
+    }
+}
+
+// endregion bulk load implementation
+
+
 #endif
\ No newline at end of file
@@ -1,7 +1,9 @@
 #include "gtest/gtest.h"
 
+#include <algorithm>
 #include <list>
 #include <random>
+#include <string_view>
 #include <vector>
 #include <b_plus_tree.h>
 #include <client_logger_builder.h>
@@ -591,6 +593,289 @@ TEST(bTreeNegativeTests, test3)
     logger->trace("bTreeNegativeTests.test3 finished");
 }
 
+TEST(bTreeBulkLoadTests, test1)
+{
+    std::vector<std::pair<int, std::string>> data;
+
+    for (int i = 0; i < 1000; ++i)
+    {
+        data.emplace_back(i * 2, std::to_string(i));
+    }
+
+    BP_tree<int, std::string, std::less<int>, 3> tree(sorted_unique, data.begin(), data.end(), 0.7, std::less<int>(), nullptr, nullptr);
+
+    EXPECT_EQ(tree.size(), data.size());
+
+    auto expected = data.begin();
+    for (auto const &item: tree)
+    {
+        EXPECT_EQ(item.first, expected->first);
+        EXPECT_EQ(item.second, expected->second);
+        ++expected;
+    }
+    EXPECT_EQ(expected, data.end());
+}
+
+TEST(bTreeBulkLoadTests, test2)
+{
+    std::vector<std::pair<int, std::string>> data =
+    {
+        { 1, "a" }, { 2, "b" }, { 3, "c" }, { 3, "d" }, { 4, "e" }
+    };
+
+    using tree_type = BP_tree<int, std::string, std::less<int>, 3>;
+
+    EXPECT_THROW(tree_type(sorted_unique, data.begin(), data.end(), 1.0, std::less<int>(), nullptr, nullptr), std::logic_error);
+    EXPECT_THROW(tree_type(sorted_unique, data.begin(), data.begin() + 3, 0.0, std::less<int>(), nullptr, nullptr), std::invalid_argument);
+}
+
+TEST(bTreeBulkLoadTests, test3)
+{
+    using separator = bptree_separator<std::string, std::less<std::string>>;
+
+    EXPECT_EQ(separator::shorten("https://a.org/path/apple", "https://a.org/path/banana"), "https://a.org/path/b");
+    EXPECT_EQ(separator::shorten("abc", "abcd"), "abcd");
+    EXPECT_EQ(separator::shorten("abc", "abd"), "abd");
+    EXPECT_EQ((bptree_separator<int, std::less<int>>::shorten(1, 7)), 7);
+
+    // Long shared prefixes, middle nodes get separators cut after the first differing character
+    std::vector<std::pair<std::string, int>> data;
+
+    for (int i = 0; i < 2000; ++i)
+    {
+        std::string number = std::to_string(100000 + i * 3);
+        data.emplace_back("https://example.com/catalog/" + number + "/details", i);
+    }
+
+    BP_tree<std::string, int, std::less<std::string>, 3> tree(sorted_unique, data.begin(), data.end(), 1.0, std::less<std::string>(), nullptr, nullptr);
+
+    for (auto const &[key, value]: data)
+    {
+        EXPECT_EQ(tree.at(key), value);
+        EXPECT_FALSE(tree.contains(key + "/more"));
+        EXPECT_FALSE(tree.contains(key.substr(0, key.size() - 1)));
+    }
+
+    std::vector<int> values;
+    tree.scan(data[10].first + "!", data[20].first, [&values](const std::string&, const int& value) { values.push_back(value); });
+
+    ASSERT_EQ(values.size(), 9);
+    EXPECT_EQ(values.front(), 11);
+    EXPECT_EQ(values.back(), 19);
+}
+
+TEST(bTreeLookupTests, test1)
+{
+    std::vector<std::pair<int, std::string>> data;
+
+    for (int i = 0; i < 500; ++i)
+    {
+        data.emplace_back(i * 3, std::to_string(i));
+    }
+
+    BP_tree<int, std::string, std::less<int>, 3> tree(sorted_unique, data.begin(), data.end(), 0.8, std::less<int>(), nullptr, nullptr);
+    const auto& view = tree;
+
+    for (int key = -3; key <= 1500; ++key)
+    {
+        bool present = key >= 0 && key < 1500 && key % 3 == 0;
+
+        EXPECT_EQ(view.contains(key), present);
+
+        if (present)
+        {
+            EXPECT_EQ(view.at(key), std::to_string(key / 3));
+        } else
+        {
+            EXPECT_THROW(view.at(key), std::out_of_range);
+        }
+    }
+
+    tree.at(300) = "changed";
+
+    EXPECT_EQ(view.at(300), "changed");
+}
+
+TEST(bTreeLookupTests, test2)
+{
+    std::vector<std::pair<std::string, int>> data;
+
+    for (int i = 0; i < 500; ++i)
+    {
+        data.emplace_back(std::to_string(i), i);
+    }
+
+    std::sort(data.begin(), data.end());
+
+    BP_tree<std::string, int, std::less<>, 3> tree(sorted_unique, data.begin(), data.end(), 0.8, std::less<>(), nullptr, nullptr);
+    const auto& view = tree;
+
+    EXPECT_EQ(view.at(std::string_view("42")), 42);
+    EXPECT_TRUE(tree.contains("7"));
+    EXPECT_TRUE(view.contains(std::string_view("499")));
+    EXPECT_FALSE(view.contains(std::string_view("500")));
+    EXPECT_FALSE(tree.contains(""));
+    EXPECT_THROW(view.at("x"), std::out_of_range);
+
+    tree.at(std::string_view("3")) = -1;
+
+    EXPECT_EQ(view.at("3"), -1);
+}
+
+TEST(bTreeLookupTests, test3)
+{
+    std::vector<std::pair<int, int>> data;
+
+    for (int i = 0; i < 3000; ++i)
+    {
+        data.emplace_back(i * 3, i);
+    }
+
+    BP_tree<int, int, std::less<int>, 3> tree(sorted_unique, data.begin(), data.end(), 0.8, std::less<int>(), nullptr, nullptr);
+    const auto& view = tree;
+
+    // More keys than one interleaved group, hits and misses mixed in random order
+    std::mt19937 gen(37);
+    std::vector<int> keys(1000);
+
+    for (auto& key: keys)
+    {
+        key = static_cast<int>(gen() % 9100) - 50;
+    }
+
+    std::vector<int*> values(keys.size());
+    std::vector<const int*> const_values(keys.size());
+
+    tree.find_batch(keys, values);
+    view.find_batch(keys, const_values);
+
+    for (size_t i = 0; i < keys.size(); ++i)
+    {
+        if (view.contains(keys[i]))
+        {
+            ASSERT_NE(values[i], nullptr);
+            EXPECT_EQ(*values[i], keys[i] / 3);
+            EXPECT_EQ(const_values[i], &view.at(keys[i]));
+        } else
+        {
+            EXPECT_EQ(values[i], nullptr);
+            EXPECT_EQ(const_values[i], nullptr);
+        }
+    }
+
+    std::vector<int*> shorter(keys.size() - 1);
+    EXPECT_THROW(tree.find_batch(keys, shorter), std::invalid_argument);
+
+    BP_tree<int, int, std::less<int>, 3> empty;
+    empty.find_batch(keys, values);
+
+    EXPECT_TRUE(std::all_of(values.begin(), values.end(), [](int* value) { return value == nullptr; }));
+}
+
+TEST(bTreeConstructorTests, test1)
+{
+    using tree_type = BP_tree<int, std::string, std::less<int>, 3>;
+
+    // Unsorted input is sorted, the first value of repeated key is kept
+    tree_type small{ { 5, "a" }, { 1, "b" }, { 3, "c" }, { 1, "d" }, { 4, "e" }, { 5, "f" } };
+    std::vector<std::pair<int, std::string>> expected = { { 1, "b" }, { 3, "c" }, { 4, "e" }, { 5, "a" } };
+
+    EXPECT_EQ(small.size(), expected.size());
+
+    auto next = expected.begin();
+    for (auto const &item: small)
+    {
+        EXPECT_EQ(item.first, next->first);
+        EXPECT_EQ(item.second, next->second);
+        ++next;
+    }
+    EXPECT_EQ(next, expected.end());
+
+    std::vector<std::pair<int, std::string>> data;
+
+    for (int i = 0; i < 2000; ++i)
+    {
+        data.emplace_back(i % 700, std::to_string(i));
+    }
+
+    std::shuffle(data.begin(), data.end(), std::mt19937(27));
+
+    tree_type tree(data.begin(), data.end());
+
+    EXPECT_EQ(tree.size(), size_t(700));
+
+    int key = 0;
+    for (auto const &item: tree)
+    {
+        auto first = std::find_if(data.begin(), data.end(), [key](auto const &pair) { return pair.first == key; });
+        EXPECT_EQ(item.first, key);
+        EXPECT_EQ(item.second, first->second);
+        ++key;
+    }
+    EXPECT_EQ(key, 700);
+}
+
+template<typename tree_type>
+void layout_test()
+{
+    std::vector<std::pair<int, std::string>> data;
+
+    for (int i = 0; i < 1000; ++i)
+    {
+        data.emplace_back(i * 2, std::to_string(i));
+    }
+
+    tree_type tree(sorted_unique, data.begin(), data.end(), 1.0, std::less<int>(), nullptr, nullptr);
+
+    EXPECT_EQ(tree.size(), data.size());
+
+    for (int i = 0; i < 2000; ++i)
+    {
+        EXPECT_EQ(tree.contains(i), i % 2 == 0);
+    }
+    EXPECT_EQ(tree.at(500), "250");
+    EXPECT_THROW(tree.at(501), std::out_of_range);
+}
+
+TEST(bTreeLayoutTests, test1)
+{
+    // Each instantiation checks node sizes and fanout of its layout at compile time
+    layout_test<BP_tree<int, std::string, std::less<int>, 5, bptree_degree_layout>>();
+    layout_test<BP_tree<int, std::string, std::less<int>, 5, bptree_sized_layout<256>>>();
+    layout_test<BP_tree<int, std::string, std::less<int>, 5, bptree_sized_layout<1000>>>();
+    layout_test<BP_tree<int, std::string, std::less<int>, 5, bptree_sized_layout<4096>>>();
+}
+
+TEST(bTreeScanTests, test1)
+{
+    std::vector<std::pair<int, std::string>> data;
+
+    for (int i = 0; i < 1000; ++i)
+    {
+        data.emplace_back(i * 2, std::to_string(i));
+    }
+
+    BP_tree<int, std::string, std::less<int>, 3> tree(sorted_unique, data.begin(), data.end(), 1.0, std::less<int>(), nullptr, nullptr);
+
+    std::vector<int> keys;
+    EXPECT_EQ(tree.scan(101, 201, [&keys](const int& key, const std::string&) { keys.push_back(key); }), 50);
+    EXPECT_EQ(keys.front(), 102);
+    EXPECT_EQ(keys.back(), 200);
+
+    EXPECT_EQ(tree.scan(0, 2000, [](const int& key, const std::string&) { return key < 10; }), 6);
+
+    auto cursor = tree.scan(-10, 3000);
+    std::vector<std::pair<int, std::string>> buffer(64), fetched;
+
+    for (size_t count; (count = cursor.fetch(buffer)) != 0; )
+    {
+        fetched.insert(fetched.end(), buffer.begin(), buffer.begin() + count);
+    }
+
+    EXPECT_TRUE(cursor.done());
+    EXPECT_EQ(fetched, data);
+}
+
 int main(
         int argc,
         char **argv)
@@ -1,4 +1,6 @@
 #include <iterator>
+#include <algorithm>
+#include <stdexcept>
 #include <utility>
 #include <vector>
 #include <boost/container/static_vector.hpp>
@@ -6,6 +8,7 @@
 #include <stack>
 #include <pp_allocator.h>
 #include <search_tree.h>
+#include <node_search.h>
 #include <initializer_list>
 #include <logger_guardant.h>
 
@@ -26,6 +29,7 @@ private:
     // TODO: Another restrictions
     static constexpr const size_t minimum_keys_in_node = t - 1;
     static constexpr const size_t maximum_keys_in_node = 2 * t - 1;
+    static constexpr const bool vectorized_search = vectorized_key_search_v<tkey, compare>;
 
     // region comparators declaration
 
@@ -51,6 +55,8 @@ private:
 
 
         boost::container::static_vector<tree_data_type, maximum_keys_in_node + 1> _data;
+        /* Copy of keys from _data for vectorized search, changed together with _data */
+        [[no_unique_address]] node_search_keys<tkey, maximum_keys_in_node + 1, vectorized_search> _search_keys;
         bsptree_node_term() noexcept;
     };
 
@@ -74,6 +80,43 @@ private:
     logger* get_logger() const noexcept override;
     pp_allocator<value_type> get_allocator() const noexcept;
 
+    /** Frees node with all nodes below it, allocator is given the real kind of every node
+     */
+    void destroy_subtree(bsptree_node_base* node) noexcept;
+
+    // region bulk load declaration
+
+    static constexpr const double default_fill_factor = 1.0;
+
+    /** Number of nodes one level of count items is packed into, each node gets between minimum and maximum items
+     */
+    static size_t bulk_nodes_count(size_t count, size_t capacity, size_t minimum, size_t maximum) noexcept;
+
+    /** Builds empty tree bottom-up from count strictly increasing items, leaves are linked in one pass
+     */
+    template<std::forward_iterator iterator>
+    void bulk_load(iterator begin, size_t count, double fill_factor);
+
+    // endregion bulk load declaration
+
+    // region node search declaration
+
+    /** Index of the child of middle node which may hold key
+     */
+    size_t node_upper_bound(const bsptree_node_middle* node, const tkey& key) const;
+
+    /** Index of the first key of leaf not less than key
+     */
+    size_t node_lower_bound(const bsptree_node_term* node, const tkey& key) const;
+
+    /** Pair with given key or nullptr
+     */
+    const tree_data_type* find_data(const tkey& key) const;
+
+    tree_data_type* find_data(const tkey& key);
+
+    // endregion node search declaration
+
 public:
 
     // region constructors declaration
@@ -87,6 +130,13 @@ public:
 
     BSP_tree(std::initializer_list<std::pair<tkey, tvalue>> data, const compare& cmp = compare(), pp_allocator<value_type> = pp_allocator<value_type>(), logger* logger = nullptr);
 
+    /*
+     * Bulk load of input sorted by key without duplicates, nodes are filled to fill_factor of their capacity.
+     * Throws std::logic_error if input is not strictly increasing
+     */
+    template<input_iterator_for_pair<tkey, tvalue> iterator>
+    explicit BSP_tree(sorted_unique_t, iterator begin, iterator end, double fill_factor = default_fill_factor, const compare& cmp = compare(), pp_allocator<value_type> = pp_allocator<value_type>(), logger* logger = nullptr);
+
     // endregion constructors declaration
 
     // region five declaration
@@ -293,20 +343,20 @@ bool BSP_tree<tkey, tvalue, compare, t>::compare_keys(const tkey &lhs, const tke
 
 template<typename tkey, typename tvalue, compator<tkey> compare, std::size_t t>
 BSP_tree<tkey, tvalue, compare, t>::bsptree_node_base::bsptree_node_base() noexcept
+    : _is_terminated(false)
 {
-    throw not_implemented("BSP_tree::bsptree_node_base::bsptree_node_base() noexcept", "your code should be here...");
 }
 
 template<typename tkey, typename tvalue, compator<tkey> compare, std::size_t t>
 BSP_tree<tkey, tvalue, compare, t>::bsptree_node_term::bsptree_node_term() noexcept
+    : _next(nullptr)
 {
-    throw not_implemented("BSP_tree::bsptree_node_term::bsptree_node_term(pp_allocator<tree_data_type> al)", "your code should be here...");
+    this->_is_terminated = true;
 }
 
 template<typename tkey, typename tvalue, compator<tkey> compare, std::size_t t>
 BSP_tree<tkey, tvalue, compare, t>::bsptree_node_middle::bsptree_node_middle() noexcept
 {
-    throw not_implemented("BSP_tree::bsptree_node_middle::bsptree_node_middle(pp_allocator<tkey> al)", "your code should be here...");
 }
 
 // region BSP_tree constructor implementations
@@ -314,46 +364,85 @@ BSP_tree<tkey, tvalue, compare, t>::bsptree_node_middle::bsptree_node_middle() n
 template<typename tkey, typename tvalue, compator<tkey> compare, std::size_t t>
 logger * BSP_tree<tkey, tvalue, compare, t>::get_logger() const noexcept
 {
-    throw not_implemented("template<typename tkey, typename tvalue, compator<tkey> compare, std::size_t t>logger * BSP_tree<tkey, tvalue, compare, t>::get_logger() const noexcept", "your code should be here...");
+    return _logger;
 }
 
 template<typename tkey, typename tvalue, compator<tkey> compare, std::size_t t>
 pp_allocator<typename BSP_tree<tkey, tvalue, compare, t>::value_type> BSP_tree<tkey, tvalue, compare, t>::
 get_allocator() const noexcept
 {
-    throw not_implemented("template<typename tkey, typename tvalue, compator<tkey> compare, std::size_t t> pp_allocator<typename BSP_tree<tkey, tvalue, compare, t>::value_type> BSP_tree<tkey, tvalue, compare, t>::get_allocator() const noexcept", "your code should be here...");
+    return _allocator;
 }
 
 template<typename tkey, typename tvalue, compator<tkey> compare, std::size_t t>
 BSP_tree<tkey, tvalue, compare, t>::bsptree_const_iterator::bsptree_const_iterator(bsptree_node_term *node,
     size_t index)
+    : _node(node), _index(index)
 {
-    throw not_implemented("template<typename tkey, typename tvalue, compator<tkey> compare, std::size_t t> BSP_tree<tkey, tvalue, compare, t>::bsptree_const_iterator::bsptree_const_iterator(bsptree_node_term *node, size_t index)", "your code should be here...");
 }
 
 template<typename tkey, typename tvalue, compator<tkey> compare, std::size_t t>
 BSP_tree<tkey, tvalue, compare, t>::BSP_tree(const compare& cmp, pp_allocator<value_type> alloc, logger* log)
+    : compare(cmp), _allocator(alloc), _logger(log), _root(nullptr), _size(0)
 {
-    throw not_implemented("template<typename tkey, typename tvalue, compator<tkey> compare, std::size_t t> BSP_tree<tkey, tvalue, compare, t>::BSP_tree(const compare& cmp, pp_allocator<value_type> alloc, logger* log) ", "your code should be here...");
 }
 
 template<typename tkey, typename tvalue, compator<tkey> compare, std::size_t t>
 BSP_tree<tkey, tvalue, compare, t>::BSP_tree(pp_allocator<value_type> alloc, const compare& cmp, logger* log)
+    : compare(cmp), _allocator(alloc), _logger(log), _root(nullptr), _size(0)
 {
-    throw not_implemented("template<typename tkey, typename tvalue, compator<tkey> compare, std::size_t t> BSP_tree<tkey, tvalue, compare, t>::BSP_tree(pp_allocator<value_type> alloc, const compare& cmp, logger* log)", "your code should be here...");
 }
 
 template<typename tkey, typename tvalue, compator<tkey> compare, std::size_t t>
 template<input_iterator_for_pair<tkey, tvalue> iterator>
 BSP_tree<tkey, tvalue, compare, t>::BSP_tree(iterator begin, iterator end, const compare& cmp, pp_allocator<value_type> alloc, logger* log)
+    : compare(cmp), _allocator(alloc), _logger(log), _root(nullptr), _size(0)
 {
-    throw not_implemented("template<typename tkey, typename tvalue, compator<tkey> compare, std::size_t t> template<input_iterator_for_pair<tkey, tvalue> iterator> BSP_tree<tkey, tvalue, compare, t>::BSP_tree(iterator begin, iterator end, const compare& cmp, pp_allocator<value_type> alloc, logger* log)", "your code should be here...");
+    auto unordered = [this](const tree_data_type& lhs, const tree_data_type& rhs)
+    {
+        return !compare_pairs(lhs, rhs);
+    };
+
+    if constexpr (std::forward_iterator<iterator>)
+    {
+        if (std::adjacent_find(begin, end, unordered) == end)
+        {
+            bulk_load(begin, std::distance(begin, end), default_fill_factor);
+            return;
+        }
+    }
+
+    // Other input is sorted here, first of equal keys is kept as insert would keep it
+    std::vector<tree_data_type> data(begin, end);
+
+    std::stable_sort(data.begin(), data.end(), [this](const tree_data_type& lhs, const tree_data_type& rhs)
+    {
+        return compare_pairs(lhs, rhs);
+    });
+    data.erase(std::unique(data.begin(), data.end(), unordered), data.end());
+
+    bulk_load(data.begin(), data.size(), default_fill_factor);
 }
 
 template<typename tkey, typename tvalue, compator<tkey> compare, std::size_t t>
 BSP_tree<tkey, tvalue, compare, t>::BSP_tree(std::initializer_list<std::pair<tkey, tvalue>> data, const compare& cmp, pp_allocator<value_type> alloc, logger* log)
+    : BSP_tree(data.begin(), data.end(), cmp, alloc, log)
 {
-    throw not_implemented("template<typename tkey, typename tvalue, compator<tkey> compare, std::size_t t> BSP_tree<tkey, tvalue, compare, t>::BSP_tree(std::initializer_list<std::pair<tkey, tvalue>> data, const compare& cmp, pp_allocator<value_type> alloc, logger* log)", "your code should be here...");
+}
+
+template<typename tkey, typename tvalue, compator<tkey> compare, std::size_t t>
+template<input_iterator_for_pair<tkey, tvalue> iterator>
+BSP_tree<tkey, tvalue, compare, t>::BSP_tree(sorted_unique_t, iterator begin, iterator end, double fill_factor, const compare& cmp, pp_allocator<value_type> alloc, logger* log)
+    : compare(cmp), _allocator(alloc), _logger(log), _root(nullptr), _size(0)
+{
+    if constexpr (std::forward_iterator<iterator>)
+    {
+        bulk_load(begin, std::distance(begin, end), fill_factor);
+    } else
+    {
+        std::vector<tree_data_type> data(begin, end);
+        bulk_load(data.begin(), data.size(), fill_factor);
+    }
 }
 
 // endregion BSP_tree constructor implementations
@@ -393,117 +482,133 @@ BSP_tree<tkey, tvalue, compare, t>& BSP_tree<tkey, tvalue, compare, t>::operator
 template<typename tkey, typename tvalue, compator<tkey> compare, std::size_t t>
 BSP_tree<tkey, tvalue, compare, t>::~BSP_tree() noexcept
 {
-    throw not_implemented("template<typename tkey, typename tvalue, compator<tkey> compare, std::size_t t> BSP_tree<tkey, tvalue, compare, t>::~BSP_tree() noexcept", "your code should be here...");
+    clear();
 }
 
 // region BSP_tree iterators implementations
 
 template<typename tkey, typename tvalue, compator<tkey> compare, std::size_t t>
 BSP_tree<tkey, tvalue, compare, t>::bsptree_iterator::bsptree_iterator(bsptree_node_term* node, size_t index)
+    : _node(node), _index(index)
 {
-    throw not_implemented("template<typename tkey, typename tvalue, compator<tkey> compare, std::size_t t> BSP_tree<tkey, tvalue, compare, t>::bsptree_iterator::bsptree_iterator(bsptree_node_term* node, size_t index) ", "your code should be here...");
 }
 
 template<typename tkey, typename tvalue, compator<tkey> compare, std::size_t t>
 typename BSP_tree<tkey, tvalue, compare, t>::bsptree_iterator::reference BSP_tree<tkey, tvalue, compare, t>::bsptree_iterator::operator*() const noexcept
 {
-    throw not_implemented("template<typename tkey, typename tvalue, compator<tkey> compare, std::size_t t> typename BSP_tree<tkey, tvalue, compare, t>::bsptree_iterator::reference BSP_tree<tkey, tvalue, compare, t>::bsptree_iterator::operator*() const noexcept", "your code should be here...");
+    return *operator->();
 }
 
 template<typename tkey, typename tvalue, compator<tkey> compare, std::size_t t>
 typename BSP_tree<tkey, tvalue, compare, t>::bsptree_iterator::pointer BSP_tree<tkey, tvalue, compare, t>::bsptree_iterator::operator->() const noexcept
 {
-    throw not_implemented("template<typename tkey, typename tvalue, compator<tkey> compare, std::size_t t> typename BSP_tree<tkey, tvalue, compare, t>::bsptree_iterator::pointer BSP_tree<tkey, tvalue, compare, t>::bsptree_iterator::operator->() const noexcept", "your code should be here...");
+    return reinterpret_cast<pointer>(&_node->_data[_index]);
 }
 
 template<typename tkey, typename tvalue, compator<tkey> compare, std::size_t t>
 typename BSP_tree<tkey, tvalue, compare, t>::bsptree_iterator& BSP_tree<tkey, tvalue, compare, t>::bsptree_iterator::operator++()
 {
-    throw not_implemented("template<typename tkey, typename tvalue, compator<tkey> compare, std::size_t t> typename BSP_tree<tkey, tvalue, compare, t>::bsptree_iterator& BSP_tree<tkey, tvalue, compare, t>::bsptree_iterator::operator++()", "your code should be here...");
+    if (++_index == _node->_data.size())
+    {
+        _node = _node->_next;
+        _index = 0;
+    }
+
+    return *this;
 }
 
 template<typename tkey, typename tvalue, compator<tkey> compare, std::size_t t>
 typename BSP_tree<tkey, tvalue, compare, t>::bsptree_iterator BSP_tree<tkey, tvalue, compare, t>::bsptree_iterator::operator++(int)
 {
-    throw not_implemented("template<typename tkey, typename tvalue, compator<tkey> compare, std::size_t t> typename BSP_tree<tkey, tvalue, compare, t>::bsptree_iterator BSP_tree<tkey, tvalue, compare, t>::bsptree_iterator::operator++(int)", "your code should be here...");
+    self result = *this;
+    ++*this;
+    return result;
 }
 
 template<typename tkey, typename tvalue, compator<tkey> compare, std::size_t t>
 bool BSP_tree<tkey, tvalue, compare, t>::bsptree_iterator::operator==(const self& other) const noexcept
 {
-    throw not_implemented("template<typename tkey, typename tvalue, compator<tkey> compare, std::size_t t> bool BSP_tree<tkey, tvalue, compare, t>::bsptree_iterator::operator==(const self& other) const noexcept", "your code should be here...");
+    return _node == other._node && _index == other._index;
 }
 
 template<typename tkey, typename tvalue, compator<tkey> compare, std::size_t t>
 bool BSP_tree<tkey, tvalue, compare, t>::bsptree_iterator::operator!=(const self& other) const noexcept
 {
-    throw not_implemented("template<typename tkey, typename tvalue, compator<tkey> compare, std::size_t t> bool BSP_tree<tkey, tvalue, compare, t>::bsptree_iterator::operator!=(const self& other) const noexcept", "your code should be here...");
+    return !(*this == other);
 }
 
 template<typename tkey, typename tvalue, compator<tkey> compare, std::size_t t>
 size_t BSP_tree<tkey, tvalue, compare, t>::bsptree_iterator::current_node_keys_count() const noexcept
 {
-    throw not_implemented("template<typename tkey, typename tvalue, compator<tkey> compare, std::size_t t> size_t BSP_tree<tkey, tvalue, compare, t>::bsptree_iterator::current_node_keys_count() const noexcept", "your code should be here...");
+    return _node == nullptr ? 0 : _node->_data.size();
 }
 
 template<typename tkey, typename tvalue, compator<tkey> compare, std::size_t t>
 size_t BSP_tree<tkey, tvalue, compare, t>::bsptree_iterator::index() const noexcept
 {
-    throw not_implemented("template<typename tkey, typename tvalue, compator<tkey> compare, std::size_t t> size_t BSP_tree<tkey, tvalue, compare, t>::bsptree_iterator::index() const noexcept", "your code should be here...");
+    return _index;
 }
 
 template<typename tkey, typename tvalue, compator<tkey> compare, std::size_t t>
 BSP_tree<tkey, tvalue, compare, t>::bsptree_const_iterator::bsptree_const_iterator(const bsptree_iterator& it) noexcept
+    : _node(it._node), _index(it._index)
 {
-    throw not_implemented("template<typename tkey, typename tvalue, compator<tkey> compare, std::size_t t> BSP_tree<tkey, tvalue, compare, t>::bsptree_const_iterator::bsptree_const_iterator(const bsptree_iterator& it) noexcept", "your code should be here...");
 }
 
 template<typename tkey, typename tvalue, compator<tkey> compare, std::size_t t>
 typename BSP_tree<tkey, tvalue, compare, t>::bsptree_const_iterator::reference BSP_tree<tkey, tvalue, compare, t>::bsptree_const_iterator::operator*() const noexcept
 {
-    throw not_implemented("template<typename tkey, typename tvalue, compator<tkey> compare, std::size_t t> typename BSP_tree<tkey, tvalue, compare, t>::bsptree_const_iterator::reference BSP_tree<tkey, tvalue, compare, t>::bsptree_const_iterator::operator*() const noexcept", "your code should be here...");
+    return *operator->();
 }
 
 template<typename tkey, typename tvalue, compator<tkey> compare, std::size_t t>
 typename BSP_tree<tkey, tvalue, compare, t>::bsptree_const_iterator::pointer BSP_tree<tkey, tvalue, compare, t>::bsptree_const_iterator::operator->() const noexcept
 {
-    throw not_implemented("template<typename tkey, typename tvalue, compator<tkey> compare, std::size_t t> typename BSP_tree<tkey, tvalue, compare, t>::bsptree_const_iterator::pointer BSP_tree<tkey, tvalue, compare, t>::bsptree_const_iterator::operator->() const noexcept", "your code should be here...");
+    return reinterpret_cast<pointer>(&_node->_data[_index]);
 }
 
 template<typename tkey, typename tvalue, compator<tkey> compare, std::size_t t>
 typename BSP_tree<tkey, tvalue, compare, t>::bsptree_const_iterator& BSP_tree<tkey, tvalue, compare, t>::bsptree_const_iterator::operator++()
 {
-    throw not_implemented("template<typename tkey, typename tvalue, compator<tkey> compare, std::size_t t> typename BSP_tree<tkey, tvalue, compare, t>::bsptree_const_iterator& BSP_tree<tkey, tvalue, compare, t>::bsptree_const_iterator::operator++()", "your code should be here...");
+    if (++_index == _node->_data.size())
+    {
+        _node = _node->_next;
+        _index = 0;
+    }
+
+    return *this;
 }
 
 template<typename tkey, typename tvalue, compator<tkey> compare, std::size_t t>
 typename BSP_tree<tkey, tvalue, compare, t>::bsptree_const_iterator BSP_tree<tkey, tvalue, compare, t>::bsptree_const_iterator::operator++(int)
 {
-    throw not_implemented("template<typename tkey, typename tvalue, compator<tkey> compare, std::size_t t> typename BSP_tree<tkey, tvalue, compare, t>::bsptree_const_iterator BSP_tree<tkey, tvalue, compare, t>::bsptree_const_iterator::operator++(int)", "your code should be here...");
+    self result = *this;
+    ++*this;
+    return result;
 }
 
 template<typename tkey, typename tvalue, compator<tkey> compare, std::size_t t>
 bool BSP_tree<tkey, tvalue, compare, t>::bsptree_const_iterator::operator==(const self& other) const noexcept
 {
-    throw not_implemented("template<typename tkey, typename tvalue, compator<tkey> compare, std::size_t t> bool BSP_tree<tkey, tvalue, compare, t>::bsptree_const_iterator::operator==(const self& other) const noexcept", "your code should be here...");
+    return _node == other._node && _index == other._index;
 }
 
 template<typename tkey, typename tvalue, compator<tkey> compare, std::size_t t>
 bool BSP_tree<tkey, tvalue, compare, t>::bsptree_const_iterator::operator!=(const self& other) const noexcept
 {
-    throw not_implemented("template<typename tkey, typename tvalue, compator<tkey> compare, std::size_t t> bool BSP_tree<tkey, tvalue, compare, t>::bsptree_const_iterator::operator!=(const self& other) const noexcept", "your code should be here...");
+    return !(*this == other);
 }
 
 template<typename tkey, typename tvalue, compator<tkey> compare, std::size_t t>
 size_t BSP_tree<tkey, tvalue, compare, t>::bsptree_const_iterator::current_node_keys_count() const noexcept
 {
-    throw not_implemented("template<typename tkey, typename tvalue, compator<tkey> compare, std::size_t t> size_t BSP_tree<tkey, tvalue, compare, t>::bsptree_const_iterator::current_node_keys_count() const noexcept", "your code should be here...");
+    return _node == nullptr ? 0 : _node->_data.size();
 }
 
 template<typename tkey, typename tvalue, compator<tkey> compare, std::size_t t>
 size_t BSP_tree<tkey, tvalue, compare, t>::bsptree_const_iterator::index() const noexcept
 {
-    throw not_implemented("template<typename tkey, typename tvalue, compator<tkey> compare, std::size_t t> size_t BSP_tree<tkey, tvalue, compare, t>::bsptree_const_iterator::index() const noexcept", "your code should be here...");
+    return _index;
 }
 
 // endregion BSP_tree iterators implementations
@@ -513,13 +618,27 @@ size_t BSP_tree<tkey, tvalue, compare, t>::bsptree_const_iterator::index() const
 template<typename tkey, typename tvalue, compator<tkey> compare, std::size_t t>
 tvalue& BSP_tree<tkey, tvalue, compare, t>::at(const tkey& key)
 {
-    throw not_implemented("template<typename tkey, typename tvalue, compator<tkey> compare, std::size_t t> tvalue& BSP_tree<tkey, tvalue, compare, t>::at(const tkey& key)", "your code should be here...");
+    tree_data_type* data = find_data(key);
+
+    if (data == nullptr)
+    {
+        throw std::out_of_range("key not found");
+    }
+
+    return data->second;
 }
 
 template<typename tkey, typename tvalue, compator<tkey> compare, std::size_t t>
 const tvalue& BSP_tree<tkey, tvalue, compare, t>::at(const tkey& key) const
 {
-    throw not_implemented("template<typename tkey, typename tvalue, compator<tkey> compare, std::size_t t> const tvalue& BSP_tree<tkey, tvalue, compare, t>::at(const tkey& key) const", "your code should be here...");
+    const tree_data_type* data = find_data(key);
+
+    if (data == nullptr)
+    {
+        throw std::out_of_range("key not found");
+    }
+
+    return data->second;
 }
 
 template<typename tkey, typename tvalue, compator<tkey> compare, std::size_t t>
@@ -541,37 +660,49 @@ tvalue& BSP_tree<tkey, tvalue, compare, t>::operator[](tkey&& key)
 template<typename tkey, typename tvalue, compator<tkey> compare, std::size_t t>
 typename BSP_tree<tkey, tvalue, compare, t>::bsptree_iterator BSP_tree<tkey, tvalue, compare, t>::begin()
 {
-    throw not_implemented("template<typename tkey, typename tvalue, compator<tkey> compare, std::size_t t> typename BSP_tree<tkey, tvalue, compare, t>::bsptree_iterator BSP_tree<tkey, tvalue, compare, t>::begin()", "your code should be here...");
+    if (_root == nullptr)
+    {
+        return bsptree_iterator();
+    }
+
+    bsptree_node_base* node = _root;
+
+    while (!node->_is_terminated)
+    {
+        node = static_cast<bsptree_node_middle*>(node)->_pointers.front();
+    }
+
+    return bsptree_iterator(static_cast<bsptree_node_term*>(node), 0);
 }
 
 template<typename tkey, typename tvalue, compator<tkey> compare, std::size_t t>
 typename BSP_tree<tkey, tvalue, compare, t>::bsptree_iterator BSP_tree<tkey, tvalue, compare, t>::end()
 {
-    throw not_implemented("template<typename tkey, typename tvalue, compator<tkey> compare, std::size_t t> typename BSP_tree<tkey, tvalue, compare, t>::bsptree_iterator BSP_tree<tkey, tvalue, compare, t>::end()", "your code should be here...");
+    return bsptree_iterator();
 }
 
 template<typename tkey, typename tvalue, compator<tkey> compare, std::size_t t>
 typename BSP_tree<tkey, tvalue, compare, t>::bsptree_const_iterator BSP_tree<tkey, tvalue, compare, t>::begin() const
 {
-    throw not_implemented("template<typename tkey, typename tvalue, compator<tkey> compare, std::size_t t> typename BSP_tree<tkey, tvalue, compare, t>::bsptree_const_iterator BSP_tree<tkey, tvalue, compare, t>::begin() const", "your code should be here...");
+    return const_cast<BSP_tree*>(this)->begin();
 }
 
 template<typename tkey, typename tvalue, compator<tkey> compare, std::size_t t>
 typename BSP_tree<tkey, tvalue, compare, t>::bsptree_const_iterator BSP_tree<tkey, tvalue, compare, t>::end() const
 {
-    throw not_implemented("template<typename tkey, typename tvalue, compator<tkey> compare, std::size_t t> typename BSP_tree<tkey, tvalue, compare, t>::bsptree_const_iterator BSP_tree<tkey, tvalue, compare, t>::end() const", "your code should be here...");
+    return bsptree_const_iterator();
 }
 
 template<typename tkey, typename tvalue, compator<tkey> compare, std::size_t t>
 typename BSP_tree<tkey, tvalue, compare, t>::bsptree_const_iterator BSP_tree<tkey, tvalue, compare, t>::cbegin() const
 {
-    throw not_implemented("template<typename tkey, typename tvalue, compator<tkey> compare, std::size_t t> typename BSP_tree<tkey, tvalue, compare, t>::bsptree_const_iterator BSP_tree<tkey, tvalue, compare, t>::cbegin() const", "your code should be here...");
+    return begin();
 }
 
 template<typename tkey, typename tvalue, compator<tkey> compare, std::size_t t>
 typename BSP_tree<tkey, tvalue, compare, t>::bsptree_const_iterator BSP_tree<tkey, tvalue, compare, t>::cend() const
 {
-    throw not_implemented("template<typename tkey, typename tvalue, compator<tkey> compare, std::size_t t> typename BSP_tree<tkey, tvalue, compare, t>::bsptree_const_iterator BSP_tree<tkey, tvalue, compare, t>::cend() const", "your code should be here...");
+    return end();
 }
 
 // endregion BSP_tree iterator begins implementations
@@ -581,13 +712,13 @@ typename BSP_tree<tkey, tvalue, compare, t>::bsptree_const_iterator BSP_tree<tke
 template<typename tkey, typename tvalue, compator<tkey> compare, std::size_t t>
 size_t BSP_tree<tkey, tvalue, compare, t>::size() const noexcept
 {
-    throw not_implemented("template<typename tkey, typename tvalue, compator<tkey> compare, std::size_t t> size_t BSP_tree<tkey, tvalue, compare, t>::size() const noexcept", "your code should be here...");
+    return _size;
 }
 
 template<typename tkey, typename tvalue, compator<tkey> compare, std::size_t t>
 bool BSP_tree<tkey, tvalue, compare, t>::empty() const noexcept
 {
-    throw not_implemented("template<typename tkey, typename tvalue, compator<tkey> compare, std::size_t t> bool BSP_tree<tkey, tvalue, compare, t>::empty() const noexcept", "your code should be here...");
+    return _size == 0;
 }
 
 template<typename tkey, typename tvalue, compator<tkey> compare, std::size_t t>
@@ -629,7 +760,7 @@ typename BSP_tree<tkey, tvalue, compare, t>::bsptree_const_iterator BSP_tree<tke
 template<typename tkey, typename tvalue, compator<tkey> compare, std::size_t t>
 bool BSP_tree<tkey, tvalue, compare, t>::contains(const tkey& key) const
 {
-    throw not_implemented("template<typename tkey, typename tvalue, compator<tkey> compare, std::size_t t> bool BSP_tree<tkey, tvalue, compare, t>::contains(const tkey& key) const", "your code should be here...");
+    return find_data(key) != nullptr;
 }
 
 // endregion BSP_tree lookup implementations
@@ -639,7 +770,9 @@ bool BSP_tree<tkey, tvalue, compare, t>::contains(const tkey& key) const
 template<typename tkey, typename tvalue, compator<tkey> compare, std::size_t t>
 void BSP_tree<tkey, tvalue, compare, t>::clear() noexcept
 {
-    throw not_implemented("template<typename tkey, typename tvalue, compator<tkey> compare, std::size_t t> void BSP_tree<tkey, tvalue, compare, t>::clear() noexcept", "your code should be here...");
+    destroy_subtree(_root);
+    _root = nullptr;
+    _size = 0;
 }
 
 template<typename tkey, typename tvalue, compator<tkey> compare, std::size_t t>
@@ -713,4 +846,233 @@ typename BSP_tree<tkey, tvalue, compare, t>::bsptree_iterator BSP_tree<tkey, tva
 // endregion BSP_tree modifiers implementations
 
 
+// region node search implementation
+
+template<typename tkey, typename tvalue, compator<tkey> compare, std::size_t t>
+size_t BSP_tree<tkey, tvalue, compare, t>::node_upper_bound(const bsptree_node_middle* node, const tkey& key) const
+{
+    // Keys of middle nodes are stored without values already
+    if constexpr (vectorized_search)
+    {
+        return __detail::keys_upper_bound(node->_keys.data(), node->_keys.size(), key);
+    } else
+    {
+        auto it = std::upper_bound(node->_keys.begin(), node->_keys.end(), key, [this](const tkey& needle, const tkey& item)
+        {
+            return compare_keys(needle, item);
+        });
+        return std::distance(node->_keys.begin(), it);
+    }
+}
+
+template<typename tkey, typename tvalue, compator<tkey> compare, std::size_t t>
+size_t BSP_tree<tkey, tvalue, compare, t>::node_lower_bound(const bsptree_node_term* node, const tkey& key) const
+{
+    if constexpr (vectorized_search)
+    {
+        return node->_search_keys.lower_bound(key);
+    } else
+    {
+        auto it = std::lower_bound(node->_data.begin(), node->_data.end(), key, [this](const tree_data_type& item, const tkey& needle)
+        {
+            return compare_keys(item.first, needle);
+        });
+        return std::distance(node->_data.begin(), it);
+    }
+}
+
+template<typename tkey, typename tvalue, compator<tkey> compare, std::size_t t>
+const typename BSP_tree<tkey, tvalue, compare, t>::tree_data_type* BSP_tree<tkey, tvalue, compare, t>::find_data(const tkey& key) const
+{
+    if (_root == nullptr)
+    {
+        return nullptr;
+    }
+
+    const bsptree_node_base* node = _root;
+
+    while (!node->_is_terminated)
+    {
+        auto middle = static_cast<const bsptree_node_middle*>(node);
+        node = middle->_pointers[node_upper_bound(middle, key)];
+    }
+
+    auto leaf = static_cast<const bsptree_node_term*>(node);
+    size_t index = node_lower_bound(leaf, key);
+
+    if (index < leaf->_data.size() && !compare_keys(key, leaf->_data[index].first))
+    {
+        return &leaf->_data[index];
+    }
+
+    return nullptr;
+}
+
+template<typename tkey, typename tvalue, compator<tkey> compare, std::size_t t>
+typename BSP_tree<tkey, tvalue, compare, t>::tree_data_type* BSP_tree<tkey, tvalue, compare, t>::find_data(const tkey& key)
+{
+    return const_cast<tree_data_type*>(std::as_const(*this).find_data(key));
+}
+
+// endregion node search implementation
+
+template<typename tkey, typename tvalue, compator<tkey> compare, std::size_t t>
+void BSP_tree<tkey, tvalue, compare, t>::destroy_subtree(bsptree_node_base* node) noexcept
+{
+    if (node == nullptr)
+    {
+        return;
+    }
+
+    if (node->_is_terminated)
+    {
+        _allocator.delete_object(static_cast<bsptree_node_term*>(node));
+        return;
+    }
+
+    auto middle = static_cast<bsptree_node_middle*>(node);
+
+    for (bsptree_node_base* child : middle->_pointers)
+    {
+        destroy_subtree(child);
+    }
+
+    _allocator.delete_object(middle);
+}
+
+// region bulk load implementation
+
+template<typename tkey, typename tvalue, compator<tkey> compare, std::size_t t>
+size_t BSP_tree<tkey, tvalue, compare, t>::bulk_nodes_count(size_t count, size_t capacity, size_t minimum, size_t maximum) noexcept
+{
+    if (count <= maximum)
+    {
+        return 1;
+    }
+
+    size_t packed = (count + capacity - 1) / capacity;
+    size_t sparsest = count / std::max<size_t>(minimum, 1);
+
+    return std::max<size_t>(std::min(packed, sparsest), 2);
+}
+
+template<typename tkey, typename tvalue, compator<tkey> compare, std::size_t t>
+template<std::forward_iterator iterator>
+void BSP_tree<tkey, tvalue, compare, t>::bulk_load(iterator begin, size_t count, double fill_factor)
+{
+    if (!(fill_factor > 0 && fill_factor <= 1))
+    {
+        throw std::invalid_argument("fill factor must be in (0, 1]");
+    }
+
+    if (count == 0)
+    {
+        return;
+    }
+
+    const size_t capacity = std::clamp<size_t>(static_cast<size_t>(fill_factor * maximum_keys_in_node),
+                                               std::max<size_t>(minimum_keys_in_node, 1), maximum_keys_in_node);
+
+    // Nodes are kept by their own type so that deallocation gets the right size
+    std::vector<bsptree_node_term*> leaves;
+    std::vector<bsptree_node_middle*> middles;
+
+    try
+    {
+        size_t nodes = bulk_nodes_count(count, capacity, minimum_keys_in_node, maximum_keys_in_node);
+
+        std::vector<bsptree_node_base*> level;
+        std::vector<tkey> lows;
+        level.reserve(nodes);
+        lows.reserve(nodes);
+        leaves.reserve(nodes);
+
+        const tkey* previous = nullptr;
+        bsptree_node_term* previous_leaf = nullptr;
+
+        for (size_t i = 0; i < nodes; ++i)
+        {
+            bsptree_node_term* leaf = _allocator.template new_object<bsptree_node_term>();
+            leaves.push_back(leaf);
+            leaf->_is_terminated = true;
+            leaf->_next = nullptr;
+
+            for (size_t j = 0, size = count / nodes + (i < count % nodes ? 1 : 0); j < size; ++j, ++begin)
+            {
+                auto&& item = *begin;
+
+                if (previous != nullptr && !compare_keys(*previous, item.first))
+                {
+                    throw std::logic_error("bulk load input must be strictly increasing by key");
+                }
+
+                leaf->_data.emplace_back(std::forward<decltype(item)>(item));
+                previous = &leaf->_data.back().first;
+            }
+            leaf->_search_keys.assign(leaf->_data);
+
+            if (previous_leaf != nullptr)
+            {
+                previous_leaf->_next = leaf;
+            }
+            previous_leaf = leaf;
+
+            level.push_back(leaf);
+            lows.push_back(leaf->_data.front().first);
+        }
+
+        // Every child but the first one of a node is separated by copy of its smallest key
+        while (level.size() > 1)
+        {
+            nodes = bulk_nodes_count(level.size(), capacity + 1, minimum_keys_in_node + 1, maximum_keys_in_node + 1);
+
+            std::vector<bsptree_node_base*> next_level;
+            std::vector<tkey> next_lows;
+            next_level.reserve(nodes);
+            next_lows.reserve(nodes);
+
+            size_t child = 0;
+
+            for (size_t i = 0; i < nodes; ++i)
+            {
+                bsptree_node_middle* node = _allocator.template new_object<bsptree_node_middle>();
+                middles.push_back(node);
+                node->_is_terminated = false;
+
+                next_lows.push_back(std::move(lows[child]));
+                node->_pointers.push_back(level[child++]);
+
+                for (size_t j = 1, size = level.size() / nodes + (i < level.size() % nodes ? 1 : 0); j < size; ++j)
+                {
+                    node->_keys.push_back(std::move(lows[child]));
+                    node->_pointers.push_back(level[child++]);
+                }
+
+                next_level.push_back(node);
+            }
+
+            level = std::move(next_level);
+            lows = std::move(next_lows);
+        }
+
+        _root = level.front();
+        _size = count;
+    }
+    catch (...)
+    {
+        for (auto leaf : leaves)
+        {
+            _allocator.delete_object(leaf);
+        }
+        for (auto node : middles)
+        {
+            _allocator.delete_object(node);
+        }
+        throw;
+    }
+}
+
+// endregion bulk load implementation
+
+
 #endif
\ No newline at end of file
@@ -1,5 +1,6 @@
 #include "gtest/gtest.h"
 
+#include <algorithm>
 #include <list>
 #include <random>
 #include <vector>
@@ -591,6 +592,117 @@ TEST(bTreeNegativeTests, test3)
     logger->trace("bTreeNegativeTests.test3 finished");
 }
 
+TEST(bTreeBulkLoadTests, test1)
+{
+    std::vector<std::pair<int, std::string>> data;
+
+    for (int i = 0; i < 1000; ++i)
+    {
+        data.emplace_back(i * 2, std::to_string(i));
+    }
+
+    BSP_tree<int, std::string, std::less<int>, 3> tree(sorted_unique, data.begin(), data.end(), 0.7, std::less<int>(), nullptr, nullptr);
+
+    EXPECT_EQ(tree.size(), data.size());
+
+    auto expected = data.begin();
+    for (auto const &item: tree)
+    {
+        EXPECT_EQ(item.first, expected->first);
+        EXPECT_EQ(item.second, expected->second);
+        ++expected;
+    }
+    EXPECT_EQ(expected, data.end());
+}
+
+TEST(bTreeBulkLoadTests, test2)
+{
+    std::vector<std::pair<int, std::string>> data =
+    {
+        { 1, "a" }, { 2, "b" }, { 3, "c" }, { 3, "d" }, { 4, "e" }
+    };
+
+    using tree_type = BSP_tree<int, std::string, std::less<int>, 3>;
+
+    EXPECT_THROW(tree_type(sorted_unique, data.begin(), data.end(), 1.0, std::less<int>(), nullptr, nullptr), std::logic_error);
+    EXPECT_THROW(tree_type(sorted_unique, data.begin(), data.begin() + 3, 0.0, std::less<int>(), nullptr, nullptr), std::invalid_argument);
+}
+
+TEST(bTreeLookupTests, test1)
+{
+    std::vector<std::pair<int, std::string>> data;
+
+    for (int i = 0; i < 500; ++i)
+    {
+        data.emplace_back(i * 3, std::to_string(i));
+    }
+
+    BSP_tree<int, std::string, std::less<int>, 3> tree(sorted_unique, data.begin(), data.end(), 0.8, std::less<int>(), nullptr, nullptr);
+    const auto& view = tree;
+
+    for (int key = -3; key <= 1500; ++key)
+    {
+        bool present = key >= 0 && key < 1500 && key % 3 == 0;
+
+        EXPECT_EQ(view.contains(key), present);
+
+        if (present)
+        {
+            EXPECT_EQ(view.at(key), std::to_string(key / 3));
+        } else
+        {
+            EXPECT_THROW(view.at(key), std::out_of_range);
+        }
+    }
+
+    tree.at(300) = "changed";
+
+    EXPECT_EQ(view.at(300), "changed");
+}
+
+TEST(bTreeConstructorTests, test1)
+{
+    using tree_type = BSP_tree<int, std::string, std::less<int>, 3>;
+
+    // Unsorted input is sorted, the first value of repeated key is kept
+    tree_type small{ { 5, "a" }, { 1, "b" }, { 3, "c" }, { 1, "d" }, { 4, "e" }, { 5, "f" } };
+    std::vector<std::pair<int, std::string>> expected = { { 1, "b" }, { 3, "c" }, { 4, "e" }, { 5, "a" } };
+
+    EXPECT_EQ(small.size(), expected.size());
+
+    auto next = expected.begin();
+    for (auto const &item: small)
+    {
+        EXPECT_EQ(item.first, next->first);
+        EXPECT_EQ(item.second, next->second);
+        ++next;
+    }
+    EXPECT_EQ(next, expected.end());
+
+    std::vector<std::pair<int, std::string>> data;
+
+    for (int i = 0; i < 2000; ++i)
+    {
+        data.emplace_back(i % 700, std::to_string(i));
+    }
+
+    std::shuffle(data.begin(), data.end(), std::mt19937(27));
+
+    tree_type tree(data.begin(), data.end());
+
+    EXPECT_EQ(tree.size(), size_t(700));
+
+    int key = 0;
+    for (auto const &item: tree)
+    {
+        auto first = std::find_if(data.begin(), data.end(), [key](auto const &pair) { return pair.first == key; });
+        EXPECT_EQ(item.first, key);
+        EXPECT_EQ(item.second, first->second);
+        ++key;
+    }
+    EXPECT_EQ(key, 700);
+}
+
 int main(
         int argc,
         char **argv)
@@ -1,4 +1,6 @@
 #include <iterator>
+#include <algorithm>
+#include <stdexcept>
 #include <utility>
 #include <vector>
 #include <boost/container/static_vector.hpp>
@@ -6,6 +8,7 @@
 #include <stack>
 #include <pp_allocator.h>
 #include <search_tree.h>
+#include <node_search.h>
 #include <initializer_list>
 #include <logger_guardant.h>
 
@@ -26,6 +29,7 @@ private:
     // TODO: Another restrictions
     static constexpr const size_t minimum_keys_in_node = t - 1;
     static constexpr const size_t maximum_keys_in_node = 2 * t - 1;
+    static constexpr const bool vectorized_search = vectorized_key_search_v<tkey, compare>;
 
     // region comparators declaration
 
@@ -38,6 +42,8 @@ private:
     {
         boost::container::static_vector<tree_data_type, maximum_keys_in_node + 1> _keys;
         boost::container::static_vector<bstree_node*, maximum_keys_in_node + 2> _pointers;
+        /* Copy of keys from _keys for vectorized search, changed together with _keys */
+        [[no_unique_address]] node_search_keys<tkey, maximum_keys_in_node + 1, vectorized_search> _search_keys;
         bstree_node() noexcept;
 //        std::vector<tree_data_type, pp_allocator<tree_data_type>> _keys;
 //        std::vector<bstree_node*, pp_allocator<bstree_node*>> _pointers;
@@ -53,6 +59,52 @@ private:
     logger* get_logger() const noexcept override;
     pp_allocator<value_type> get_allocator() const noexcept;
 
+    // region bulk load declaration
+
+    static constexpr const double default_fill_factor = 1.0;
+
+    /** Number of nodes one level of count items is packed into, one item between neighbours goes to the parent level
+     */
+    static size_t bulk_nodes_count(size_t count, size_t capacity) noexcept;
+
+    /** Builds empty tree bottom-up from count strictly increasing items, each level in one pass
+     */
+    template<std::forward_iterator iterator>
+    void bulk_load(iterator begin, size_t count, double fill_factor);
+
+    // endregion bulk load declaration
+
+    // region node search declaration
+
+    /** Index of the first key of node not less than key
+     */
+    size_t node_lower_bound(const bstree_node* node, const tkey& key) const;
+
+    /** Pair with given key or nullptr
+     */
+    const tree_data_type* find_data(const tkey& key) const;
+
+    tree_data_type* find_data(const tkey& key);
+
+    // endregion node search declaration
+
+    // region iteration declaration
+
+    /* Path of iterator holds slots of nodes from root down with index of each node in its parent, empty for end() */
+    using node_path = std::stack<std::pair<bstree_node**, size_t>>;
+
+    static void descend_leftmost(node_path& path);
+
+    /** Moves path and index of key to the next key in order, path becomes empty after the last one
+     */
+    static void next_position(node_path& path, size_t& index);
+
+    static bool same_position(const node_path& lhs, size_t lhs_index, const node_path& rhs, size_t rhs_index) noexcept;
+
+    void destroy_subtree(bstree_node* node) noexcept;
+
+    // endregion iteration declaration
+
 public:
 
     // region constructors declaration
@@ -66,6 +118,13 @@ public:
 
     BS_tree(std::initializer_list<std::pair<tkey, tvalue>> data, const compare& cmp = compare(), pp_allocator<value_type> = pp_allocator<value_type>(), logger* logger = nullptr);
 
+    /*
+     * Bulk load of input sorted by key without duplicates, nodes are filled to fill_factor of their capacity.
+     * Throws std::logic_error if input is not strictly increasing
+     */
+    template<input_iterator_for_pair<tkey, tvalue> iterator>
+    explicit BS_tree(sorted_unique_t, iterator begin, iterator end, double fill_factor = default_fill_factor, const compare& cmp = compare(), pp_allocator<value_type> = pp_allocator<value_type>(), logger* logger = nullptr);
+
     // endregion constructors declaration
 
     // region five declaration
@@ -376,48 +435,51 @@ bool BS_tree<tkey, tvalue, compare, t>::compare_pairs(const BS_tree::tree_data_t
 template<typename tkey, typename tvalue, compator<tkey> compare, std::size_t t>
 BS_tree<tkey, tvalue, compare, t>::bstree_node::bstree_node() noexcept
 {
-    throw not_implemented("too laazyy", "your code should be here...");
 }
 
 template<typename tkey, typename tvalue, compator<tkey> compare, std::size_t t>
 logger * BS_tree<tkey, tvalue, compare, t>::get_logger() const noexcept
 {
-    throw not_implemented("too laazyy", "your code should be here...");
+    return _logger;
 }
 
 template<typename tkey, typename tvalue, compator<tkey> compare, std::size_t t>
 pp_allocator<typename BS_tree<tkey, tvalue, compare, t>::value_type> BS_tree<tkey, tvalue, compare, t>::
 get_allocator() const noexcept
 {
-    throw not_implemented("too laazyy", "your code should be here...");
+    return _allocator;
 }
 
 template<typename tkey, typename tvalue, compator<tkey> compare, std::size_t t>
 typename BS_tree<tkey, tvalue, compare, t>::bstree_iterator::reference BS_tree<tkey, tvalue, compare, t>::
 bstree_iterator::operator*() const noexcept
 {
-    throw not_implemented("too laazyy", "your code should be here...");
+    return *operator->();
 }
 
 template<typename tkey, typename tvalue, compator<tkey> compare, std::size_t t>
 typename BS_tree<tkey, tvalue, compare, t>::bstree_iterator::pointer BS_tree<tkey, tvalue, compare, t>::bstree_iterator
 ::operator->() const noexcept
 {
-    throw not_implemented("too laazyy", "your code should be here...");
+    // Node keeps mutable pairs, key must not be changed through iterator
+    return reinterpret_cast<pointer>(&(*_path.top().first)->_keys[_index]);
 }
 
 template<typename tkey, typename tvalue, compator<tkey> compare, std::size_t t>
 typename BS_tree<tkey, tvalue, compare, t>::bstree_iterator::self & BS_tree<tkey, tvalue, compare, t>::bstree_iterator::
 operator++()
 {
-    throw not_implemented("too laazyy", "your code should be here...");
+    next_position(_path, _index);
+    return *this;
 }
 
 template<typename tkey, typename tvalue, compator<tkey> compare, std::size_t t>
 typename BS_tree<tkey, tvalue, compare, t>::bstree_iterator::self BS_tree<tkey, tvalue, compare, t>::bstree_iterator::
 operator++(int)
 {
-    throw not_implemented("too laazyy", "your code should be here...");
+    self result = *this;
+    ++*this;
+    return result;
 }
 
 template<typename tkey, typename tvalue, compator<tkey> compare, std::size_t t>
@@ -437,78 +499,81 @@ operator--(int)
 template<typename tkey, typename tvalue, compator<tkey> compare, std::size_t t>
 bool BS_tree<tkey, tvalue, compare, t>::bstree_iterator::operator==(const self &other) const noexcept
 {
-    throw not_implemented("too laazyy", "your code should be here...");
+    return same_position(_path, _index, other._path, other._index);
 }
 
 template<typename tkey, typename tvalue, compator<tkey> compare, std::size_t t>
 bool BS_tree<tkey, tvalue, compare, t>::bstree_iterator::operator!=(const self &other) const noexcept
 {
-    throw not_implemented("too laazyy", "your code should be here...");
+    return !(*this == other);
 }
 
 template<typename tkey, typename tvalue, compator<tkey> compare, std::size_t t>
 size_t BS_tree<tkey, tvalue, compare, t>::bstree_iterator::depth() const noexcept
 {
-    throw not_implemented("too laazyy", "your code should be here...");
+    return _path.empty() ? 0 : _path.size() - 1;
 }
 
 template<typename tkey, typename tvalue, compator<tkey> compare, std::size_t t>
 size_t BS_tree<tkey, tvalue, compare, t>::bstree_iterator::current_node_keys_count() const noexcept
 {
-    throw not_implemented("too laazyy", "your code should be here...");
+    return (*_path.top().first)->_keys.size();
 }
 
 template<typename tkey, typename tvalue, compator<tkey> compare, std::size_t t>
 bool BS_tree<tkey, tvalue, compare, t>::bstree_iterator::is_terminate_node() const noexcept
 {
-    throw not_implemented("too laazyy", "your code should be here...");
+    return (*_path.top().first)->_pointers.empty();
 }
 
 template<typename tkey, typename tvalue, compator<tkey> compare, std::size_t t>
 size_t BS_tree<tkey, tvalue, compare, t>::bstree_iterator::index() const noexcept
 {
-    throw not_implemented("too laazyy", "your code should be here...");
+    return _index;
 }
 
 template<typename tkey, typename tvalue, compator<tkey> compare, std::size_t t>
 BS_tree<tkey, tvalue, compare, t>::bstree_iterator::bstree_iterator(
     const std::stack<std::pair<bstree_node **, size_t>> &path, size_t index)
+    : _path(path), _index(index)
 {
-    throw not_implemented("too laazyy", "your code should be here...");
 }
 
 template<typename tkey, typename tvalue, compator<tkey> compare, std::size_t t>
 BS_tree<tkey, tvalue, compare, t>::bstree_const_iterator::bstree_const_iterator(const bstree_iterator &it) noexcept
+    : _path(it._path), _index(it._index)
 {
-    throw not_implemented("too laazyy", "your code should be here...");
 }
 
 template<typename tkey, typename tvalue, compator<tkey> compare, std::size_t t>
 typename BS_tree<tkey, tvalue, compare, t>::bstree_const_iterator::reference BS_tree<tkey, tvalue, compare, t>::
 bstree_const_iterator::operator*() const noexcept
 {
-    throw not_implemented("too laazyy", "your code should be here...");
+    return *operator->();
 }
 
 template<typename tkey, typename tvalue, compator<tkey> compare, std::size_t t>
 typename BS_tree<tkey, tvalue, compare, t>::bstree_const_iterator::pointer BS_tree<tkey, tvalue, compare, t>::
 bstree_const_iterator::operator->() const noexcept
 {
-    throw not_implemented("too laazyy", "your code should be here...");
+    return reinterpret_cast<pointer>(&(*_path.top().first)->_keys[_index]);
 }
 
 template<typename tkey, typename tvalue, compator<tkey> compare, std::size_t t>
 typename BS_tree<tkey, tvalue, compare, t>::bstree_const_iterator::self & BS_tree<tkey, tvalue, compare, t>::
 bstree_const_iterator::operator++()
 {
-    throw not_implemented("too laazyy", "your code should be here...");
+    next_position(_path, _index);
+    return *this;
 }
 
 template<typename tkey, typename tvalue, compator<tkey> compare, std::size_t t>
 typename BS_tree<tkey, tvalue, compare, t>::bstree_const_iterator::self BS_tree<tkey, tvalue, compare, t>::
 bstree_const_iterator::operator++(int)
 {
-    throw not_implemented("too laazyy", "your code should be here...");
+    self result = *this;
+    ++*this;
+    return result;
 }
 
 template<typename tkey, typename tvalue, compator<tkey> compare, std::size_t t>
@@ -528,44 +593,56 @@ bstree_const_iterator::operator--(int)
 template<typename tkey, typename tvalue, compator<tkey> compare, std::size_t t>
 bool BS_tree<tkey, tvalue, compare, t>::bstree_const_iterator::operator==(const self &other) const noexcept
 {
-    throw not_implemented("too laazyy", "your code should be here...");
+    return same_position(_path, _index, other._path, other._index);
 }
 
 template<typename tkey, typename tvalue, compator<tkey> compare, std::size_t t>
 bool BS_tree<tkey, tvalue, compare, t>::bstree_const_iterator::operator!=(const self &other) const noexcept
 {
-    throw not_implemented("too laazyy", "your code should be here...");
+    return !(*this == other);
 }
 
 template<typename tkey, typename tvalue, compator<tkey> compare, std::size_t t>
 size_t BS_tree<tkey, tvalue, compare, t>::bstree_const_iterator::depth() const noexcept
 {
-    throw not_implemented("too laazyy", "your code should be here...");
+    return _path.empty() ? 0 : _path.size() - 1;
 }
 
 template<typename tkey, typename tvalue, compator<tkey> compare, std::size_t t>
 size_t BS_tree<tkey, tvalue, compare, t>::bstree_const_iterator::current_node_keys_count() const noexcept
 {
-    throw not_implemented("too laazyy", "your code should be here...");
+    return (*_path.top().first)->_keys.size();
 }
 
 template<typename tkey, typename tvalue, compator<tkey> compare, std::size_t t>
 bool BS_tree<tkey, tvalue, compare, t>::bstree_const_iterator::is_terminate_node() const noexcept
 {
-    throw not_implemented("too laazyy", "your code should be here...");
+    return (*_path.top().first)->_pointers.empty();
 }
 
 template<typename tkey, typename tvalue, compator<tkey> compare, std::size_t t>
 size_t BS_tree<tkey, tvalue, compare, t>::bstree_const_iterator::index() const noexcept
 {
-    throw not_implemented("too laazyy", "your code should be here...");
+    return _index;
 }
 
 template<typename tkey, typename tvalue, compator<tkey> compare, std::size_t t>
 BS_tree<tkey, tvalue, compare, t>::bstree_const_iterator::bstree_const_iterator(
     const std::stack<std::pair<const bstree_node **, size_t>> &path, size_t index)
+    : _index(index)
 {
-    throw not_implemented("too laazyy", "your code should be here...");
+    // Path of const iterator is stored as mutable one, nodes are never changed through it
+    std::vector<std::pair<const bstree_node**, size_t>> steps;
+
+    for (auto copy = path; !copy.empty(); copy.pop())
+    {
+        steps.push_back(copy.top());
+    }
+
+    for (auto step = steps.rbegin(); step != steps.rend(); ++step)
+    {
+        _path.emplace(const_cast<bstree_node**>(step->first), step->second);
+    }
 }
 
 template<typename tkey, typename tvalue, compator<tkey> compare, std::size_t t>
@@ -771,27 +848,66 @@ bool BS_tree<tkey, tvalue, compare, t>::compare_keys(const tkey &lhs, const tkey
 
 template<typename tkey, typename tvalue, compator<tkey> compare, std::size_t t>
 BS_tree<tkey, tvalue, compare, t>::BS_tree(const compare& cmp, pp_allocator<value_type> alloc, logger* logger)
+    : compare(cmp), _allocator(alloc), _logger(logger), _root(nullptr), _size(0)
 {
-    throw not_implemented("template<typename tkey, typename tvalue, compator<tkey> compare, std::size_t t> BS_tree<tkey, tvalue, compare, t>::BS_tree(const compare& cmp, pp_allocator<value_type> alloc, logger* logger)", "your code should be here...");
 }
 
 template<typename tkey, typename tvalue, compator<tkey> compare, std::size_t t>
 BS_tree<tkey, tvalue, compare, t>::BS_tree(pp_allocator<value_type> alloc, const compare& comp, logger* logger)
+    : compare(comp), _allocator(alloc), _logger(logger), _root(nullptr), _size(0)
 {
-    throw not_implemented("template<typename tkey, typename tvalue, compator<tkey> compare, std::size_t t> BS_tree<tkey, tvalue, compare, t>::BS_tree(pp_allocator<value_type> alloc, const compare& comp, logger* logger)", "your code should be here...");
 }
 
 template<typename tkey, typename tvalue, compator<tkey> compare, std::size_t t>
 template<input_iterator_for_pair<tkey, tvalue> iterator>
 BS_tree<tkey, tvalue, compare, t>::BS_tree(iterator begin, iterator end, const compare& cmp, pp_allocator<value_type> alloc, logger* logger)
+    : compare(cmp), _allocator(alloc), _logger(logger), _root(nullptr), _size(0)
 {
-    throw not_implemented("template<typename tkey, typename tvalue, compator<tkey> compare, std::size_t t> template<input_iterator_for_pair<tkey, tvalue> iterator> BS_tree<tkey, tvalue, compare, t>::BS_tree(iterator begin, iterator end, const compare& cmp, pp_allocator<value_type> alloc, logger* logger)", "your code should be here...");
+    auto unordered = [this](const tree_data_type& lhs, const tree_data_type& rhs)
+    {
+        return !compare_pairs(lhs, rhs);
+    };
+
+    if constexpr (std::forward_iterator<iterator>)
+    {
+        if (std::adjacent_find(begin, end, unordered) == end)
+        {
+            bulk_load(begin, std::distance(begin, end), default_fill_factor);
+            return;
+        }
+    }
+
+    // Other input is sorted here, first of equal keys is kept as insert would keep it
+    std::vector<tree_data_type> data(begin, end);
+
+    std::stable_sort(data.begin(), data.end(), [this](const tree_data_type& lhs, const tree_data_type& rhs)
+    {
+        return compare_pairs(lhs, rhs);
+    });
+    data.erase(std::unique(data.begin(), data.end(), unordered), data.end());
+
+    bulk_load(data.begin(), data.size(), default_fill_factor);
 }
 
 template<typename tkey, typename tvalue, compator<tkey> compare, std::size_t t>
 BS_tree<tkey, tvalue, compare, t>::BS_tree(std::initializer_list<std::pair<tkey, tvalue>> data, const compare& cmp, pp_allocator<value_type> alloc, logger* logger)
+    : BS_tree(data.begin(), data.end(), cmp, alloc, logger)
 {
-    throw not_implemented("template<typename tkey, typename tvalue, compator<tkey> compare, std::size_t t> BS_tree<tkey, tvalue, compare, t>::BS_tree(std::initializer_list<std::pair<tkey, tvalue>> data, const compare& cmp, pp_allocator<value_type> alloc, logger* logger)", "your code should be here...");
+}
+
+template<typename tkey, typename tvalue, compator<tkey> compare, std::size_t t>
+template<input_iterator_for_pair<tkey, tvalue> iterator>
+BS_tree<tkey, tvalue, compare, t>::BS_tree(sorted_unique_t, iterator begin, iterator end, double fill_factor, const compare& cmp, pp_allocator<value_type> alloc, logger* logger)
+    : compare(cmp), _allocator(alloc), _logger(logger), _root(nullptr), _size(0)
+{
+    if constexpr (std::forward_iterator<iterator>)
+    {
+        bulk_load(begin, std::distance(begin, end), fill_factor);
+    } else
+    {
+        std::vector<tree_data_type> data(begin, end);
+        bulk_load(data.begin(), data.size(), fill_factor);
+    }
 }
 
 template<typename tkey, typename tvalue, compator<tkey> compare, std::size_t t>
@@ -821,19 +937,33 @@ BS_tree<tkey, tvalue, compare, t>& BS_tree<tkey, tvalue, compare, t>::operator=(
 template<typename tkey, typename tvalue, compator<tkey> compare, std::size_t t>
 BS_tree<tkey, tvalue, compare, t>::~BS_tree() noexcept
 {
-    throw not_implemented("template<typename tkey, typename tvalue, compator<tkey> compare, std::size_t t> BS_tree<tkey, tvalue, compare, t>::~BS_tree() noexcept", "your code should be here...");
+    clear();
 }
 
 template<typename tkey, typename tvalue, compator<tkey> compare, std::size_t t>
 tvalue& BS_tree<tkey, tvalue, compare, t>::at(const tkey& key)
 {
-    throw not_implemented("template<typename tkey, typename tvalue, compator<tkey> compare, std::size_t t> tvalue& BS_tree<tkey, tvalue, compare, t>::at(const tkey& key)", "your code should be here...");
+    tree_data_type* data = find_data(key);
+
+    if (data == nullptr)
+    {
+        throw std::out_of_range("key not found");
+    }
+
+    return data->second;
 }
 
 template<typename tkey, typename tvalue, compator<tkey> compare, std::size_t t>
 const tvalue& BS_tree<tkey, tvalue, compare, t>::at(const tkey& key) const
 {
-    throw not_implemented("template<typename tkey, typename tvalue, compator<tkey> compare, std::size_t t> const tvalue& BS_tree<tkey, tvalue, compare, t>::at(const tkey& key) const", "your code should be here...");
+    const tree_data_type* data = find_data(key);
+
+    if (data == nullptr)
+    {
+        throw std::out_of_range("key not found");
+    }
+
+    return data->second;
 }
 
 template<typename tkey, typename tvalue, compator<tkey> compare, std::size_t t>
@@ -851,37 +981,45 @@ tvalue& BS_tree<tkey, tvalue, compare, t>::operator[](tkey&& key)
 template<typename tkey, typename tvalue, compator<tkey> compare, std::size_t t>
 typename BS_tree<tkey, tvalue, compare, t>::bstree_iterator BS_tree<tkey, tvalue, compare, t>::begin()
 {
-    throw not_implemented("template<typename tkey, typename tvalue, compator<tkey> compare, std::size_t t> typename BS_tree<tkey, tvalue, compare, t>::bstree_iterator BS_tree<tkey, tvalue, compare, t>::begin()", "your code should be here...");
+    std::stack<std::pair<bstree_node**, size_t>> path;
+
+    if (_root != nullptr)
+    {
+        path.emplace(&_root, 0);
+        descend_leftmost(path);
+    }
+
+    return bstree_iterator(path, 0);
 }
 
 template<typename tkey, typename tvalue, compator<tkey> compare, std::size_t t>
 typename BS_tree<tkey, tvalue, compare, t>::bstree_iterator BS_tree<tkey, tvalue, compare, t>::end()
 {
-    throw not_implemented("template<typename tkey, typename tvalue, compator<tkey> compare, std::size_t t> typename BS_tree<tkey, tvalue, compare, t>::bstree_iterator BS_tree<tkey, tvalue, compare, t>::end()", "your code should be here...");
+    return bstree_iterator();
 }
 
 template<typename tkey, typename tvalue, compator<tkey> compare, std::size_t t>
 typename BS_tree<tkey, tvalue, compare, t>::bstree_const_iterator BS_tree<tkey, tvalue, compare, t>::begin() const
 {
-    throw not_implemented("template<typename tkey, typename tvalue, compator<tkey> compare, std::size_t t> typename BS_tree<tkey, tvalue, compare, t>::bstree_const_iterator BS_tree<tkey, tvalue, compare, t>::begin() const", "your code should be here...");
+    return const_cast<BS_tree*>(this)->begin();
 }
 
 template<typename tkey, typename tvalue, compator<tkey> compare, std::size_t t>
 typename BS_tree<tkey, tvalue, compare, t>::bstree_const_iterator BS_tree<tkey, tvalue, compare, t>::end() const
 {
-    throw not_implemented("template<typename tkey, typename tvalue, compator<tkey> compare, std::size_t t> typename BS_tree<tkey, tvalue, compare, t>::bstree_const_iterator BS_tree<tkey, tvalue, compare, t>::end() const", "your code should be here...");
+    return bstree_const_iterator();
 }
 
 template<typename tkey, typename tvalue, compator<tkey> compare, std::size_t t>
 typename BS_tree<tkey, tvalue, compare, t>::bstree_const_iterator BS_tree<tkey, tvalue, compare, t>::cbegin() const
 {
-    throw not_implemented("template<typename tkey, typename tvalue, compator<tkey> compare, std::size_t t> typename BS_tree<tkey, tvalue, compare, t>::bstree_const_iterator BS_tree<tkey, tvalue, compare, t>::cbegin() const", "your code should be here...");
+    return begin();
 }
 
 template<typename tkey, typename tvalue, compator<tkey> compare, std::size_t t>
 typename BS_tree<tkey, tvalue, compare, t>::bstree_const_iterator BS_tree<tkey, tvalue, compare, t>::cend() const
 {
-    throw not_implemented("template<typename tkey, typename tvalue, compator<tkey> compare, std::size_t t> typename BS_tree<tkey, tvalue, compare, t>::bstree_const_iterator BS_tree<tkey, tvalue, compare, t>::cend() const", "your code should be here...");
+    return end();
 }
 
 template<typename tkey, typename tvalue, compator<tkey> compare, std::size_t t>
@@ -923,13 +1061,13 @@ typename BS_tree<tkey, tvalue, compare, t>::bstree_const_reverse_iterator BS_tre
 template<typename tkey, typename tvalue, compator<tkey> compare, std::size_t t>
 size_t BS_tree<tkey, tvalue, compare, t>::size() const noexcept
 {
-    throw not_implemented("template<typename tkey, typename tvalue, compator<tkey> compare, std::size_t t> size_t BS_tree<tkey, tvalue, compare, t>::size() const noexcept", "your code should be here...");
+    return _size;
 }
 
 template<typename tkey, typename tvalue, compator<tkey> compare, std::size_t t>
 bool BS_tree<tkey, tvalue, compare, t>::empty() const noexcept
 {
-    throw not_implemented("template<typename tkey, typename tvalue, compator<tkey> compare, std::size_t t> bool BS_tree<tkey, tvalue, compare, t>::empty() const noexcept", "your code should be here...");
+    return _size == 0;
 }
 
 template<typename tkey, typename tvalue, compator<tkey> compare, std::size_t t>
@@ -971,13 +1109,15 @@ typename BS_tree<tkey, tvalue, compare, t>::bstree_const_iterator BS_tree<tkey,
 template<typename tkey, typename tvalue, compator<tkey> compare, std::size_t t>
 bool BS_tree<tkey, tvalue, compare, t>::contains(const tkey& key) const
 {
-    throw not_implemented("template<typename tkey, typename tvalue, compator<tkey> compare, std::size_t t> bool BS_tree<tkey, tvalue, compare, t>::contains(const tkey& key) const", "your code should be here...");
+    return find_data(key) != nullptr;
 }
 
 template<typename tkey, typename tvalue, compator<tkey> compare, std::size_t t>
 void BS_tree<tkey, tvalue, compare, t>::clear() noexcept
 {
-    throw not_implemented("template<typename tkey, typename tvalue, compator<tkey> compare, std::size_t t> void BS_tree<tkey, tvalue, compare, t>::clear() noexcept", "your code should be here...");
+    destroy_subtree(_root);
+    _root = nullptr;
+    _size = 0;
 }
 
 template<typename tkey, typename tvalue, compator<tkey> compare, std::size_t t>
@@ -1050,4 +1190,254 @@ typename BS_tree<tkey, tvalue, compare, t>::bstree_iterator BS_tree<tkey, tvalue
             "your code should be here...");
 }
 
+// region node search implementation
+
+template<typename tkey, typename tvalue, compator<tkey> compare, std::size_t t>
+size_t BS_tree<tkey, tvalue, compare, t>::node_lower_bound(const bstree_node* node, const tkey& key) const
+{
+    if constexpr (vectorized_search)
+    {
+        return node->_search_keys.lower_bound(key);
+    } else
+    {
+        auto it = std::lower_bound(node->_keys.begin(), node->_keys.end(), key, [this](const tree_data_type& item, const tkey& needle)
+        {
+            return compare_keys(item.first, needle);
+        });
+        return std::distance(node->_keys.begin(), it);
+    }
+}
+
+template<typename tkey, typename tvalue, compator<tkey> compare, std::size_t t>
+const typename BS_tree<tkey, tvalue, compare, t>::tree_data_type* BS_tree<tkey, tvalue, compare, t>::find_data(const tkey& key) const
+{
+    const bstree_node* node = _root;
+
+    while (node != nullptr)
+    {
+        size_t index = node_lower_bound(node, key);
+
+        if (index < node->_keys.size() && !compare_keys(key, node->_keys[index].first))
+        {
+            return &node->_keys[index];
+        }
+
+        node = node->_pointers.empty() ? nullptr : node->_pointers[index];
+    }
+
+    return nullptr;
+}
+
+template<typename tkey, typename tvalue, compator<tkey> compare, std::size_t t>
+typename BS_tree<tkey, tvalue, compare, t>::tree_data_type* BS_tree<tkey, tvalue, compare, t>::find_data(const tkey& key)
+{
+    return const_cast<tree_data_type*>(std::as_const(*this).find_data(key));
+}
+
+// endregion node search implementation
+
+// region iteration implementation
+
+template<typename tkey, typename tvalue, compator<tkey> compare, std::size_t t>
+void BS_tree<tkey, tvalue, compare, t>::descend_leftmost(node_path& path)
+{
+    while (!(*path.top().first)->_pointers.empty())
+    {
+        path.emplace(&(*path.top().first)->_pointers.front(), 0);
+    }
+}
+
+template<typename tkey, typename tvalue, compator<tkey> compare, std::size_t t>
+void BS_tree<tkey, tvalue, compare, t>::next_position(node_path& path, size_t& index)
+{
+    bstree_node* node = *path.top().first;
+
+    // Next of key in middle node is the smallest key of subtree right of it
+    if (!node->_pointers.empty())
+    {
+        path.emplace(&node->_pointers[index + 1], index + 1);
+        descend_leftmost(path);
+        index = 0;
+        return;
+    }
+
+    ++index;
+
+    // Leaf is over, next is the key of parent right of the subtree just left
+    while (index == (*path.top().first)->_keys.size())
+    {
+        index = path.top().second;
+        path.pop();
+
+        if (path.empty())
+        {
+            index = 0;
+            return;
+        }
+    }
+}
+
+template<typename tkey, typename tvalue, compator<tkey> compare, std::size_t t>
+bool BS_tree<tkey, tvalue, compare, t>::same_position(const node_path& lhs, size_t lhs_index, const node_path& rhs, size_t rhs_index) noexcept
+{
+    if (lhs.empty() || rhs.empty())
+    {
+        return lhs.empty() && rhs.empty();
+    }
+
+    return *lhs.top().first == *rhs.top().first && lhs_index == rhs_index;
+}
+
+template<typename tkey, typename tvalue, compator<tkey> compare, std::size_t t>
+void BS_tree<tkey, tvalue, compare, t>::destroy_subtree(bstree_node* node) noexcept
+{
+    if (node == nullptr)
+    {
+        return;
+    }
+
+    for (auto child : node->_pointers)
+    {
+        destroy_subtree(child);
+    }
+
+    _allocator.delete_object(node);
+}
+
+// endregion iteration implementation
+
+// region bulk load implementation
+
+template<typename tkey, typename tvalue, compator<tkey> compare, std::size_t t>
+size_t BS_tree<tkey, tvalue, compare, t>::bulk_nodes_count(size_t count, size_t capacity) noexcept
+{
+    if (count <= maximum_keys_in_node)
+    {
+        return 1;
+    }
+
+    // count == sum of node sizes + (nodes - 1) separators
+    size_t packed = (count + capacity + 1) / (capacity + 1);
+    size_t sparsest = (count + 1) / (minimum_keys_in_node + 1);
+
+    return std::max<size_t>(std::min(packed, sparsest), 2);
+}
+
+template<typename tkey, typename tvalue, compator<tkey> compare, std::size_t t>
+template<std::forward_iterator iterator>
+void BS_tree<tkey, tvalue, compare, t>::bulk_load(iterator begin, size_t count, double fill_factor)
+{
+    if (!(fill_factor > 0 && fill_factor <= 1))
+    {
+        throw std::invalid_argument("fill factor must be in (0, 1]");
+    }
+
+    if (count == 0)
+    {
+        return;
+    }
+
+    const size_t capacity = std::clamp<size_t>(static_cast<size_t>(fill_factor * maximum_keys_in_node),
+                                               std::max<size_t>(minimum_keys_in_node, 1), maximum_keys_in_node);
+
+    std::vector<bstree_node*> created;
+
+    try
+    {
+        // Leaves are filled straight from input, every item between two leaves goes one level up
+        size_t nodes = bulk_nodes_count(count, capacity);
+        size_t keys = count - (nodes - 1);
+
+        std::vector<bstree_node*> level;
+        std::vector<tree_data_type> separators;
+        level.reserve(nodes);
+        separators.reserve(nodes - 1);
+
+        const tkey* previous = nullptr;
+
+        auto take = [&](auto& destination)
+        {
+            auto&& item = *begin;
+
+            if (previous != nullptr && !compare_keys(*previous, item.first))
+            {
+                throw std::logic_error("bulk load input must be strictly increasing by key");
+            }
+
+            destination.emplace_back(std::forward<decltype(item)>(item));
+            previous = &destination.back().first;
+            ++begin;
+        };
+
+        for (size_t i = 0; i < nodes; ++i)
+        {
+            bstree_node* leaf = _allocator.template new_object<bstree_node>();
+            created.push_back(leaf);
+            level.push_back(leaf);
+
+            for (size_t j = 0, size = keys / nodes + (i < keys % nodes ? 1 : 0); j < size; ++j)
+            {
+                take(leaf->_keys);
+            }
+            leaf->_search_keys.assign(leaf->_keys);
+
+            if (i + 1 < nodes)
+            {
+                take(separators);
+            }
+        }
+
+        // Separators of a level become keys of the next one until single root remains
+        while (level.size() > 1)
+        {
+            nodes = bulk_nodes_count(separators.size(), capacity);
+            keys = separators.size() - (nodes - 1);
+
+            std::vector<bstree_node*> next_level;
+            std::vector<tree_data_type> next_separators;
+            next_level.reserve(nodes);
+            next_separators.reserve(nodes - 1);
+
+            size_t child = 0, separator = 0;
+
+            for (size_t i = 0; i < nodes; ++i)
+            {
+                bstree_node* middle = _allocator.template new_object<bstree_node>();
+                created.push_back(middle);
+                next_level.push_back(middle);
+
+                for (size_t j = 0, size = keys / nodes + (i < keys % nodes ? 1 : 0); j < size; ++j)
+                {
+                    middle->_pointers.push_back(level[child++]);
+                    middle->_keys.push_back(std::move(separators[separator++]));
+                }
+                middle->_pointers.push_back(level[child++]);
+                middle->_search_keys.assign(middle->_keys);
+
+                if (i + 1 < nodes)
+                {
+                    next_separators.push_back(std::move(separators[separator++]));
+                }
+            }
+
+            level = std::move(next_level);
+            separators = std::move(next_separators);
+        }
+
+        _root = level.front();
+        _size = count;
+    }
+    catch (...)
+    {
+        for (auto node : created)
+        {
+            _allocator.delete_object(node);
+        }
+        throw;
+    }
+}
+
+// endregion bulk load implementation
+
+
 #endif
\ No newline at end of file
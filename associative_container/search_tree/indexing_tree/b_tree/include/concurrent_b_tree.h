@@ -0,0 +1,902 @@
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include <boost/container/static_vector.hpp>
+#include <pp_allocator.h>
+#include <search_tree.h>
+#include <node_search.h>
+#include <logger_guardant.h>
+
+#ifndef MP_OS_CONCURRENT_B_TREE_H
+#define MP_OS_CONCURRENT_B_TREE_H
+
+/**
+ * B-tree for concurrent use built on optimistic lock coupling. Every node carries version word. Readers take no locks:
+ * they remember versions of nodes on their path and check all of them once they are done, restarting if any node was
+ * changed meanwhile. Writers lock only nodes they change: insert upgrades versions it has read, so split locks node
+ * and its parent only, erase locks nodes from root down and holds node only until its child is made safe to descend.
+ *
+ * Readers may look into node while it is being changed, so keys and values have to be trivially copyable and are
+ * trusted only after validation. Nodes unlinked by merges are freed when tree is destroyed.
+**/
+template <typename tkey, typename tvalue, compator<tkey> compare = std::less<tkey>, std::size_t t = 5>
+class concurrent_B_tree final : private logger_guardant, private compare
+{
+    static_assert(t >= 2, "node must be able to lend a key to its sibling");
+    static_assert(std::is_trivially_copyable_v<tkey> && std::is_trivially_copyable_v<tvalue>,
+                  "optimistic readers copy keys and values out of nodes which may be changed concurrently");
+
+public:
+
+    using tree_data_type = std::pair<tkey, tvalue>;
+    using tree_data_type_const = std::pair<const tkey, tvalue>;
+    using value_type = tree_data_type_const;
+
+private:
+
+    static constexpr const size_t minimum_keys_in_node = t - 1;
+    static constexpr const size_t maximum_keys_in_node = 2 * t - 1;
+    static constexpr const bool vectorized_search = vectorized_key_search_v<tkey, compare>;
+
+    // Version word: bit 0 marks node unlinked from tree, bit 1 marks node locked, the rest counts changes
+    static constexpr const uint64_t obsolete_bit = 0b01;
+    static constexpr const uint64_t locked_bit = 0b10;
+
+    static constexpr const size_t maximum_height = 64;
+
+    // region comparators declaration
+
+    inline bool compare_keys(const tkey& lhs, const tkey& rhs) const;
+
+    // endregion comparators declaration
+
+    struct btree_node
+    {
+        std::atomic<uint64_t> _version;
+        bool _is_leaf;
+        boost::container::static_vector<tkey, maximum_keys_in_node> _keys;
+        boost::container::static_vector<tvalue, maximum_keys_in_node> _values;
+        boost::container::static_vector<btree_node*, maximum_keys_in_node + 1> _pointers;
+
+        explicit btree_node(bool is_leaf) noexcept;
+    };
+
+    using path_type = boost::container::static_vector<std::pair<btree_node*, uint64_t>, maximum_height>;
+
+    enum class erase_target
+    {
+        key,
+        minimum,
+        maximum
+    };
+
+    pp_allocator<value_type> _allocator;
+    logger* _logger;
+    std::atomic<btree_node*> _root;
+    std::atomic<size_t> _size;
+
+    std::mutex _retired_guard;
+    std::vector<btree_node*> _retired;
+
+    logger* get_logger() const noexcept override;
+    pp_allocator<value_type> get_allocator() const noexcept;
+
+    // region version locks declaration
+
+    /** Waits while node is locked, false if node is unlinked from tree
+     */
+    static bool read_lock(const btree_node* node, uint64_t& version) noexcept;
+
+    /** Whether node was not changed since its version was read
+     */
+    static bool validate(const btree_node* node, uint64_t version) noexcept;
+
+    /** Validates first count nodes of path
+     */
+    static bool validate(const path_type& path, size_t count) noexcept;
+
+    /** Locks node if it was not changed since version was read
+     */
+    static bool upgrade(btree_node* node, uint64_t version) noexcept;
+
+    /** Waits for node and locks it, false if node is unlinked from tree
+     */
+    static bool write_lock(btree_node* node) noexcept;
+
+    static void write_unlock(btree_node* node) noexcept;
+
+    /** Unlocks node unlinked from tree, so that readers holding it restart, and keeps it until destruction
+     */
+    void retire(btree_node* node);
+
+    bool read_root(btree_node*& node, uint64_t& version) const noexcept;
+
+    // endregion version locks declaration
+
+    // region node operations declaration
+
+    size_t node_lower_bound(const btree_node* node, const tkey& key) const;
+
+    /** Splits full node around its median, which goes to parent or to new root. Both nodes are locked by caller
+     */
+    void split(btree_node* parent, size_t index, btree_node* node);
+
+    /** Gives child of locked parent one more key than minimum by borrowing from sibling or merging with it.
+     * Returns locked node to descend into
+     */
+    btree_node* fill(btree_node* parent, size_t index, btree_node* child);
+
+    void rotate_right(btree_node* parent, size_t separator, btree_node* left, btree_node* right);
+
+    void rotate_left(btree_node* parent, size_t separator, btree_node* left, btree_node* right);
+
+    void merge(btree_node* parent, size_t separator, btree_node* left, btree_node* right);
+
+    /** Unlocks parent after descent to child, root left without keys is replaced by child
+     */
+    void release_parent(btree_node* parent, btree_node* child);
+
+    /** Erases target from subtree of locked node, which is root or has more keys than minimum. Unlocks node
+     */
+    std::optional<tree_data_type> erase_locked(btree_node* node, erase_target target, const tkey& key);
+
+    bool put(const tkey& key, const tvalue& value, bool assign);
+
+    void destroy_subtree(btree_node* node) noexcept;
+
+    // endregion node operations declaration
+
+public:
+
+    // region constructors declaration
+
+    explicit concurrent_B_tree(const compare& cmp = compare(), pp_allocator<value_type> = pp_allocator<value_type>(), logger* logger = nullptr);
+
+    // endregion constructors declaration
+
+    // region five declaration
+
+    concurrent_B_tree(const concurrent_B_tree& other) = delete;
+
+    concurrent_B_tree& operator=(const concurrent_B_tree& other) = delete;
+
+    /*
+     * Must not run concurrently with any other operation
+     */
+    ~concurrent_B_tree() noexcept override;
+
+    // endregion five declaration
+
+    // region lookup declaration
+
+    size_t size() const noexcept;
+    bool empty() const noexcept;
+
+    /*
+     * Copy of value by key, empty if not exist
+     */
+    std::optional<tvalue> find(const tkey& key) const;
+
+    /*
+     * Copy of pair with smallest key not less than key, empty if not exist
+     */
+    std::optional<tree_data_type> lower_bound(const tkey& key) const;
+
+    bool contains(const tkey& key) const;
+
+    // endregion lookup declaration
+
+    // region modifiers declaration
+
+    /*
+     * Returns false and leaves tree unchanged if key exists
+     */
+    bool insert(const tkey& key, const tvalue& value);
+
+    /*
+     * Returns true if key was inserted, false if existing value was replaced
+     */
+    bool insert_or_assign(const tkey& key, const tvalue& value);
+
+    bool erase(const tkey& key);
+
+    // endregion modifiers declaration
+};
+
+template<typename tkey, typename tvalue, compator<tkey> compare, std::size_t t>
+bool concurrent_B_tree<tkey, tvalue, compare, t>::compare_keys(const tkey& lhs, const tkey& rhs) const
+{
+    return compare::operator()(lhs, rhs);
+}
+
+template<typename tkey, typename tvalue, compator<tkey> compare, std::size_t t>
+concurrent_B_tree<tkey, tvalue, compare, t>::btree_node::btree_node(bool is_leaf) noexcept
+    : _version(0), _is_leaf(is_leaf)
+{
+}
+
+template<typename tkey, typename tvalue, compator<tkey> compare, std::size_t t>
+logger* concurrent_B_tree<tkey, tvalue, compare, t>::get_logger() const noexcept
+{
+    return _logger;
+}
+
+template<typename tkey, typename tvalue, compator<tkey> compare, std::size_t t>
+pp_allocator<typename concurrent_B_tree<tkey, tvalue, compare, t>::value_type> concurrent_B_tree<tkey, tvalue, compare, t>::get_allocator() const noexcept
+{
+    return _allocator;
+}
+
+// region version locks implementation
+
+template<typename tkey, typename tvalue, compator<tkey> compare, std::size_t t>
+bool concurrent_B_tree<tkey, tvalue, compare, t>::read_lock(const btree_node* node, uint64_t& version) noexcept
+{
+    version = node->_version.load(std::memory_order_acquire);
+
+    while (version & locked_bit)
+    {
+        std::this_thread::yield();
+        version = node->_version.load(std::memory_order_acquire);
+    }
+
+    return (version & obsolete_bit) == 0;
+}
+
+template<typename tkey, typename tvalue, compator<tkey> compare, std::size_t t>
+bool concurrent_B_tree<tkey, tvalue, compare, t>::validate(const btree_node* node, uint64_t version) noexcept
+{
+    // Reads of node data must not move past the version check
+    std::atomic_thread_fence(std::memory_order_acquire);
+    return node->_version.load(std::memory_order_relaxed) == version;
+}
+
+template<typename tkey, typename tvalue, compator<tkey> compare, std::size_t t>
+bool concurrent_B_tree<tkey, tvalue, compare, t>::validate(const path_type& path, size_t count) noexcept
+{
+    std::atomic_thread_fence(std::memory_order_acquire);
+
+    for (size_t i = 0; i < count; ++i)
+    {
+        if (path[i].first->_version.load(std::memory_order_relaxed) != path[i].second)
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+template<typename tkey, typename tvalue, compator<tkey> compare, std::size_t t>
+bool concurrent_B_tree<tkey, tvalue, compare, t>::upgrade(btree_node* node, uint64_t version) noexcept
+{
+    return node->_version.compare_exchange_strong(version, version + locked_bit, std::memory_order_acquire);
+}
+
+template<typename tkey, typename tvalue, compator<tkey> compare, std::size_t t>
+bool concurrent_B_tree<tkey, tvalue, compare, t>::write_lock(btree_node* node) noexcept
+{
+    while (true)
+    {
+        uint64_t version;
+
+        if (!read_lock(node, version))
+        {
+            return false;
+        }
+
+        if (upgrade(node, version))
+        {
+            return true;
+        }
+    }
+}
+
+template<typename tkey, typename tvalue, compator<tkey> compare, std::size_t t>
+void concurrent_B_tree<tkey, tvalue, compare, t>::write_unlock(btree_node* node) noexcept
+{
+    node->_version.fetch_add(locked_bit, std::memory_order_release);
+}
+
+template<typename tkey, typename tvalue, compator<tkey> compare, std::size_t t>
+void concurrent_B_tree<tkey, tvalue, compare, t>::retire(btree_node* node)
+{
+    node->_version.fetch_add(locked_bit | obsolete_bit, std::memory_order_release);
+
+    std::lock_guard lock(_retired_guard);
+    _retired.push_back(node);
+}
+
+template<typename tkey, typename tvalue, compator<tkey> compare, std::size_t t>
+bool concurrent_B_tree<tkey, tvalue, compare, t>::read_root(btree_node*& node, uint64_t& version) const noexcept
+{
+    node = _root.load(std::memory_order_acquire);
+
+    // Root which was split or shrunk after being loaded is no longer root
+    return read_lock(node, version) && node == _root.load(std::memory_order_acquire);
+}
+
+// endregion version locks implementation
+
+// region node operations implementation
+
+template<typename tkey, typename tvalue, compator<tkey> compare, std::size_t t>
+size_t concurrent_B_tree<tkey, tvalue, compare, t>::node_lower_bound(const btree_node* node, const tkey& key) const
+{
+    if constexpr (vectorized_search)
+    {
+        return __detail::keys_lower_bound(node->_keys.data(), node->_keys.size(), key);
+    } else
+    {
+        auto it = std::lower_bound(node->_keys.data(), node->_keys.data() + node->_keys.size(), key, [this](const tkey& item, const tkey& needle)
+        {
+            return compare_keys(item, needle);
+        });
+        return std::distance(node->_keys.data(), it);
+    }
+}
+
+template<typename tkey, typename tvalue, compator<tkey> compare, std::size_t t>
+void concurrent_B_tree<tkey, tvalue, compare, t>::split(btree_node* parent, size_t index, btree_node* node)
+{
+    // Allocations go first, so that failure leaves both nodes intact
+    btree_node* right = _allocator.template new_object<btree_node>(node->_is_leaf);
+    btree_node* root = nullptr;
+
+    if (parent == nullptr)
+    {
+        try
+        {
+            root = _allocator.template new_object<btree_node>(false);
+        }
+        catch (...)
+        {
+            _allocator.delete_object(right);
+            throw;
+        }
+    }
+
+    right->_keys.assign(node->_keys.begin() + t, node->_keys.end());
+    right->_values.assign(node->_values.begin() + t, node->_values.end());
+
+    if (!node->_is_leaf)
+    {
+        right->_pointers.assign(node->_pointers.begin() + t, node->_pointers.end());
+        node->_pointers.erase(node->_pointers.begin() + t, node->_pointers.end());
+    }
+
+    tkey median_key = node->_keys[t - 1];
+    tvalue median_value = node->_values[t - 1];
+
+    node->_keys.erase(node->_keys.begin() + (t - 1), node->_keys.end());
+    node->_values.erase(node->_values.begin() + (t - 1), node->_values.end());
+
+    if (parent == nullptr)
+    {
+        root->_keys.push_back(median_key);
+        root->_values.push_back(median_value);
+        root->_pointers.push_back(node);
+        root->_pointers.push_back(right);
+        _root.store(root, std::memory_order_release);
+    } else
+    {
+        parent->_keys.insert(parent->_keys.begin() + index, median_key);
+        parent->_values.insert(parent->_values.begin() + index, median_value);
+        parent->_pointers.insert(parent->_pointers.begin() + index + 1, right);
+    }
+}
+
+template<typename tkey, typename tvalue, compator<tkey> compare, std::size_t t>
+typename concurrent_B_tree<tkey, tvalue, compare, t>::btree_node* concurrent_B_tree<tkey, tvalue, compare, t>::fill(btree_node* parent, size_t index, btree_node* child)
+{
+    // Parent is locked, so none of its children can be unlinked and locking them always succeeds
+    btree_node* left = index > 0 ? parent->_pointers[index - 1] : nullptr;
+
+    if (left != nullptr)
+    {
+        write_lock(left);
+
+        if (left->_keys.size() > minimum_keys_in_node)
+        {
+            rotate_right(parent, index - 1, left, child);
+            write_unlock(left);
+            return child;
+        }
+    }
+
+    btree_node* right = index < parent->_keys.size() ? parent->_pointers[index + 1] : nullptr;
+
+    if (right != nullptr)
+    {
+        write_lock(right);
+
+        if (right->_keys.size() > minimum_keys_in_node)
+        {
+            rotate_left(parent, index, child, right);
+            write_unlock(right);
+        } else
+        {
+            merge(parent, index, child, right);
+        }
+
+        if (left != nullptr)
+        {
+            write_unlock(left);
+        }
+
+        return child;
+    }
+
+    merge(parent, index - 1, left, child);
+    return left;
+}
+
+template<typename tkey, typename tvalue, compator<tkey> compare, std::size_t t>
+void concurrent_B_tree<tkey, tvalue, compare, t>::rotate_right(btree_node* parent, size_t separator, btree_node* left, btree_node* right)
+{
+    right->_keys.insert(right->_keys.begin(), parent->_keys[separator]);
+    right->_values.insert(right->_values.begin(), parent->_values[separator]);
+
+    parent->_keys[separator] = left->_keys.back();
+    parent->_values[separator] = left->_values.back();
+    left->_keys.pop_back();
+    left->_values.pop_back();
+
+    if (!left->_is_leaf)
+    {
+        right->_pointers.insert(right->_pointers.begin(), left->_pointers.back());
+        left->_pointers.pop_back();
+    }
+}
+
+template<typename tkey, typename tvalue, compator<tkey> compare, std::size_t t>
+void concurrent_B_tree<tkey, tvalue, compare, t>::rotate_left(btree_node* parent, size_t separator, btree_node* left, btree_node* right)
+{
+    left->_keys.push_back(parent->_keys[separator]);
+    left->_values.push_back(parent->_values[separator]);
+
+    parent->_keys[separator] = right->_keys.front();
+    parent->_values[separator] = right->_values.front();
+    right->_keys.erase(right->_keys.begin());
+    right->_values.erase(right->_values.begin());
+
+    if (!right->_is_leaf)
+    {
+        left->_pointers.push_back(right->_pointers.front());
+        right->_pointers.erase(right->_pointers.begin());
+    }
+}
+
+template<typename tkey, typename tvalue, compator<tkey> compare, std::size_t t>
+void concurrent_B_tree<tkey, tvalue, compare, t>::merge(btree_node* parent, size_t separator, btree_node* left, btree_node* right)
+{
+    left->_keys.push_back(parent->_keys[separator]);
+    left->_values.push_back(parent->_values[separator]);
+    left->_keys.insert(left->_keys.end(), right->_keys.begin(), right->_keys.end());
+    left->_values.insert(left->_values.end(), right->_values.begin(), right->_values.end());
+    left->_pointers.insert(left->_pointers.end(), right->_pointers.begin(), right->_pointers.end());
+
+    parent->_keys.erase(parent->_keys.begin() + separator);
+    parent->_values.erase(parent->_values.begin() + separator);
+    parent->_pointers.erase(parent->_pointers.begin() + separator + 1);
+
+    retire(right);
+}
+
+template<typename tkey, typename tvalue, compator<tkey> compare, std::size_t t>
+void concurrent_B_tree<tkey, tvalue, compare, t>::release_parent(btree_node* parent, btree_node* child)
+{
+    // Only root may lose its last key, children of other nodes are filled before descent
+    if (parent->_keys.empty() && !parent->_is_leaf)
+    {
+        _root.store(child, std::memory_order_release);
+        retire(parent);
+    } else
+    {
+        write_unlock(parent);
+    }
+}
+
+template<typename tkey, typename tvalue, compator<tkey> compare, std::size_t t>
+std::optional<typename concurrent_B_tree<tkey, tvalue, compare, t>::tree_data_type> concurrent_B_tree<tkey, tvalue, compare, t>::erase_locked(btree_node* node, erase_target target, const tkey& key)
+{
+    while (true)
+    {
+        size_t count = node->_keys.size();
+        size_t index = 0;
+        bool found = false;
+
+        switch (target)
+        {
+            case erase_target::key:
+                index = node_lower_bound(node, key);
+                found = index < count && !compare_keys(key, node->_keys[index]);
+                break;
+            case erase_target::minimum:
+                found = node->_is_leaf && count > 0;
+                break;
+            case erase_target::maximum:
+                index = node->_is_leaf && count > 0 ? count - 1 : count;
+                found = node->_is_leaf && count > 0;
+                break;
+        }
+
+        if (node->_is_leaf)
+        {
+            std::optional<tree_data_type> result;
+
+            if (found)
+            {
+                result.emplace(node->_keys[index], node->_values[index]);
+                node->_keys.erase(node->_keys.begin() + index);
+                node->_values.erase(node->_values.begin() + index);
+            }
+
+            write_unlock(node);
+            return result;
+        }
+
+        if (found)
+        {
+            // Key of middle node is replaced by its predecessor or successor, otherwise both neighbours are merged
+            tree_data_type result(node->_keys[index], node->_values[index]);
+
+            btree_node* left = node->_pointers[index];
+            write_lock(left);
+
+            if (left->_keys.size() > minimum_keys_in_node)
+            {
+                auto replacement = erase_locked(left, erase_target::maximum, key);
+                node->_keys[index] = replacement->first;
+                node->_values[index] = replacement->second;
+                write_unlock(node);
+                return result;
+            }
+
+            btree_node* right = node->_pointers[index + 1];
+            write_lock(right);
+
+            if (right->_keys.size() > minimum_keys_in_node)
+            {
+                write_unlock(left);
+
+                auto replacement = erase_locked(right, erase_target::minimum, key);
+                node->_keys[index] = replacement->first;
+                node->_values[index] = replacement->second;
+                write_unlock(node);
+                return result;
+            }
+
+            merge(node, index, left, right);
+            release_parent(node, left);
+            node = left;
+            continue;
+        }
+
+        btree_node* child = node->_pointers[index];
+        write_lock(child);
+
+        if (child->_keys.size() == minimum_keys_in_node)
+        {
+            child = fill(node, index, child);
+        }
+
+        release_parent(node, child);
+        node = child;
+    }
+}
+
+template<typename tkey, typename tvalue, compator<tkey> compare, std::size_t t>
+bool concurrent_B_tree<tkey, tvalue, compare, t>::put(const tkey& key, const tvalue& value, bool assign)
+{
+    while (true)
+    {
+        path_type path;
+        btree_node* node;
+        uint64_t version;
+
+        if (!read_root(node, version))
+        {
+            continue;
+        }
+
+        btree_node* parent = nullptr;
+        uint64_t parent_version = 0;
+        size_t parent_index = 0;
+
+        while (true)
+        {
+            path.emplace_back(node, version);
+
+            if (node->_keys.size() == maximum_keys_in_node)
+            {
+                // Full nodes are split on the way down, so parent of the one being split always has room for median
+                if (parent != nullptr && !upgrade(parent, parent_version))
+                {
+                    break;
+                }
+
+                if (!upgrade(node, version))
+                {
+                    if (parent != nullptr)
+                    {
+                        write_unlock(parent);
+                    }
+                    break;
+                }
+
+                try
+                {
+                    split(parent, parent_index, node);
+                }
+                catch (...)
+                {
+                    write_unlock(node);
+                    if (parent != nullptr)
+                    {
+                        write_unlock(parent);
+                    }
+                    throw;
+                }
+
+                write_unlock(node);
+                if (parent != nullptr)
+                {
+                    write_unlock(parent);
+                }
+                break;
+            }
+
+            size_t index = node_lower_bound(node, key);
+
+            if (index < node->_keys.size() && !compare_keys(key, node->_keys.data()[index]))
+            {
+                if (!assign)
+                {
+                    if (validate(path, path.size()))
+                    {
+                        return false;
+                    }
+                    break;
+                }
+
+                if (!upgrade(node, version))
+                {
+                    break;
+                }
+
+                if (!validate(path, path.size() - 1))
+                {
+                    write_unlock(node);
+                    break;
+                }
+
+                node->_values[index] = value;
+                write_unlock(node);
+                return false;
+            }
+
+            if (node->_is_leaf)
+            {
+                if (!upgrade(node, version))
+                {
+                    break;
+                }
+
+                // Ancestors are checked as well: erase may move keys through them without touching this leaf's parent
+                if (!validate(path, path.size() - 1))
+                {
+                    write_unlock(node);
+                    break;
+                }
+
+                node->_keys.insert(node->_keys.begin() + index, key);
+                node->_values.insert(node->_values.begin() + index, value);
+                _size.fetch_add(1, std::memory_order_relaxed);
+                write_unlock(node);
+                return true;
+            }
+
+            btree_node* child = node->_pointers.data()[index];
+
+            if (!validate(node, version))
+            {
+                break;
+            }
+
+            parent = node;
+            parent_version = version;
+            parent_index = index;
+
+            if (!read_lock(child, version))
+            {
+                break;
+            }
+
+            node = child;
+        }
+    }
+}
+
+template<typename tkey, typename tvalue, compator<tkey> compare, std::size_t t>
+void concurrent_B_tree<tkey, tvalue, compare, t>::destroy_subtree(btree_node* node) noexcept
+{
+    for (auto child : node->_pointers)
+    {
+        destroy_subtree(child);
+    }
+
+    _allocator.delete_object(node);
+}
+
+// endregion node operations implementation
+
+// region constructors implementation
+
+template<typename tkey, typename tvalue, compator<tkey> compare, std::size_t t>
+concurrent_B_tree<tkey, tvalue, compare, t>::concurrent_B_tree(const compare& cmp, pp_allocator<value_type> alloc, logger* logger)
+    : compare(cmp), _allocator(alloc), _logger(logger), _root(nullptr), _size(0)
+{
+    _root.store(_allocator.template new_object<btree_node>(true), std::memory_order_release);
+}
+
+// endregion constructors implementation
+
+// region five implementation
+
+template<typename tkey, typename tvalue, compator<tkey> compare, std::size_t t>
+concurrent_B_tree<tkey, tvalue, compare, t>::~concurrent_B_tree() noexcept
+{
+    destroy_subtree(_root.load(std::memory_order_acquire));
+
+    for (auto node : _retired)
+    {
+        _allocator.delete_object(node);
+    }
+}
+
+// endregion five implementation
+
+// region lookup implementation
+
+template<typename tkey, typename tvalue, compator<tkey> compare, std::size_t t>
+size_t concurrent_B_tree<tkey, tvalue, compare, t>::size() const noexcept
+{
+    return _size.load(std::memory_order_relaxed);
+}
+
+template<typename tkey, typename tvalue, compator<tkey> compare, std::size_t t>
+bool concurrent_B_tree<tkey, tvalue, compare, t>::empty() const noexcept
+{
+    return size() == 0;
+}
+
+template<typename tkey, typename tvalue, compator<tkey> compare, std::size_t t>
+std::optional<typename concurrent_B_tree<tkey, tvalue, compare, t>::tree_data_type> concurrent_B_tree<tkey, tvalue, compare, t>::lower_bound(const tkey& key) const
+{
+    while (true)
+    {
+        path_type path;
+        btree_node* node;
+        uint64_t version;
+
+        if (!read_root(node, version))
+        {
+            continue;
+        }
+
+        // Keys met on the way down are candidates, deeper ones are closer to key
+        std::optional<tree_data_type> candidate;
+        bool restart = false;
+
+        while (true)
+        {
+            path.emplace_back(node, version);
+
+            size_t index = node_lower_bound(node, key);
+
+            if (index < node->_keys.size())
+            {
+                candidate.emplace(node->_keys.data()[index], node->_values.data()[index]);
+
+                if (!compare_keys(key, candidate->first))
+                {
+                    break;
+                }
+            }
+
+            if (node->_is_leaf)
+            {
+                break;
+            }
+
+            btree_node* child = node->_pointers.data()[index];
+
+            if (!validate(node, version) || !read_lock(child, version))
+            {
+                restart = true;
+                break;
+            }
+
+            node = child;
+        }
+
+        if (!restart && validate(path, path.size()))
+        {
+            return candidate;
+        }
+    }
+}
+
+template<typename tkey, typename tvalue, compator<tkey> compare, std::size_t t>
+std::optional<tvalue> concurrent_B_tree<tkey, tvalue, compare, t>::find(const tkey& key) const
+{
+    auto data = lower_bound(key);
+
+    if (!data.has_value() || compare_keys(key, data->first))
+    {
+        return std::nullopt;
+    }
+
+    return data->second;
+}
+
+template<typename tkey, typename tvalue, compator<tkey> compare, std::size_t t>
+bool concurrent_B_tree<tkey, tvalue, compare, t>::contains(const tkey& key) const
+{
+    return find(key).has_value();
+}
+
+// endregion lookup implementation
+
+// region modifiers implementation
+
+template<typename tkey, typename tvalue, compator<tkey> compare, std::size_t t>
+bool concurrent_B_tree<tkey, tvalue, compare, t>::insert(const tkey& key, const tvalue& value)
+{
+    return put(key, value, false);
+}
+
+template<typename tkey, typename tvalue, compator<tkey> compare, std::size_t t>
+bool concurrent_B_tree<tkey, tvalue, compare, t>::insert_or_assign(const tkey& key, const tvalue& value)
+{
+    return put(key, value, true);
+}
+
+template<typename tkey, typename tvalue, compator<tkey> compare, std::size_t t>
+bool concurrent_B_tree<tkey, tvalue, compare, t>::erase(const tkey& key)
+{
+    btree_node* root;
+
+    while (true)
+    {
+        root = _root.load(std::memory_order_acquire);
+
+        if (write_lock(root))
+        {
+            if (root == _root.load(std::memory_order_acquire))
+            {
+                break;
+            }
+            write_unlock(root);
+        }
+    }
+
+    if (erase_locked(root, erase_target::key, key).has_value())
+    {
+        _size.fetch_sub(1, std::memory_order_relaxed);
+        return true;
+    }
+
+    return false;
+}
+
+// endregion modifiers implementation
+
+#endif
@@ -1,9 +1,15 @@
 #include "gtest/gtest.h"
 
+#include <algorithm>
+#include <atomic>
 #include <list>
+#include <map>
 #include <random>
+#include <string_view>
+#include <thread>
 #include <vector>
 #include <b_tree.h>
+#include <concurrent_b_tree.h>
 #include <client_logger_builder.h>
 
 
@@ -591,6 +597,377 @@ TEST(bTreeNegativeTests, test3)
     logger->trace("bTreeNegativeTests.test3 finished");
 }
 
+TEST(bTreeBulkLoadTests, test1)
+{
+    std::vector<std::pair<int, std::string>> data;
+
+    for (int i = 0; i < 1000; ++i)
+    {
+        data.emplace_back(i * 2, std::to_string(i));
+    }
+
+    B_tree<int, std::string, std::less<int>, 3> tree(sorted_unique, data.begin(), data.end(), 0.7, std::less<int>(), nullptr, nullptr);
+
+    EXPECT_EQ(tree.size(), data.size());
+
+    auto expected = data.begin();
+    for (auto const &item: tree)
+    {
+        EXPECT_EQ(item.first, expected->first);
+        EXPECT_EQ(item.second, expected->second);
+        ++expected;
+    }
+    EXPECT_EQ(expected, data.end());
+}
+
+TEST(bTreeBulkLoadTests, test2)
+{
+    std::vector<std::pair<int, std::string>> data =
+    {
+        { 1, "a" }, { 2, "b" }, { 3, "c" }, { 3, "d" }, { 4, "e" }
+    };
+
+    using tree_type = B_tree<int, std::string, std::less<int>, 3>;
+
+    EXPECT_THROW(tree_type(sorted_unique, data.begin(), data.end(), 1.0, std::less<int>(), nullptr, nullptr), std::logic_error);
+    EXPECT_THROW(tree_type(sorted_unique, data.begin(), data.begin() + 3, 0.0, std::less<int>(), nullptr, nullptr), std::invalid_argument);
+}
+
+TEST(bTreeConstructorTests, test1)
+{
+    using tree_type = B_tree<int, std::string, std::less<int>, 3>;
+
+    // Unsorted input is sorted, the first value of repeated key is kept
+    tree_type small{ { 5, "a" }, { 1, "b" }, { 3, "c" }, { 1, "d" }, { 4, "e" }, { 5, "f" } };
+    std::vector<std::pair<int, std::string>> expected = { { 1, "b" }, { 3, "c" }, { 4, "e" }, { 5, "a" } };
+
+    EXPECT_EQ(small.size(), expected.size());
+
+    auto next = expected.begin();
+    for (auto const &item: small)
+    {
+        EXPECT_EQ(item.first, next->first);
+        EXPECT_EQ(item.second, next->second);
+        ++next;
+    }
+    EXPECT_EQ(next, expected.end());
+
+    std::vector<std::pair<int, std::string>> data;
+
+    for (int i = 0; i < 2000; ++i)
+    {
+        data.emplace_back(i % 700, std::to_string(i));
+    }
+
+    std::shuffle(data.begin(), data.end(), std::mt19937(27));
+
+    tree_type tree(data.begin(), data.end());
+
+    EXPECT_EQ(tree.size(), size_t(700));
+
+    int key = 0;
+    for (auto const &item: tree)
+    {
+        auto first = std::find_if(data.begin(), data.end(), [key](auto const &pair) { return pair.first == key; });
+        EXPECT_EQ(item.first, key);
+        EXPECT_EQ(item.second, first->second);
+        ++key;
+    }
+    EXPECT_EQ(key, 700);
+}
+
+template<typename tkey>
+bool node_search_test(std::mt19937& gen, size_t count)
+{
+    std::uniform_int_distribution<int> dist(-50, 50);
+    std::vector<tkey> keys(count);
+
+    for (auto &key: keys)
+    {
+        key = static_cast<tkey>(dist(gen));
+    }
+    std::sort(keys.begin(), keys.end());
+
+    for (int i = -60; i <= 60; ++i)
+    {
+        tkey key = static_cast<tkey>(i);
+
+        if (__detail::keys_lower_bound(keys.data(), keys.size(), key) != size_t(std::lower_bound(keys.begin(), keys.end(), key) - keys.begin()) ||
+            __detail::keys_upper_bound(keys.data(), keys.size(), key) != size_t(std::upper_bound(keys.begin(), keys.end(), key) - keys.begin()))
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+TEST(nodeSearchTests, test1)
+{
+    static_assert(vectorized_key_search_v<int, std::less<int>>);
+    static_assert(vectorized_key_search_v<double, std::less<double>>);
+    static_assert(!vectorized_key_search_v<int, std::greater<int>>);
+    static_assert(!vectorized_key_search_v<std::string, std::less<std::string>>);
+
+    std::mt19937 gen(42);
+
+    for (size_t count: { 0, 1, 3, 7, 8, 9, 31, 33, 100, 1000 })
+    {
+        EXPECT_TRUE(node_search_test<int>(gen, count));
+        EXPECT_TRUE(node_search_test<unsigned>(gen, count));
+        EXPECT_TRUE(node_search_test<long long>(gen, count));
+        EXPECT_TRUE(node_search_test<unsigned long long>(gen, count));
+        EXPECT_TRUE(node_search_test<float>(gen, count));
+        EXPECT_TRUE(node_search_test<double>(gen, count));
+    }
+}
+
+TEST(bTreeLookupTests, test2)
+{
+    std::vector<std::pair<std::string, int>> data;
+
+    for (int i = 0; i < 500; ++i)
+    {
+        data.emplace_back(std::to_string(i), i);
+    }
+
+    std::sort(data.begin(), data.end());
+
+    B_tree<std::string, int, std::less<>, 3> tree(sorted_unique, data.begin(), data.end(), 0.8, std::less<>(), nullptr, nullptr);
+    const auto& view = tree;
+
+    EXPECT_EQ(view.at(std::string_view("42")), 42);
+    EXPECT_TRUE(tree.contains("7"));
+    EXPECT_TRUE(view.contains(std::string_view("499")));
+    EXPECT_FALSE(view.contains(std::string_view("500")));
+    EXPECT_FALSE(tree.contains(""));
+    EXPECT_THROW(view.at("x"), std::out_of_range);
+
+    tree.at(std::string_view("3")) = -1;
+
+    EXPECT_EQ(view.at("3"), -1);
+}
+
+TEST(bTreeLookupTests, test3)
+{
+    std::vector<std::pair<int, int>> data;
+
+    for (int i = 0; i < 3000; ++i)
+    {
+        data.emplace_back(i * 3, i);
+    }
+
+    B_tree<int, int, std::less<int>, 3> tree(sorted_unique, data.begin(), data.end(), 0.8, std::less<int>(), nullptr, nullptr);
+    const auto& view = tree;
+
+    // More keys than one interleaved group, hits and misses mixed in random order
+    std::mt19937 gen(37);
+    std::vector<int> keys(1000);
+
+    for (auto& key: keys)
+    {
+        key = static_cast<int>(gen() % 9100) - 50;
+    }
+
+    std::vector<int*> values(keys.size());
+    std::vector<const int*> const_values(keys.size());
+
+    tree.find_batch(keys, values);
+    view.find_batch(keys, const_values);
+
+    for (size_t i = 0; i < keys.size(); ++i)
+    {
+        if (view.contains(keys[i]))
+        {
+            ASSERT_NE(values[i], nullptr);
+            EXPECT_EQ(*values[i], keys[i] / 3);
+            EXPECT_EQ(const_values[i], &view.at(keys[i]));
+        } else
+        {
+            EXPECT_EQ(values[i], nullptr);
+            EXPECT_EQ(const_values[i], nullptr);
+        }
+    }
+
+    std::vector<int*> shorter(keys.size() - 1);
+    EXPECT_THROW(tree.find_batch(keys, shorter), std::invalid_argument);
+
+    B_tree<int, int, std::less<int>, 3> empty;
+    empty.find_batch(keys, values);
+
+    EXPECT_TRUE(std::all_of(values.begin(), values.end(), [](int* value) { return value == nullptr; }));
+}
+
+TEST(concurrentBTreeTests, test1)
+{
+    concurrent_B_tree<int, int, std::less<int>, 2> tree;
+    std::map<int, int> expected;
+    std::mt19937 gen(7);
+
+    for (int i = 0; i < 20000; ++i)
+    {
+        int key = static_cast<int>(gen() % 500);
+
+        switch (gen() % 3)
+        {
+            case 0:
+                EXPECT_EQ(tree.insert(key, i), expected.emplace(key, i).second);
+                break;
+            case 1:
+                EXPECT_EQ(tree.erase(key), expected.erase(key) == 1);
+                break;
+            default:
+                EXPECT_EQ(tree.insert_or_assign(key, i), !expected.contains(key));
+                expected[key] = i;
+                break;
+        }
+
+        auto bound = tree.lower_bound(key);
+        auto expected_bound = expected.lower_bound(key);
+
+        ASSERT_EQ(bound.has_value(), expected_bound != expected.end());
+        if (bound.has_value())
+        {
+            EXPECT_EQ(bound->first, expected_bound->first);
+            EXPECT_EQ(bound->second, expected_bound->second);
+        }
+    }
+
+    EXPECT_EQ(tree.size(), expected.size());
+
+    for (auto const &[key, value]: expected)
+    {
+        EXPECT_EQ(tree.find(key), std::optional<int>(value));
+    }
+}
+
+TEST(concurrentBTreeTests, test2)
+{
+    constexpr int writers = 4;
+    constexpr int readers = 4;
+    constexpr int keys_per_writer = 20000;
+
+    concurrent_B_tree<int, int, std::less<int>, 4> tree;
+    std::atomic<int> progress[writers] = {};
+    std::atomic<bool> erasing = false;
+    std::atomic<bool> done = false;
+    std::atomic<size_t> misses = 0;
+
+    // Writer w inserts keys w, w + writers, ... in order, readers look up keys already published by progress
+    std::vector<std::thread> threads;
+
+    for (int w = 0; w < writers; ++w)
+    {
+        threads.emplace_back([&, w]()
+        {
+            for (int i = 0; i < keys_per_writer; ++i)
+            {
+                tree.insert(i * writers + w, -(i * writers + w));
+                progress[w].store(i + 1, std::memory_order_release);
+            }
+        });
+    }
+
+    for (int r = 0; r < readers; ++r)
+    {
+        threads.emplace_back([&, r]()
+        {
+            std::mt19937 gen(r);
+
+            while (!done.load(std::memory_order_acquire))
+            {
+                int w = static_cast<int>(gen() % writers);
+                int published = progress[w].load(std::memory_order_acquire);
+
+                if (published == 0)
+                {
+                    continue;
+                }
+
+                int key = static_cast<int>(gen() % published) * writers + w;
+
+                // Odd keys may disappear once erasing has started
+                if (tree.find(key) != std::optional<int>(-key) && (key % 2 == 0 || !erasing.load()))
+                {
+                    ++misses;
+                }
+            }
+        });
+    }
+
+    for (int w = 0; w < writers; ++w)
+    {
+        threads[w].join();
+    }
+
+    // Odd keys are erased while readers keep looking up even ones
+    erasing.store(true);
+    std::vector<std::thread> erasers;
+
+    for (int w = 0; w < writers; ++w)
+    {
+        erasers.emplace_back([&, w]()
+        {
+            for (int key = w * 2 + 1; key < writers * keys_per_writer; key += writers * 2)
+            {
+                tree.erase(key);
+            }
+        });
+    }
+
+    for (auto &eraser: erasers)
+    {
+        eraser.join();
+    }
+
+    done.store(true, std::memory_order_release);
+
+    for (int r = 0; r < readers; ++r)
+    {
+        threads[writers + r].join();
+    }
+
+    EXPECT_EQ(misses.load(), 0);
+    EXPECT_EQ(tree.size(), size_t(writers * keys_per_writer / 2));
+
+    for (int key = 0; key < writers * keys_per_writer; ++key)
+    {
+        EXPECT_EQ(tree.contains(key), key % 2 == 0);
+    }
+}
+
+TEST(bTreeLookupTests, test1)
+{
+    std::vector<std::pair<int, std::string>> data;
+
+    for (int i = 0; i < 500; ++i)
+    {
+        data.emplace_back(i * 3, std::to_string(i));
+    }
+
+    B_tree<int, std::string, std::less<int>, 3> tree(sorted_unique, data.begin(), data.end(), 0.8, std::less<int>(), nullptr, nullptr);
+    const auto& view = tree;
+
+    for (int key = -3; key <= 1500; ++key)
+    {
+        bool present = key >= 0 && key < 1500 && key % 3 == 0;
+
+        EXPECT_EQ(view.contains(key), present);
+
+        if (present)
+        {
+            EXPECT_EQ(view.at(key), std::to_string(key / 3));
+        } else
+        {
+            EXPECT_THROW(view.at(key), std::out_of_range);
+        }
+    }
+
+    tree.at(300) = "changed";
+
+    EXPECT_EQ(view.at(300), "changed");
+}
+
 int main(
     int argc,
     char **argv)
@@ -0,0 +1,47 @@
+#ifndef B_TREE_DISK_ASYNC_PAGE_READER_HPP
+#define B_TREE_DISK_ASYNC_PAGE_READER_HPP
+
+#include <cstddef>
+#include <memory>
+#include <span>
+#include <page_file.hpp>
+
+struct page_read {
+    size_t id;
+    std::span<char> page;
+};
+
+/**
+ * Reads batch of pages keeping many of them in flight, so that independent reads overlap instead of waiting for each
+ * other. Uses io_uring where kernel allows it and pool of threads issuing pread otherwise. Backend is chosen on first
+ * read. Reads behave as page_file::read_page, errors are thrown as std::system_error
+ */
+class async_page_reader final {
+    struct backend;
+
+    std::unique_ptr<backend> _backend;
+    size_t _queue_depth;
+
+public:
+    static constexpr const size_t default_queue_depth = 128;
+
+    explicit async_page_reader(size_t queue_depth = default_queue_depth) noexcept;
+
+    async_page_reader(async_page_reader &&other) noexcept;
+
+    async_page_reader &operator=(async_page_reader &&other) noexcept;
+
+    ~async_page_reader() noexcept;
+
+    /*
+     * Returns when every page is read
+     */
+    void read(const page_file &file, std::span<const page_read> reads);
+
+    /*
+     * "io_uring", "threads" or "sync", empty before first read
+     */
+    const char *backend_name() const noexcept;
+};
+
+#endif //B_TREE_DISK_ASYNC_PAGE_READER_HPP
@@ -6,6 +6,7 @@
 #define B_TREE_DISK_HPP
 
 #include <iterator>
+#include <limits>
 #include <utility>
 #include <vector>
 #include <concepts>
@@ -13,8 +14,33 @@
 #include <stack>
 #include <fstream>
 #include <optional>
+#include <mutex>
 #include <cstddef>
 #include <filesystem>
+#include <algorithm>
+#include <bit>
+#include <cstdint>
+#include <cstring>
+#include <deque>
+#include <future>
+#include <numeric>
+#include <ranges>
+#include <set>
+#include <span>
+#include <spanstream>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <type_traits>
+#include <unordered_map>
+#include <async_page_reader.hpp>
+#include <bloom_filter.hpp>
+#include <buffer_pool.hpp>
+#include <page_file.hpp>
+#include <shared_latch.hpp>
+#include <slotted_page.hpp>
+#include <write_ahead_log.hpp>
 
 #pragma pack(push, 1)
 #pragma pack(pop)
@@ -37,6 +63,42 @@ concept serializable = requires(const T t, std::fstream &s)
                            { t.serialize_size() } -> std::same_as<size_t>;
                        } && std::copyable<T>;
 
+/*
+ * Тип, байты объекта которого и есть его сериализованная форма: ключи и значения таких типов копируются memcpy
+ * без вызовов serialize и deserialize. Специализируйте как false, если serialize пишет что-то другое
+ */
+template<typename T>
+inline constexpr bool raw_serializable_v = std::is_trivially_copyable_v<T> && std::is_standard_layout_v<T> &&
+                                          std::has_unique_object_representations_v<T>;
+
+template<typename T>
+concept raw_serializable = serializable<T> && raw_serializable_v<T>;
+
+/*
+ * Ключ, отдающий свои байты: у ключей одного узла общий префикс этих байтов хранится в странице один раз.
+ * from_bytes восстанавливает ключ по байтам, которые вернул bytes
+ */
+template<typename T>
+concept prefix_compressible = serializable<T> && requires(const T t, std::string_view bytes)
+                              {
+                                  { t.bytes() } -> std::convertible_to<std::string_view>;
+                                  { T::from_bytes(bytes) } -> std::same_as<T>;
+                              };
+
+/**
+ * Settings of B_tree_disk::build
+ */
+struct build_options {
+    /* Unsorted pairs held in memory by all sorting threads together, roughly */
+    size_t memory_bytes = size_t(64) << 20;
+
+    /* Threads sorting runs while next run is read, 0 means one per hardware thread */
+    size_t threads = 0;
+
+    /* Runs merged at once, more runs are merged in several passes */
+    size_t merge_fan_in = 64;
+};
+
 struct SerializableInt {
     int data;
 
@@ -87,6 +149,12 @@ struct SerializableString {
 
     std::string &get() noexcept { return data; }
 
+    std::string_view bytes() const noexcept { return data; }
+
+    static SerializableString from_bytes(std::string_view bytes) {
+        return SerializableString(std::string(bytes));
+    }
+
     // Десериализация из бинарного потока
     static SerializableString deserialize(std::fstream &stream) {
         size_t size;
@@ -163,21 +231,6 @@ struct SerializableVector {
     operator std::vector<T>() const { return data; }
 };
 
-inline void write_node_header(std::fstream &stream, size_t size, bool is_leaf, size_t pos) {
-    stream.write(reinterpret_cast<const char *>(&size), sizeof(size_t));
-    uint8_t leaf = is_leaf ? 1 : 0;
-    stream.write(reinterpret_cast<const char *>(&leaf), sizeof(uint8_t));
-    stream.write(reinterpret_cast<const char *>(&pos), sizeof(size_t));
-}
-
-inline void read_node_header(std::fstream &stream, size_t &size, bool &is_leaf, size_t &pos) {
-    stream.read(reinterpret_cast<char *>(&size), sizeof(size_t));
-    uint8_t leaf;
-    stream.read(reinterpret_cast<char *>(&leaf), sizeof(uint8_t));
-    is_leaf = (leaf != 0);
-    stream.read(reinterpret_cast<char *>(&pos), sizeof(size_t));
-}
-
 template<serializable tkey, serializable tvalue, compator<tkey> compare = std::less<tkey>, std::size_t t = 2>
 class B_tree_disk final : private compare {
 public:
@@ -188,6 +241,9 @@ private:
     static constexpr const size_t minimum_keys_in_node = t - 1;
     static constexpr const size_t maximum_keys_in_node = 2 * t - 1;
 
+    /* Nodes go to packed pages when they fit there */
+    static constexpr const bool packed_pairs = raw_serializable<tkey> && raw_serializable<tvalue>;
+
     // region comparators declaration
 
     inline bool compare_keys(const tkey &lhs, const tkey &rhs) const;
@@ -204,10 +260,6 @@ public:
         std::vector<tree_data_type> keys;
         std::vector<size_t> pointers;
 
-        void serialize(std::fstream &stream, std::fstream &stream_for_data) const;
-
-        static btree_disk_node deserialize(std::fstream &stream, std::fstream &stream_for_data);
-
         explicit btree_disk_node(bool is_leaf);
 
         btree_disk_node();
@@ -218,9 +270,102 @@ private:
 
     //logger* _logger;
 
-    std::fstream _file_for_tree;
+    /* Page 0 is file header, other pages are nodes and overflow chains of their large cells */
+    page_file _file;
+
+    /*
+     * Readers share tree latch, operations changing tree take it alone. Readers use no buffers of tree, pages they
+     * load and prefetch are guarded by latches of their own
+     */
+    struct latches {
+        shared_latch tree;
+        std::mutex reader;
+        std::mutex prefetched;
+        std::mutex chains;
+    };
+
+    std::unique_ptr<latches> _latches;
+
+    std::string _file_path;
+
+    /* Free pages, written into some of themselves on flush */
+    std::vector<size_t> _free_pages;
+    size_t _free_list_head;
+
+    /* Overflow pages of node as it is on disk, reused when node is written again and freed with node */
+    std::unordered_map<size_t, std::vector<size_t>> _overflow_chains;
+
+    /* Pages written by compact go to new file */
+    page_file *_compact_target;
+
+    std::vector<char> _page_buffer;
+    std::vector<char> _chain_buffer;
+    std::vector<char> _cell_buffer;
+
+    /* Nodes read and written by tree operations, files are touched only on misses and write-back */
+    buffer_pool<btree_disk_node> _pool;
+
+    /* Pages read ahead in one batch, load_page takes them instead of reading file */
+    async_page_reader _reader;
+    std::unordered_map<size_t, std::vector<char>> _prefetched;
+
+    /* Pages written to file, batch read while some page was written may hold its old bytes and is dropped */
+    uint64_t _written_pages;
+
+    /*
+     * Operations since last checkpoint. While log is open pool does not steal, so file changes only on checkpoint
+     * and always holds tree as of some checkpoint, which recovery replays operations against
+     */
+    write_ahead_log _log;
+    wal_options _wal;
+    uint64_t _log_generation;
+    size_t _uncommitted_operations;
+    bool _replaying;
+
+    /*
+     * Hashes of keys. Filter is saved to <file_path>.bloom before header on flush, and header holds stamp of filter
+     * file, so filter left by other flush is rebuilt from tree on open instead of being trusted
+     */
+    bloom_options _bloom;
+    bloom_filter _filter;
+    uint64_t _filter_stamp;
+    bool _filter_dirty;
+
+    /* Pages encoded by checkpoint, they are logged before being written in place */
+    bool _staging;
+    std::vector<size_t> _staged_ids;
+    std::vector<char> _staged_pages;
+
+    /*
+     * Snapshot sees tree as of its epoch. Node changed or freed while some snapshot may still read it is first copied
+     * to <file_path>.versions, and snapshot reads the copy made after its epoch instead of the page. Version file is
+     * not part of tree, it is dropped with last snapshot
+     */
+    struct page_version {
+        uint64_t saved_at;
+        size_t page;
+        std::vector<size_t> chain;
+    };
+
+    page_file _versions;
+    std::vector<size_t> _free_versions;
+    size_t _version_count;
+    std::unordered_map<size_t, std::vector<page_version>> _page_versions;
+
+    /* Epoch of last change of page. Page missing here or changed before newest snapshot may be seen by snapshots */
+    std::unordered_map<size_t, uint64_t> _changed_at;
+    std::multiset<uint64_t> _snapshots;
+    uint64_t _epoch;
+
+    enum class log_record : uint8_t {
+        insert = 1,
+        update = 2,
+        erase = 3,
+        page_image = 4,
+        checkpoint_end = 5
+    };
 
-    std::fstream _file_for_key_value;
+    friend class buffer_pool<btree_disk_node>;
 
     //    btree_disk_node _root;
 
@@ -234,26 +379,42 @@ private:
 
 
 public:
-    size_t _count_of_node; //только растет
+    size_t _count_of_node; // страниц в файле, освобожденные переиспользуются из _free_pages
 
     // region constructors declaration
 
-    explicit B_tree_disk(const std::string &file_path, const compare &cmp = compare(), void *logger = nullptr);
+    static constexpr const size_t default_cache_pages = 256;
+    static constexpr const size_t default_page_size = 4096;
+    static constexpr const size_t minimum_page_size = 512;
+
+    /*
+     * Page size is taken from file when it exists already. Operations logged to <file_path>.wal before crash
+     * are replayed on open
+     */
+    explicit B_tree_disk(const std::string &file_path, const compare &cmp = compare(), void *logger = nullptr,
+                         size_t cache_pages = default_cache_pages, size_t page_size = default_page_size,
+                         const wal_options &wal = wal_options(), const bloom_options &bloom = bloom_options());
 
 
     // endregion constructors declaration
 
     // region five declaration
 
-    B_tree_disk(B_tree_disk &&other) noexcept = default;
+    /*
+     * Moved-from tree gets latches of its own and a closed file, so it can still be destroyed
+     */
+    B_tree_disk(B_tree_disk &&other) noexcept;
 
-    B_tree_disk &operator=(B_tree_disk &&other) noexcept = default;
+    B_tree_disk &operator=(B_tree_disk &&other) noexcept;
 
     B_tree_disk(const B_tree_disk &other) = delete;
 
     B_tree_disk &operator=(const B_tree_disk &other) = delete;
 
-    ~B_tree_disk() noexcept = default;
+    /*
+     * Writes back cached nodes
+     */
+    ~B_tree_disk() noexcept;
 
     // endregion five declaration
 
@@ -296,8 +457,57 @@ public:
 
     friend class btree_disk_const_iterator;
 
+    /**
+     * Read-only view of tree as it was when snapshot was taken. Writers go on meanwhile, nodes they change are copied
+     * aside while snapshot may read them and reclaimed when no snapshot needs them. Reads may run in many threads,
+     * each page is read under shared latch of tree, so writers wait for one page read at most
+     */
+    class btree_disk_snapshot {
+        B_tree_disk<tkey, tvalue, compare, t> *_tree;
+        uint64_t _epoch;
+        size_t _root;
+
+        friend class B_tree_disk;
+
+        btree_disk_snapshot(B_tree_disk<tkey, tvalue, compare, t> *tree, uint64_t epoch, size_t root) noexcept;
+
+    public:
+        btree_disk_snapshot(btree_disk_snapshot &&other) noexcept;
+
+        btree_disk_snapshot &operator=(btree_disk_snapshot &&other) noexcept;
+
+        btree_disk_snapshot(const btree_disk_snapshot &other) = delete;
+
+        btree_disk_snapshot &operator=(const btree_disk_snapshot &other) = delete;
+
+        ~btree_disk_snapshot() noexcept;
+
+        std::optional<tvalue> at(const tkey &key) const;
+
+        /*
+         * Calls visit for every pair in order of keys
+         */
+        template<std::invocable<const std::pair<tkey, tvalue> &> F>
+        void for_each(F &&visit) const;
+
+        size_t root() const noexcept;
+    };
+
+    friend class btree_disk_snapshot;
+
+    /*
+     * Tree must outlive its snapshots, and can not be moved or compacted while they are open
+     */
+    btree_disk_snapshot snapshot();
+
     std::optional<tvalue> at(const tkey &); //либо пустое, либо tvalue//std::nullopt
 
+    /*
+     * Same as at for every key. Keys descend together level by level, and nodes missing from cache at each level
+     * are read in one asynchronous batch instead of one by one
+     */
+    void at_batch(std::span<const tkey> keys, std::span<std::optional<tvalue>> values);
+
     btree_disk_const_iterator begin();
 
     btree_disk_const_iterator end();
@@ -325,10 +535,50 @@ public:
 
     bool is_valid() const noexcept;
 
+    /*
+     * Checkpoint: writes dirty cached nodes in order of their positions, then header with root position.
+     * With log enabled pages are logged first and log is truncated after them
+     *
+     * at and at_batch may be called by many threads at once, also while one thread calls operations changing tree,
+     * which wait for readers in progress. Iterators, disk_read and disk_write are for single thread
+     */
+    void flush();
+
+    /*
+     * Makes logged operations durable with one fsync, operations are committed in groups of wal_options::group_commit
+     * otherwise
+     */
+    void commit();
+
+    /*
+     * Rewrites tree densely into new file which replaces current one, free pages disappear and nodes go
+     * in depth-first order, so range scan reads file forward
+     */
+    void compact();
+
+    /*
+     * Builds tree at file_path from pairs in any order, tree which is there is replaced when new one is complete.
+     * Pairs are sorted externally: runs bounded by memory are sorted by several threads and merged, then nodes are
+     * written full in one pass over file. Of pairs with equal keys the first one is kept, as insert does.
+     * File must not be open by other B_tree_disk meanwhile
+     */
+    template<std::ranges::input_range R>
+    requires std::convertible_to<std::ranges::range_reference_t<R>, std::pair<tkey, tvalue>>
+    static void build(const std::string &file_path, R &&pairs, const build_options &options = build_options(),
+                      const compare &cmp = compare(), size_t page_size = default_page_size,
+                      const bloom_options &bloom = bloom_options());
+
+    size_t page_count() const noexcept;
+
+    size_t free_page_count() const noexcept;
+
 
     std::pair<std::stack<std::pair<size_t, size_t> >, std::pair<size_t, bool> > find_path(const tkey &key);
 
 public:
+    /*
+     * Both go through buffer pool
+     */
     btree_disk_node disk_read(size_t position);
 
 
@@ -344,6 +594,178 @@ public:
         print_node(os, _position_root, 0);
     }
 private:
+    static void check_page_size(size_t page_size);
+
+    void read_header();
+
+    /*
+     * Page goes to file, or to checkpoint being staged
+     */
+    void emit_page(size_t id, std::span<const char> page);
+
+    void flush_inner();
+
+    void commit_inner();
+
+    void checkpoint();
+
+    bool logging() const noexcept;
+
+    /*
+     * Hash of serialized key, so keys equal by compare have to be serialized equally for filter to work
+     */
+    uint64_t key_hash(const tkey &key);
+
+    bool may_contain(const tkey &key);
+
+    /*
+     * Filter sized twice as large as tree is built from all keys
+     */
+    void rebuild_filter();
+
+    void save_filter();
+
+    /* Temporary file of build: size and serialized pair for every pair, sorted by key without equal keys */
+    struct sorted_run {
+        std::string path;
+        size_t count;
+    };
+
+    struct run_cursor {
+        std::ifstream stream;
+        size_t left;
+        std::vector<char> record;
+        tree_data_type data;
+    };
+
+    static void write_record(std::ofstream &stream, std::span<const char> record);
+
+    /*
+     * Reads next pair of run into cursor, false at end of run
+     */
+    bool advance(run_cursor &cursor);
+
+    /*
+     * Runs are taken in order of input, so of equal keys the one from earlier run stays
+     */
+    sorted_run merge_runs(std::span<const sorted_run> runs, const std::string &path);
+
+    /*
+     * Keys in subtree of given height with all nodes full
+     */
+    static size_t subtree_capacity(size_t height) noexcept;
+
+    /*
+     * Writes subtree of count pairs taken from input, children before parent, returns page of its root
+     */
+    size_t build_subtree(run_cursor &input, size_t count, size_t height, bool is_root);
+
+    /*
+     * Replaces empty tree with one built from sorted run
+     */
+    void load_sorted(run_cursor &input, size_t count);
+
+    void log_operation(log_record kind, std::span<const char> payload);
+
+    void recover(std::vector<wal_record> records);
+
+    bool insert_inner(const tree_data_type &data);
+
+    bool update_inner(const tree_data_type &data);
+
+    bool erase_inner(const tkey &key);
+
+    /*
+     * Never opened, rebound to memory buffers to run serialize and deserialize of keys and values. One per thread,
+     * so that readers decode at once
+     */
+    static std::fstream &codec();
+
+    void serialize_key(const tkey &key, std::vector<char> &bytes);
+
+    tkey deserialize_key(std::span<char> bytes);
+
+    size_t allocate_page();
+
+    /*
+     * Page of node unlinked from tree, its overflow pages are freed too
+     */
+    void release_page(size_t id);
+
+    /*
+     * Copies node to version file before it is changed or freed, unless no snapshot may read it as it is now
+     */
+    void preserve_page(size_t id);
+
+    /*
+     * Node as snapshot of epoch sees it
+     */
+    btree_disk_node snapshot_read(size_t id, uint64_t epoch);
+
+    /*
+     * Versions no open snapshot reads are reclaimed
+     */
+    void release_snapshot(uint64_t epoch);
+
+    void write_free_list();
+
+    void read_free_list();
+
+    void serialize_pair(const tree_data_type &data, std::vector<char> &bytes);
+
+    tree_data_type deserialize_pair(std::span<char> bytes);
+
+    template<serializable T>
+    void encode(const T &value, std::vector<char> &bytes);
+
+    /*
+     * Reads value at offset and moves offset past it, false if bytes are damaged
+     */
+    template<serializable T>
+    bool decode(std::span<char> bytes, size_t &offset, T &value);
+
+    /*
+     * Cell of prefix_compressible key: suffix size, suffix of key bytes after prefix and serialized value
+     */
+    void serialize_suffix_pair(const tree_data_type &data, size_t prefix_size, std::vector<char> &bytes);
+
+    tree_data_type deserialize_suffix_pair(std::string_view prefix, std::span<char> bytes);
+
+    /*
+     * Node of packed_pairs type goes to packed page unless it does not fit
+     */
+    bool fits_packed(bool is_leaf) const noexcept;
+
+    /*
+     * Writes bytes to chain of pages taken from back of reusable first and appended to owned, returns first page of
+     * chain
+     */
+    size_t write_overflow(std::span<const char> bytes, std::vector<size_t> &reusable, std::vector<size_t> &owned);
+
+    void read_overflow(const page_file &file, size_t page_id, size_t length, std::vector<char> &bytes,
+                       std::vector<size_t> &owned);
+
+    /*
+     * Reads pages of nodes not in cache in one batch, they wait for load_page
+     */
+    void prefetch_pages(std::span<const size_t> ids);
+
+    btree_disk_node load_page(size_t position);
+
+    /*
+     * Node of page read from file, overflow chains are read from same file and listed in owned
+     */
+    btree_disk_node decode_page(const page_file &file, size_t position, std::span<char> bytes,
+                                std::vector<size_t> &owned);
+
+    void store_page(size_t position, const btree_disk_node &node);
+
+    /*
+     * Encodes node, overflow chains take pages from reusable first and are listed in owned
+     */
+    void write_node(size_t position, const btree_disk_node &node, std::vector<size_t> &reusable,
+                    std::vector<size_t> &owned);
+
     std::pair<size_t, bool> find_index(const tkey &key, btree_disk_node &node) const noexcept;
 
     void insert_array(btree_disk_node &node, size_t right_node, const tree_data_type &data, size_t index) noexcept;
@@ -354,7 +776,7 @@ private:
 
     void rebalance_node(std::stack<std::pair<size_t, size_t> > &path, btree_disk_node &node, size_t &index);
 
-    void print_root_position() noexcept;
+    void write_header();
 
     void print_node(std::ostream &os, std::size_t pos, int level) const {
         auto node = const_cast<B_tree_disk*>(this)->disk_read(pos);;
@@ -383,7 +805,7 @@ bool B_tree_disk<tkey, tvalue, compare, t>::is_valid() const noexcept {
 
 
 template<serializable tkey, serializable tvalue, compator<tkey> compare, std::size_t t>
-bool B_tree_disk<tkey, tvalue, compare, t>::erase(const tkey &key) {
+bool B_tree_disk<tkey, tvalue, compare, t>::erase_inner(const tkey &key) {
     // Проверка на пустое дерево
     if (_position_root == static_cast<size_t>(-1)) {
         return false;
@@ -413,11 +835,8 @@ bool B_tree_disk<tkey, tvalue, compare, t>::erase(const tkey &key) {
         // Проверяем необходимость ребалансировки
         if (current.size < minimum_keys_in_node && current_pos != _position_root) {
             rebalance_node(path, current, index);
-        } else if (current_pos == _position_root && current.size == 0) {
-            // Если удалили последний ключ из корня, дерево становится пустым
-            _position_root = static_cast<size_t>(-1);
-            print_root_position();
         }
+        // Опустевший корень-лист остается корнем, чтобы следующей вставке было куда вставлять
         return true;
     }
 
@@ -499,7 +918,16 @@ bool B_tree_disk<tkey, tvalue, compare, t>::erase(const tkey &key) {
 
     // Случай 2.3: Оба потомка имеют минимальное количество ключей
 
-    // Объединяем левого и правого потомков с ключом из текущего узла
+    // Объединяем левого и правого потомков с ключом из текущего узла.
+    // Ключ из листьев просто пропадает, а между внутренними узлами он нужен как разделитель их указателей
+    bool separator_moved = !left_child._is_leaf;
+
+    if (separator_moved) {
+        left_child.keys.push_back(current.keys[index]);
+        left_child.size++;
+    }
+
+    size_t first_pointer = left_child.size;
 
     // Добавляем все ключи из правого потомка в левый
     for (size_t i = 0; i < right_child.size; i++) {
@@ -507,10 +935,11 @@ bool B_tree_disk<tkey, tvalue, compare, t>::erase(const tkey &key) {
         left_child.size++;
     }
 
-    // Если не листовые узлы, переносим указатели
+    // Если не листовые узлы, переносим указатели сразу за указателями левого потомка
     if (!left_child._is_leaf) {
+        left_child.pointers.resize(std::max(left_child.pointers.size(), left_child.size + 1));
         for (size_t i = 0; i <= right_child.size; i++) {
-            left_child.pointers.push_back(right_child.pointers[i]);
+            left_child.pointers[first_pointer + i] = right_child.pointers[i];
         }
     }
 
@@ -523,91 +952,846 @@ bool B_tree_disk<tkey, tvalue, compare, t>::erase(const tkey &key) {
     current.size--;
     disk_write(current);
 
+    // Правый потомок влит в левого
+    release_page(right_child_pos);
+
     // Если корень стал пустым, обновляем корень
     if (current_pos == _position_root && current.size == 0) {
         _position_root = left_child_pos;
-        print_root_position();
+        release_page(current_pos);
     }
         // Если узел требует ребалансировки
     else if (current.size < minimum_keys_in_node && current_pos != _position_root) {
         rebalance_node(path, current, index);
     }
-    return true;
+
+    // Спустившийся разделитель удаляется уже из объединенного узла
+    return !separator_moved || erase_inner(key);
 }
 
 
 
 template<serializable tkey, serializable tvalue, compator<tkey> compare, std::size_t t>
-void B_tree_disk<tkey, tvalue, compare, t>::print_root_position() noexcept {
-    if (!_file_for_tree.is_open())
-        return;
+void B_tree_disk<tkey, tvalue, compare, t>::write_header() {
+    __detail::disk_file_header header{__detail::disk_file_header::expected_magic, _file.page_size(), _count_of_node,
+                                      _position_root, _log_generation, _free_list_head, _filter_stamp};
 
-
-    _file_for_tree.seekp(sizeof(size_t), std::ios::beg);
-    _file_for_tree.write(reinterpret_cast<const char *>(&_position_root), sizeof(size_t));
-    _file_for_tree.flush();
+    std::fill(_page_buffer.begin(), _page_buffer.end(), '\0');
+    __detail::store_at(_page_buffer.data(), 0, header);
+    emit_page(0, _page_buffer);
 }
 
 template<serializable tkey, serializable tvalue, compator<tkey> compare, std::size_t t>
-void B_tree_disk<tkey, tvalue, compare, t>::rebalance_node(
-        std::stack<std::pair<size_t, size_t>> &path,
-        btree_disk_node &node,
-        size_t &index) {
+void B_tree_disk<tkey, tvalue, compare, t>::read_header() {
+    // Заголовок лежит в начале страницы 0 при любом размере страницы
+    std::span<char> head(_page_buffer.data(), sizeof(__detail::disk_file_header));
+    _file.read_page(0, head);
 
-    // Если путь пуст или узел имеет достаточно ключей, выходим
-    if (path.empty() || node.size >= minimum_keys_in_node) {
+    auto header = __detail::load_at<__detail::disk_file_header>(head.data(), 0);
+
+    if (header.magic != __detail::disk_file_header::expected_magic)
+        throw std::runtime_error("file is not a B_tree_disk page file");
+
+    check_page_size(header.page_size);
+    _file.set_page_size(header.page_size);
+    _page_buffer.resize(header.page_size);
+
+    _count_of_node = header.page_count;
+    _position_root = header.root;
+    _log_generation = header.log_generation;
+    _free_list_head = header.free_list;
+    _filter_stamp = header.filter_stamp;
+
+    read_free_list();
+}
+
+template<serializable tkey, serializable tvalue, compator<tkey> compare, std::size_t t>
+void B_tree_disk<tkey, tvalue, compare, t>::flush() {
+    if (_latches == nullptr || !_file.is_open())
         return;
-    }
 
-    // Получаем родительский узел
-    size_t parent_pos = path.top().first;
-    size_t parent_idx = path.top().second;
-    path.pop();
+    std::unique_lock lock(_latches->tree);
+    flush_inner();
+}
 
-    btree_disk_node parent = disk_read(parent_pos);
+template<serializable tkey, serializable tvalue, compator<tkey> compare, std::size_t t>
+void B_tree_disk<tkey, tvalue, compare, t>::flush_inner() {
+    if (!_file.is_open())
+        return;
 
-    // Определяем позицию текущего узла среди потомков родителя
-    size_t node_idx = 0;
-    while (node_idx <= parent.size && parent.pointers[node_idx] != node.position_in_disk) {
-        node_idx++;
+    if (_log.is_open()) {
+        checkpoint();
+        return;
     }
 
-    // Стратегия 1: Попытаться заимствовать ключ у левого соседа
-    if (node_idx > 0) {
-        size_t left_sibling_pos = parent.pointers[node_idx - 1];
-        btree_disk_node left_sibling = disk_read(left_sibling_pos);
+    _pool.flush(*this);
+    write_free_list();
+    save_filter();
+    write_header();
+}
 
-        // Если у левого соседа есть запасной ключ
-        if (left_sibling.size > minimum_keys_in_node) {
-            // Сдвигаем все ключи в текущем узле вправо
-            node.keys.insert(node.keys.begin(), parent.keys[node_idx - 1]);
-            node.size++;
+template<serializable tkey, serializable tvalue, compator<tkey> compare, std::size_t t>
+void B_tree_disk<tkey, tvalue, compare, t>::commit() {
+    std::unique_lock lock(_latches->tree);
+    commit_inner();
+}
 
-            // Перемещаем последний ключ из левого соседа в родителя
-            parent.keys[node_idx - 1] = left_sibling.keys[left_sibling.size - 1];
+template<serializable tkey, serializable tvalue, compator<tkey> compare, std::size_t t>
+void B_tree_disk<tkey, tvalue, compare, t>::commit_inner() {
+    if (!_log.is_open())
+        return;
 
-            // Если не лист, перемещаем соответствующий указатель
-            if (!node._is_leaf) {
-                node.pointers.insert(node.pointers.begin(), left_sibling.pointers[left_sibling.size]);
-                left_sibling.pointers.pop_back();
-            }
+    _log.commit();
+    _uncommitted_operations = 0;
+}
 
-            // Удаляем последний ключ из левого соседа
-            left_sibling.keys.pop_back();
-            left_sibling.size--;
+template<serializable tkey, serializable tvalue, compator<tkey> compare, std::size_t t>
+void B_tree_disk<tkey, tvalue, compare, t>::emit_page(size_t id, std::span<const char> page) {
+    if (_staging) {
+        _staged_ids.push_back(id);
+        _staged_pages.insert(_staged_pages.end(), page.begin(), page.end());
+    } else if (_compact_target != nullptr) {
+        _compact_target->write_page(id, page);
+    } else {
+        _file.write_page(id, page);
 
-            // Записываем обновленные узлы
-            disk_write(left_sibling);
-            disk_write(parent);
-            disk_write(node);
-            return;
-        }
+        // Читатель мог вытеснить измененную страницу, пока другой читал ее заранее
+        std::lock_guard lock(_latches->prefetched);
+        _prefetched.erase(id);
+        ++_written_pages;
     }
+}
 
-    // Стратегия 2: Попытаться заимствовать ключ у правого соседа
-    if (node_idx < parent.size) {
-        size_t right_sibling_pos = parent.pointers[node_idx + 1];
-        btree_disk_node right_sibling = disk_read(right_sibling_pos);
+template<serializable tkey, serializable tvalue, compator<tkey> compare, std::size_t t>
+void B_tree_disk<tkey, tvalue, compare, t>::checkpoint() {
+    // Ничего не изменилось с прошлой контрольной точки
+    if (_log.size() == 0 && !_filter_dirty)
+        return;
+
+    const size_t page_size = _file.page_size();
+
+    _staged_ids.clear();
+    _staged_pages.clear();
+    _staging = true;
+
+    try {
+        _pool.flush(*this);
+        write_free_list();
+        save_filter();
+        ++_log_generation;
+        write_header();
+    } catch (...) {
+        _staging = false;
+        throw;
+    }
+
+    _staging = false;
+
+    // Образы страниц попадают в журнал раньше, чем в файл, поэтому оборванная запись на месте повторяется при открытии
+    for (size_t i = 0; i < _staged_ids.size(); ++i) {
+        _cell_buffer.resize(sizeof(uint64_t) + page_size);
+        __detail::store_at(_cell_buffer.data(), 0, static_cast<uint64_t>(_staged_ids[i]));
+        std::memcpy(_cell_buffer.data() + sizeof(uint64_t), _staged_pages.data() + i * page_size, page_size);
+        _log.append(static_cast<uint8_t>(log_record::page_image), _cell_buffer);
+    }
+
+    _log.append(static_cast<uint8_t>(log_record::checkpoint_end), {});
+    _log.commit();
+
+    for (size_t i = 0; i < _staged_ids.size(); ++i)
+        _file.write_page(_staged_ids[i], std::span<const char>(_staged_pages.data() + i * page_size, page_size));
+
+    _file.sync();
+    _log.restart(_log_generation);
+    _uncommitted_operations = 0;
+
+    _staged_ids.clear();
+    _staged_pages.clear();
+    _pool.trim();
+}
+
+template<serializable tkey, serializable tvalue, compator<tkey> compare, std::size_t t>
+void B_tree_disk<tkey, tvalue, compare, t>::compact() {
+    std::unique_lock lock(_latches->tree);
+
+    // Снимки держат номера страниц, которые compact меняет
+    if (!_snapshots.empty())
+        throw std::logic_error("tree can not be compacted while snapshots are open");
+
+    flush_inner();
+
+    // Новые номера в порядке обхода в глубину: поддерево лежит одним отрезком файла, листья идут по порядку ключей
+    std::vector<size_t> order;
+    std::unordered_map<size_t, size_t> renumbered;
+    std::vector<size_t> pending{_position_root};
+
+    while (!pending.empty()) {
+        size_t id = pending.back();
+        pending.pop_back();
+
+        renumbered.emplace(id, order.size() + 1);
+        order.push_back(id);
+
+        auto node = _pool.pin(*this, id);
+
+        if (!node->_is_leaf) {
+            for (size_t i = node->size + 1; i-- > 0;)
+                pending.push_back(node->pointers[i]);
+        }
+    }
+
+    const std::string tree_file = _file_path + ".tree";
+    const std::string compact_file = tree_file + ".compact";
+
+    auto saved_count = _count_of_node;
+    auto saved_root = _position_root;
+    auto saved_free_pages = _free_pages;
+    auto saved_free_list_head = _free_list_head;
+    auto saved_chains = _overflow_chains;
+
+    page_file compacted(compact_file, _file.page_size());
+    std::unordered_map<size_t, std::vector<size_t>> chains;
+
+    _count_of_node = order.size() + 1;
+    _free_pages.clear();
+    _free_list_head = 0;
+    _compact_target = &compacted;
+
+    try {
+        compacted.truncate(0);
+
+        for (size_t i = 0; i < order.size(); ++i) {
+            btree_disk_node node = *_pool.pin(*this, order[i]);
+
+            if (!node._is_leaf) {
+                for (size_t j = 0; j <= node.size; ++j)
+                    node.pointers[j] = renumbered.at(node.pointers[j]);
+            }
+
+            // Цепочки переполнения пишутся заново за страницами узлов
+            std::vector<size_t> reusable;
+            std::vector<size_t> owned;
+            write_node(i + 1, node, reusable, owned);
+
+            if (!owned.empty())
+                chains.emplace(i + 1, std::move(owned));
+        }
+
+        // Фильтр строится обходом старого файла, пока корень еще под старым номером
+        rebuild_filter();
+        save_filter();
+
+        _position_root = 1;
+        write_header();
+        compacted.sync();
+        compacted.close();
+
+        // Старый файл закрывается до замены, иначе на некоторых системах его нельзя заменить
+        _file.close();
+        std::filesystem::rename(compact_file, tree_file);
+    } catch (...) {
+        _compact_target = nullptr;
+        _count_of_node = saved_count;
+        _position_root = saved_root;
+        _free_pages = std::move(saved_free_pages);
+        _free_list_head = saved_free_list_head;
+        _overflow_chains = std::move(saved_chains);
+
+        compacted.close();
+        std::filesystem::remove(compact_file);
+
+        if (!_file.is_open()) {
+            _file = page_file(tree_file, compacted.page_size());
+            _pool.clear();
+        }
+        throw;
+    }
+
+    _compact_target = nullptr;
+    _overflow_chains = std::move(chains);
+    _pool.clear();
+    _prefetched.clear();
+    _file = page_file(tree_file, compacted.page_size());
+    _current_node = disk_read(_position_root);
+}
+
+template<serializable tkey, serializable tvalue, compator<tkey> compare, std::size_t t>
+template<std::ranges::input_range R>
+requires std::convertible_to<std::ranges::range_reference_t<R>, std::pair<tkey, tvalue>>
+void B_tree_disk<tkey, tvalue, compare, t>::build(const std::string &file_path, R &&pairs,
+                                                  const build_options &options, const compare &cmp, size_t page_size,
+                                                  const bloom_options &bloom) {
+    if (options.merge_fan_in < 2)
+        throw std::invalid_argument("at least two runs have to be merged at once");
+
+    const size_t threads = options.threads != 0 ? options.threads
+                                                : std::max<size_t>(std::thread::hardware_concurrency(), 1);
+
+    // Память делится между сортируемыми прогонами и тем, который еще читается
+    const size_t run_budget = std::max<size_t>(options.memory_bytes / (threads + 1), 1);
+
+    // Дерево строится рядом под другим именем, старое остается целым до переименования
+    const std::string temporary = file_path + ".build";
+    std::filesystem::remove(temporary + ".tree");
+    std::filesystem::remove(temporary + ".bloom");
+
+    std::vector<sorted_run> runs;
+    size_t next_run = 0;
+
+    auto run_path = [&] { return temporary + ".run" + std::to_string(next_run++); };
+
+    auto remove_runs = [&] {
+        for (auto &run: runs)
+            std::filesystem::remove(run.path);
+        runs.clear();
+    };
+
+    try {
+        {
+            B_tree_disk tree(temporary, cmp, nullptr, default_cache_pages, page_size, wal_options{.enabled = false},
+                             bloom);
+
+            struct unsorted_run {
+                std::vector<tree_data_type> pairs;
+                std::vector<char> bytes;
+                std::vector<size_t> ends;
+            };
+
+            // Прогон сортируется и пишется потоком, пока следующий читается из входа
+            auto sort_run = [&tree](unsorted_run run, std::string path) {
+                std::vector<size_t> order(run.pairs.size());
+                std::iota(order.begin(), order.end(), size_t(0));
+                std::stable_sort(order.begin(), order.end(), [&](size_t lhs, size_t rhs) {
+                    return tree.compare_keys(run.pairs[lhs].first, run.pairs[rhs].first);
+                });
+
+                std::ofstream stream(path, std::ios::binary | std::ios::trunc);
+                size_t count = 0;
+
+                for (size_t i = 0; i < order.size(); ++i) {
+                    size_t index = order[i];
+
+                    // Устойчивая сортировка оставляет первой пару, встретившуюся раньше
+                    if (i != 0 && !tree.compare_keys(run.pairs[order[i - 1]].first, run.pairs[index].first))
+                        continue;
+
+                    size_t begin = index == 0 ? 0 : run.ends[index - 1];
+                    write_record(stream, std::span<const char>(run.bytes).subspan(begin, run.ends[index] - begin));
+                    ++count;
+                }
+
+                stream.flush();
+
+                if (!stream)
+                    throw std::runtime_error("cannot write sorted run " + path);
+                return sorted_run{std::move(path), count};
+            };
+
+            std::deque<std::future<sorted_run>> sorting;
+            unsorted_run current;
+            size_t used = 0;
+
+            auto start_run = [&] {
+                if (sorting.size() >= threads) {
+                    runs.push_back(sorting.front().get());
+                    sorting.pop_front();
+                }
+
+                sorting.push_back(std::async(std::launch::async, sort_run, std::move(current), run_path()));
+                current = unsorted_run();
+                used = 0;
+            };
+
+            try {
+                for (auto &&data: pairs) {
+                    current.pairs.emplace_back(std::forward<decltype(data)>(data));
+
+                    size_t before = current.bytes.size();
+                    tree.serialize_pair(current.pairs.back(), current.bytes);
+                    current.ends.push_back(current.bytes.size());
+
+                    // Пара в памяти занимает примерно столько же, сколько ее сериализованная форма
+                    used += sizeof(tree_data_type) + 2 * sizeof(size_t) + 2 * (current.bytes.size() - before);
+
+                    if (used >= run_budget)
+                        start_run();
+                }
+
+                if (!current.pairs.empty())
+                    start_run();
+
+                while (!sorting.empty()) {
+                    runs.push_back(sorting.front().get());
+                    sorting.pop_front();
+                }
+            } catch (...) {
+                // Потоки дописывают свои прогоны, их файлы тоже удаляются
+                for (auto &future: sorting) {
+                    try {
+                        runs.push_back(future.get());
+                    } catch (...) {
+                    }
+                }
+                throw;
+            }
+
+            // Проходы слияния, пока не останется один прогон, число пар в нем нужно для формы дерева
+            while (runs.size() > 1) {
+                std::vector<sorted_run> merged;
+
+                try {
+                    for (size_t first = 0; first < runs.size(); first += options.merge_fan_in) {
+                        size_t last = std::min(runs.size(), first + options.merge_fan_in);
+                        auto group = std::span<const sorted_run>(runs).subspan(first, last - first);
+
+                        if (group.size() == 1) {
+                            merged.push_back(group.front());
+                            continue;
+                        }
+
+                        merged.push_back({run_path(), 0});
+                        merged.back() = tree.merge_runs(group, merged.back().path);
+
+                        for (auto &run: group)
+                            std::filesystem::remove(run.path);
+                    }
+                } catch (...) {
+                    for (auto &run: merged)
+                        std::filesystem::remove(run.path);
+                    throw;
+                }
+
+                runs = std::move(merged);
+            }
+
+            run_cursor input;
+            input.left = 0;
+
+            if (!runs.empty()) {
+                input.stream.open(runs.front().path, std::ios::binary);
+                input.left = runs.front().count;
+            }
+
+            tree.load_sorted(input, input.left);
+        }
+
+        remove_runs();
+
+        // Журнал старого дерева нельзя воспроизводить поверх нового
+        std::filesystem::remove(file_path + ".wal");
+
+        if (std::filesystem::exists(temporary + ".bloom"))
+            std::filesystem::rename(temporary + ".bloom", file_path + ".bloom");
+        else
+            std::filesystem::remove(file_path + ".bloom");
+
+        std::filesystem::rename(temporary + ".tree", file_path + ".tree");
+    } catch (...) {
+        remove_runs();
+        std::filesystem::remove(temporary + ".tree");
+        std::filesystem::remove(temporary + ".bloom");
+        throw;
+    }
+}
+
+template<serializable tkey, serializable tvalue, compator<tkey> compare, std::size_t t>
+void B_tree_disk<tkey, tvalue, compare, t>::write_record(std::ofstream &stream, std::span<const char> record) {
+    char size[sizeof(uint32_t)];
+    __detail::store_at(size, 0, static_cast<uint32_t>(record.size()));
+
+    stream.write(size, sizeof(size));
+    stream.write(record.data(), static_cast<std::streamsize>(record.size()));
+}
+
+template<serializable tkey, serializable tvalue, compator<tkey> compare, std::size_t t>
+bool B_tree_disk<tkey, tvalue, compare, t>::advance(run_cursor &cursor) {
+    if (cursor.left == 0)
+        return false;
+
+    char size[sizeof(uint32_t)];
+    cursor.stream.read(size, sizeof(size));
+    cursor.record.resize(cursor.stream ? __detail::load_at<uint32_t>(size, 0) : 0);
+    cursor.stream.read(cursor.record.data(), static_cast<std::streamsize>(cursor.record.size()));
+
+    if (!cursor.stream)
+        throw std::runtime_error("sorted run is shorter than its count");
+
+    cursor.data = deserialize_pair(cursor.record);
+    --cursor.left;
+    return true;
+}
+
+template<serializable tkey, serializable tvalue, compator<tkey> compare, std::size_t t>
+typename B_tree_disk<tkey, tvalue, compare, t>::sorted_run
+B_tree_disk<tkey, tvalue, compare, t>::merge_runs(std::span<const sorted_run> runs, const std::string &path) {
+    std::vector<run_cursor> cursors(runs.size());
+    std::vector<size_t> heap;
+
+    for (size_t i = 0; i < runs.size(); ++i) {
+        cursors[i].stream.open(runs[i].path, std::ios::binary);
+        cursors[i].left = runs[i].count;
+
+        if (advance(cursors[i]))
+            heap.push_back(i);
+    }
+
+    // Вершина кучи - наименьший ключ, из равных - ключ более раннего прогона
+    auto later = [&](size_t lhs, size_t rhs) {
+        if (compare_keys(cursors[rhs].data.first, cursors[lhs].data.first))
+            return true;
+        return !compare_keys(cursors[lhs].data.first, cursors[rhs].data.first) && lhs > rhs;
+    };
+
+    std::make_heap(heap.begin(), heap.end(), later);
+
+    std::ofstream stream(path, std::ios::binary | std::ios::trunc);
+    std::optional<tkey> last;
+    size_t count = 0;
+
+    while (!heap.empty()) {
+        std::pop_heap(heap.begin(), heap.end(), later);
+        run_cursor &cursor = cursors[heap.back()];
+
+        if (!last || compare_keys(*last, cursor.data.first)) {
+            write_record(stream, cursor.record);
+            last = cursor.data.first;
+            ++count;
+        }
+
+        if (advance(cursor))
+            std::push_heap(heap.begin(), heap.end(), later);
+        else
+            heap.pop_back();
+    }
+
+    stream.flush();
+
+    if (!stream)
+        throw std::runtime_error("cannot write sorted run " + path);
+    return {path, count};
+}
+
+template<serializable tkey, serializable tvalue, compator<tkey> compare, std::size_t t>
+size_t B_tree_disk<tkey, tvalue, compare, t>::subtree_capacity(size_t height) noexcept {
+    size_t capacity = maximum_keys_in_node;
+
+    for (size_t i = 0; i < height; ++i) {
+        if (capacity > (std::numeric_limits<size_t>::max() - maximum_keys_in_node) / (maximum_keys_in_node + 1))
+            return std::numeric_limits<size_t>::max();
+        capacity = capacity * (maximum_keys_in_node + 1) + maximum_keys_in_node;
+    }
+
+    return capacity;
+}
+
+template<serializable tkey, serializable tvalue, compator<tkey> compare, std::size_t t>
+size_t B_tree_disk<tkey, tvalue, compare, t>::build_subtree(run_cursor &input, size_t count, size_t height,
+                                                            bool is_root) {
+    btree_disk_node node(height == 0);
+
+    auto take = [&] {
+        if (!advance(input))
+            throw std::runtime_error("sorted run is shorter than its count");
+
+        if (_bloom.enabled)
+            _filter.add(key_hash(input.data.first));
+        node.keys.push_back(std::move(input.data));
+    };
+
+    if (height == 0) {
+        for (size_t i = 0; i < count; ++i)
+            take();
+    } else {
+        // Детей столько, чтобы каждый был заполнен почти целиком. Поддерево из count ключей не меньше
+        // минимального, поэтому и дети получаются не меньше минимальных
+        const size_t below = subtree_capacity(height - 1);
+        const size_t children = std::max<size_t>((count + below + 1) / (below + 1), is_root ? 2 : t);
+        const size_t spread = count - (children - 1);
+
+        for (size_t i = 0; i < children; ++i) {
+            size_t child_count = spread / children + (i < spread % children ? 1 : 0);
+            node.pointers[i] = build_subtree(input, child_count, height - 1, false);
+
+            if (i + 1 < children)
+                take();
+        }
+    }
+
+    node.size = node.keys.size();
+    node.position_in_disk = allocate_page();
+
+    std::vector<size_t> reusable;
+    std::vector<size_t> owned;
+    write_node(node.position_in_disk, node, reusable, owned);
+
+    if (!owned.empty())
+        _overflow_chains.emplace(node.position_in_disk, std::move(owned));
+    return node.position_in_disk;
+}
+
+template<serializable tkey, serializable tvalue, compator<tkey> compare, std::size_t t>
+void B_tree_disk<tkey, tvalue, compare, t>::load_sorted(run_cursor &input, size_t count) {
+    // Пустой корень нового файла занимает страницу 1, она достается первому листу
+    _pool.discard(_position_root);
+    _count_of_node = 1;
+
+    if (_bloom.enabled)
+        _filter = bloom_filter(std::max<size_t>(2 * count, 1024), _bloom.bits_per_key);
+
+    size_t height = 0;
+    while (subtree_capacity(height) < count)
+        ++height;
+
+    // Узлы пишутся в обратном порядке обхода: дети раньше родителя, страницы файла идут подряд
+    _position_root = build_subtree(input, count, height, true);
+    _filter_dirty = true;
+
+    flush_inner();
+    _current_node = disk_read(_position_root);
+}
+
+template<serializable tkey, serializable tvalue, compator<tkey> compare, std::size_t t>
+bool B_tree_disk<tkey, tvalue, compare, t>::logging() const noexcept {
+    return _log.is_open() && !_replaying;
+}
+
+template<serializable tkey, serializable tvalue, compator<tkey> compare, std::size_t t>
+uint64_t B_tree_disk<tkey, tvalue, compare, t>::key_hash(const tkey &key) {
+    thread_local std::vector<char> bytes;
+
+    bytes.clear();
+    encode(key, bytes);
+    return bloom_filter::hash(bytes);
+}
+
+template<serializable tkey, serializable tvalue, compator<tkey> compare, std::size_t t>
+bool B_tree_disk<tkey, tvalue, compare, t>::may_contain(const tkey &key) {
+    return !_bloom.enabled || _filter.may_contain(key_hash(key));
+}
+
+template<serializable tkey, serializable tvalue, compator<tkey> compare, std::size_t t>
+void B_tree_disk<tkey, tvalue, compare, t>::rebuild_filter() {
+    std::vector<uint64_t> hashes;
+    std::vector<size_t> pending{_position_root};
+
+    while (!pending.empty()) {
+        auto node = _pool.pin(*this, pending.back());
+        pending.pop_back();
+
+        for (auto &data: node->keys)
+            hashes.push_back(key_hash(data.first));
+
+        if (!node->_is_leaf) {
+            for (size_t i = 0; i <= node->size; ++i)
+                pending.push_back(node->pointers[i]);
+        }
+    }
+
+    // Запас вдвое, чтобы дерево успело вырасти до следующей перестройки
+    _filter = bloom_filter(std::max<size_t>(2 * hashes.size(), 1024), _bloom.bits_per_key);
+
+    for (uint64_t hash: hashes)
+        _filter.add(hash);
+
+    _filter_dirty = true;
+}
+
+template<serializable tkey, serializable tvalue, compator<tkey> compare, std::size_t t>
+void B_tree_disk<tkey, tvalue, compare, t>::save_filter() {
+    // Без фильтра заголовок не ссылается ни на какой файл, иначе старый фильтр считался бы верным после изменений
+    if (!_bloom.enabled) {
+        _filter_stamp = 0;
+        return;
+    }
+
+    if (!_filter_dirty)
+        return;
+
+    _filter.save(_file_path + ".bloom", _file.page_size(), ++_filter_stamp);
+    _filter_dirty = false;
+}
+
+template<serializable tkey, serializable tvalue, compator<tkey> compare, std::size_t t>
+void B_tree_disk<tkey, tvalue, compare, t>::log_operation(log_record kind, std::span<const char> payload) {
+    _log.append(static_cast<uint8_t>(kind), payload);
+
+    if (++_uncommitted_operations >= _wal.group_commit)
+        commit_inner();
+
+    // Пул вырос, значит в нем не осталось чистых страниц для вытеснения
+    if (_pool.size() > _pool.capacity() || _log.size() >= _wal.checkpoint_bytes)
+        checkpoint();
+}
+
+template<serializable tkey, serializable tvalue, compator<tkey> compare, std::size_t t>
+void B_tree_disk<tkey, tvalue, compare, t>::recover(std::vector<wal_record> records) {
+    auto end = std::find_if(records.begin(), records.end(), [](const wal_record &record) {
+        return record.kind == static_cast<uint8_t>(log_record::checkpoint_end);
+    });
+
+    // Завершенная контрольная точка уже содержит все операции до нее, остается дописать ее страницы на место
+    if (end != records.end()) {
+        for (auto it = records.begin(); it != end; ++it) {
+            if (it->kind != static_cast<uint8_t>(log_record::page_image))
+                continue;
+
+            auto id = __detail::load_at<uint64_t>(it->payload.data(), 0);
+            _file.write_page(id, std::span<const char>(it->payload).subspan(sizeof(uint64_t)));
+        }
+
+        _file.sync();
+        read_header();
+        _log.restart(_log_generation);
+        return;
+    }
+
+    _replaying = true;
+
+    try {
+        for (auto &record: records) {
+            switch (static_cast<log_record>(record.kind)) {
+                case log_record::insert:
+                    insert_inner(deserialize_pair(record.payload));
+                    break;
+                case log_record::update:
+                    update_inner(deserialize_pair(record.payload));
+                    break;
+                case log_record::erase:
+                    erase_inner(deserialize_key(record.payload));
+                    break;
+                default:
+                    // Образы страниц контрольной точки, которая не успела завершиться
+                    break;
+            }
+        }
+    } catch (...) {
+        _replaying = false;
+        throw;
+    }
+
+    _replaying = false;
+
+    // Журнал обрезается только после того, как воспроизведенные операции записаны контрольной точкой
+    checkpoint();
+}
+
+template<serializable tkey, serializable tvalue, compator<tkey> compare, std::size_t t>
+bool B_tree_disk<tkey, tvalue, compare, t>::insert(const tree_data_type &data) {
+    std::unique_lock lock(_latches->tree);
+
+    if (!insert_inner(data))
+        return false;
+
+    if (logging()) {
+        _cell_buffer.clear();
+        serialize_pair(data, _cell_buffer);
+        log_operation(log_record::insert, _cell_buffer);
+    }
+
+    // Переполненный фильтр пропускал бы почти все отсутствующие ключи
+    if (_bloom.enabled && _filter.added() > _filter.capacity())
+        rebuild_filter();
+    return true;
+}
+
+template<serializable tkey, serializable tvalue, compator<tkey> compare, std::size_t t>
+bool B_tree_disk<tkey, tvalue, compare, t>::update(const tree_data_type &data) {
+    std::unique_lock lock(_latches->tree);
+
+    if (!update_inner(data))
+        return false;
+
+    if (logging()) {
+        _cell_buffer.clear();
+        serialize_pair(data, _cell_buffer);
+        log_operation(log_record::update, _cell_buffer);
+    }
+    return true;
+}
+
+template<serializable tkey, serializable tvalue, compator<tkey> compare, std::size_t t>
+bool B_tree_disk<tkey, tvalue, compare, t>::erase(const tkey &key) {
+    std::unique_lock lock(_latches->tree);
+
+    if (!erase_inner(key))
+        return false;
+
+    if (logging()) {
+        _cell_buffer.clear();
+        serialize_key(key, _cell_buffer);
+        log_operation(log_record::erase, _cell_buffer);
+    }
+    return true;
+}
+
+template<serializable tkey, serializable tvalue, compator<tkey> compare, std::size_t t>
+void B_tree_disk<tkey, tvalue, compare, t>::rebalance_node(
+        std::stack<std::pair<size_t, size_t>> &path,
+        btree_disk_node &node,
+        size_t &index) {
+
+    // Если путь пуст или узел имеет достаточно ключей, выходим
+    if (path.empty() || node.size >= minimum_keys_in_node) {
+        return;
+    }
+
+    // Получаем родительский узел
+    size_t parent_pos = path.top().first;
+    size_t parent_idx = path.top().second;
+    path.pop();
+
+    btree_disk_node parent = disk_read(parent_pos);
+
+    // Определяем позицию текущего узла среди потомков родителя
+    size_t node_idx = 0;
+    while (node_idx <= parent.size && parent.pointers[node_idx] != node.position_in_disk) {
+        node_idx++;
+    }
+
+    // Оба соседа могут понадобиться, читаем их одним пакетом
+    std::vector<size_t> siblings;
+    if (node_idx > 0)
+        siblings.push_back(parent.pointers[node_idx - 1]);
+    if (node_idx < parent.size)
+        siblings.push_back(parent.pointers[node_idx + 1]);
+    prefetch_pages(siblings);
+
+    // Стратегия 1: Попытаться заимствовать ключ у левого соседа
+    if (node_idx > 0) {
+        size_t left_sibling_pos = parent.pointers[node_idx - 1];
+        btree_disk_node left_sibling = disk_read(left_sibling_pos);
+
+        // Если у левого соседа есть запасной ключ
+        if (left_sibling.size > minimum_keys_in_node) {
+            // Сдвигаем все ключи в текущем узле вправо
+            node.keys.insert(node.keys.begin(), parent.keys[node_idx - 1]);
+            node.size++;
+
+            // Перемещаем последний ключ из левого соседа в родителя
+            parent.keys[node_idx - 1] = left_sibling.keys[left_sibling.size - 1];
+
+            // Если не лист, перемещаем соответствующий указатель
+            if (!node._is_leaf) {
+                node.pointers.insert(node.pointers.begin(), left_sibling.pointers[left_sibling.size]);
+                left_sibling.pointers.pop_back();
+            }
+
+            // Удаляем последний ключ из левого соседа
+            left_sibling.keys.pop_back();
+            left_sibling.size--;
+
+            // Записываем обновленные узлы
+            disk_write(left_sibling);
+            disk_write(parent);
+            disk_write(node);
+            return;
+        }
+    }
+
+    // Стратегия 2: Попытаться заимствовать ключ у правого соседа
+    if (node_idx < parent.size) {
+        size_t right_sibling_pos = parent.pointers[node_idx + 1];
+        btree_disk_node right_sibling = disk_read(right_sibling_pos);
 
         // Если у правого соседа есть запасной ключ
         if (right_sibling.size > minimum_keys_in_node) {
@@ -620,7 +1804,7 @@ void B_tree_disk<tkey, tvalue, compare, t>::rebalance_node(
 
             // Если не лист, перемещаем соответствующий указатель
             if (!node._is_leaf) {
-                node.pointers.push_back(right_sibling.pointers[0]);
+                node.pointers.insert(node.pointers.begin() + node.size, right_sibling.pointers[0]);
                 right_sibling.pointers.erase(right_sibling.pointers.begin());
             }
 
@@ -647,16 +1831,19 @@ void B_tree_disk<tkey, tvalue, compare, t>::rebalance_node(
         left_sibling.keys.push_back(parent.keys[node_idx - 1]);
         left_sibling.size++;
 
+        size_t first_pointer = left_sibling.size;
+
         // Добавляем все ключи из текущего узла в левого соседа
         for (size_t i = 0; i < node.size; i++) {
             left_sibling.keys.push_back(node.keys[i]);
             left_sibling.size++;
         }
 
-        // Если не листовые узлы, переносим указатели
+        // Если не листовые узлы, переносим указатели сразу за указателями соседа
         if (!node._is_leaf) {
+            left_sibling.pointers.resize(std::max(left_sibling.pointers.size(), left_sibling.size + 1));
             for (size_t i = 0; i <= node.size; i++) {
-                left_sibling.pointers.push_back(node.pointers[i]);
+                left_sibling.pointers[first_pointer + i] = node.pointers[i];
             }
         }
 
@@ -669,10 +1856,13 @@ void B_tree_disk<tkey, tvalue, compare, t>::rebalance_node(
         parent.size--;
         disk_write(parent);
 
+        // Текущий узел влит в левого соседа
+        release_page(node.position_in_disk);
+
         // Если родитель стал корнем с 0 ключей, обновляем корень
         if (parent_pos == _position_root && parent.size == 0) {
             _position_root = left_sibling_pos;
-            print_root_position();
+            release_page(parent_pos);
         }
             // Если родитель требует ребалансировки
         else if (parent.size < minimum_keys_in_node && parent_pos != _position_root) {
@@ -691,16 +1881,19 @@ void B_tree_disk<tkey, tvalue, compare, t>::rebalance_node(
         node.keys.push_back(parent.keys[node_idx]);
         node.size++;
 
+        size_t first_pointer = node.size;
+
         // Добавляем все ключи из правого соседа в текущий узел
         for (size_t i = 0; i < right_sibling.size; i++) {
             node.keys.push_back(right_sibling.keys[i]);
             node.size++;
         }
 
-        // Если не листовые узлы, переносим указатели
+        // Если не листовые узлы, переносим указатели сразу за указателями узла
         if (!node._is_leaf) {
+            node.pointers.resize(std::max(node.pointers.size(), node.size + 1));
             for (size_t i = 0; i <= right_sibling.size; i++) {
-                node.pointers.push_back(right_sibling.pointers[i]);
+                node.pointers[first_pointer + i] = right_sibling.pointers[i];
             }
         }
 
@@ -713,10 +1906,13 @@ void B_tree_disk<tkey, tvalue, compare, t>::rebalance_node(
         parent.size--;
         disk_write(parent);
 
+        // Правый сосед влит в текущий узел
+        release_page(right_sibling_pos);
+
         // Если родитель стал корнем с 0 ключей, обновляем корень
         if (parent_pos == _position_root && parent.size == 0) {
             _position_root = node.position_in_disk;
-            print_root_position();
+            release_page(parent_pos);
         }
             // Если родитель требует ребалансировки
         else if (parent.size < minimum_keys_in_node && parent_pos != _position_root) {
@@ -760,7 +1956,7 @@ B_tree_disk<tkey, tvalue, compare, t>::remove_array(
 
 
 template<serializable tkey, serializable tvalue, compator<tkey> compare, std::size_t t>
-bool B_tree_disk<tkey, tvalue, compare, t>::update(const tree_data_type &data) {
+bool B_tree_disk<tkey, tvalue, compare, t>::update_inner(const tree_data_type &data) {
     auto [path, result] = find_path(data.first);
     auto [index, found] = result;
 
@@ -777,7 +1973,7 @@ bool B_tree_disk<tkey, tvalue, compare, t>::update(const tree_data_type &data) {
 
 
 template<serializable tkey, serializable tvalue, compator<tkey> compare, std::size_t t>
-bool B_tree_disk<tkey, tvalue, compare, t>::insert(const B_tree_disk::tree_data_type &data) {
+bool B_tree_disk<tkey, tvalue, compare, t>::insert_inner(const tree_data_type &data) {
     // 1) Находим путь до листа и позицию вставки
     auto [path, result] = find_path(data.first);
     auto [index, found] = result;
@@ -814,6 +2010,12 @@ bool B_tree_disk<tkey, tvalue, compare, t>::insert(const B_tree_disk::tree_data_
         split_node(path);
     }
 
+    // Фильтр без блоков будет перестроен целиком
+    if (_bloom.enabled && _filter.capacity() != 0) {
+        _filter.add(key_hash(data.first));
+        _filter_dirty = true;
+    }
+
     return true;
 }
 
@@ -829,244 +2031,852 @@ void B_tree_disk<tkey, tvalue, compare, t>::split_node(
     path.pop();
     btree_disk_node current = disk_read(current_pos);
 
-    // защита от мусора
-    current.pointers.resize(maximum_keys_in_node + 2, 0);
+    // защита от мусора
+    current.pointers.resize(maximum_keys_in_node + 2, 0);
+
+    // 2. Правый узел
+    btree_disk_node right(current._is_leaf);
+    right.position_in_disk = allocate_page();
+    right.pointers.resize(maximum_keys_in_node + 2, 0);
+
+    // 3. Считаем середину ПО ВЕКТОРУ ключей
+    size_t mid = current.keys.size() / 2;
+    tree_data_type middle_key = current.keys[mid];
+
+    // 4. Переносим ключи > mid в правый узел
+    right.keys.assign(
+            current.keys.begin() + mid + 1,
+            current.keys.end()
+    );
+    current.keys.erase(
+            current.keys.begin() + mid,
+            current.keys.end()
+    );
+
+    // 5. Перенос указателей (если не лист)
+    if (!current._is_leaf) {
+        right.pointers.assign(
+                current.pointers.begin() + mid + 1,
+                current.pointers.end()
+        );
+        current.pointers.erase(
+                current.pointers.begin() + mid + 1,
+                current.pointers.end()
+        );
+        right.pointers.resize(maximum_keys_in_node + 2, 0);
+        current.pointers.resize(maximum_keys_in_node + 2, 0);
+    }
+
+    // 6. Обновляем размеры и пишем на диск
+    current.size = current.keys.size();
+    right.size   = right.keys.size();
+    disk_write(current);
+    disk_write(right);
+
+    // 7. Вставляем в родителя или создаём новый корень
+    if (path.empty()) {
+        btree_disk_node root(false);
+        root.position_in_disk = allocate_page();
+        root.keys.push_back(middle_key);
+        root.pointers[0] = current_pos;
+        root.pointers[1] = right.position_in_disk;
+        root.size = 1;
+        root.pointers.resize(maximum_keys_in_node + 2, 0);
+        _position_root = root.position_in_disk;
+        disk_write(root);
+        return;
+    }
+
+    auto [parent_pos, parent_idx] = path.top();
+    btree_disk_node parent = disk_read(parent_pos);
+    parent.keys.insert(parent.keys.begin() + parent_idx, middle_key);
+    parent.pointers.insert(
+            parent.pointers.begin() + parent_idx + 1,
+            right.position_in_disk
+    );
+    ++parent.size;
+    parent.pointers.resize(maximum_keys_in_node + 2, 0);
+    disk_write(parent);
+    if (parent.size > maximum_keys_in_node)
+        split_node(path);
+}
+
+
+template<serializable tkey, serializable tvalue, compator<tkey> compare, std::size_t t>
+void B_tree_disk<tkey, tvalue, compare, t>::insert_array(btree_disk_node &node, size_t right_node,
+                                                         const tree_data_type &data, size_t index) noexcept {
+    node.keys.insert(node.keys.begin() + index, data);
+    node.pointers.insert(node.pointers.begin() + index + 1, right_node);
+    node.size++;
+
+    disk_write(node);
+}
+
+
+template<serializable tkey, serializable tvalue, compator<tkey> compare, std::size_t t>
+std::pair<std::stack<std::pair<size_t, size_t> >, std::pair<size_t, bool> >
+B_tree_disk<tkey, tvalue, compare, t>::find_path(const tkey &key) {
+    std::stack<std::pair<size_t, size_t> > path;
+
+    if (_position_root == static_cast<size_t>(-1)) {
+        return {path, {0, false}};
+    }
+
+    size_t current_position = _position_root;
+
+    // Узлы читаются прямо из пула, без копирования
+    auto current_node = _pool.pin(*this, current_position);
+
+    while (true) {
+        auto [index, key_found] = find_index(key, *current_node);
+
+        if (key_found) {
+            path.push({current_position, index});
+            return {path, {index, true}};
+        }
+
+        path.push({current_position, index});
+
+        if (current_node->_is_leaf) {
+            return {path, {index, false}};
+        }
+        current_position = current_node->pointers[index];
+        current_node = _pool.pin(*this, current_position);
+    }
+}
+
+
+template<serializable tkey, serializable tvalue, compator<tkey> compare, std::size_t t>
+std::pair<size_t, bool> B_tree_disk<tkey, tvalue, compare, t>::find_index(
+        const tkey &key, btree_disk_node &node) const noexcept {
+    size_t i = 0;
+    // std::cout << "find_index: key=" << key.data << ", keys: ";
+    // for (auto &pair: node.keys) std::cout << pair.first.data << " ";
+    // std::cout << std::endl;
+
+    while (i < node.keys.size() && compare_keys(node.keys[i].first, key)) {
+        // std::cout << "compare_keys(" << node.keys[i].first.data << ", " << key.data << ") = "
+        // << compare_keys(node.keys[i].first, key) << std::endl;
+        ++i;
+    }
+
+    bool found = (i < node.keys.size() && !compare_keys(key, node.keys[i].first));
+    // std::cout << "index = " << i << ", found = " << found << std::endl;
+    return {i, found};
+}
+
+
+template<serializable tkey, serializable tvalue, compator<tkey> compare, std::size_t t>
+void B_tree_disk<tkey, tvalue, compare, t>::disk_write(btree_disk_node &node) {
+    preserve_page(node.position_in_disk);
+    _pool.put(*this, node.position_in_disk, node);
+}
+
+template<serializable tkey, serializable tvalue, compator<tkey> compare, std::size_t t>
+typename B_tree_disk<tkey, tvalue, compare, t>::btree_disk_node
+B_tree_disk<tkey, tvalue, compare, t>::disk_read(size_t node_position) {
+    return *_pool.pin(*this, node_position);
+}
+
+template<serializable tkey, serializable tvalue, compator<tkey> compare, std::size_t t>
+void B_tree_disk<tkey, tvalue, compare, t>::check_page_size(size_t page_size) {
+    if (!std::has_single_bit(page_size) || page_size < minimum_page_size ||
+        __detail::inline_cell_limit(page_size, maximum_keys_in_node + 1) < sizeof(uint64_t)) {
+        throw std::invalid_argument("page size must be a power of two large enough for node of degree t");
+    }
+}
+
+template<serializable tkey, serializable tvalue, compator<tkey> compare, std::size_t t>
+size_t B_tree_disk<tkey, tvalue, compare, t>::allocate_page() {
+    size_t id;
+
+    if (_free_pages.empty()) {
+        id = _count_of_node++;
+    } else {
+        id = _free_pages.back();
+        _free_pages.pop_back();
+    }
+
+    // Снимки новую страницу не видят, прежнее ее содержимое сохранять незачем. Страницы файла версий не в счет
+    if (!_snapshots.empty() && _compact_target == nullptr)
+        _changed_at.insert_or_assign(id, _epoch);
+
+    return id;
+}
+
+template<serializable tkey, serializable tvalue, compator<tkey> compare, std::size_t t>
+void B_tree_disk<tkey, tvalue, compare, t>::release_page(size_t id) {
+    preserve_page(id);
+    _pool.discard(id);
+
+    if (auto it = _overflow_chains.find(id); it != _overflow_chains.end()) {
+        _free_pages.insert(_free_pages.end(), it->second.begin(), it->second.end());
+        _overflow_chains.erase(it);
+    }
+
+    _free_pages.push_back(id);
+}
+
+template<serializable tkey, serializable tvalue, compator<tkey> compare, std::size_t t>
+void B_tree_disk<tkey, tvalue, compare, t>::preserve_page(size_t id) {
+    if (_snapshots.empty())
+        return;
+
+    // Изменена после самого нового снимка: то, что видят снимки, уже скопировано
+    if (auto it = _changed_at.find(id); it != _changed_at.end() && it->second > *_snapshots.rbegin())
+        return;
+
+    btree_disk_node node = *_pool.pin(*this, id);
+
+    // Копия пишется тем же кодированием, что и узел, но страницы берет из файла версий
+    std::swap(_free_pages, _free_versions);
+    std::swap(_count_of_node, _version_count);
+    _compact_target = &_versions;
+
+    std::vector<size_t> reusable;
+    std::vector<size_t> chain;
+    size_t page;
+
+    try {
+        page = allocate_page();
+        write_node(page, node, reusable, chain);
+    } catch (...) {
+        _compact_target = nullptr;
+        std::swap(_free_pages, _free_versions);
+        std::swap(_count_of_node, _version_count);
+        throw;
+    }
+
+    _compact_target = nullptr;
+    std::swap(_free_pages, _free_versions);
+    std::swap(_count_of_node, _version_count);
+
+    _page_versions[id].push_back({_epoch, page, std::move(chain)});
+    _changed_at.insert_or_assign(id, _epoch);
+}
+
+template<serializable tkey, serializable tvalue, compator<tkey> compare, std::size_t t>
+typename B_tree_disk<tkey, tvalue, compare, t>::btree_disk_node
+B_tree_disk<tkey, tvalue, compare, t>::snapshot_read(size_t id, uint64_t epoch) {
+    std::shared_lock lock(_latches->tree);
+
+    // Первая копия, сделанная после снимка, хранит узел таким, каким снимок его видел
+    if (auto it = _page_versions.find(id); it != _page_versions.end()) {
+        for (auto &version: it->second) {
+            if (version.saved_at > epoch) {
+                std::vector<char> bytes(_versions.page_size());
+                std::vector<size_t> chain;
+
+                _versions.read_page(version.page, bytes);
+                return decode_page(_versions, id, bytes, chain);
+            }
+        }
+    }
+
+    return *_pool.pin(*this, id);
+}
+
+template<serializable tkey, serializable tvalue, compator<tkey> compare, std::size_t t>
+typename B_tree_disk<tkey, tvalue, compare, t>::btree_disk_snapshot B_tree_disk<tkey, tvalue, compare, t>::snapshot() {
+    std::unique_lock lock(_latches->tree);
+
+    if (!_versions.is_open()) {
+        _versions = page_file(_file_path + ".versions", _file.page_size());
+        _versions.truncate(0);
+
+        // Как и в файле дерева, страница 0 не используется: 0 означает конец цепочки переполнения
+        _version_count = 1;
+    }
+
+    // Изменения после снимка получают эпоху больше его собственной
+    uint64_t epoch = _epoch++;
+    _snapshots.insert(epoch);
+
+    return btree_disk_snapshot(this, epoch, _position_root);
+}
+
+template<serializable tkey, serializable tvalue, compator<tkey> compare, std::size_t t>
+void B_tree_disk<tkey, tvalue, compare, t>::release_snapshot(uint64_t epoch) {
+    std::unique_lock lock(_latches->tree);
+
+    _snapshots.erase(_snapshots.find(epoch));
+
+    if (_snapshots.empty()) {
+        _page_versions.clear();
+        _changed_at.clear();
+        _free_versions.clear();
+        _version_count = 1;
+        _versions.close();
+        std::filesystem::remove(_file_path + ".versions");
+        return;
+    }
+
+    // Копия нужна снимкам от эпохи предыдущей копии той же страницы до эпохи своей
+    for (auto it = _page_versions.begin(); it != _page_versions.end();) {
+        auto &versions = it->second;
+        uint64_t from = 0;
+        size_t kept = 0;
+
+        for (auto &version: versions) {
+            auto reader = _snapshots.lower_bound(from);
+            from = version.saved_at;
+
+            if (reader != _snapshots.end() && *reader < version.saved_at) {
+                versions[kept++] = std::move(version);
+            } else {
+                _free_versions.push_back(version.page);
+                _free_versions.insert(_free_versions.end(), version.chain.begin(), version.chain.end());
+            }
+        }
+
+        versions.resize(kept);
+        it = versions.empty() ? _page_versions.erase(it) : std::next(it);
+    }
+
+    // Изменения до самого нового снимка видны ему, и такие страницы отмечать незачем
+    std::erase_if(_changed_at, [newest = *_snapshots.rbegin()](const auto &changed) {
+        return changed.second <= newest;
+    });
+}
+
+template<serializable tkey, serializable tvalue, compator<tkey> compare, std::size_t t>
+void B_tree_disk<tkey, tvalue, compare, t>::write_free_list() {
+    const size_t capacity = (_file.page_size() - __detail::free_list_page_header_size) / sizeof(uint64_t);
+    char *page = _page_buffer.data();
+
+    // Список лежит в последних свободных страницах, остальные перечислены в них
+    size_t list_pages = 0;
+    while (list_pages < _free_pages.size() && list_pages * capacity < _free_pages.size() - list_pages)
+        ++list_pages;
+
+    const size_t listed = _free_pages.size() - list_pages;
+    size_t next = 0;
+
+    for (size_t i = list_pages; i-- > 0;) {
+        size_t first = i * capacity;
+        size_t count = std::min(capacity, listed - std::min(listed, first));
+
+        std::fill(_page_buffer.begin(), _page_buffer.end(), '\0');
+        page[0] = static_cast<char>(__detail::disk_page_kind::free_list);
+        __detail::store_at(page, 4, static_cast<uint32_t>(count));
+        __detail::store_at(page, 8, static_cast<uint64_t>(next));
+
+        for (size_t j = 0; j < count; ++j)
+            __detail::store_at(page, __detail::free_list_page_header_size + j * sizeof(uint64_t),
+                               static_cast<uint64_t>(_free_pages[first + j]));
+
+        next = _free_pages[listed + i];
+        emit_page(next, _page_buffer);
+    }
+
+    _free_list_head = next;
+}
+
+template<serializable tkey, serializable tvalue, compator<tkey> compare, std::size_t t>
+void B_tree_disk<tkey, tvalue, compare, t>::read_free_list() {
+    const size_t capacity = (_file.page_size() - __detail::free_list_page_header_size) / sizeof(uint64_t);
+    const char *page = _page_buffer.data();
+    std::vector<size_t> list_pages;
+
+    _free_pages.clear();
+
+    for (size_t id = _free_list_head; id != 0; id = __detail::load_at<uint64_t>(page, 8)) {
+        _file.read_page(id, _page_buffer);
+        size_t count = __detail::load_at<uint32_t>(page, 4);
+
+        if (page[0] != static_cast<char>(__detail::disk_page_kind::free_list) || count > capacity ||
+            list_pages.size() >= _count_of_node)
+            throw std::runtime_error("page " + std::to_string(id) + " is not a free list page");
+
+        for (size_t j = 0; j < count; ++j)
+            _free_pages.push_back(__detail::load_at<uint64_t>(page, __detail::free_list_page_header_size +
+                                                                    j * sizeof(uint64_t)));
+        list_pages.push_back(id);
+    }
+
+    _free_pages.insert(_free_pages.end(), list_pages.begin(), list_pages.end());
+}
+
+template<serializable tkey, serializable tvalue, compator<tkey> compare, std::size_t t>
+size_t B_tree_disk<tkey, tvalue, compare, t>::page_count() const noexcept {
+    return _count_of_node;
+}
+
+template<serializable tkey, serializable tvalue, compator<tkey> compare, std::size_t t>
+size_t B_tree_disk<tkey, tvalue, compare, t>::free_page_count() const noexcept {
+    return _free_pages.size();
+}
+
+template<serializable tkey, serializable tvalue, compator<tkey> compare, std::size_t t>
+void B_tree_disk<tkey, tvalue, compare, t>::serialize_pair(const tree_data_type &data, std::vector<char> &bytes) {
+    encode(data.first, bytes);
+    encode(data.second, bytes);
+}
+
+template<serializable tkey, serializable tvalue, compator<tkey> compare, std::size_t t>
+typename B_tree_disk<tkey, tvalue, compare, t>::tree_data_type
+B_tree_disk<tkey, tvalue, compare, t>::deserialize_pair(std::span<char> bytes) {
+    tree_data_type data;
+    size_t offset = 0;
+
+    if (!decode(bytes, offset, data.first) || !decode(bytes, offset, data.second))
+        throw std::runtime_error("corrupted cell of node page");
+    return data;
+}
+
+template<serializable tkey, serializable tvalue, compator<tkey> compare, std::size_t t>
+std::fstream &B_tree_disk<tkey, tvalue, compare, t>::codec() {
+    thread_local std::fstream stream;
+    return stream;
+}
+
+template<serializable tkey, serializable tvalue, compator<tkey> compare, std::size_t t>
+void B_tree_disk<tkey, tvalue, compare, t>::serialize_key(const tkey &key, std::vector<char> &bytes) {
+    encode(key, bytes);
+}
+
+template<serializable tkey, serializable tvalue, compator<tkey> compare, std::size_t t>
+tkey B_tree_disk<tkey, tvalue, compare, t>::deserialize_key(std::span<char> bytes) {
+    tkey key;
+    size_t offset = 0;
+
+    if (!decode(bytes, offset, key))
+        throw std::runtime_error("corrupted key in write-ahead log");
+    return key;
+}
+
+template<serializable tkey, serializable tvalue, compator<tkey> compare, std::size_t t>
+void B_tree_disk<tkey, tvalue, compare, t>::serialize_suffix_pair(const tree_data_type &data, size_t prefix_size,
+                                                                  std::vector<char> &bytes) {
+    if constexpr (prefix_compressible<tkey>) {
+        std::string_view suffix = std::string_view(data.first.bytes()).substr(prefix_size);
+
+        size_t position = bytes.size();
+        bytes.resize(position + sizeof(uint32_t));
+        __detail::store_at(bytes.data(), position, static_cast<uint32_t>(suffix.size()));
+        bytes.insert(bytes.end(), suffix.begin(), suffix.end());
+        encode(data.second, bytes);
+    }
+}
+
+template<serializable tkey, serializable tvalue, compator<tkey> compare, std::size_t t>
+typename B_tree_disk<tkey, tvalue, compare, t>::tree_data_type
+B_tree_disk<tkey, tvalue, compare, t>::deserialize_suffix_pair(std::string_view prefix, std::span<char> bytes) {
+    tree_data_type data;
+
+    if constexpr (prefix_compressible<tkey>) {
+        size_t suffix_size = bytes.size() >= sizeof(uint32_t) ? __detail::load_at<uint32_t>(bytes.data(), 0) : 0;
+        size_t offset = sizeof(uint32_t) + suffix_size;
+
+        if (bytes.size() < offset)
+            throw std::runtime_error("corrupted cell of node page");
+
+        std::string key;
+        key.reserve(prefix.size() + suffix_size);
+        key.append(prefix).append(bytes.data() + sizeof(uint32_t), suffix_size);
+        data.first = tkey::from_bytes(key);
+
+        if (!decode(bytes, offset, data.second))
+            throw std::runtime_error("corrupted cell of node page");
+    }
+    return data;
+}
+
+template<serializable tkey, serializable tvalue, compator<tkey> compare, std::size_t t>
+template<serializable T>
+void B_tree_disk<tkey, tvalue, compare, t>::encode(const T &value, std::vector<char> &bytes) {
+    if constexpr (raw_serializable<T>) {
+        const char *raw = reinterpret_cast<const char *>(&value);
+        bytes.insert(bytes.end(), raw, raw + sizeof(T));
+    } else {
+        __detail::vector_output_buffer buffer(bytes);
+
+        std::fstream &stream = codec();
+
+        stream.std::ios::rdbuf(&buffer);
+        value.serialize(stream);
+        stream.std::ios::rdbuf(nullptr);
+    }
+}
+
+template<serializable tkey, serializable tvalue, compator<tkey> compare, std::size_t t>
+template<serializable T>
+bool B_tree_disk<tkey, tvalue, compare, t>::decode(std::span<char> bytes, size_t &offset, T &value) {
+    if constexpr (raw_serializable<T>) {
+        if (bytes.size() - offset < sizeof(T))
+            return false;
+
+        std::memcpy(&value, bytes.data() + offset, sizeof(T));
+        offset += sizeof(T);
+        return true;
+    } else {
+        std::spanbuf buffer(bytes.subspan(offset), std::ios::in);
+
+        std::fstream &stream = codec();
+
+        stream.std::ios::rdbuf(&buffer);
+        value = T::deserialize(stream);
+        bool failed = stream.fail();
+        stream.std::ios::rdbuf(nullptr);
+
+        offset += static_cast<size_t>(std::streamoff(buffer.pubseekoff(0, std::ios::cur, std::ios::in)));
+        return !failed;
+    }
+}
+
+template<serializable tkey, serializable tvalue, compator<tkey> compare, std::size_t t>
+bool B_tree_disk<tkey, tvalue, compare, t>::fits_packed(bool is_leaf) const noexcept {
+    return packed_pairs && __detail::packed_node_size(maximum_keys_in_node + 1, is_leaf, sizeof(tkey),
+                                                      sizeof(tvalue)) <= _file.page_size();
+}
+
+template<serializable tkey, serializable tvalue, compator<tkey> compare, std::size_t t>
+size_t B_tree_disk<tkey, tvalue, compare, t>::write_overflow(std::span<const char> bytes, std::vector<size_t> &reusable,
+                                                           std::vector<size_t> &owned) {
+    const size_t capacity = _file.page_size() - __detail::overflow_page_header_size;
+    const size_t pages = (bytes.size() + capacity - 1) / capacity;
+    const size_t first = owned.size();
+
+    for (size_t i = 0; i < pages; ++i) {
+        if (reusable.empty()) {
+            owned.push_back(allocate_page());
+        } else {
+            owned.push_back(reusable.back());
+            reusable.pop_back();
+        }
+    }
+
+    for (size_t i = 0; i < pages; ++i) {
+        size_t chunk = std::min(capacity, bytes.size() - i * capacity);
+        char *page = _chain_buffer.data();
+
+        std::fill(_chain_buffer.begin(), _chain_buffer.end(), '\0');
+        page[0] = static_cast<char>(__detail::disk_page_kind::overflow);
+        __detail::store_at(page, 4, static_cast<uint32_t>(chunk));
+        __detail::store_at(page, 8, static_cast<uint64_t>(i + 1 < pages ? owned[first + i + 1] : 0));
+        std::memcpy(page + __detail::overflow_page_header_size, bytes.data() + i * capacity, chunk);
+        emit_page(owned[first + i], _chain_buffer);
+    }
+
+    return owned[first];
+}
+
+template<serializable tkey, serializable tvalue, compator<tkey> compare, std::size_t t>
+void B_tree_disk<tkey, tvalue, compare, t>::read_overflow(const page_file &file, size_t page_id, size_t length,
+                                                          std::vector<char> &bytes, std::vector<size_t> &owned) {
+    const size_t capacity = file.page_size() - __detail::overflow_page_header_size;
+    std::vector<char> chain(file.page_size());
+    const char *page = chain.data();
+
+    bytes.clear();
 
-    // 2. Правый узел
-    btree_disk_node right(current._is_leaf);
-    right.position_in_disk = this->_count_of_node++;
-    right.pointers.resize(maximum_keys_in_node + 2, 0);
+    while (bytes.size() < length) {
+        // Страница 0 - заголовок, поэтому 0 означает конец цепочки
+        if (page_id == 0)
+            throw std::runtime_error("overflow chain is shorter than its cell");
 
-    // 3. Считаем середину ПО ВЕКТОРУ ключей
-    size_t mid = current.keys.size() / 2;
-    tree_data_type middle_key = current.keys[mid];
+        file.read_page(page_id, chain);
+        auto used = __detail::load_at<uint32_t>(page, 4);
 
-    // 4. Переносим ключи > mid в правый узел
-    right.keys.assign(
-            current.keys.begin() + mid + 1,
-            current.keys.end()
-    );
-    current.keys.erase(
-            current.keys.begin() + mid,
-            current.keys.end()
-    );
+        if (page[0] != static_cast<char>(__detail::disk_page_kind::overflow) || used > capacity)
+            throw std::runtime_error("page " + std::to_string(page_id) + " is not an overflow page");
 
-    // 5. Перенос указателей (если не лист)
-    if (!current._is_leaf) {
-        right.pointers.assign(
-                current.pointers.begin() + mid + 1,
-                current.pointers.end()
-        );
-        current.pointers.erase(
-                current.pointers.begin() + mid + 1,
-                current.pointers.end()
-        );
-        right.pointers.resize(maximum_keys_in_node + 2, 0);
-        current.pointers.resize(maximum_keys_in_node + 2, 0);
+        bytes.insert(bytes.end(), page + __detail::overflow_page_header_size,
+                     page + __detail::overflow_page_header_size + used);
+        owned.push_back(page_id);
+        page_id = __detail::load_at<uint64_t>(page, 8);
     }
+}
 
-    // 6. Обновляем размеры и пишем на диск
-    current.size = current.keys.size();
-    right.size   = right.keys.size();
-    disk_write(current);
-    disk_write(right);
-
-    // 7. Вставляем в родителя или создаём новый корень
-    if (path.empty()) {
-        btree_disk_node root(false);
-        root.position_in_disk = this->_count_of_node++;
-        root.keys.push_back(middle_key);
-        root.pointers[0] = current_pos;
-        root.pointers[1] = right.position_in_disk;
-        root.size = 1;
-        root.pointers.resize(maximum_keys_in_node + 2, 0);
-        _position_root = root.position_in_disk;
-        disk_write(root);
-        print_root_position();
-        return;
+template<serializable tkey, serializable tvalue, compator<tkey> compare, std::size_t t>
+void B_tree_disk<tkey, tvalue, compare, t>::store_page(size_t position, const btree_disk_node &node) {
+    std::vector<size_t> reusable;
+    std::vector<size_t> owned;
+
+    // Цепочки, которыми узел владел, переиспользуются в первую очередь. Вытеснять страницы может и читатель,
+    // пока другие читатели загружают свои
+    {
+        std::lock_guard lock(_latches->chains);
+
+        if (auto it = _overflow_chains.find(position); it != _overflow_chains.end()) {
+            reusable = std::move(it->second);
+            _overflow_chains.erase(it);
+        }
     }
 
-    auto [parent_pos, parent_idx] = path.top();
-    btree_disk_node parent = disk_read(parent_pos);
-    parent.keys.insert(parent.keys.begin() + parent_idx, middle_key);
-    parent.pointers.insert(
-            parent.pointers.begin() + parent_idx + 1,
-            right.position_in_disk
-    );
-    ++parent.size;
-    parent.pointers.resize(maximum_keys_in_node + 2, 0);
-    disk_write(parent);
-    if (parent.size > maximum_keys_in_node)
-        split_node(path);
-}
+    write_node(position, node, reusable, owned);
 
+    // write_overflow забирает страницы с конца, оставшиеся узлу больше не нужны
+    _free_pages.insert(_free_pages.end(), reusable.begin(), reusable.end());
+
+    if (!owned.empty()) {
+        std::lock_guard lock(_latches->chains);
+        _overflow_chains.emplace(position, std::move(owned));
+    }
+}
 
 template<serializable tkey, serializable tvalue, compator<tkey> compare, std::size_t t>
-void B_tree_disk<tkey, tvalue, compare, t>::insert_array(btree_disk_node &node, size_t right_node,
-                                                         const tree_data_type &data, size_t index) noexcept {
-    node.keys.insert(node.keys.begin() + index, data);
-    node.pointers.insert(node.pointers.begin() + index + 1, right_node);
-    node.size++;
+void B_tree_disk<tkey, tvalue, compare, t>::write_node(size_t position, const btree_disk_node &node,
+                                                       std::vector<size_t> &reusable, std::vector<size_t> &owned) {
+    const size_t page_size = _file.page_size();
+    char *page = _page_buffer.data();
 
-    disk_write(node);
-}
+    const bool packed = fits_packed(node._is_leaf);
 
+    // Общий префикс байтов всех ключей узла, порядок сравнения не обязан совпадать с порядком байтов
+    size_t prefix_size = 0;
 
-template<serializable tkey, serializable tvalue, compator<tkey> compare, std::size_t t>
-std::pair<std::stack<std::pair<size_t, size_t> >, std::pair<size_t, bool> >
-B_tree_disk<tkey, tvalue, compare, t>::find_path(const tkey &key) {
-    std::stack<std::pair<size_t, size_t> > path;
+    if constexpr (prefix_compressible<tkey>) {
+        if (!node.keys.empty()) {
+            std::string_view first = node.keys.front().first.bytes();
+            prefix_size = std::min(first.size(), __detail::max_key_prefix_size(page_size, maximum_keys_in_node + 1));
 
-    if (_position_root == static_cast<size_t>(-1)) {
-        return {path, {0, false}};
+            for (size_t i = 1; i < node.keys.size() && prefix_size != 0; ++i) {
+                std::string_view key = node.keys[i].first.bytes();
+                prefix_size = std::mismatch(first.begin(), first.begin() + std::min(prefix_size, key.size()),
+                                            key.begin()).first - first.begin();
+            }
+        }
     }
 
-    size_t current_position = _position_root;
+    const size_t limit = __detail::inline_cell_limit(page_size - prefix_size, maximum_keys_in_node + 1);
 
-    btree_disk_node current_node = disk_read(current_position);
+    std::fill(_page_buffer.begin(), _page_buffer.end(), '\0');
 
-    // std::cout << "root: size=" << current_node.size
-    //         << ", is_leaf=" << current_node._is_leaf
-    //         << ", pointers={";
-    // for (auto p: current_node.pointers) std::cout << p << " ";
-    // std::cout << "}\n";
+    if (packed)
+        page[0] = static_cast<char>(node._is_leaf ? __detail::disk_page_kind::packed_leaf
+                                                  : __detail::disk_page_kind::packed_internal);
+    else
+        page[0] = static_cast<char>(node._is_leaf ? __detail::disk_page_kind::leaf
+                                                  : __detail::disk_page_kind::internal);
+    __detail::store_at(page, 4, static_cast<uint32_t>(node.keys.size()));
 
-    while (true) {
-        auto [index, key_found] = find_index(key, current_node);
+    size_t directory = __detail::node_page_header_size;
 
-        if (key_found) {
-            path.push({current_position, index});
-            return {path, {index, true}};
-        }
+    if (!node._is_leaf) {
+        for (size_t i = 0; i <= node.keys.size(); ++i, directory += sizeof(uint64_t))
+            __detail::store_at(page, directory, static_cast<uint64_t>(node.pointers[i]));
+    }
 
-        path.push({current_position, index});
+    if constexpr (packed_pairs) {
+        if (packed) {
+            char *keys = page + directory;
+            char *values = keys + node.keys.size() * sizeof(tkey);
 
-        if (current_node._is_leaf) {
-            return {path, {index, false}};
+            for (size_t i = 0; i < node.keys.size(); ++i) {
+                std::memcpy(keys + i * sizeof(tkey), &node.keys[i].first, sizeof(tkey));
+                std::memcpy(values + i * sizeof(tvalue), &node.keys[i].second, sizeof(tvalue));
+            }
+
+            __detail::store_at(page, 8, static_cast<uint32_t>(values + node.keys.size() * sizeof(tvalue) - page));
+            emit_page(position, _page_buffer);
+            return;
         }
-        // std::cout << "cur pos: " << current_position << ", go to: " << current_node.pointers[index] << std::endl;
-        current_position = current_node.pointers[index];
-        current_node = disk_read(current_position);
     }
-}
 
+    size_t cells_begin = page_size;
 
-template<serializable tkey, serializable tvalue, compator<tkey> compare, std::size_t t>
-std::pair<size_t, bool> B_tree_disk<tkey, tvalue, compare, t>::find_index(
-        const tkey &key, btree_disk_node &node) const noexcept {
-    size_t i = 0;
-    // std::cout << "find_index: key=" << key.data << ", keys: ";
-    // for (auto &pair: node.keys) std::cout << pair.first.data << " ";
-    // std::cout << std::endl;
+    if constexpr (prefix_compressible<tkey>) {
+        page[1] = static_cast<char>(__detail::node_key_prefix);
+        __detail::store_at(page, 2, static_cast<uint16_t>(prefix_size));
 
-    while (i < node.keys.size() && compare_keys(node.keys[i].first, key)) {
-        // std::cout << "compare_keys(" << node.keys[i].first.data << ", " << key.data << ") = "
-        // << compare_keys(node.keys[i].first, key) << std::endl;
-        ++i;
+        cells_begin -= prefix_size;
+        if (prefix_size != 0)
+            std::memcpy(page + cells_begin, node.keys.front().first.bytes().data(), prefix_size);
     }
 
-    bool found = (i < node.keys.size() && !compare_keys(key, node.keys[i].first));
-    // std::cout << "index = " << i << ", found = " << found << std::endl;
-    return {i, found};
-}
+    for (size_t i = 0; i < node.keys.size(); ++i) {
+        _cell_buffer.clear();
+
+        if constexpr (prefix_compressible<tkey>)
+            serialize_suffix_pair(node.keys[i], prefix_size, _cell_buffer);
+        else
+            serialize_pair(node.keys[i], _cell_buffer);
 
+        if (_cell_buffer.size() <= limit) {
+            cells_begin -= __detail::cell_header_size + _cell_buffer.size();
+            page[cells_begin] = static_cast<char>(__detail::cell_inline);
+            std::memcpy(page + cells_begin + __detail::cell_header_size, _cell_buffer.data(), _cell_buffer.size());
+        } else {
+            size_t first = write_overflow(_cell_buffer, reusable, owned);
+            cells_begin -= __detail::overflow_cell_size;
+            page[cells_begin] = static_cast<char>(__detail::cell_overflow);
+            __detail::store_at(page, cells_begin + __detail::cell_header_size, static_cast<uint64_t>(first));
+        }
+
+        __detail::store_at(page, cells_begin + 1, static_cast<uint32_t>(_cell_buffer.size()));
+        __detail::store_at(page, directory + i * sizeof(uint32_t), static_cast<uint32_t>(cells_begin));
+    }
+
+    __detail::store_at(page, 8, static_cast<uint32_t>(cells_begin));
+    emit_page(position, _page_buffer);
+}
 
 template<serializable tkey, serializable tvalue, compator<tkey> compare, std::size_t t>
-void B_tree_disk<tkey, tvalue, compare, t>::btree_disk_node::serialize(
-        std::fstream &tree_stream,
-        std::fstream &data_stream) const {
-    // пишем header
-    write_node_header(tree_stream, size, _is_leaf, position_in_disk);
+void B_tree_disk<tkey, tvalue, compare, t>::prefetch_pages(std::span<const size_t> ids) {
+    std::vector<size_t> missing;
 
-    // пишем указатели
-    for (size_t i = 0; i < maximum_keys_in_node + 2; ++i) {
-        size_t val = (i < pointers.size() ? pointers[i] : 0);
-        tree_stream.write(reinterpret_cast<const char *>(&val), sizeof(size_t));
+    for (size_t id: ids) {
+        if (!_pool.contains(id))
+            missing.push_back(id);
     }
 
-    // пишем позиции + сам ключ/значение в data_stream
-    for (size_t i = 0; i < maximum_keys_in_node + 1; ++i) {
-        size_t pos = 0;
-        if (i < keys.size()) {
-            // идём в конец data-файла и запоминаем оффсет
-            data_stream.seekp(0, std::ios::end);
-            pos = static_cast<size_t>(data_stream.tellp());
+    std::sort(missing.begin(), missing.end());
+    missing.erase(std::unique(missing.begin(), missing.end()), missing.end());
 
-            // сериализуем ключ и значение
-            keys[i].first.serialize(data_stream);
-            keys[i].second.serialize(data_stream);
+    // Одну страницу load_page прочитает сам
+    if (missing.size() < 2)
+        return;
 
-            data_stream.flush();
-        }
-        // пишем в .tree файл позицию этого ключа (или 0)
-        tree_stream.write(reinterpret_cast<const char *>(&pos), sizeof(size_t));
+    std::unordered_map<size_t, std::vector<char>> pages;
+    std::vector<page_read> reads;
+    reads.reserve(missing.size());
+
+    for (size_t id: missing) {
+        auto &bytes = pages[id];
+        bytes.resize(_file.page_size());
+        reads.push_back({id, bytes});
     }
-}
 
+    uint64_t written;
 
-template<serializable tkey, serializable tvalue, compator<tkey> compare, std::size_t t>
-void B_tree_disk<tkey, tvalue, compare, t>::disk_write(btree_disk_node &node) {
-    const size_t header_size = 2 * sizeof(size_t); // count_of_node + position_root
+    {
+        std::lock_guard lock(_latches->prefetched);
+        written = _written_pages;
+    }
+
+    {
+        std::lock_guard lock(_latches->reader);
+        _reader.read(_file, reads);
+    }
 
-    const size_t node_size =
-            sizeof(size_t) + // size
-            sizeof(uint8_t) + // is_leaf
-            sizeof(size_t) + // position_in_disk
-            (maximum_keys_in_node + 1) * sizeof(size_t) + // pointers
-            (maximum_keys_in_node + 2) * sizeof(size_t); // keys positions
+    std::lock_guard lock(_latches->prefetched);
 
-    _file_for_tree.seekp(header_size + node.position_in_disk * node_size, std::ios::beg);
-    node.serialize(_file_for_tree, _file_for_key_value);
-    _file_for_tree.flush();
-    _file_for_key_value.flush();
+    // Оставшееся от прошлого пакета больше не нужно, пакет другого читателя он прочитает сам
+    if (written == _written_pages)
+        _prefetched = std::move(pages);
+    else
+        _prefetched.clear();
 }
 
 template<serializable tkey, serializable tvalue, compator<tkey> compare, std::size_t t>
 typename B_tree_disk<tkey, tvalue, compare, t>::btree_disk_node
-B_tree_disk<tkey, tvalue, compare,
-        t>::btree_disk_node::deserialize(std::fstream &stream, std::fstream &stream_for_data) {
-    btree_disk_node node;
-
-    // Чтение заголовка
-    read_node_header(stream, node.size, node._is_leaf, node.position_in_disk);
-
-    // Чтение указателей
-    node.pointers.resize(maximum_keys_in_node + 2);
-    for (auto &p: node.pointers)
-        stream.read(reinterpret_cast<char *>(&p), sizeof(size_t));
-
-    // Чтение ключей
-    node.keys.clear();
-    for (size_t i = 0; i < maximum_keys_in_node + 1; ++i) {
-        size_t pos = 0;
-        stream.read(reinterpret_cast<char *>(&pos), sizeof(size_t));
-        if (node.keys.size() < node.size) {
-            stream_for_data.seekg(pos);
-            tree_data_type pair;
-            pair.first = tkey::deserialize(stream_for_data);
-            pair.second = tvalue::deserialize(stream_for_data);
-            node.keys.push_back(pair);
+B_tree_disk<tkey, tvalue, compare, t>::load_page(size_t node_position) {
+    // Читатели загружают страницы одновременно, поэтому буферы у каждого свои
+    std::vector<char> bytes;
+
+    {
+        std::lock_guard lock(_latches->prefetched);
+        auto prefetched = _prefetched.find(node_position);
+
+        if (prefetched != _prefetched.end()) {
+            bytes = std::move(prefetched->second);
+            _prefetched.erase(prefetched);
         }
     }
 
+    if (bytes.empty()) {
+        bytes.resize(_file.page_size());
+        _file.read_page(node_position, bytes);
+    }
+
+    std::vector<size_t> owned;
+    btree_disk_node node = decode_page(_file, node_position, bytes, owned);
+
+    std::lock_guard lock(_latches->chains);
+
+    if (owned.empty())
+        _overflow_chains.erase(node_position);
+    else
+        _overflow_chains.insert_or_assign(node_position, std::move(owned));
+
     return node;
 }
 
 template<serializable tkey, serializable tvalue, compator<tkey> compare, std::size_t t>
 typename B_tree_disk<tkey, tvalue, compare, t>::btree_disk_node
-B_tree_disk<tkey, tvalue, compare, t>::disk_read(size_t node_position) {
-    const size_t header_size = 2 * sizeof(size_t);
-    const size_t node_size =
-            sizeof(size_t) + // size
-            sizeof(uint8_t) + // is_leaf
-            sizeof(size_t) + // position_in_disk
-            (maximum_keys_in_node + 2) * sizeof(size_t) + // pointers
-            (maximum_keys_in_node + 1) * sizeof(size_t); // keys positions
+B_tree_disk<tkey, tvalue, compare, t>::decode_page(const page_file &file, size_t node_position, std::span<char> bytes,
+                                                   std::vector<size_t> &owned) {
+    const size_t page_size = file.page_size();
+    const char *page = bytes.data();
+
+    auto kind = static_cast<__detail::disk_page_kind>(page[0]);
+    size_t count = __detail::load_at<uint32_t>(page, 4);
+    bool packed = kind == __detail::disk_page_kind::packed_leaf || kind == __detail::disk_page_kind::packed_internal;
+
+    if ((kind != __detail::disk_page_kind::leaf && kind != __detail::disk_page_kind::internal && !packed) ||
+        (packed && !packed_pairs) || count > maximum_keys_in_node + 1) {
+        throw std::runtime_error("page " + std::to_string(node_position) + " is not a node page");
+    }
 
-    _file_for_tree.seekg(header_size + node_position * node_size, std::ios::beg);
-    return btree_disk_node::deserialize(_file_for_tree, _file_for_key_value);
-}
+    btree_disk_node node(kind == __detail::disk_page_kind::leaf || kind == __detail::disk_page_kind::packed_leaf);
+    node.size = count;
+    node.position_in_disk = node_position;
+
+    size_t directory = __detail::node_page_header_size;
+
+    if (!node._is_leaf) {
+        for (size_t i = 0; i <= count; ++i, directory += sizeof(uint64_t))
+            node.pointers[i] = __detail::load_at<uint64_t>(page, directory);
+    }
+
+    std::vector<char> overflow;
+
+    if constexpr (packed_pairs) {
+        if (packed) {
+            if (__detail::packed_node_size(count, node._is_leaf, sizeof(tkey), sizeof(tvalue)) > page_size)
+                throw std::runtime_error("keys of page " + std::to_string(node_position) + " are out of page");
+
+            // Ключи и значения лежат двумя массивами, байты копируются в узел как есть
+            const char *keys = page + directory;
+            const char *values = keys + count * sizeof(tkey);
+
+            node.keys.resize(count);
+
+            for (size_t i = 0; i < count; ++i) {
+                std::memcpy(&node.keys[i].first, keys + i * sizeof(tkey), sizeof(tkey));
+                std::memcpy(&node.keys[i].second, values + i * sizeof(tvalue), sizeof(tvalue));
+            }
+        }
+    }
+
+    bool prefixed = (page[1] & __detail::node_key_prefix) != 0;
+    size_t prefix_size = prefixed ? __detail::load_at<uint16_t>(page, 2) : 0;
+
+    if (prefixed && (!prefix_compressible<tkey> || prefix_size > page_size - directory))
+        throw std::runtime_error("key prefix of page " + std::to_string(node_position) + " is damaged");
+
+    std::string_view prefix(page + page_size - prefix_size, prefix_size);
+
+    auto deserialize_cell = [&](std::span<char> bytes) {
+        if constexpr (prefix_compressible<tkey>) {
+            if (prefixed)
+                return deserialize_suffix_pair(prefix, bytes);
+        }
+        return deserialize_pair(bytes);
+    };
+
+    if (!packed)
+        node.keys.reserve(count);
+
+    for (size_t i = 0; i < count && !packed; ++i) {
+        size_t cell = __detail::load_at<uint32_t>(page, directory + i * sizeof(uint32_t));
+        size_t length = cell + __detail::cell_header_size <= page_size ? __detail::load_at<uint32_t>(page, cell + 1) : 0;
+
+        if (page[cell] == static_cast<char>(__detail::cell_inline)) {
+            if (cell + __detail::cell_header_size + length > page_size)
+                throw std::runtime_error("cell of page " + std::to_string(node_position) + " is out of page");
+
+            node.keys.push_back(deserialize_cell({bytes.data() + cell + __detail::cell_header_size, length}));
+        } else {
+            read_overflow(file, __detail::load_at<uint64_t>(page, cell + __detail::cell_header_size), length,
+                          overflow, owned);
+            node.keys.push_back(deserialize_cell(overflow));
+        }
+    }
 
+    return node;
+}
 
 template<serializable tkey, serializable tvalue, compator<tkey> compare, std::size_t t>
 B_tree_disk<tkey, tvalue, compare, t>::btree_disk_node::btree_disk_node(bool is_leaf) : _is_leaf(is_leaf), size(0),
@@ -1094,73 +2904,148 @@ template<serializable tkey, serializable tvalue, compator<tkey> compare, std::si
 B_tree_disk<tkey, tvalue, compare, t>::B_tree_disk(
         const std::string &file_path,
         const compare &cmp,
-        void *logger)
-        : compare(cmp) {
+        void *logger,
+        size_t cache_pages,
+        size_t page_size,
+        const wal_options &wal,
+        const bloom_options &bloom)
+        : compare(cmp), _latches(std::make_unique<latches>()), _file_path(file_path), _free_list_head(0),
+          _compact_target(nullptr), _pool(cache_pages), _written_pages(0), _wal(wal), _log_generation(0), _uncommitted_operations(0), _replaying(false), _bloom(bloom),
+          _filter_stamp(0), _filter_dirty(false), _staging(false), _version_count(1), _epoch(1) {
     std::string tree_file = file_path + ".tree";
-    std::string data_file = file_path + ".data";
 
-    bool files_exist =
+    bool file_exists =
             std::filesystem::exists(tree_file) &&
-            std::filesystem::exists(data_file);
-
-    if (!files_exist) {
-        // Создаем и чистим оба файла
-        _file_for_tree.open(tree_file,
-                            std::ios::out | std::ios::binary | std::ios::trunc);
-        _file_for_tree.close();
+            std::filesystem::file_size(tree_file) != 0;
 
-        _file_for_key_value.open(data_file,
-                                 std::ios::out | std::ios::binary | std::ios::trunc);
-        _file_for_key_value.close();
+    if (!file_exists)
+        check_page_size(page_size);
 
-        // Открываем для чтения/записи: .tree без append, .data — с append
-        _file_for_tree.open(tree_file,
-                            std::ios::in | std::ios::out | std::ios::binary);
+    _file = page_file(tree_file, page_size);
+    _page_buffer.resize(page_size);
 
-        _file_for_key_value.open(data_file,
-                                 std::ios::in |
-                                 std::ios::out |
-                                 std::ios::binary |
-                                 std::ios::app); // ← ключевой режим
-
-        // Инициализация
-        _count_of_node = 0;
-        _position_root = 0;
+    if (!file_exists) {
+        // Страница 0 - заголовок, корень - пустой лист
+        _count_of_node = 1;
 
         btree_disk_node root_node(true);
-        root_node.position_in_disk = _count_of_node++;
+        root_node.position_in_disk = allocate_page();
         _position_root = root_node.position_in_disk;
 
         disk_write(root_node);
 
-        // Записать заголовок
-        _file_for_tree.seekp(0, std::ios::beg);
-        _file_for_tree.write(
-                reinterpret_cast<const char *>(&_count_of_node),
-                sizeof(size_t));
-        _file_for_tree.write(
-                reinterpret_cast<const char *>(&_position_root),
-                sizeof(size_t));
-        _file_for_tree.flush();
+        if (_bloom.enabled)
+            rebuild_filter();
+
+        flush();
     } else {
-        // Открываем существующие файлы
-        _file_for_tree.open(tree_file,
-                            std::ios::in | std::ios::out | std::ios::binary);
-
-        _file_for_key_value.open(data_file,
-                                 std::ios::in |
-                                 std::ios::out |
-                                 std::ios::binary |
-                                 std::ios::app); // ← и тут
-
-        _file_for_tree.read(
-                reinterpret_cast<char *>(&_count_of_node),
-                sizeof(size_t));
-        _file_for_tree.read(
-                reinterpret_cast<char *>(&_position_root),
-                sizeof(size_t));
+        read_header();
+    }
+
+    // Фильтр от другого сброса мог пропустить ключи, вставленные позже
+    bool filter_loaded =
+            !_bloom.enabled || !file_exists || _filter.load(file_path + ".bloom", _file.page_size(), _filter_stamp);
+
+    _chain_buffer.resize(_file.page_size());
+
+    if (_wal.enabled) {
+        _pool.set_steal(false);
+        _log = write_ahead_log(file_path + ".wal", _file.page_size());
+
+        // Журнал от прежнего дерева по тому же пути ничего не значит для нового
+        if (file_exists)
+            recover(_log.recover(_log_generation));
+        else
+            _log.restart(_log_generation);
+    }
+
+    if (!filter_loaded) {
+        rebuild_filter();
+        flush();
+    }
 
+    if (file_exists)
         _current_node = disk_read(_position_root);
+}
+
+
+template<serializable tkey, serializable tvalue, compator<tkey> compare, std::size_t t>
+B_tree_disk<tkey, tvalue, compare, t>::B_tree_disk(B_tree_disk &&other) noexcept
+        : compare(std::move(static_cast<compare &>(other))), _file(std::move(other._file)),
+          _latches(std::exchange(other._latches, std::make_unique<latches>())), _file_path(std::move(other._file_path)),
+          _free_pages(std::move(other._free_pages)), _free_list_head(other._free_list_head),
+          _overflow_chains(std::move(other._overflow_chains)), _compact_target(nullptr),
+          _page_buffer(std::move(other._page_buffer)), _chain_buffer(std::move(other._chain_buffer)),
+          _cell_buffer(std::move(other._cell_buffer)), _pool(std::move(other._pool)), _reader(std::move(other._reader)),
+          _prefetched(std::move(other._prefetched)), _written_pages(other._written_pages), _log(std::move(other._log)),
+          _wal(other._wal), _log_generation(other._log_generation), _uncommitted_operations(other._uncommitted_operations),
+          _replaying(other._replaying), _bloom(other._bloom), _filter(std::move(other._filter)),
+          _filter_stamp(other._filter_stamp), _filter_dirty(other._filter_dirty), _staging(other._staging),
+          _staged_ids(std::move(other._staged_ids)), _staged_pages(std::move(other._staged_pages)),
+          _versions(std::move(other._versions)), _free_versions(std::move(other._free_versions)),
+          _version_count(other._version_count), _page_versions(std::move(other._page_versions)),
+          _changed_at(std::move(other._changed_at)), _snapshots(std::move(other._snapshots)), _epoch(other._epoch),
+          _position_root(other._position_root), _current_node(std::move(other._current_node)),
+          _count_of_node(other._count_of_node) {
+}
+
+template<serializable tkey, serializable tvalue, compator<tkey> compare, std::size_t t>
+B_tree_disk<tkey, tvalue, compare, t> &B_tree_disk<tkey, tvalue, compare, t>::operator=(B_tree_disk &&other) noexcept {
+    if (this != &other) {
+        try {
+            flush();
+        } catch (...) {
+        }
+
+        static_cast<compare &>(*this) = std::move(static_cast<compare &>(other));
+        _file = std::move(other._file);
+        std::swap(_latches, other._latches);
+        _file_path = std::move(other._file_path);
+        _free_pages = std::move(other._free_pages);
+        _free_list_head = other._free_list_head;
+        _overflow_chains = std::move(other._overflow_chains);
+        _compact_target = nullptr;
+        _page_buffer = std::move(other._page_buffer);
+        _chain_buffer = std::move(other._chain_buffer);
+        _cell_buffer = std::move(other._cell_buffer);
+        _pool = std::move(other._pool);
+        _reader = std::move(other._reader);
+        _prefetched = std::move(other._prefetched);
+        _written_pages = other._written_pages;
+        _log = std::move(other._log);
+        _wal = other._wal;
+        _bloom = other._bloom;
+        _filter = std::move(other._filter);
+        _filter_stamp = other._filter_stamp;
+        _filter_dirty = other._filter_dirty;
+        _log_generation = other._log_generation;
+        _uncommitted_operations = other._uncommitted_operations;
+        _replaying = other._replaying;
+        _staging = other._staging;
+        _staged_ids = std::move(other._staged_ids);
+        _staged_pages = std::move(other._staged_pages);
+        _versions = std::move(other._versions);
+        _free_versions = std::move(other._free_versions);
+        _version_count = other._version_count;
+        _page_versions = std::move(other._page_versions);
+        _changed_at = std::move(other._changed_at);
+        _snapshots = std::move(other._snapshots);
+        _epoch = other._epoch;
+        _position_root = other._position_root;
+        _current_node = std::move(other._current_node);
+        _count_of_node = other._count_of_node;
+    }
+    return *this;
+}
+
+template<serializable tkey, serializable tvalue, compator<tkey> compare, std::size_t t>
+B_tree_disk<tkey, tvalue, compare, t>::~B_tree_disk() noexcept {
+    if (_latches == nullptr || !_file.is_open())
+        return;
+
+    try {
+        flush();
+    } catch (...) {
     }
 }
 
@@ -1185,19 +3070,20 @@ void B_tree_disk<tkey, tvalue, compare, t>::check_tree(size_t pos, size_t depth)
 
     // Рекурсивная проверка дочерних узлов
     if (!node._is_leaf) {
-        if (node.pointers.size() != node.size + 1) {
+        // Узлы в памяти держат указатели с запасом на переполнение, значимы первые size + 1
+        if (node.pointers.size() < node.size + 1) {
             throw std::logic_error("Pointers count mismatch in node at position " + std::to_string(pos));
         }
 
-        for (size_t i = 0; i < node.pointers.size(); ++i) {
+        for (size_t i = 0; i <= node.size; ++i) {
             btree_disk_node child = disk_read(node.pointers[i]);
 
             // Проверка интервалов ключей
-            if (i > 0 && !compare_keys(child.keys.front().first, node.keys[i - 1].first)) {
+            if (i > 0 && !compare_keys(node.keys[i - 1].first, child.keys.front().first)) {
                 throw std::logic_error("Left interval violation in node at position " + std::to_string(pos));
             }
 
-            if (i < node.keys.size() && !compare_keys(node.keys[i].first, child.keys.back().first)) {
+            if (i < node.keys.size() && !compare_keys(child.keys.back().first, node.keys[i].first)) {
                 throw std::logic_error("Right interval violation in node at position " + std::to_string(pos));
             }
 
@@ -1377,8 +3263,101 @@ B_tree_disk<tkey, tvalue, compare, t>::btree_disk_const_iterator::operator*() no
 }
 
 
+template<serializable tkey, serializable tvalue, compator<tkey> compare, std::size_t t>
+B_tree_disk<tkey, tvalue, compare, t>::btree_disk_snapshot::btree_disk_snapshot(
+        B_tree_disk<tkey, tvalue, compare, t> *tree, uint64_t epoch, size_t root) noexcept
+        : _tree(tree), _epoch(epoch), _root(root) {
+}
+
+template<serializable tkey, serializable tvalue, compator<tkey> compare, std::size_t t>
+B_tree_disk<tkey, tvalue, compare, t>::btree_disk_snapshot::btree_disk_snapshot(btree_disk_snapshot &&other) noexcept
+        : _tree(std::exchange(other._tree, nullptr)), _epoch(other._epoch), _root(other._root) {
+}
+
+template<serializable tkey, serializable tvalue, compator<tkey> compare, std::size_t t>
+typename B_tree_disk<tkey, tvalue, compare, t>::btree_disk_snapshot &
+B_tree_disk<tkey, tvalue, compare, t>::btree_disk_snapshot::operator=(btree_disk_snapshot &&other) noexcept {
+    if (this != &other) {
+        this->~btree_disk_snapshot();
+        _tree = std::exchange(other._tree, nullptr);
+        _epoch = other._epoch;
+        _root = other._root;
+    }
+    return *this;
+}
+
+template<serializable tkey, serializable tvalue, compator<tkey> compare, std::size_t t>
+B_tree_disk<tkey, tvalue, compare, t>::btree_disk_snapshot::~btree_disk_snapshot() noexcept {
+    if (_tree == nullptr)
+        return;
+
+    try {
+        _tree->release_snapshot(_epoch);
+    } catch (...) {
+    }
+}
+
+template<serializable tkey, serializable tvalue, compator<tkey> compare, std::size_t t>
+std::optional<tvalue> B_tree_disk<tkey, tvalue, compare, t>::btree_disk_snapshot::at(const tkey &key) const {
+    // Фильтр не спрашивается: после перестроения он не знает ключей, удаленных позже снимка
+    for (size_t position = _root; position != static_cast<size_t>(-1);) {
+        btree_disk_node node = _tree->snapshot_read(position, _epoch);
+        auto [index, found] = _tree->find_index(key, node);
+
+        if (found)
+            return node.keys[index].second;
+
+        position = node._is_leaf ? static_cast<size_t>(-1) : node.pointers[index];
+    }
+
+    return std::nullopt;
+}
+
+template<serializable tkey, serializable tvalue, compator<tkey> compare, std::size_t t>
+template<std::invocable<const std::pair<tkey, tvalue> &> F>
+void B_tree_disk<tkey, tvalue, compare, t>::btree_disk_snapshot::for_each(F &&visit) const {
+    if (_root == static_cast<size_t>(-1))
+        return;
+
+    // Узел и номер следующего потомка для каждого уровня пути
+    std::vector<std::pair<btree_disk_node, size_t>> path;
+    path.emplace_back(_tree->snapshot_read(_root, _epoch), 0);
+
+    while (!path.empty()) {
+        auto &[node, index] = path.back();
+
+        if (node._is_leaf) {
+            for (auto &data: node.keys)
+                visit(data);
+            path.pop_back();
+            continue;
+        }
+
+        if (index > node.size) {
+            path.pop_back();
+            continue;
+        }
+
+        if (index > 0)
+            visit(node.keys[index - 1]);
+
+        size_t child = node.pointers[index++];
+        path.emplace_back(_tree->snapshot_read(child, _epoch), 0);
+    }
+}
+
+template<serializable tkey, serializable tvalue, compator<tkey> compare, std::size_t t>
+size_t B_tree_disk<tkey, tvalue, compare, t>::btree_disk_snapshot::root() const noexcept {
+    return _root;
+}
+
 template<serializable tkey, serializable tvalue, compator<tkey> compare, std::size_t t>
 std::optional<tvalue> B_tree_disk<tkey, tvalue, compare, t>::at(const tkey &key) {
+    std::shared_lock lock(_latches->tree);
+
+    if (!may_contain(key))
+        return std::nullopt;
+
     auto [path, result] = find_path(key);
     auto [index, found] = result;
 
@@ -1386,10 +3365,61 @@ std::optional<tvalue> B_tree_disk<tkey, tvalue, compare, t>::at(const tkey &key)
         return std::nullopt;
     }
 
-    size_t current_position = path.top().first;
-    btree_disk_node current_node = disk_read(current_position);
+    return _pool.pin(*this, path.top().first)->keys[index].second;
+}
+
+template<serializable tkey, serializable tvalue, compator<tkey> compare, std::size_t t>
+void B_tree_disk<tkey, tvalue, compare, t>::at_batch(std::span<const tkey> keys,
+                                                     std::span<std::optional<tvalue>> values) {
+    if (keys.size() != values.size())
+        throw std::invalid_argument("at_batch: keys and values differ in size");
 
-    return current_node.keys[index].second;
+    std::shared_lock lock(_latches->tree);
+
+    std::fill(values.begin(), values.end(), std::nullopt);
+
+    if (_position_root == static_cast<size_t>(-1))
+        return;
+
+    // Группы ограничены глубиной очереди, чтобы прочитанные заранее страницы не занимали много памяти
+    const size_t group = async_page_reader::default_queue_depth;
+
+    std::vector<size_t> positions;
+    std::vector<size_t> pending;
+
+    for (size_t first = 0; first < keys.size(); first += group) {
+        size_t last = std::min(keys.size(), first + group);
+
+        pending.clear();
+        for (size_t i = first; i < last; ++i) {
+            if (may_contain(keys[i]))
+                pending.push_back(i);
+        }
+        positions.assign(pending.size(), _position_root);
+
+        // Каждый проход спускает все ключи группы на уровень ниже
+        while (!pending.empty()) {
+            prefetch_pages(positions);
+
+            size_t kept = 0;
+
+            for (size_t j = 0; j < pending.size(); ++j) {
+                size_t i = pending[j];
+                auto node = _pool.pin(*this, positions[j]);
+                auto [index, found] = find_index(keys[i], *node);
+
+                if (found) {
+                    values[i] = node->keys[index].second;
+                } else if (!node->_is_leaf) {
+                    positions[kept] = node->pointers[index];
+                    pending[kept++] = i;
+                }
+            }
+
+            pending.resize(kept);
+            positions.resize(kept);
+        }
+    }
 }
 
 
@@ -0,0 +1,71 @@
+#ifndef B_TREE_DISK_BLOOM_FILTER_HPP
+#define B_TREE_DISK_BLOOM_FILTER_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string>
+#include <vector>
+
+/**
+ * Filter of B_tree_disk keys answering most lookups of missing keys without reading tree
+ */
+struct bloom_options {
+    bool enabled = false;
+
+    /* About 1.3% of missing keys pass filter at 10 bits per key, 0.5% at 12 */
+    size_t bits_per_key = 10;
+};
+
+/**
+ * Split block Bloom filter. Each key sets one bit in each of 8 words of one 32-byte block, so check reads single
+ * block. Keys can not be removed, erased keys pass filter until it is rebuilt.
+ *
+ * Filter is saved to its own file stamped by caller, file with other stamp is not loaded
+ */
+class bloom_filter final {
+    static constexpr const size_t words_in_block = 8;
+
+    std::vector<uint32_t> _words;
+    size_t _capacity;
+    size_t _added;
+
+public:
+    bloom_filter() noexcept;
+
+    /*
+     * Filter for capacity keys, bits are rounded up to whole blocks
+     */
+    bloom_filter(size_t capacity, size_t bits_per_key);
+
+    static uint64_t hash(std::span<const char> bytes) noexcept;
+
+    /*
+     * Filter without blocks ignores keys
+     */
+    void add(uint64_t hash) noexcept;
+
+    /*
+     * Filter without blocks may contain anything
+     */
+    bool may_contain(uint64_t hash) const noexcept;
+
+    size_t capacity() const noexcept;
+
+    /*
+     * Keys added since filter was built, erased ones included
+     */
+    size_t added() const noexcept;
+
+    /*
+     * Writes filter to new file which replaces previous one
+     */
+    void save(const std::string &path, size_t page_size, uint64_t stamp) const;
+
+    /*
+     * False if file is missing, damaged or has other stamp, filter stays as it was then
+     */
+    bool load(const std::string &path, size_t page_size, uint64_t stamp);
+};
+
+#endif //B_TREE_DISK_BLOOM_FILTER_HPP
@@ -0,0 +1,433 @@
+#ifndef B_TREE_DISK_BUFFER_POOL_HPP
+#define B_TREE_DISK_BUFFER_POOL_HPP
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+/**
+ * Frames caching pages of some storage. Page stays in its frame while pinned, unpinned pages are evicted by CLOCK,
+ * so pages used over and over (upper levels of tree above all) stay in memory. Writing page only marks its frame
+ * dirty. Dirty pages reach storage in batches sorted by page id, when eviction meets one of them or on flush.
+ * Without steal dirty pages are never evicted and reach storage only on flush, pool grows over capacity instead.
+ *
+ * Pool is latched inside, so several threads may pin pages at once. Page missing from pool is loaded outside of latch,
+ * threads pinning the same page meanwhile wait for it, so readers missing different pages read them in parallel.
+ * Pinned page itself is not latched: pages must not be changed while other threads read them.
+ *
+ * Storage is passed to every call which may do I/O and has to provide
+ *     page_type load_page(size_t id);
+ *     void store_page(size_t id, const page_type& page);
+ * load_page may be called by several threads at once, store_page is called under latch of pool
+ */
+template<typename page_type>
+class buffer_pool {
+    static constexpr const size_t no_page = static_cast<size_t>(-1);
+
+    struct frame {
+        size_t id = no_page;
+        page_type page;
+        std::atomic<size_t> pins = 0;
+        bool dirty = false;
+        bool referenced = false;
+        bool loading = false;
+
+        frame() = default;
+
+        frame(frame &&other) noexcept : id(other.id), page(std::move(other.page)), pins(other.pins.load()),
+                                        dirty(other.dirty), referenced(other.referenced), loading(other.loading) {
+        }
+    };
+
+    /* Deque keeps frames in place when pool grows */
+    std::deque<frame> _frames;
+    std::unordered_map<size_t, frame *> _index;
+    size_t _capacity;
+    size_t _hand;
+    size_t _hits;
+    size_t _misses;
+    bool _steal;
+
+    /* Latch lives apart from pool, so that pool stays movable */
+    std::unique_ptr<std::mutex> _latch;
+    std::unique_ptr<std::condition_variable> _loaded;
+
+public:
+    class pinned_page {
+        frame *_frame;
+
+        friend class buffer_pool;
+
+        explicit pinned_page(frame *f) noexcept;
+
+    public:
+        pinned_page(pinned_page &&other) noexcept;
+
+        pinned_page &operator=(pinned_page &&other) noexcept;
+
+        pinned_page(const pinned_page &) = delete;
+
+        pinned_page &operator=(const pinned_page &) = delete;
+
+        ~pinned_page() noexcept;
+
+        page_type &operator*() const noexcept;
+
+        page_type *operator->() const noexcept;
+
+        /*
+         * Page changed in place is written back before its frame is reused
+         */
+        void mark_dirty() noexcept;
+    };
+
+    /*
+     * Pool grows over capacity only while every frame is pinned
+     */
+    explicit buffer_pool(size_t capacity);
+
+    /*
+     * Loads page on miss. If loading throws, page stays missing and the error goes to the caller
+     */
+    template<typename storage>
+    pinned_page pin(storage &source, size_t id);
+
+    /*
+     * Replaces cached page or caches new one without loading it, page becomes dirty
+     */
+    template<typename storage>
+    void put(storage &source, size_t id, page_type page);
+
+    /*
+     * Writes all dirty pages in order of their ids
+     */
+    template<typename storage>
+    void flush(storage &source);
+
+    /*
+     * Forgets page without writing it back
+     */
+    void discard(size_t id) noexcept;
+
+    /*
+     * Forgets all pages, none of them may be pinned
+     */
+    void clear() noexcept;
+
+    /*
+     * Drops clean frames over capacity, does nothing while some page is pinned
+     */
+    void trim();
+
+    void set_steal(bool steal) noexcept;
+
+    bool contains(size_t id) const noexcept;
+
+    size_t capacity() const noexcept;
+
+    size_t size() const noexcept;
+
+    size_t hits() const noexcept;
+
+    size_t misses() const noexcept;
+
+private:
+    /*
+     * Empty frame, evicting unpinned page not referenced since the hand passed it last time
+     */
+    template<typename storage>
+    frame &acquire_frame(storage &source);
+
+    template<typename storage>
+    void write_back(storage &source);
+};
+
+// region pinned_page implementation
+
+template<typename page_type>
+buffer_pool<page_type>::pinned_page::pinned_page(frame *f) noexcept : _frame(f) {
+    ++_frame->pins;
+}
+
+template<typename page_type>
+buffer_pool<page_type>::pinned_page::pinned_page(pinned_page &&other) noexcept : _frame(std::exchange(other._frame, nullptr)) {
+}
+
+template<typename page_type>
+typename buffer_pool<page_type>::pinned_page &buffer_pool<page_type>::pinned_page::operator=(pinned_page &&other) noexcept {
+    if (this != &other) {
+        if (_frame != nullptr)
+            --_frame->pins;
+        _frame = std::exchange(other._frame, nullptr);
+    }
+    return *this;
+}
+
+template<typename page_type>
+buffer_pool<page_type>::pinned_page::~pinned_page() noexcept {
+    if (_frame != nullptr)
+        --_frame->pins;
+}
+
+template<typename page_type>
+page_type &buffer_pool<page_type>::pinned_page::operator*() const noexcept {
+    return _frame->page;
+}
+
+template<typename page_type>
+page_type *buffer_pool<page_type>::pinned_page::operator->() const noexcept {
+    return &_frame->page;
+}
+
+template<typename page_type>
+void buffer_pool<page_type>::pinned_page::mark_dirty() noexcept {
+    _frame->dirty = true;
+}
+
+// endregion pinned_page implementation
+
+// region buffer_pool implementation
+
+template<typename page_type>
+buffer_pool<page_type>::buffer_pool(size_t capacity) : _capacity(std::max<size_t>(capacity, 1)), _hand(0), _hits(0),
+                                                       _misses(0), _steal(true), _latch(std::make_unique<std::mutex>()),
+                                                       _loaded(std::make_unique<std::condition_variable>()) {
+}
+
+template<typename page_type>
+template<typename storage>
+typename buffer_pool<page_type>::pinned_page buffer_pool<page_type>::pin(storage &source, size_t id) {
+    std::unique_lock lock(*_latch);
+
+    auto it = _index.find(id);
+
+    // Frame may be freed while its page fails to load, so it is looked up again after waiting
+    while (it != _index.end() && it->second->loading) {
+        _loaded->wait(lock);
+        it = _index.find(id);
+    }
+
+    if (it != _index.end()) {
+        ++_hits;
+        it->second->referenced = true;
+        return pinned_page(it->second);
+    }
+
+    ++_misses;
+    frame &f = acquire_frame(source);
+    f.id = id;
+    f.referenced = true;
+    f.loading = true;
+    _index.emplace(id, &f);
+
+    // Pin keeps frame from eviction while page is read without latch
+    pinned_page pinned(&f);
+    lock.unlock();
+
+    try {
+        page_type page = source.load_page(id);
+
+        lock.lock();
+        f.page = std::move(page);
+    } catch (...) {
+        if (!lock.owns_lock())
+            lock.lock();
+
+        _index.erase(id);
+        f.id = no_page;
+        f.referenced = false;
+        f.loading = false;
+        _loaded->notify_all();
+        throw;
+    }
+
+    f.loading = false;
+    _loaded->notify_all();
+    return pinned;
+}
+
+template<typename page_type>
+template<typename storage>
+void buffer_pool<page_type>::put(storage &source, size_t id, page_type page) {
+    std::lock_guard lock(*_latch);
+
+    auto it = _index.find(id);
+    frame *f = it != _index.end() ? it->second : nullptr;
+
+    if (f == nullptr) {
+        f = &acquire_frame(source);
+        f->page = std::move(page);
+        f->id = id;
+        _index.emplace(id, f);
+    } else {
+        f->page = std::move(page);
+    }
+
+    f->dirty = true;
+    f->referenced = true;
+}
+
+template<typename page_type>
+template<typename storage>
+void buffer_pool<page_type>::flush(storage &source) {
+    std::lock_guard lock(*_latch);
+    write_back(source);
+}
+
+template<typename page_type>
+void buffer_pool<page_type>::discard(size_t id) noexcept {
+    std::lock_guard lock(*_latch);
+
+    auto it = _index.find(id);
+
+    if (it == _index.end())
+        return;
+
+    // Кадр освобождается, даже если страница закреплена: вытеснение его пропустит, пока закрепление не снимут
+    it->second->id = no_page;
+    it->second->dirty = false;
+    it->second->referenced = false;
+    _index.erase(it);
+}
+
+template<typename page_type>
+void buffer_pool<page_type>::clear() noexcept {
+    std::lock_guard lock(*_latch);
+
+    _frames.clear();
+    _index.clear();
+    _hand = 0;
+}
+
+template<typename page_type>
+void buffer_pool<page_type>::trim() {
+    std::lock_guard lock(*_latch);
+
+    if (_frames.size() <= _capacity)
+        return;
+
+    // Frames move, so pinned pages would dangle
+    for (auto &f: _frames) {
+        if (f.pins != 0)
+            return;
+    }
+
+    std::deque<frame> kept;
+    size_t excess = _frames.size() - _capacity;
+
+    // Frames added over capacity hold most recent pages, so the oldest clean frames go first
+    for (auto &f: _frames) {
+        if (excess != 0 && !f.dirty) {
+            --excess;
+            continue;
+        }
+        kept.push_back(std::move(f));
+    }
+
+    _frames = std::move(kept);
+    _index.clear();
+    _hand = 0;
+
+    for (auto &f: _frames) {
+        if (f.id != no_page)
+            _index.emplace(f.id, &f);
+    }
+}
+
+template<typename page_type>
+void buffer_pool<page_type>::set_steal(bool steal) noexcept {
+    std::lock_guard lock(*_latch);
+    _steal = steal;
+}
+
+template<typename page_type>
+bool buffer_pool<page_type>::contains(size_t id) const noexcept {
+    std::lock_guard lock(*_latch);
+    return _index.contains(id);
+}
+
+template<typename page_type>
+size_t buffer_pool<page_type>::capacity() const noexcept {
+    return _capacity;
+}
+
+template<typename page_type>
+size_t buffer_pool<page_type>::size() const noexcept {
+    std::lock_guard lock(*_latch);
+    return _index.size();
+}
+
+template<typename page_type>
+size_t buffer_pool<page_type>::hits() const noexcept {
+    std::lock_guard lock(*_latch);
+    return _hits;
+}
+
+template<typename page_type>
+size_t buffer_pool<page_type>::misses() const noexcept {
+    std::lock_guard lock(*_latch);
+    return _misses;
+}
+
+template<typename page_type>
+template<typename storage>
+typename buffer_pool<page_type>::frame &buffer_pool<page_type>::acquire_frame(storage &source) {
+    if (_frames.size() < _capacity)
+        return _frames.emplace_back();
+
+    // Two turns clear every reference bit, so finding nothing means every frame is pinned
+    for (size_t step = 0; step < 2 * _frames.size(); ++step) {
+        frame &f = _frames[_hand];
+        _hand = (_hand + 1) % _frames.size();
+
+        if (f.pins != 0 || (f.dirty && !_steal))
+            continue;
+
+        if (f.referenced && f.id != no_page) {
+            f.referenced = false;
+            continue;
+        }
+
+        // Victim is dirty, so others are likely dirty too and are written along with it
+        if (f.dirty)
+            write_back(source);
+
+        if (f.id != no_page)
+            _index.erase(f.id);
+        f.id = no_page;
+        return f;
+    }
+
+    return _frames.emplace_back();
+}
+
+template<typename page_type>
+template<typename storage>
+void buffer_pool<page_type>::write_back(storage &source) {
+    std::vector<frame *> dirty;
+
+    for (auto &f: _frames) {
+        if (f.dirty && f.id != no_page)
+            dirty.push_back(&f);
+    }
+
+    std::sort(dirty.begin(), dirty.end(), [](const frame *lhs, const frame *rhs) {
+        return lhs->id < rhs->id;
+    });
+
+    for (frame *f: dirty) {
+        source.store_page(f->id, f->page);
+        f->dirty = false;
+    }
+}
+
+// endregion buffer_pool implementation
+
+#endif //B_TREE_DISK_BUFFER_POOL_HPP
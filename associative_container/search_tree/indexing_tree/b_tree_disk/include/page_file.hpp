@@ -0,0 +1,74 @@
+#ifndef B_TREE_DISK_PAGE_FILE_HPP
+#define B_TREE_DISK_PAGE_FILE_HPP
+
+#include <cstddef>
+#include <span>
+#include <string>
+
+/**
+ * File read and written in whole pages of fixed size, page id times page size being offset of page. Every transfer
+ * is page-aligned, so the file may be opened with O_DIRECT where buffers are aligned as well. Reading page past end
+ * of file gives zeros. I/O errors are thrown as std::system_error
+ */
+class page_file final {
+    int _fd;
+    size_t _page_size;
+
+public:
+    page_file() noexcept;
+
+    /*
+     * Opens file, creating it if not exists
+     */
+    page_file(const std::string &path, size_t page_size);
+
+    page_file(page_file &&other) noexcept;
+
+    page_file &operator=(page_file &&other) noexcept;
+
+    page_file(const page_file &) = delete;
+
+    page_file &operator=(const page_file &) = delete;
+
+    ~page_file() noexcept;
+
+    bool is_open() const noexcept;
+
+    /*
+     * File descriptor for I/O issued past this class, -1 when closed
+     */
+    int native_handle() const noexcept;
+
+    size_t page_size() const noexcept;
+
+    /*
+     * Page size may change only while nothing was read or written with the old one
+     */
+    void set_page_size(size_t page_size) noexcept;
+
+    /*
+     * Pages in file, counting last partial one
+     */
+    size_t page_count() const;
+
+    /*
+     * Span may cover several consecutive pages starting from id
+     */
+    void read_page(size_t id, std::span<char> page) const;
+
+    void write_page(size_t id, std::span<const char> page);
+
+    /*
+     * Waits until written pages reach the device
+     */
+    void sync();
+
+    /*
+     * Cuts file to given number of pages
+     */
+    void truncate(size_t pages);
+
+    void close() noexcept;
+};
+
+#endif //B_TREE_DISK_PAGE_FILE_HPP
@@ -0,0 +1,26 @@
+#ifndef B_TREE_DISK_SHARED_LATCH_HPP
+#define B_TREE_DISK_SHARED_LATCH_HPP
+
+#include <mutex>
+#include <shared_mutex>
+
+/**
+ * Latch taken by many readers or one writer, usable with std::shared_lock and std::unique_lock. Unlike bare
+ * std::shared_mutex, which lets readers coming one after another keep writer waiting forever on some systems, writer
+ * waiting for latch stops new readers from taking it
+ */
+class shared_latch final {
+    std::mutex _turnstile;
+    std::shared_mutex _latch;
+
+public:
+    void lock();
+
+    void unlock();
+
+    void lock_shared();
+
+    void unlock_shared();
+};
+
+#endif //B_TREE_DISK_SHARED_LATCH_HPP
@@ -0,0 +1,133 @@
+#ifndef B_TREE_DISK_SLOTTED_PAGE_HPP
+#define B_TREE_DISK_SLOTTED_PAGE_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <streambuf>
+#include <type_traits>
+#include <vector>
+
+/**
+ * Layout of pages of B_tree_disk file. Page 0 holds file header, any other page is node or overflow page.
+ *
+ *     node page:      kind | flags | prefix size | count | cells begin | child ids (internal node only) |
+ *                     cell offsets | ... | cells | key prefix
+ *     packed node:    kind | count | data end | child ids (internal node only) | keys | values
+ *     overflow page:  kind | used bytes | next overflow page | bytes
+ *     free list page: kind | count | next free list page | free page ids
+ *
+ * Cells are packed from the end of page towards directory of their offsets, and directory lists them in key order.
+ * Cell holds serialized key and value, or their length and first page of overflow chain when they are larger than
+ * inline limit. Limit is chosen so that node with one key more than maximum still fits, which split relies on.
+ *
+ * Keys of prefix_compressible type share prefix of their bytes, which is stored once at the end of page, and
+ * their cells hold key suffix size, key suffix and serialized value. Inline limit is then taken for page without
+ * prefix, so every cell which fits uncompressed fits compressed as well.
+ *
+ * Packed node is written instead when keys and values are stored as raw bytes of fixed width, and node with one
+ * key more than maximum fits in page. Keys and values then lie in two arrays copied without any parsing
+ */
+namespace __detail {
+    enum class disk_page_kind : uint8_t {
+        leaf = 1,
+        internal = 2,
+        overflow = 3,
+        free_list = 4,
+        packed_leaf = 5,
+        packed_internal = 6
+    };
+
+    struct disk_file_header {
+        static constexpr const uint64_t expected_magic = 0x31304B5349445442ull; // "BTDISK01"
+
+        uint64_t magic;
+        uint64_t page_size;
+        uint64_t page_count;
+        uint64_t root;
+        /* Records of other generations found in write-ahead log are stale */
+        uint64_t log_generation;
+        /* First page of free list, 0 when there are no free pages */
+        uint64_t free_list;
+        /* Stamp of key filter saved with this header, 0 when there is none */
+        uint64_t filter_stamp;
+    };
+
+    inline constexpr const size_t node_page_header_size = 12;
+    inline constexpr const size_t overflow_page_header_size = 16;
+    inline constexpr const size_t free_list_page_header_size = 16;
+    inline constexpr const size_t cell_header_size = 5;
+    inline constexpr const size_t overflow_cell_size = cell_header_size + sizeof(uint64_t);
+
+    inline constexpr const uint8_t cell_inline = 0;
+    inline constexpr const uint8_t cell_overflow = 1;
+
+    /* Flag of node page with key prefix, its size is at offset 2 */
+    inline constexpr const uint8_t node_key_prefix = 1;
+
+    template<typename T> requires std::is_trivially_copyable_v<T>
+    T load_at(const char *page, size_t offset) noexcept {
+        T value;
+        std::memcpy(&value, page + offset, sizeof(T));
+        return value;
+    }
+
+    template<typename T> requires std::is_trivially_copyable_v<T>
+    void store_at(char *page, size_t offset, T value) noexcept {
+        std::memcpy(page + offset, &value, sizeof(T));
+    }
+
+    /*
+     * Largest cell payload kept inline in node of keys_count keys, 0 if page is too small even for overflow cells
+     */
+    constexpr size_t inline_cell_limit(size_t page_size, size_t keys_count) noexcept {
+        size_t fixed = node_page_header_size + (keys_count + 1) * sizeof(uint64_t) + keys_count * sizeof(uint32_t);
+
+        if (page_size < fixed + keys_count * overflow_cell_size)
+            return 0;
+
+        return (page_size - fixed) / keys_count - cell_header_size;
+    }
+
+    /*
+     * Largest key prefix leaving inline limit of keys_count keys at least 8 bytes, so overflow cells still fit
+     */
+    constexpr size_t max_key_prefix_size(size_t page_size, size_t keys_count) noexcept {
+        size_t fixed = node_page_header_size + (keys_count + 1) * sizeof(uint64_t) + keys_count * sizeof(uint32_t) +
+                       keys_count * overflow_cell_size;
+
+        return page_size > fixed ? std::min<size_t>(page_size - fixed, UINT16_MAX) : 0;
+    }
+
+    constexpr size_t packed_node_size(size_t keys_count, bool is_leaf, size_t key_size, size_t value_size) noexcept {
+        return node_page_header_size + (is_leaf ? 0 : (keys_count + 1) * sizeof(uint64_t)) +
+               keys_count * (key_size + value_size);
+    }
+
+    /**
+     * Output buffer appending to vector, so that serialize(std::fstream&) writes to memory once stream is rebound
+     * to it with std::ios::rdbuf
+     */
+    class vector_output_buffer final : public std::streambuf {
+        std::vector<char> &_bytes;
+
+    public:
+        explicit vector_output_buffer(std::vector<char> &bytes) noexcept : _bytes(bytes) {
+        }
+
+    protected:
+        std::streamsize xsputn(const char *data, std::streamsize count) override {
+            _bytes.insert(_bytes.end(), data, data + count);
+            return count;
+        }
+
+        int_type overflow(int_type c) override {
+            if (!traits_type::eq_int_type(c, traits_type::eof()))
+                _bytes.push_back(traits_type::to_char_type(c));
+            return traits_type::not_eof(c);
+        }
+    };
+}
+
+#endif //B_TREE_DISK_SLOTTED_PAGE_HPP
@@ -0,0 +1,84 @@
+#ifndef B_TREE_DISK_WRITE_AHEAD_LOG_HPP
+#define B_TREE_DISK_WRITE_AHEAD_LOG_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string>
+#include <vector>
+#include <page_file.hpp>
+
+/**
+ * Durability settings of B_tree_disk
+ */
+struct wal_options {
+    /* Without log nodes are written in place on eviction and flush, so crash may leave tree corrupted */
+    bool enabled = true;
+
+    /* Operations logged per fsync of log, operations of group not committed yet are lost on crash */
+    size_t group_commit = 1024;
+
+    /* Log grown over this many bytes is checkpointed and truncated */
+    size_t checkpoint_bytes = size_t(16) << 20;
+};
+
+struct wal_record {
+    uint8_t kind;
+    std::vector<char> payload;
+};
+
+/**
+ * Append-only log of records checked by CRC-32. Records are buffered in memory until commit, which writes them
+ * and waits for fsync, so one fsync makes durable the whole group appended since previous commit. Commit pads log
+ * to page boundary, so pages with committed records are never written again and torn write may lose only records
+ * of commit in progress.
+ *
+ * Every record is tagged with generation of log. Log is truncated when new generation starts, and records of other
+ * generations left by truncation which did not reach disk are skipped on reading.
+ */
+class write_ahead_log final {
+    page_file _file;
+    uint64_t _generation;
+
+    /* Records not written yet, they start at page _tail_page of file */
+    std::vector<char> _tail;
+    size_t _tail_page;
+
+public:
+    static constexpr const size_t record_header_size = 17;
+
+    write_ahead_log() noexcept;
+
+    /*
+     * Opens log, creating it if not exists
+     */
+    write_ahead_log(const std::string &path, size_t page_size);
+
+    bool is_open() const noexcept;
+
+    /*
+     * Records of given generation from start of log up to first damaged one, records appended from now on follow
+     * them and are tagged with that generation
+     */
+    std::vector<wal_record> recover(uint64_t generation);
+
+    /*
+     * Drops all records, new ones are tagged with given generation
+     */
+    void restart(uint64_t generation);
+
+    void append(uint8_t kind, std::span<const char> payload);
+
+    void commit();
+
+    /*
+     * Bytes written since restart, committed or not
+     */
+    size_t size() const noexcept;
+
+    bool has_uncommitted() const noexcept;
+
+    void close() noexcept;
+};
+
+#endif //B_TREE_DISK_WRITE_AHEAD_LOG_HPP
@@ -0,0 +1,472 @@
+#include "../include/async_page_reader.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <condition_variable>
+#include <cstring>
+#include <exception>
+#include <mutex>
+#include <system_error>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#if defined(__linux__) && __has_include(<linux/io_uring.h>)
+#define B_TREE_DISK_HAS_IO_URING 1
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace
+{
+#ifdef B_TREE_DISK_HAS_IO_URING
+    /*
+     * Bare io_uring over system calls, so that no liburing is needed
+     */
+    class uring final
+    {
+        int _fd;
+        unsigned _entries;
+
+        void *_sq_ring;
+        size_t _sq_ring_size;
+        void *_cq_ring;
+        size_t _cq_ring_size;
+        io_uring_sqe *_sqes;
+        size_t _sqes_size;
+
+        unsigned *_sq_tail;
+        unsigned *_sq_mask;
+        unsigned *_sq_array;
+        unsigned *_cq_head;
+        unsigned *_cq_tail;
+        unsigned *_cq_mask;
+        io_uring_cqe *_cqes;
+
+    public:
+        explicit uring(unsigned entries) : _fd(-1), _sq_ring(MAP_FAILED), _cq_ring(MAP_FAILED), _sqes(nullptr)
+        {
+            io_uring_params params{};
+
+            _fd = static_cast<int>(::syscall(__NR_io_uring_setup, entries, &params));
+
+            if (_fd < 0)
+            {
+                throw std::system_error(errno, std::generic_category(), "cannot set up io_uring");
+            }
+
+            _entries = params.sq_entries;
+            _sq_ring_size = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+            _cq_ring_size = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+
+            bool single_mmap = (params.features & IORING_FEAT_SINGLE_MMAP) != 0;
+
+            if (single_mmap)
+            {
+                _sq_ring_size = _cq_ring_size = std::max(_sq_ring_size, _cq_ring_size);
+            }
+
+            _sq_ring = ::mmap(nullptr, _sq_ring_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, _fd,
+                              IORING_OFF_SQ_RING);
+            _cq_ring = single_mmap
+                       ? _sq_ring
+                       : ::mmap(nullptr, _cq_ring_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, _fd,
+                                IORING_OFF_CQ_RING);
+
+            _sqes_size = params.sq_entries * sizeof(io_uring_sqe);
+            void *sqes = ::mmap(nullptr, _sqes_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, _fd,
+                                IORING_OFF_SQES);
+
+            if (sqes != MAP_FAILED)
+            {
+                _sqes = static_cast<io_uring_sqe *>(sqes);
+            }
+
+            if (_sq_ring == MAP_FAILED || _cq_ring == MAP_FAILED || sqes == MAP_FAILED)
+            {
+                int error = errno;
+                release();
+                throw std::system_error(error, std::generic_category(), "cannot map io_uring");
+            }
+
+            auto *sq = static_cast<char *>(_sq_ring);
+            auto *cq = static_cast<char *>(_cq_ring);
+
+            _sq_tail = reinterpret_cast<unsigned *>(sq + params.sq_off.tail);
+            _sq_mask = reinterpret_cast<unsigned *>(sq + params.sq_off.ring_mask);
+            _sq_array = reinterpret_cast<unsigned *>(sq + params.sq_off.array);
+            _cq_head = reinterpret_cast<unsigned *>(cq + params.cq_off.head);
+            _cq_tail = reinterpret_cast<unsigned *>(cq + params.cq_off.tail);
+            _cq_mask = reinterpret_cast<unsigned *>(cq + params.cq_off.ring_mask);
+            _cqes = reinterpret_cast<io_uring_cqe *>(cq + params.cq_off.cqes);
+        }
+
+        uring(const uring &) = delete;
+
+        uring &operator=(const uring &) = delete;
+
+        ~uring() noexcept
+        {
+            release();
+        }
+
+        void read(const page_file &file, std::span<const page_read> reads)
+        {
+            // Short reads (end of file) and kernels without IORING_OP_READ are finished synchronously
+            std::vector<size_t> retry;
+            int error = 0;
+            size_t next = 0;
+            size_t completed = 0;
+            size_t in_flight = 0;
+            unsigned unsubmitted = 0;
+
+            while (completed < next || (error == 0 && completed < reads.size()))
+            {
+                std::atomic_ref<unsigned> sq_tail(*_sq_tail);
+                unsigned tail = sq_tail.load(std::memory_order_relaxed);
+
+                // After error nothing new is submitted, but reads in flight still write to their pages
+                for (; error == 0 && next < reads.size() && in_flight < _entries;
+                       ++next, ++in_flight, ++unsubmitted, ++tail)
+                {
+                    unsigned index = tail & *_sq_mask;
+                    io_uring_sqe &sqe = _sqes[index];
+
+                    std::memset(&sqe, 0, sizeof(sqe));
+                    sqe.opcode = IORING_OP_READ;
+                    sqe.fd = file.native_handle();
+                    sqe.addr = reinterpret_cast<uint64_t>(reads[next].page.data());
+                    sqe.len = static_cast<uint32_t>(reads[next].page.size());
+                    sqe.off = reads[next].id * file.page_size();
+                    sqe.user_data = next;
+                    _sq_array[index] = index;
+                }
+
+                sq_tail.store(tail, std::memory_order_release);
+
+                int entered = static_cast<int>(::syscall(__NR_io_uring_enter, _fd, unsubmitted, 1,
+                                                         IORING_ENTER_GETEVENTS, nullptr, 0));
+
+                if (entered < 0)
+                {
+                    if (errno == EINTR)
+                    {
+                        continue;
+                    }
+
+                    // Entries kernel has not taken are dropped, taken ones still write to pages of this batch
+                    int failure = errno;
+                    sq_tail.store(tail - unsubmitted, std::memory_order_release);
+                    wait_for(in_flight - unsubmitted);
+
+                    throw std::system_error(failure, std::generic_category(), "cannot submit reads to io_uring");
+                }
+
+                unsubmitted -= static_cast<unsigned>(entered);
+
+                std::atomic_ref<unsigned> cq_head(*_cq_head);
+                std::atomic_ref<unsigned> cq_tail(*_cq_tail);
+                unsigned head = cq_head.load(std::memory_order_relaxed);
+                unsigned ready = cq_tail.load(std::memory_order_acquire);
+
+                for (; head != ready; ++head, ++completed, --in_flight)
+                {
+                    const io_uring_cqe &cqe = _cqes[head & *_cq_mask];
+                    size_t request = static_cast<size_t>(cqe.user_data);
+
+                    if (cqe.res == -EINVAL || cqe.res == -EOPNOTSUPP ||
+                        (cqe.res >= 0 && static_cast<size_t>(cqe.res) < reads[request].page.size()))
+                    {
+                        retry.push_back(request);
+                    } else if (cqe.res < 0 && error == 0)
+                    {
+                        error = -cqe.res;
+                    }
+                }
+
+                cq_head.store(head, std::memory_order_release);
+            }
+
+            if (error != 0)
+            {
+                throw std::system_error(error, std::generic_category(), "cannot read page");
+            }
+
+            for (size_t request: retry)
+            {
+                file.read_page(reads[request].id, reads[request].page);
+            }
+        }
+
+    private:
+        /*
+         * Reaps count completions of reads taken by kernel, so that ring is empty for next batch and pages may be freed
+         */
+        void wait_for(size_t count) noexcept
+        {
+            std::atomic_ref<unsigned> cq_head(*_cq_head);
+            std::atomic_ref<unsigned> cq_tail(*_cq_tail);
+
+            while (count != 0)
+            {
+                unsigned head = cq_head.load(std::memory_order_relaxed);
+                unsigned ready = cq_tail.load(std::memory_order_acquire);
+
+                if (head == ready)
+                {
+                    if (::syscall(__NR_io_uring_enter, _fd, 0, 1, IORING_ENTER_GETEVENTS, nullptr, 0) < 0 &&
+                        errno != EINTR)
+                    {
+                        std::this_thread::yield();
+                    }
+
+                    continue;
+                }
+
+                count -= std::min<size_t>(count, ready - head);
+                cq_head.store(ready, std::memory_order_release);
+            }
+        }
+
+        void release() noexcept
+        {
+            if (_sqes != nullptr)
+            {
+                ::munmap(_sqes, _sqes_size);
+            }
+
+            if (_cq_ring != MAP_FAILED && _cq_ring != _sq_ring)
+            {
+                ::munmap(_cq_ring, _cq_ring_size);
+            }
+
+            if (_sq_ring != MAP_FAILED)
+            {
+                ::munmap(_sq_ring, _sq_ring_size);
+            }
+
+            if (_fd >= 0)
+            {
+                ::close(_fd);
+            }
+        }
+    };
+#endif
+
+    /*
+     * Workers and calling thread take reads one by one, pread lets them share file descriptor
+     */
+    class read_pool final
+    {
+        std::vector<std::thread> _workers;
+        std::mutex _mutex;
+        std::condition_variable _wake;
+        std::condition_variable _finished;
+
+        const page_file *_file;
+        std::span<const page_read> _reads;
+        std::atomic<size_t> _next;
+        size_t _active;
+        uint64_t _batch;
+        bool _stop;
+        std::exception_ptr _error;
+
+    public:
+        explicit read_pool(size_t workers) : _file(nullptr), _next(0), _active(0), _batch(0), _stop(false)
+        {
+            for (size_t i = 0; i < workers; ++i)
+            {
+                _workers.emplace_back([this] { work(); });
+            }
+        }
+
+        read_pool(const read_pool &) = delete;
+
+        read_pool &operator=(const read_pool &) = delete;
+
+        ~read_pool() noexcept
+        {
+            {
+                std::lock_guard lock(_mutex);
+                _stop = true;
+            }
+
+            _wake.notify_all();
+
+            for (auto &worker: _workers)
+            {
+                worker.join();
+            }
+        }
+
+        void read(const page_file &file, std::span<const page_read> reads)
+        {
+            {
+                std::unique_lock lock(_mutex);
+
+                // Worker woken late for previous batch must not see reads of this one
+                _finished.wait(lock, [this] { return _active == 0; });
+
+                _file = &file;
+                _reads = reads;
+                _next.store(0);
+                _error = nullptr;
+                ++_batch;
+            }
+
+            _wake.notify_all();
+            drain(file, reads);
+
+            std::unique_lock lock(_mutex);
+            _finished.wait(lock, [this] { return _active == 0; });
+
+            if (_error)
+            {
+                std::rethrow_exception(std::exchange(_error, nullptr));
+            }
+        }
+
+    private:
+        void drain(const page_file &file, std::span<const page_read> reads)
+        {
+            for (size_t i = _next.fetch_add(1); i < reads.size(); i = _next.fetch_add(1))
+            {
+                try
+                {
+                    file.read_page(reads[i].id, reads[i].page);
+                } catch (...)
+                {
+                    std::lock_guard lock(_mutex);
+
+                    if (!_error)
+                    {
+                        _error = std::current_exception();
+                    }
+                }
+            }
+        }
+
+        void work()
+        {
+            uint64_t seen = 0;
+            std::unique_lock lock(_mutex);
+
+            while (true)
+            {
+                _wake.wait(lock, [&] { return _stop || _batch != seen; });
+
+                if (_stop)
+                {
+                    return;
+                }
+
+                seen = _batch;
+                const page_file *file = _file;
+                auto reads = _reads;
+                ++_active;
+
+                lock.unlock();
+                drain(*file, reads);
+                lock.lock();
+
+                --_active;
+                _finished.notify_all();
+            }
+        }
+    };
+}
+
+struct async_page_reader::backend
+{
+#ifdef B_TREE_DISK_HAS_IO_URING
+    std::unique_ptr<uring> ring;
+#endif
+    std::unique_ptr<read_pool> pool;
+};
+
+async_page_reader::async_page_reader(size_t queue_depth) noexcept : _queue_depth(std::max<size_t>(queue_depth, 1))
+{
+}
+
+async_page_reader::async_page_reader(async_page_reader &&other) noexcept = default;
+
+async_page_reader &async_page_reader::operator=(async_page_reader &&other) noexcept = default;
+
+async_page_reader::~async_page_reader() noexcept = default;
+
+void async_page_reader::read(const page_file &file, std::span<const page_read> reads)
+{
+    if (reads.size() < 2)
+    {
+        for (auto &read: reads)
+        {
+            file.read_page(read.id, read.page);
+        }
+        return;
+    }
+
+    if (!_backend)
+    {
+        _backend = std::make_unique<backend>();
+        bool has_ring = false;
+
+#ifdef B_TREE_DISK_HAS_IO_URING
+        try
+        {
+            _backend->ring = std::make_unique<uring>(static_cast<unsigned>(std::min<size_t>(_queue_depth, 4096)));
+            has_ring = true;
+        } catch (const std::system_error &)
+        {
+            // Kernel without io_uring, or seccomp forbids it, threads take over
+        }
+#endif
+
+#ifndef _WIN32
+        if (!has_ring)
+        {
+            size_t workers = std::clamp<size_t>(std::thread::hardware_concurrency(), 2, 8);
+            _backend->pool = std::make_unique<read_pool>(std::min(workers, _queue_depth));
+        }
+#endif
+    }
+
+#ifdef B_TREE_DISK_HAS_IO_URING
+    if (_backend->ring)
+    {
+        _backend->ring->read(file, reads);
+        return;
+    }
+#endif
+
+    if (_backend->pool)
+    {
+        _backend->pool->read(file, reads);
+        return;
+    }
+
+    // Reads on Windows move shared file position, so threads would get in each other's way
+    for (auto &read: reads)
+    {
+        file.read_page(read.id, read.page);
+    }
+}
+
+const char *async_page_reader::backend_name() const noexcept
+{
+    if (!_backend)
+    {
+        return "";
+    }
+
+#ifdef B_TREE_DISK_HAS_IO_URING
+    if (_backend->ring)
+    {
+        return "io_uring";
+    }
+#endif
+
+    return _backend->pool ? "threads" : "sync";
+}
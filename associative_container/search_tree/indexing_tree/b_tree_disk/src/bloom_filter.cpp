@@ -0,0 +1,172 @@
+#include "../include/bloom_filter.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+#include <page_file.hpp>
+
+namespace
+{
+    // Odd constants spreading one hash over the words of block
+    constexpr uint32_t salts[8] = {0x47b6137bu, 0x44974d91u, 0x8824ad5bu, 0xa2b7289du,
+                                   0x705495c7u, 0x2df1424bu, 0x9efc4947u, 0x5c6bfb31u};
+
+    constexpr uint64_t expected_magic = 0x31304D4F4F4C4254ull; // "TBLOOM01"
+
+    // File is magic | stamp | block count | capacity | added | words
+    constexpr size_t header_size = 5 * sizeof(uint64_t);
+
+    uint64_t mix(uint64_t value) noexcept
+    {
+        value ^= value >> 33;
+        value *= 0xff51afd7ed558ccdull;
+        value ^= value >> 33;
+        value *= 0xc4ceb9fe1a85ec53ull;
+        value ^= value >> 33;
+        return value;
+    }
+}
+
+bloom_filter::bloom_filter() noexcept : _capacity(0), _added(0)
+{
+}
+
+bloom_filter::bloom_filter(size_t capacity, size_t bits_per_key) : _capacity(capacity), _added(0)
+{
+    const size_t block_bits = words_in_block * 32;
+    size_t blocks = std::max<size_t>(1, (capacity * std::max<size_t>(bits_per_key, 1) + block_bits - 1) / block_bits);
+
+    _words.assign(blocks * words_in_block, 0);
+}
+
+uint64_t bloom_filter::hash(std::span<const char> bytes) noexcept
+{
+    uint64_t hash = 0x9e3779b97f4a7c15ull ^ bytes.size();
+    size_t i = 0;
+
+    for (; i + sizeof(uint64_t) <= bytes.size(); i += sizeof(uint64_t))
+    {
+        uint64_t word;
+        std::memcpy(&word, bytes.data() + i, sizeof(word));
+        hash = mix(hash ^ word);
+    }
+
+    if (i < bytes.size())
+    {
+        uint64_t word = 0;
+        std::memcpy(&word, bytes.data() + i, bytes.size() - i);
+        hash = mix(hash ^ word);
+    }
+
+    return mix(hash);
+}
+
+void bloom_filter::add(uint64_t hash) noexcept
+{
+    if (_words.empty())
+    {
+        return;
+    }
+
+    // High half picks block, low half picks bits inside it
+    size_t blocks = _words.size() / words_in_block;
+    uint32_t *block = _words.data() + ((hash >> 32) * blocks >> 32) * words_in_block;
+    auto key = static_cast<uint32_t>(hash);
+
+    for (size_t i = 0; i < words_in_block; ++i)
+    {
+        block[i] |= uint32_t(1) << ((key * salts[i]) >> 27);
+    }
+
+    ++_added;
+}
+
+bool bloom_filter::may_contain(uint64_t hash) const noexcept
+{
+    if (_words.empty())
+    {
+        return true;
+    }
+
+    size_t blocks = _words.size() / words_in_block;
+    const uint32_t *block = _words.data() + ((hash >> 32) * blocks >> 32) * words_in_block;
+    auto key = static_cast<uint32_t>(hash);
+
+    for (size_t i = 0; i < words_in_block; ++i)
+    {
+        if ((block[i] & (uint32_t(1) << ((key * salts[i]) >> 27))) == 0)
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+size_t bloom_filter::capacity() const noexcept
+{
+    return _capacity;
+}
+
+size_t bloom_filter::added() const noexcept
+{
+    return _added;
+}
+
+void bloom_filter::save(const std::string &path, size_t page_size, uint64_t stamp) const
+{
+    const size_t words_size = _words.size() * sizeof(uint32_t);
+    std::vector<char> bytes((header_size + words_size + page_size - 1) / page_size * page_size, '\0');
+
+    uint64_t header[5] = {expected_magic, stamp, _words.size() / words_in_block, _capacity, _added};
+    std::memcpy(bytes.data(), header, header_size);
+    std::memcpy(bytes.data() + header_size, _words.data(), words_size);
+
+    // Old filter stays whole until new one is on disk
+    std::string temporary = path + ".tmp";
+
+    {
+        page_file file(temporary, page_size);
+        file.truncate(0);
+        file.write_page(0, bytes);
+        file.sync();
+    }
+
+    std::filesystem::rename(temporary, path);
+}
+
+bool bloom_filter::load(const std::string &path, size_t page_size, uint64_t stamp)
+{
+    if (!std::filesystem::exists(path))
+    {
+        return false;
+    }
+
+    page_file file(path, page_size);
+    std::vector<char> bytes(file.page_count() * page_size);
+
+    if (bytes.size() < header_size)
+    {
+        return false;
+    }
+
+    file.read_page(0, bytes);
+
+    uint64_t header[5];
+    std::memcpy(header, bytes.data(), header_size);
+
+    const uint64_t blocks = header[2];
+
+    if (header[0] != expected_magic || header[1] != stamp || blocks == 0 ||
+        blocks > (bytes.size() - header_size) / (words_in_block * sizeof(uint32_t)))
+    {
+        return false;
+    }
+
+    _words.resize(blocks * words_in_block);
+    std::memcpy(_words.data(), bytes.data() + header_size, _words.size() * sizeof(uint32_t));
+    _capacity = header[3];
+    _added = header[4];
+
+    return true;
+}
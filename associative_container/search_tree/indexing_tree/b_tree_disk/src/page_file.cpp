@@ -0,0 +1,220 @@
+#include "../include/page_file.hpp"
+
+#include <algorithm>
+#include <cerrno>
+#include <system_error>
+#include <utility>
+
+#ifdef _WIN32
+#include <fcntl.h>
+#include <io.h>
+#include <sys/stat.h>
+#else
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace
+{
+    [[noreturn]] void throw_io_error(const char *what)
+    {
+        throw std::system_error(errno, std::generic_category(), what);
+    }
+
+#ifdef _WIN32
+    long long read_at(int fd, char *data, size_t bytes, size_t offset)
+    {
+        if (::_lseeki64(fd, static_cast<long long>(offset), SEEK_SET) < 0)
+        {
+            return -1;
+        }
+
+        return ::_read(fd, data, static_cast<unsigned>(bytes));
+    }
+
+    long long write_at(int fd, const char *data, size_t bytes, size_t offset)
+    {
+        if (::_lseeki64(fd, static_cast<long long>(offset), SEEK_SET) < 0)
+        {
+            return -1;
+        }
+
+        return ::_write(fd, data, static_cast<unsigned>(bytes));
+    }
+#else
+    long long read_at(int fd, char *data, size_t bytes, size_t offset)
+    {
+        return ::pread(fd, data, bytes, static_cast<off_t>(offset));
+    }
+
+    long long write_at(int fd, const char *data, size_t bytes, size_t offset)
+    {
+        return ::pwrite(fd, data, bytes, static_cast<off_t>(offset));
+    }
+#endif
+}
+
+page_file::page_file() noexcept : _fd(-1), _page_size(0)
+{
+}
+
+page_file::page_file(const std::string &path, size_t page_size) : _page_size(page_size)
+{
+#ifdef _WIN32
+    _fd = ::_open(path.c_str(), _O_RDWR | _O_CREAT | _O_BINARY, _S_IREAD | _S_IWRITE);
+#else
+    _fd = ::open(path.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+#endif
+
+    if (_fd < 0)
+    {
+        throw_io_error("cannot open page file");
+    }
+}
+
+page_file::page_file(page_file &&other) noexcept : _fd(std::exchange(other._fd, -1)), _page_size(other._page_size)
+{
+}
+
+page_file &page_file::operator=(page_file &&other) noexcept
+{
+    if (this != &other)
+    {
+        close();
+        _fd = std::exchange(other._fd, -1);
+        _page_size = other._page_size;
+    }
+
+    return *this;
+}
+
+page_file::~page_file() noexcept
+{
+    close();
+}
+
+bool page_file::is_open() const noexcept
+{
+    return _fd >= 0;
+}
+
+int page_file::native_handle() const noexcept
+{
+    return _fd;
+}
+
+size_t page_file::page_size() const noexcept
+{
+    return _page_size;
+}
+
+void page_file::set_page_size(size_t page_size) noexcept
+{
+    _page_size = page_size;
+}
+
+size_t page_file::page_count() const
+{
+#ifdef _WIN32
+    struct _stat64 info;
+
+    if (::_fstat64(_fd, &info) != 0)
+#else
+    struct stat info;
+
+    if (::fstat(_fd, &info) != 0)
+#endif
+    {
+        throw_io_error("cannot stat page file");
+    }
+
+    return (static_cast<size_t>(info.st_size) + _page_size - 1) / _page_size;
+}
+
+void page_file::read_page(size_t id, std::span<char> page) const
+{
+    size_t done = 0;
+
+    while (done < page.size())
+    {
+        long long got = read_at(_fd, page.data() + done, page.size() - done, id * _page_size + done);
+
+        if (got < 0)
+        {
+            if (errno == EINTR)
+            {
+                continue;
+            }
+
+            throw_io_error("cannot read page");
+        }
+
+        if (got == 0)
+        {
+            std::fill(page.begin() + done, page.end(), '\0');
+            return;
+        }
+
+        done += static_cast<size_t>(got);
+    }
+}
+
+void page_file::write_page(size_t id, std::span<const char> page)
+{
+    size_t done = 0;
+
+    while (done < page.size())
+    {
+        long long put = write_at(_fd, page.data() + done, page.size() - done, id * _page_size + done);
+
+        if (put < 0)
+        {
+            if (errno == EINTR)
+            {
+                continue;
+            }
+
+            throw_io_error("cannot write page");
+        }
+
+        done += static_cast<size_t>(put);
+    }
+}
+
+void page_file::sync()
+{
+#ifdef _WIN32
+    if (::_commit(_fd) != 0)
+#else
+    if (::fsync(_fd) != 0)
+#endif
+    {
+        throw_io_error("cannot sync page file");
+    }
+}
+
+void page_file::truncate(size_t pages)
+{
+#ifdef _WIN32
+    if (::_chsize_s(_fd, static_cast<long long>(pages * _page_size)) != 0)
+#else
+    if (::ftruncate(_fd, static_cast<off_t>(pages * _page_size)) != 0)
+#endif
+    {
+        throw_io_error("cannot truncate page file");
+    }
+}
+
+void page_file::close() noexcept
+{
+    if (_fd >= 0)
+    {
+#ifdef _WIN32
+        ::_close(_fd);
+#else
+        ::close(_fd);
+#endif
+        _fd = -1;
+    }
+}
@@ -0,0 +1,27 @@
+#include "../include/shared_latch.hpp"
+
+void shared_latch::lock()
+{
+    // Readers queue on turnstile while writer waits for readers inside to leave
+    std::lock_guard gate(_turnstile);
+    _latch.lock();
+}
+
+void shared_latch::unlock()
+{
+    _latch.unlock();
+}
+
+void shared_latch::lock_shared()
+{
+    {
+        std::lock_guard gate(_turnstile);
+    }
+
+    _latch.lock_shared();
+}
+
+void shared_latch::unlock_shared()
+{
+    _latch.unlock_shared();
+}
@@ -0,0 +1,195 @@
+#include "../include/write_ahead_log.hpp"
+
+#include <array>
+#include <cstring>
+
+namespace
+{
+    // Record is length | checksum | generation | kind | payload, checksum covers everything after itself
+    constexpr size_t length_offset = 0;
+    constexpr size_t checksum_offset = 4;
+    constexpr size_t generation_offset = 8;
+    constexpr size_t kind_offset = 16;
+
+    // Kind 0 is never appended, zero bytes mean padding up to next page
+    constexpr uint8_t padding_kind = 0;
+
+    constexpr std::array<uint32_t, 256> make_crc_table()
+    {
+        std::array<uint32_t, 256> table{};
+
+        for (uint32_t i = 0; i < 256; ++i)
+        {
+            uint32_t crc = i;
+
+            for (int bit = 0; bit < 8; ++bit)
+            {
+                crc = (crc & 1) ? (crc >> 1) ^ 0xEDB88320u : crc >> 1;
+            }
+
+            table[i] = crc;
+        }
+
+        return table;
+    }
+
+    constexpr auto crc_table = make_crc_table();
+
+    uint32_t crc32(const char *data, size_t size)
+    {
+        uint32_t crc = 0xFFFFFFFFu;
+
+        for (size_t i = 0; i < size; ++i)
+        {
+            crc = crc_table[(crc ^ static_cast<uint8_t>(data[i])) & 0xFF] ^ (crc >> 8);
+        }
+
+        return ~crc;
+    }
+
+    template<typename T>
+    T load(const char *data, size_t offset)
+    {
+        T value;
+        std::memcpy(&value, data + offset, sizeof(T));
+        return value;
+    }
+
+    template<typename T>
+    void store(char *data, size_t offset, T value)
+    {
+        std::memcpy(data + offset, &value, sizeof(T));
+    }
+}
+
+write_ahead_log::write_ahead_log() noexcept : _generation(0), _tail_page(0)
+{
+}
+
+write_ahead_log::write_ahead_log(const std::string &path, size_t page_size) : _file(path, page_size), _generation(0),
+                                                                              _tail_page(0)
+{
+}
+
+bool write_ahead_log::is_open() const noexcept
+{
+    return _file.is_open();
+}
+
+std::vector<wal_record> write_ahead_log::recover(uint64_t generation)
+{
+    const size_t page_size = _file.page_size();
+    std::vector<char> bytes(_file.page_count() * page_size);
+    std::vector<wal_record> records;
+
+    _file.read_page(0, bytes);
+
+    size_t position = 0;
+
+    while (position < bytes.size())
+    {
+        size_t left_in_page = page_size - position % page_size;
+
+        if (left_in_page < record_header_size ||
+            static_cast<uint8_t>(bytes[position + kind_offset]) == padding_kind)
+        {
+            position += left_in_page;
+            continue;
+        }
+
+        const char *header = bytes.data() + position;
+        size_t length = load<uint32_t>(header, length_offset);
+
+        if (bytes.size() - position - record_header_size < length ||
+            load<uint64_t>(header, generation_offset) != generation ||
+            load<uint32_t>(header, checksum_offset) != crc32(header + generation_offset,
+                                                             record_header_size - generation_offset + length))
+        {
+            break;
+        }
+
+        records.push_back({static_cast<uint8_t>(header[kind_offset]),
+                           std::vector<char>(header + record_header_size, header + record_header_size + length)});
+        position += record_header_size + length;
+    }
+
+    // Whatever follows is torn commit, cut so that it never shows up after records appended from now on.
+    // Commit pads its last page, so page holding both records and damage belongs to torn commit too
+    _generation = generation;
+    _tail_page = position / page_size;
+    _tail.assign(bytes.begin() + static_cast<std::ptrdiff_t>(_tail_page * page_size),
+                 bytes.begin() + static_cast<std::ptrdiff_t>(position));
+    _file.truncate(_tail_page);
+
+    return records;
+}
+
+void write_ahead_log::restart(uint64_t generation)
+{
+    _file.truncate(0);
+    _generation = generation;
+    _tail.clear();
+    _tail_page = 0;
+}
+
+void write_ahead_log::append(uint8_t kind, std::span<const char> payload)
+{
+    size_t position = _tail.size();
+
+    // Header never straddles pages, so that zero kind byte reliably marks padding
+    size_t left_in_page = _file.page_size() - position % _file.page_size();
+
+    if (left_in_page < record_header_size)
+    {
+        _tail.resize(position + left_in_page, '\0');
+        position += left_in_page;
+    }
+
+    _tail.resize(position + record_header_size + payload.size());
+
+    char *header = _tail.data() + position;
+    store(header, length_offset, static_cast<uint32_t>(payload.size()));
+    store(header, generation_offset, _generation);
+    header[kind_offset] = static_cast<char>(kind);
+
+    if (!payload.empty())
+    {
+        std::memcpy(header + record_header_size, payload.data(), payload.size());
+    }
+
+    store(header, checksum_offset, crc32(header + generation_offset,
+                                         record_header_size - generation_offset + payload.size()));
+}
+
+void write_ahead_log::commit()
+{
+    if (_tail.empty())
+    {
+        return;
+    }
+
+    const size_t page_size = _file.page_size();
+    size_t pages = (_tail.size() + page_size - 1) / page_size;
+    _tail.resize(pages * page_size, '\0');
+
+    // Pages go in one write, starting where previous commit ended
+    _file.write_page(_tail_page, _tail);
+    _file.sync();
+    _tail.clear();
+    _tail_page += pages;
+}
+
+size_t write_ahead_log::size() const noexcept
+{
+    return _tail_page * _file.page_size() + _tail.size();
+}
+
+bool write_ahead_log::has_uncommitted() const noexcept
+{
+    return !_tail.empty();
+}
+
+void write_ahead_log::close() noexcept
+{
+    _file.close();
+}
@@ -2,7 +2,757 @@
 // Created by Des Caldnd on 2/28/2025.
 //
 
-int main()
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <filesystem>
+#include <map>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+#include <b_tree_disk.hpp>
+
+namespace
+{
+    using disk_tree = B_tree_disk<SerializableInt, SerializableString, std::less<SerializableInt>, 3>;
+
+    /*
+     * Files of tree in temporary directory, removed both before and after test
+     */
+    class tree_files
+    {
+    public:
+
+        explicit tree_files(const std::string &name)
+            : path((std::filesystem::temp_directory_path() / name).string())
+        {
+            remove();
+        }
+
+        tree_files(const tree_files&) = delete;
+        tree_files& operator=(const tree_files&) = delete;
+
+        ~tree_files()
+        {
+            remove();
+        }
+
+        /*
+         * Copies files of path as they are on disk now, which is what restart sees if process dies at this point.
+         * Tree at path stays open and is destroyed as usual
+         */
+        void copy_from(const std::string &source) const
+        {
+            for (auto extension: extensions)
+            {
+                if (std::filesystem::exists(source + extension))
+                {
+                    std::filesystem::copy_file(source + extension, path + extension, std::filesystem::copy_options::overwrite_existing);
+                }
+            }
+        }
+
+        const std::string path;
+
+    private:
+
+        static constexpr const char* extensions[] = {".tree", ".wal", ".bloom", ".versions"};
+
+        void remove() const
+        {
+            for (auto extension: extensions)
+            {
+                std::filesystem::remove(path + extension);
+            }
+        }
+    };
+}
+
+TEST(bTreeDiskTests, test1)
+{
+    tree_files files("b_tree_disk_test1");
+    const auto &path = files.path;
+    std::map<int, std::string> expected;
+    std::mt19937 gen(1);
+
+    {
+        // Pool of four nodes makes almost every operation evict and write back
+        disk_tree tree(path, {}, nullptr, 4);
+
+        for (int i = 0; i < 3000; ++i)
+        {
+            int key = static_cast<int>(gen() % 1000);
+
+            switch (gen() % 3)
+            {
+                case 0:
+                    EXPECT_EQ(tree.insert({SerializableInt{key}, SerializableString(std::to_string(i))}),
+                              expected.emplace(key, std::to_string(i)).second);
+                    break;
+                case 1:
+                    EXPECT_EQ(tree.erase(SerializableInt{key}), expected.erase(key) == 1);
+                    break;
+                default:
+                    EXPECT_EQ(tree.at(SerializableInt{key}).has_value(), expected.contains(key));
+                    break;
+            }
+        }
+    }
+
+    disk_tree tree(path);
+
+    for (int key = 0; key < 1000; ++key)
+    {
+        auto value = tree.at(SerializableInt{key});
+        auto it = expected.find(key);
+
+        ASSERT_EQ(value.has_value(), it != expected.end());
+
+        if (value)
+        {
+            EXPECT_EQ(value->data, it->second);
+        }
+    }
+}
+
+TEST(bTreeDiskTests, test2)
+{
+    tree_files files("b_tree_disk_test2");
+    const auto &path = files.path;
+    std::map<int, std::string> expected;
+    std::mt19937 gen(2);
+
+    {
+        // Values up to three pages long go to overflow chains, short ones stay inline
+        disk_tree tree(path, {}, nullptr, 8, 1024);
+
+        for (int i = 0; i < 600; ++i)
+        {
+            int key = static_cast<int>(gen() % 200);
+            std::string value(gen() % 3000, static_cast<char>('a' + i % 26));
+
+            if (gen() % 4 == 0)
+            {
+                EXPECT_EQ(tree.erase(SerializableInt{key}), expected.erase(key) == 1);
+            } else
+            {
+                EXPECT_EQ(tree.insert({SerializableInt{key}, SerializableString(value)}),
+                          expected.emplace(key, value).second);
+            }
+        }
+    }
+
+    // Page size of existing file wins over the one passed
+    disk_tree tree(path, {}, nullptr, 8, 8192);
+
+    for (auto &[key, value]: expected)
+    {
+        auto found = tree.at(SerializableInt{key});
+
+        ASSERT_TRUE(found.has_value());
+        EXPECT_EQ(found->data, value);
+    }
+
+    tree_files bad("b_tree_disk_test2_bad");
+    EXPECT_THROW(disk_tree(bad.path, {}, nullptr, 8, 1000), std::invalid_argument);
+}
+
+TEST(bTreeDiskTests, test3)
+{
+    tree_files files("b_tree_disk_test3");
+    tree_files crashed("b_tree_disk_test3_crashed");
+
+    wal_options options;
+    options.group_commit = 100;
+
+    {
+        disk_tree tree(files.path, {}, nullptr, 1024, 1024, options);
+
+        for (int key = 0; key < 1050; ++key)
+        {
+            ASSERT_TRUE(tree.insert({SerializableInt{key}, SerializableString(std::to_string(key))}));
+        }
+
+        // Only committed groups of log are on disk yet, as if process died here
+        crashed.copy_from(files.path);
+    }
+
+    disk_tree tree(crashed.path);
+
+    for (int key = 0; key < 1050; ++key)
+    {
+        auto value = tree.at(SerializableInt{key});
+
+        ASSERT_EQ(value.has_value(), key < 1000);
+
+        if (value)
+        {
+            EXPECT_EQ(value->data, std::to_string(key));
+        }
+    }
+}
+
+TEST(bTreeDiskTests, test4)
+{
+    tree_files files("b_tree_disk_test4");
+    const auto &path = files.path;
+    std::map<int, std::string> expected;
+    size_t grown_pages = 0;
+
+    {
+        disk_tree tree(path, {}, nullptr, 16, 1024);
+
+        // Pages freed by merges are taken again by splits, so churn over the same keys does not grow file
+        for (int round = 0; round < 4; ++round)
+        {
+            for (int key = 0; key < 500; ++key)
+            {
+                tree.insert({SerializableInt{key}, SerializableString(std::string(key % 7 == 0 ? 1500 : 8, 'x'))});
+            }
+
+            if (round == 0)
+            {
+                grown_pages = tree.page_count();
+            }
+
+            for (int key = 0; key < 500; ++key)
+            {
+                tree.erase(SerializableInt{key});
+            }
+        }
+
+        EXPECT_LE(tree.page_count(), grown_pages + 8);
+
+        for (int key = 0; key < 500; key += 9)
+        {
+            tree.insert({SerializableInt{key}, SerializableString(std::to_string(key))});
+            expected.emplace(key, std::to_string(key));
+        }
+
+        tree.compact();
+
+        EXPECT_EQ(tree.free_page_count(), 0);
+        EXPECT_LT(tree.page_count(), grown_pages / 4);
+    }
+
+    disk_tree tree(path);
+
+    for (int key = 0; key < 500; ++key)
+    {
+        auto value = tree.at(SerializableInt{key});
+
+        ASSERT_EQ(value.has_value(), expected.contains(key));
+
+        if (value)
+        {
+            EXPECT_EQ(value->data, expected[key]);
+        }
+    }
+}
+
+TEST(bTreeDiskTests, test5)
+{
+    tree_files files("b_tree_disk_test5");
+    const auto &path = files.path;
+
+    {
+        disk_tree tree(path, {}, nullptr, 8);
+
+        for (int key = 0; key < 3000; key += 2)
+        {
+            tree.insert({SerializableInt{key}, SerializableString(std::to_string(key))});
+        }
+    }
+
+    // Small cache makes most nodes of every level come through batched reads
+    disk_tree tree(path, {}, nullptr, 8);
+
+    std::vector<SerializableInt> keys;
+    std::mt19937 generator(5);
+
+    for (int i = 0; i < 1000; ++i)
+    {
+        keys.push_back(SerializableInt{static_cast<int>(generator() % 3100)});
+    }
+
+    std::vector<std::optional<SerializableString>> values(keys.size());
+    tree.at_batch(keys, values);
+
+    for (size_t i = 0; i < keys.size(); ++i)
+    {
+        auto expected = tree.at(keys[i]);
+
+        ASSERT_EQ(values[i].has_value(), expected.has_value());
+        ASSERT_EQ(values[i].has_value(), keys[i].data % 2 == 0 && keys[i].data < 3000);
+
+        if (expected)
+        {
+            EXPECT_EQ(values[i]->data, expected->data);
+        }
+    }
+
+    // Merges read both siblings in one batch
+    for (int key = 0; key < 3000; key += 4)
+    {
+        ASSERT_TRUE(tree.erase(SerializableInt{key}));
+    }
+
+    tree.at_batch(keys, values);
+
+    for (size_t i = 0; i < keys.size(); ++i)
+    {
+        ASSERT_EQ(values[i].has_value(), keys[i].data % 4 == 2 && keys[i].data < 3000);
+    }
+
+    std::vector<std::optional<SerializableString>> wrong_size(1);
+
+    EXPECT_THROW(tree.at_batch(keys, wrong_size), std::invalid_argument);
+}
+
+TEST(bTreeDiskTests, test6)
+{
+    using packed_tree = B_tree_disk<SerializableInt, SerializableInt, std::less<SerializableInt>, 8>;
+
+    static_assert(raw_serializable<SerializableInt>);
+    static_assert(!raw_serializable<SerializableString>);
+
+    tree_files files("b_tree_disk_test6");
+    const auto &path = files.path;
+    std::map<int, int> expected;
+    std::mt19937 generator(6);
+
+    {
+        packed_tree tree(path, {}, nullptr, 4, 512);
+
+        for (int i = 0; i < 4000; ++i)
+        {
+            int key = static_cast<int>(generator() % 2000);
+
+            if (generator() % 3 == 0)
+            {
+                ASSERT_EQ(tree.erase(SerializableInt{key}), expected.erase(key) == 1);
+            } else if (tree.insert({SerializableInt{key}, SerializableInt{-key}}))
+            {
+                expected.emplace(key, -key);
+            }
+        }
+    }
+
+    // Nodes of fixed width pairs are packed, key and value are copied without serialize
+    packed_tree tree(path, {}, nullptr, 4);
+
+    for (int key = 0; key < 2000; ++key)
+    {
+        auto value = tree.at(SerializableInt{key});
+
+        ASSERT_EQ(value.has_value(), expected.contains(key));
+
+        if (value)
+        {
+            EXPECT_EQ(value->data, expected[key]);
+        }
+    }
+}
+
+TEST(bTreeDiskTests, test7)
+{
+    tree_files files("b_tree_disk_test7");
+    const auto &path = files.path;
+
+    bloom_options bloom;
+    bloom.enabled = true;
+
+    auto check = [&](disk_tree &tree, auto &&present)
+    {
+        for (int key = 0; key < 3000; ++key)
+        {
+            ASSERT_EQ(tree.at(SerializableInt{key}).has_value(), present(key)) << key;
+        }
+    };
+
+    {
+        disk_tree tree(path, {}, nullptr, 16, 1024, wal_options(), bloom);
+
+        for (int key = 0; key < 2000; key += 2)
+        {
+            tree.insert({SerializableInt{key}, SerializableString(std::to_string(key))});
+        }
+
+        for (int key = 0; key < 2000; key += 10)
+        {
+            tree.erase(SerializableInt{key});
+        }
+    }
+
+    auto saved = [](int key) { return key < 2000 && key % 2 == 0 && key % 10 != 0; };
+
+    EXPECT_TRUE(std::filesystem::exists(path + ".bloom"));
+
+    {
+        disk_tree tree(path, {}, nullptr, 16, 1024, wal_options(), bloom);
+        check(tree, saved);
+    }
+
+    // Keys replayed from log after crash are added to saved filter
+    tree_files crashed("b_tree_disk_test7_crashed");
+    wal_options wal;
+    wal.group_commit = 1;
+
+    {
+        disk_tree tree(path, {}, nullptr, 16, 1024, wal, bloom);
+
+        for (int key = 2001; key < 3000; key += 2)
+        {
+            tree.insert({SerializableInt{key}, SerializableString(std::to_string(key))});
+        }
+
+        crashed.copy_from(path);
+    }
+
+    auto replayed = [&](int key) { return saved(key) || (key > 2000 && key % 2 == 1); };
+
+    {
+        disk_tree tree(crashed.path, {}, nullptr, 16, 1024, wal_options(), bloom);
+        check(tree, replayed);
+    }
+
+    // Tree changed without filter does not trust filter saved before, nor does it trust missing file
+    {
+        disk_tree tree(crashed.path);
+        tree.insert({SerializableInt{1}, SerializableString("1")});
+    }
+
+    std::filesystem::remove(crashed.path + ".bloom");
+
+    disk_tree tree(crashed.path, {}, nullptr, 16, 1024, wal_options(), bloom);
+    check(tree, [&](int key) { return key == 1 || replayed(key); });
+
+    tree.compact();
+    check(tree, [&](int key) { return key == 1 || replayed(key); });
+}
+
+TEST(bTreeDiskTests, test8)
+{
+    using url_tree = B_tree_disk<SerializableString, SerializableString, std::less<SerializableString>, 4>;
+
+    static_assert(prefix_compressible<SerializableString>);
+    static_assert(!prefix_compressible<SerializableInt>);
+
+    tree_files files("b_tree_disk_test8");
+    const auto &path = files.path;
+    auto url = [](int key)
+    {
+        return SerializableString("https://example.com/" + std::string(120, 'p') + "/item/" + std::to_string(key));
+    };
+
+    {
+        url_tree tree(path, {}, nullptr, 8, 1024);
+
+        for (int key = 0; key < 400; ++key)
+        {
+            ASSERT_TRUE(tree.insert({url(key), SerializableString(std::to_string(key))}));
+        }
+
+        for (int key = 0; key < 400; key += 3)
+        {
+            ASSERT_TRUE(tree.erase(url(key)));
+        }
+
+        // Full keys do not fit inline and would take overflow page each, suffixes after shared prefix do
+        EXPECT_LT(tree.page_count(), 200);
+    }
+
+    url_tree tree(path, {}, nullptr, 8);
+
+    for (int key = 0; key < 400; ++key)
+    {
+        auto value = tree.at(url(key));
+
+        ASSERT_EQ(value.has_value(), key % 3 != 0);
+
+        if (value)
+        {
+            EXPECT_EQ(value->data, std::to_string(key));
+        }
+    }
+
+    EXPECT_FALSE(tree.at(SerializableString("https://example.com/")).has_value());
+}
+
+TEST(bTreeDiskTests, test9)
+{
+    tree_files files("b_tree_disk_test9");
+    const auto &path = files.path;
+    std::vector<std::pair<SerializableInt, SerializableString>> pairs;
+    std::map<int, std::string> expected;
+    std::mt19937 generator(9);
+
+    for (int i = 0; i < 20000; ++i)
+    {
+        int key = static_cast<int>(generator() % 15000);
+
+        pairs.emplace_back(SerializableInt{key}, SerializableString(std::to_string(i)));
+        expected.emplace(key, std::to_string(i));
+    }
+
+    {
+        // Tree left at path is replaced, its log is not replayed over new one
+        disk_tree tree(path);
+        tree.insert({SerializableInt{-1}, SerializableString("old")});
+        tree.commit();
+    }
+
+    // Small runs and narrow merges make several merge passes
+    build_options options;
+    options.memory_bytes = 64 << 10;
+    options.threads = 3;
+    options.merge_fan_in = 3;
+
+    disk_tree::build(path, pairs, options, {}, 1024);
+
+    disk_tree tree(path);
+    tree.check_tree(tree._position_root, 0);
+
+    EXPECT_FALSE(tree.at(SerializableInt{-1}).has_value());
+
+    for (int key = 0; key < 15000; ++key)
+    {
+        auto value = tree.at(SerializableInt{key});
+        auto it = expected.find(key);
+
+        ASSERT_EQ(value.has_value(), it != expected.end());
+
+        // First of equal keys wins, as with insert
+        if (value)
+        {
+            EXPECT_EQ(value->data, it->second);
+        }
+    }
+
+    // Nodes are written full, so tree takes about as many pages as keys over node capacity
+    EXPECT_LT(tree.page_count(), expected.size() / 4);
+
+    for (int key = 15000; key < 16000; ++key)
+    {
+        ASSERT_TRUE(tree.insert({SerializableInt{key}, SerializableString("new")}));
+    }
+
+    tree.check_tree(tree._position_root, 0);
+}
+
+TEST(bTreeDiskTests, test10)
+{
+    tree_files files("b_tree_disk_test10");
+    const auto &path = files.path;
+    auto value = [](int key)
+    {
+        return std::string(key % 50 == 0 ? 1500 : 8, 'v') + std::to_string(key);
+    };
+
+    // Small pool makes readers load and evict pages while writer changes tree
+    disk_tree tree(path, {}, nullptr, 16, 1024);
+
+    for (int key = 0; key < 4000; key += 2)
+    {
+        ASSERT_TRUE(tree.insert({SerializableInt{key}, SerializableString(value(key))}));
+    }
+
+    std::atomic<bool> stop = false;
+    std::atomic<size_t> wrong = 0;
+    std::vector<std::thread> readers;
+
+    for (unsigned seed = 0; seed < 4; ++seed)
+    {
+        readers.emplace_back([&, seed]
+        {
+            std::mt19937 generator(seed);
+            std::vector<SerializableInt> keys(32);
+            std::vector<std::optional<SerializableString>> values(keys.size());
+
+            while (!stop)
+            {
+                for (auto &key: keys)
+                {
+                    key = SerializableInt{static_cast<int>(generator() % 2000) * 2};
+                }
+
+                tree.at_batch(keys, values);
+
+                for (size_t i = 0; i < keys.size(); ++i)
+                {
+                    auto single = tree.at(keys[i]);
+
+                    if (!values[i] || values[i]->data != value(keys[i].data) || !single ||
+                        single->data != value(keys[i].data))
+                    {
+                        ++wrong;
+                    }
+                }
+            }
+        });
+    }
+
+    // Writer touches odd keys only, even ones stay visible to readers all the time
+    std::mt19937 generator(10);
+
+    for (int i = 0; i < 3000; ++i)
+    {
+        int key = static_cast<int>(generator() % 2000) * 2 + 1;
+
+        if (generator() % 2 == 0)
+        {
+            tree.insert({SerializableInt{key}, SerializableString(value(key))});
+        } else
+        {
+            tree.erase(SerializableInt{key});
+        }
+    }
+
+    stop = true;
+
+    for (auto &reader: readers)
+    {
+        reader.join();
+    }
+
+    EXPECT_EQ(wrong, 0);
+}
+
+TEST(bTreeDiskTests, test11)
+{
+    tree_files files("b_tree_disk_test11");
+    const auto &path = files.path;
+    auto value = [](int key, int version)
+    {
+        return std::string(key % 40 == 0 ? 1500 : 8, 'v') + std::to_string(key) + "." + std::to_string(version);
+    };
+
+    disk_tree tree(path, {}, nullptr, 16, 1024);
+    std::map<int, std::string> expected;
+
+    for (int key = 0; key < 3000; key += 3)
+    {
+        ASSERT_TRUE(tree.insert({SerializableInt{key}, SerializableString(value(key, 0))}));
+        expected.emplace(key, value(key, 0));
+    }
+
+    {
+        auto snapshot = tree.snapshot();
+        std::atomic<bool> stop = false;
+        std::atomic<size_t> wrong = 0;
+        std::vector<std::thread> readers;
+
+        // Scans see tree as it was when snapshot was taken, whatever writer does meanwhile
+        for (unsigned seed = 0; seed < 3; ++seed)
+        {
+            readers.emplace_back([&, seed]
+            {
+                std::mt19937 generator(seed);
+
+                while (!stop)
+                {
+                    auto it = expected.begin();
+                    bool same = true;
+
+                    snapshot.for_each([&](const disk_tree::tree_data_type &data)
+                    {
+                        same = same && it != expected.end() && it->first == data.first.data &&
+                               it->second == data.second.data;
+                        ++it;
+                    });
+
+                    int key = static_cast<int>(generator() % 3000);
+                    auto found = snapshot.at(SerializableInt{key});
+                    auto expected_it = expected.find(key);
+
+                    if (!same || it != expected.end() || found.has_value() != (expected_it != expected.end()) ||
+                        (found && found->data != expected_it->second))
+                    {
+                        ++wrong;
+                    }
+                }
+            });
+        }
+
+        std::mt19937 generator(11);
+
+        for (int i = 1; i < 4000; ++i)
+        {
+            int key = static_cast<int>(generator() % 3000);
+
+            switch (generator() % 3)
+            {
+                case 0:
+                    tree.insert({SerializableInt{key}, SerializableString(value(key, i))});
+                    break;
+                case 1:
+                    tree.update({SerializableInt{key}, SerializableString(value(key, i))});
+                    break;
+                default:
+                    tree.erase(SerializableInt{key});
+                    break;
+            }
+        }
+
+        stop = true;
+
+        for (auto &reader: readers)
+        {
+            reader.join();
+        }
+
+        EXPECT_EQ(wrong, 0);
+        EXPECT_THROW(tree.compact(), std::logic_error);
+    }
+
+    // Copies are dropped with last snapshot
+    EXPECT_FALSE(std::filesystem::exists(path + ".versions"));
+
+    tree.check_tree(tree._position_root, 0);
+    tree.compact();
+}
+
+TEST(bTreeDiskTests, test12)
+{
+    tree_files files("b_tree_disk_test12");
+    tree_files other_files("b_tree_disk_test12_other");
+    const auto &path = files.path;
+
+    {
+        disk_tree tree(path, {}, nullptr, 8);
+
+        for (int key = 0; key < 500; ++key)
+        {
+            tree.insert({SerializableInt{key}, SerializableString(std::to_string(key))});
+        }
+
+        // Both moved-from trees are destroyed at the end of scope
+        disk_tree moved(std::move(tree));
+        disk_tree assigned(other_files.path);
+
+        assigned = std::move(moved);
+
+        EXPECT_EQ(assigned.at(SerializableInt{250})->data, "250");
+        assigned.insert({SerializableInt{500}, SerializableString("500")});
+    }
+
+    disk_tree tree(path);
+
+    for (int key = 0; key <= 500; ++key)
+    {
+        auto value = tree.at(SerializableInt{key});
+
+        ASSERT_TRUE(value.has_value());
+        EXPECT_EQ(value->data, std::to_string(key));
+    }
+}
+
+int main(
+    int argc,
+    char **argv)
 {
+    testing::InitGoogleTest(&argc, argv);
 
-}
\ No newline at end of file
+    return RUN_ALL_TESTS();
+}